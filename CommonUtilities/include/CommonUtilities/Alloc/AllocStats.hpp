@@ -0,0 +1,181 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <vector>
+#include <string>
+#include <string_view>
+#include <bit>
+
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+	enum class AllocatorType
+	{
+		Arena,		// ArenaAlloc
+		Pool,		// PoolAlloc
+		Frame,		// FrameAllocator, FrameAlloc, and FrameResource
+		Resource,	// ArenaResource and PoolResource, chained resources are counted at every level
+
+		Count
+	};
+
+	/// Snapshot of a single kind of allocator. Reserved memory is what the allocator holds from the
+	/// system or its upstream, live memory is what has been handed out and not yet freed.
+	///
+	struct AllocatorStats
+	{
+		static constexpr std::size_t SIZE_CLASS_COUNT = 16;
+
+		std::uint64_t	reserved		{0};
+		std::uint64_t	peakReserved	{0};
+		std::int64_t	live			{0};
+		std::int64_t	peakLive		{0}; // may lag behind by up to 64 KiB per thread, see AllocStats::Capture
+		std::uint64_t	allocations		{0};
+		std::uint64_t	deallocations	{0};
+
+		std::array<std::uint64_t, SIZE_CLASS_COUNT> sizeClasses {}; // allocation counts by power-of-two size
+
+		COMMON_UTILITIES_API void Merge(const AllocatorStats& aOther) noexcept;
+
+		/// \returns Fraction of the reserved memory that is not live, e.g., freed blocks, padding, or the
+		///          unused tail of a buffer.
+		///
+		COMMON_UTILITIES_API NODISC double GetFragmentation() const noexcept;
+
+		/// \returns Size class that an allocation falls in, the first class holds up to 16 bytes and every
+		///          following class doubles it. The last class holds everything larger.
+		///
+		NODISC static constexpr std::size_t GetSizeClass(std::size_t aNumBytes) noexcept
+		{
+			const auto index = static_cast<std::size_t>(std::bit_width((aNumBytes > 0 ? aNumBytes - 1 : 0) >> 4));
+			return index < SIZE_CLASS_COUNT ? index : SIZE_CLASS_COUNT - 1;
+		}
+
+		/// \returns Largest allocation in the size class, the last class is unbounded.
+		///
+		NODISC static constexpr std::size_t GetSizeClassLimit(std::size_t aIndex) noexcept
+		{
+			return aIndex + 1 < SIZE_CLASS_COUNT ? std::size_t(16) << aIndex : SIZE_MAX;
+		}
+	};
+
+	/// Allocations made while the tag was active, summed over all allocators. Deallocations count towards
+	/// whichever tag is active on the deallocating thread, so live bytes are only meaningful for tags that
+	/// free what they allocate.
+	///
+	struct AllocTagStats
+	{
+		std::string_view	name;
+		std::uint64_t		allocations		{0};
+		std::uint64_t		deallocations	{0};
+		std::uint64_t		bytesAllocated	{0};
+		std::uint64_t		bytesFreed		{0};
+
+		NODISC std::int64_t GetLive() const noexcept
+		{
+			return static_cast<std::int64_t>(bytesAllocated) - static_cast<std::int64_t>(bytesFreed);
+		}
+	};
+
+	/// Memory statistics for the allocators in the library, collected when built with COMMON_UTILITIES_ALLOC_STATS.
+	/// Every thread writes its own counters, only reserving and releasing memory, which happens once per
+	/// buffer, slab, or chunk, touches shared counters.
+	///
+	struct AllocStats
+	{
+		static constexpr bool ENABLED = COMMON_UTILITIES_ALLOC_STATS;
+
+		std::array<AllocatorStats, static_cast<std::size_t>(AllocatorType::Count)> allocators;
+		AllocatorStats				total;
+		std::vector<AllocTagStats>	tags; // in the order they were registered, starting with the untagged allocations
+
+		/// Sums the counters of all threads. Live memory is exact, while the peak is tracked from what each
+		/// thread flushes after every 64 KiB of change, so it may miss a short spike below that.
+		///
+		COMMON_UTILITIES_API NODISC static AllocStats Capture();
+
+		/// Starts tracking the peaks anew from the current values.
+		///
+		COMMON_UTILITIES_API static void ResetPeaks();
+
+		NODISC const AllocatorStats& Get(AllocatorType aType) const noexcept
+		{
+			return allocators[static_cast<std::size_t>(aType)];
+		}
+
+		/// \returns One row per value as: section,name,metric,value
+		///
+		COMMON_UTILITIES_API NODISC std::string ToCSV() const;
+
+		COMMON_UTILITIES_API NODISC std::string ToJSON() const;
+
+		COMMON_UTILITIES_API NODISC static std::string_view GetName(AllocatorType aType) noexcept;
+	};
+
+	/// Name that allocations are attributed to while it is active through an AllocTagScope. Registering
+	/// the same name twice returns the same tag. Create tags once, e.g., as statics, since registering
+	/// takes a lock.
+	///
+	class AllocTag
+	{
+	public:
+		static constexpr std::size_t MAX_TAGS = 64; // further tags are counted as untagged
+
+		/// \param Name: Must outlive the tag, e.g., a string literal.
+		///
+		COMMON_UTILITIES_API explicit AllocTag(std::string_view aName);
+
+		NODISC std::size_t GetID() const noexcept { return myID; }
+		NODISC std::string_view GetName() const noexcept { return myName; }
+
+	private:
+		std::string_view	myName;
+		std::size_t			myID {0};
+	};
+
+	namespace details::allocstats
+	{
+#if COMMON_UTILITIES_ALLOC_STATS
+		COMMON_UTILITIES_API void RecordAllocate(AllocatorType aType, std::size_t aNumBytes) noexcept;
+		COMMON_UTILITIES_API void RecordDeallocate(AllocatorType aType, std::size_t aNumBytes) noexcept;
+
+		/// Live memory returned in bulk rather than through deallocations, e.g., by a marker or reset.
+		///
+		COMMON_UTILITIES_API void RecordRewind(AllocatorType aType, std::size_t aNumBytes) noexcept;
+
+		COMMON_UTILITIES_API void RecordReserve(AllocatorType aType, std::size_t aNumBytes) noexcept;
+		COMMON_UTILITIES_API void RecordRelease(AllocatorType aType, std::size_t aNumBytes) noexcept;
+
+		/// \returns The previously active tag.
+		///
+		COMMON_UTILITIES_API std::size_t SetTag(std::size_t aID) noexcept;
+#else
+		inline void RecordAllocate(AllocatorType, std::size_t) noexcept {}
+		inline void RecordDeallocate(AllocatorType, std::size_t) noexcept {}
+		inline void RecordRewind(AllocatorType, std::size_t) noexcept {}
+		inline void RecordReserve(AllocatorType, std::size_t) noexcept {}
+		inline void RecordRelease(AllocatorType, std::size_t) noexcept {}
+		inline std::size_t SetTag(std::size_t) noexcept { return 0; }
+#endif
+	}
+
+	/// Attributes allocations on this thread to the tag for the lifetime of the scope.
+	///
+	class AllocTagScope
+	{
+	public:
+		explicit AllocTagScope(const AllocTag& aTag) noexcept
+			: myPrevious(details::allocstats::SetTag(aTag.GetID())) {}
+
+		~AllocTagScope() { details::allocstats::SetTag(myPrevious); }
+
+		AllocTagScope(const AllocTagScope&) = delete;
+		AllocTagScope& operator=(const AllocTagScope&) = delete;
+
+	private:
+		std::size_t myPrevious {0};
+	};
+}
@@ -1,16 +1,37 @@
 #pragma once
 
 #include <cstddef>
-#include <shared_mutex>
+#include <type_traits>
 
 #include <CommonUtilities/Config.h>
 
 namespace CommonUtilities
 { 
-	namespace details::arena
+	/// How the arenas get their memory from the system. Each thread reserves a range of address space and
+	/// commits regions from it as they are needed, so a large working set is backed by a few contiguous
+	/// mappings rather than many small heap blocks. Falls back to the heap where virtual memory is unavailable.
+	///
+	struct ArenaConfig
 	{
-		static std::shared_mutex globalMutex;
+		std::size_t	capacity	{256ull * 1024 * 1024};	// address space reserved by a thread at a time, another is reserved when it runs out
+		std::size_t	prefault	{0};					// bytes committed up front when a thread first allocates
+		bool		hugePages	{false};				// advise transparent huge pages, Linux only
+		bool		populate	{false};				// fault in committed pages right away, as MAP_POPULATE
+	};
+
+	/// Applies to address space reserved from here on, threads keep using what they have already reserved.
+	///
+	COMMON_UTILITIES_API void SetArenaConfig(const ArenaConfig& aConfig);
 
+	COMMON_UTILITIES_API NODISC ArenaConfig GetArenaConfig();
+
+	namespace details::arena
+	{
+		/// Each thread allocates from its own buffers without locking. Memory may be deallocated on any
+		/// thread, memory from another thread's buffers is counted as freed and reclaimed by its owner.
+		/// Buffers are aligned regions so the owner of an address is found in constant time, and
+		/// emptied buffers are reused. The hint is no longer needed to pick a buffer and is ignored.
+		///
 		COMMON_UTILITIES_API NODISC std::byte* Allocate(std::size_t aNumBytes, std::size_t aAlignment, const std::byte* aHint);
 		COMMON_UTILITIES_API void Deallocate(std::byte* aMemory, std::size_t aNumBytes);
 	}
@@ -37,13 +58,11 @@ namespace CommonUtilities
 
 		NODISC constexpr __declspec(allocator) T* allocate(size_type aNumObjects, const T* aHint = nullptr)
 		{
-			std::scoped_lock lock(details::arena::globalMutex);
 			return reinterpret_cast<T*>(details::arena::Allocate(aNumObjects * sizeof(T), alignof(T), reinterpret_cast<const std::byte*>(aHint)));
 		}
 
 		constexpr void deallocate(T* aObject, size_type aNumObjects)
 		{
-			std::scoped_lock lock(details::arena::globalMutex);
 			details::arena::Deallocate(reinterpret_cast<std::byte*>(aObject), aNumObjects * sizeof(T));
 		}
 	};
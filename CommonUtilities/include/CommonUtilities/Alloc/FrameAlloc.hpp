@@ -0,0 +1,166 @@
+#pragma once
+
+#include <cstddef>
+#include <array>
+#include <vector>
+#include <memory_resource>
+#include <type_traits>
+
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{ 
+	/// Linear allocator for temporaries that live for at most one frame. Allocating bumps a pointer,
+	/// scopes are released in bulk by popping back to a marker, and everything is released at once
+	/// by Reset at the end of the frame. Memory is double-buffered so that what was allocated during
+	/// one frame stays valid until the end of the next. Not thread-safe, use one allocator per thread.
+	///
+	class FrameAllocator
+	{
+	public:
+		static constexpr std::size_t DEFAULT_CAPACITY = 64 * 1024;
+
+		struct Marker
+		{
+			std::size_t chunk	{0};
+			std::size_t offset	{0};
+		};
+
+		/// Pushes a marker on construction and pops back to it on destruction.
+		///
+		class Scope
+		{
+		public:
+			explicit Scope(FrameAllocator& aAllocator)
+				: myAllocator(aAllocator), myMarker(aAllocator.PushMarker()) {}
+
+			~Scope() { myAllocator.PopToMarker(myMarker); }
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+
+		private:
+			FrameAllocator& myAllocator;
+			Marker			myMarker;
+		};
+
+		/// \param Capacity: Initial size of each frame buffer.
+		/// \param Upstream: Resource that the frame buffers are allocated from.
+		///
+		COMMON_UTILITIES_API explicit FrameAllocator(std::size_t aCapacity = DEFAULT_CAPACITY, std::pmr::memory_resource* aUpstream = std::pmr::get_default_resource());
+		COMMON_UTILITIES_API ~FrameAllocator();
+
+		FrameAllocator(const FrameAllocator&) = delete;
+		FrameAllocator& operator=(const FrameAllocator&) = delete;
+
+		/// \returns Memory that remains valid until popped past or until the end of the next frame.
+		///
+		COMMON_UTILITIES_API NODISC std::byte* Allocate(std::size_t aNumBytes, std::size_t aAlignment = alignof(std::max_align_t));
+
+		/// Memory is only reclaimed if it was the latest allocation, e.g., when a vector grows, otherwise
+		/// it is left until the scope or frame ends.
+		///
+		COMMON_UTILITIES_API void Deallocate(std::byte* aMemory, std::size_t aNumBytes);
+
+		COMMON_UTILITIES_API NODISC Marker PushMarker() const;
+		COMMON_UTILITIES_API void PopToMarker(const Marker& aMarker);
+
+		/// Ends the current frame. Memory allocated during the previous frame is released and memory
+		/// allocated during the current frame stays valid until the next reset.
+		///
+		COMMON_UTILITIES_API void Reset();
+
+		/// Returns both frame buffers to the upstream resource, invalidating everything allocated.
+		///
+		COMMON_UTILITIES_API void Release();
+
+		NODISC std::pmr::memory_resource* GetUpstream() const noexcept { return myUpstream; }
+
+		/// \returns Bytes allocated during the current frame.
+		///
+		COMMON_UTILITIES_API NODISC std::size_t GetUsed() const;
+
+		/// \returns Bytes reserved for the current frame.
+		///
+		COMMON_UTILITIES_API NODISC std::size_t GetCapacity() const;
+
+	private:
+		struct Chunk
+		{
+			std::byte*	data		{nullptr};
+			std::size_t	capacity	{0};
+			std::size_t	size		{0};
+		};
+
+		struct Frame
+		{
+			std::vector<Chunk>	chunks;
+			std::size_t			current	{0};
+		};
+
+		NODISC Frame& GetFrame();
+		NODISC const Frame& GetFrame() const;
+
+		NODISC static std::size_t GetUsed(const Frame& aFrame);
+
+		Chunk& AddChunk(Frame& aFrame, std::size_t aCapacity);
+		void ReleaseChunks(Frame& aFrame);
+
+		std::array<Frame, 2>		myFrames;
+		std::pmr::memory_resource*	myUpstream	{nullptr};
+		std::size_t					myCapacity	{DEFAULT_CAPACITY};
+		std::size_t					myIndex		{0};
+	};
+
+	namespace details::frame
+	{
+		/// Thread-local allocator the library uses for temporaries within a FrameAllocator::Scope. Never
+		/// reset, so nothing allocated from it may outlive the scope it was allocated in.
+		///
+		COMMON_UTILITIES_API NODISC FrameAllocator& GetScratch();
+	}
+
+	template<typename T>
+	class FrameAlloc
+	{
+	public:
+		using value_type								= T;
+		using size_type									= std::size_t;
+		using difference_type							= std::ptrdiff_t;
+		using propagate_on_container_copy_assignment	= std::true_type;
+		using propagate_on_container_move_assignment	= std::true_type;
+		using propagate_on_container_swap				= std::true_type;
+		using is_always_equal							= std::false_type;
+
+		constexpr FrameAlloc(FrameAllocator& aAllocator) noexcept : myAllocator(&aAllocator) {}
+		constexpr ~FrameAlloc() = default;
+
+		constexpr FrameAlloc(const FrameAlloc&) noexcept = default;
+
+		template <class U>
+		constexpr FrameAlloc(const FrameAlloc<U>& aOther) noexcept : myAllocator(&aOther.GetAllocator()) {}
+
+		constexpr FrameAlloc& operator=(const FrameAlloc&) = default;
+
+		NODISC constexpr FrameAllocator& GetAllocator() const noexcept { return *myAllocator; }
+
+		NODISC constexpr __declspec(allocator) T* allocate(size_type aNumObjects)
+		{
+			return reinterpret_cast<T*>(myAllocator->Allocate(aNumObjects * sizeof(T), alignof(T)));
+		}
+
+		constexpr void deallocate(T* aObject, size_type aNumObjects)
+		{
+			myAllocator->Deallocate(reinterpret_cast<std::byte*>(aObject), aNumObjects * sizeof(T));
+		}
+
+		template <class U>
+		NODISC constexpr bool operator==(const FrameAlloc<U>& aOther) const noexcept
+		{
+			return myAllocator == &aOther.GetAllocator();
+		}
+
+	private:
+		FrameAllocator* myAllocator {nullptr};
+	};
+}
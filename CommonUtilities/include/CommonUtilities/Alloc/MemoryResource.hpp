@@ -0,0 +1,196 @@
+#pragma once
+
+#include <cstddef>
+#include <array>
+#include <memory_resource>
+
+#include <CommonUtilities/Alloc/PoolAlloc.hpp>
+#include <CommonUtilities/Alloc/FrameAlloc.hpp>
+
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+	namespace details::resource
+	{
+		/// Allocations too large for a resource's own chunks or blocks, taken directly from the upstream
+		/// resource. Each is prefixed with a link so that the resource can return all of them on release.
+		///
+		class LargeList
+		{
+		public:
+			COMMON_UTILITIES_API NODISC void* Allocate(std::pmr::memory_resource* aUpstream, std::size_t aNumBytes, std::size_t aAlignment);
+			COMMON_UTILITIES_API void Deallocate(std::pmr::memory_resource* aUpstream, void* aMemory, std::size_t aNumBytes, std::size_t aAlignment);
+
+			COMMON_UTILITIES_API void Release(std::pmr::memory_resource* aUpstream);
+
+		private:
+			struct Node
+			{
+				Node*		prev		{nullptr};
+				Node*		next		{nullptr};
+				std::size_t	size		{0}; // total size requested from upstream
+				std::size_t	alignment	{0};
+			};
+
+			NODISC static std::size_t HeaderSize(std::size_t aAlignment);
+
+			Node* myHead {nullptr};
+		};
+	}
+
+	/// Linear memory resource with its own chunks, the instanced counterpart to ArenaAlloc. Deallocation
+	/// only rolls back the latest allocation, everything else is returned in bulk by Reset or Release.
+	/// Not thread-safe, use one resource per thread.
+	///
+	class ArenaResource : public std::pmr::memory_resource
+	{
+	public:
+		static constexpr std::size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+
+		/// \param ChunkSize: Size of each chunk requested from upstream, requests larger than a quarter
+		///                   of it are given an upstream allocation of their own.
+		/// \param Upstream: Resource that the chunks are allocated from.
+		///
+		COMMON_UTILITIES_API explicit ArenaResource(std::size_t aChunkSize = DEFAULT_CHUNK_SIZE, std::pmr::memory_resource* aUpstream = std::pmr::get_default_resource());
+		explicit ArenaResource(std::pmr::memory_resource* aUpstream) : ArenaResource(DEFAULT_CHUNK_SIZE, aUpstream) {}
+
+		COMMON_UTILITIES_API ~ArenaResource() override;
+
+		ArenaResource(const ArenaResource&) = delete;
+		ArenaResource& operator=(const ArenaResource&) = delete;
+
+		NODISC std::pmr::memory_resource* GetUpstream() const noexcept { return myUpstream; }
+
+		/// Invalidates everything allocated but keeps the chunks for reuse.
+		///
+		COMMON_UTILITIES_API void Reset();
+
+		/// Returns all memory to the upstream resource, invalidating everything allocated.
+		///
+		COMMON_UTILITIES_API void Release();
+
+	protected:
+		COMMON_UTILITIES_API void* do_allocate(std::size_t aNumBytes, std::size_t aAlignment) override;
+		COMMON_UTILITIES_API void do_deallocate(void* aMemory, std::size_t aNumBytes, std::size_t aAlignment) override;
+		COMMON_UTILITIES_API bool do_is_equal(const std::pmr::memory_resource& aOther) const noexcept override;
+
+	private:
+		struct Chunk
+		{
+			Chunk*		next		{nullptr};
+			std::size_t	capacity	{0};
+			std::size_t	size		{0};
+		};
+
+		NODISC bool IsLarge(std::size_t aNumBytes, std::size_t aAlignment) const;
+
+		Chunk* NextChunk();
+		void ReleaseChunks(Chunk* aChunk);
+
+		std::pmr::memory_resource*		myUpstream	{nullptr};
+		std::size_t						myChunkSize	{DEFAULT_CHUNK_SIZE};
+		Chunk*							myChunks	{nullptr}; // in use, the first one is allocated from
+		Chunk*							myUnused	{nullptr}; // kept by Reset
+		std::size_t						myLive		{0}; // bytes not yet deallocated, for the statistics
+		details::resource::LargeList	myLarge;
+	};
+
+	/// Memory resource handing out blocks from size classes, the instanced counterpart to PoolAlloc.
+	/// Freed blocks are reused right away by the same resource, and all slabs are returned to upstream
+	/// in bulk by Release. Not thread-safe, unlike PoolAlloc there is no cache per thread.
+	///
+	class PoolResource : public std::pmr::memory_resource
+	{
+	public:
+		static constexpr std::size_t DEFAULT_SLAB_SIZE = 64 * 1024;
+
+		/// \param SlabSize: Size of each slab requested from upstream that blocks of a class are carved from.
+		/// \param Upstream: Resource that the slabs are allocated from.
+		///
+		COMMON_UTILITIES_API explicit PoolResource(std::size_t aSlabSize = DEFAULT_SLAB_SIZE, std::pmr::memory_resource* aUpstream = std::pmr::get_default_resource());
+		explicit PoolResource(std::pmr::memory_resource* aUpstream) : PoolResource(DEFAULT_SLAB_SIZE, aUpstream) {}
+
+		COMMON_UTILITIES_API ~PoolResource() override;
+
+		PoolResource(const PoolResource&) = delete;
+		PoolResource& operator=(const PoolResource&) = delete;
+
+		NODISC std::pmr::memory_resource* GetUpstream() const noexcept { return myUpstream; }
+
+		/// Returns all memory to the upstream resource, invalidating everything allocated.
+		///
+		COMMON_UTILITIES_API void Release();
+
+	protected:
+		COMMON_UTILITIES_API void* do_allocate(std::size_t aNumBytes, std::size_t aAlignment) override;
+		COMMON_UTILITIES_API void do_deallocate(void* aMemory, std::size_t aNumBytes, std::size_t aAlignment) override;
+		COMMON_UTILITIES_API bool do_is_equal(const std::pmr::memory_resource& aOther) const noexcept override;
+
+	private:
+		struct FreeBlock
+		{
+			FreeBlock* next {nullptr};
+		};
+
+		struct Slab
+		{
+			Slab* next {nullptr};
+		};
+
+		void Carve(std::size_t aIndex);
+
+		std::pmr::memory_resource*							myUpstream	{nullptr};
+		std::size_t											mySlabSize	{DEFAULT_SLAB_SIZE};
+		std::array<FreeBlock*, details::pool::CLASS_COUNT>	myLists		{};
+		Slab*												mySlabs		{nullptr};
+		std::size_t											myLive		{0}; // bytes not yet deallocated, for the statistics
+		details::resource::LargeList						myLarge;
+	};
+
+	/// Memory resource over a FrameAllocator, for handing per-frame scratch memory to std::pmr containers.
+	///
+	class FrameResource : public std::pmr::memory_resource
+	{
+	public:
+		/// \param Capacity: Initial size of each frame buffer.
+		/// \param Upstream: Resource that the frame buffers are allocated from.
+		///
+		explicit FrameResource(std::size_t aCapacity = FrameAllocator::DEFAULT_CAPACITY, std::pmr::memory_resource* aUpstream = std::pmr::get_default_resource())
+			: myAllocator(aCapacity, aUpstream) {}
+
+		explicit FrameResource(std::pmr::memory_resource* aUpstream) : FrameResource(FrameAllocator::DEFAULT_CAPACITY, aUpstream) {}
+
+		NODISC std::pmr::memory_resource* GetUpstream() const noexcept { return myAllocator.GetUpstream(); }
+
+		NODISC FrameAllocator& GetAllocator() noexcept { return myAllocator; }
+		NODISC const FrameAllocator& GetAllocator() const noexcept { return myAllocator; }
+
+		/// Ends the current frame, see FrameAllocator::Reset.
+		///
+		void Reset() { myAllocator.Reset(); }
+
+		/// Returns all memory to the upstream resource, invalidating everything allocated.
+		///
+		void Release() { myAllocator.Release(); }
+
+	protected:
+		void* do_allocate(std::size_t aNumBytes, std::size_t aAlignment) override
+		{
+			return myAllocator.Allocate(aNumBytes, aAlignment);
+		}
+
+		void do_deallocate(void* aMemory, std::size_t aNumBytes, std::size_t) override
+		{
+			myAllocator.Deallocate(static_cast<std::byte*>(aMemory), aNumBytes);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& aOther) const noexcept override
+		{
+			return this == &aOther;
+		}
+
+	private:
+		FrameAllocator myAllocator;
+	};
+}
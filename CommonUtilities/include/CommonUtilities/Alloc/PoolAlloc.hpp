@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{ 
+	namespace details::pool
+	{
+		inline constexpr std::size_t MAX_BLOCK_SIZE		= 1024;	// larger requests go straight to operator new
+		inline constexpr std::size_t BLOCK_ALIGNMENT	= 16;	// requests aligned beyond this go straight to operator new
+
+		// size classes are steps of 16 bytes up to 256 bytes, and steps of 128 bytes up to MAX_BLOCK_SIZE
+
+		inline constexpr std::size_t SMALL_LIMIT	= 256;
+		inline constexpr std::size_t SMALL_STEP		= 16;
+		inline constexpr std::size_t LARGE_STEP		= 128;
+		inline constexpr std::size_t CLASS_COUNT	= SMALL_LIMIT / SMALL_STEP + (MAX_BLOCK_SIZE - SMALL_LIMIT) / LARGE_STEP;
+
+		static_assert(SMALL_STEP % BLOCK_ALIGNMENT == 0 && LARGE_STEP % BLOCK_ALIGNMENT == 0, "Blocks must stay aligned");
+
+		NODISC constexpr std::size_t ClassIndex(std::size_t aNumBytes)
+		{
+			if (aNumBytes <= SMALL_LIMIT)
+				return ((aNumBytes != 0 ? aNumBytes : 1) + SMALL_STEP - 1) / SMALL_STEP - 1;
+
+			return SMALL_LIMIT / SMALL_STEP + (aNumBytes - SMALL_LIMIT + LARGE_STEP - 1) / LARGE_STEP - 1;
+		}
+
+		NODISC constexpr std::size_t ClassSize(std::size_t aIndex)
+		{
+			if (aIndex < SMALL_LIMIT / SMALL_STEP)
+				return (aIndex + 1) * SMALL_STEP;
+
+			return SMALL_LIMIT + (aIndex + 1 - SMALL_LIMIT / SMALL_STEP) * LARGE_STEP;
+		}
+
+		static_assert(ClassSize(CLASS_COUNT - 1) == MAX_BLOCK_SIZE);
+		static_assert(ClassIndex(MAX_BLOCK_SIZE) == CLASS_COUNT - 1);
+
+		/// Blocks are handed out from size classes, each thread keeps a cache of free blocks per class
+		/// that is refilled from, and spilled to, a shared depot in batches. Memory may be deallocated on
+		/// any thread, blocks simply end up in the deallocating thread's cache.
+		///
+		COMMON_UTILITIES_API NODISC std::byte* Allocate(std::size_t aNumBytes, std::size_t aAlignment);
+		COMMON_UTILITIES_API void Deallocate(std::byte* aMemory, std::size_t aNumBytes, std::size_t aAlignment);
+	}
+
+	/// Allocator for fixed-size objects with random-order lifetimes, such as nodes in std::list,
+	/// std::map, or std::unordered_map. Freed blocks are reused right away, unlike ArenaAlloc.
+	///
+	template<typename T>
+	class PoolAlloc
+	{
+	public:
+		using value_type								= T;
+		using size_type									= std::size_t;
+		using difference_type							= std::ptrdiff_t;
+		using propagate_on_container_move_assignment	= std::true_type;
+		using is_always_equal							= std::true_type;
+
+		constexpr PoolAlloc() noexcept {}
+		constexpr ~PoolAlloc() = default;
+
+		constexpr PoolAlloc(const PoolAlloc&) noexcept = default;
+
+		template <class U>
+		constexpr PoolAlloc(const PoolAlloc<U>&) noexcept {}
+
+		constexpr PoolAlloc& operator=(const PoolAlloc&) = default;
+
+		NODISC constexpr __declspec(allocator) T* allocate(size_type aNumObjects)
+		{
+			return reinterpret_cast<T*>(details::pool::Allocate(aNumObjects * sizeof(T), alignof(T)));
+		}
+
+		constexpr void deallocate(T* aObject, size_type aNumObjects)
+		{
+			details::pool::Deallocate(reinterpret_cast<std::byte*>(aObject), aNumObjects * sizeof(T), alignof(T));
+		}
+	};
+}
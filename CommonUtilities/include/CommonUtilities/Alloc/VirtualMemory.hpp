@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities::details::vmem
+{
+	/// What was reserved from the system, which may be larger than what was asked for to fit the alignment.
+	///
+	struct Range
+	{
+		void*		base	{nullptr};
+		std::size_t	size	{0};
+	};
+
+	inline constexpr std::size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+	/// Reserves address space without backing it with memory, pages must be committed before use.
+	///
+	/// \param Size: Bytes to reserve, rounded up to the page size.
+	/// \param Alignment: Alignment of the returned address, a power of two.
+	/// \param Range: Receives what to pass to Release.
+	///
+	/// \returns Start of the reserved space, or nullptr if virtual memory is unavailable.
+	///
+	COMMON_UTILITIES_API NODISC std::byte* Reserve(std::size_t aSize, std::size_t aAlignment, Range& outRange);
+
+	/// Backs reserved pages with memory.
+	///
+	/// \param HugePages: Advises the system to back the pages with transparent huge pages. Only has an
+	///                   effect on Linux, as large pages on Windows cannot be committed lazily.
+	/// \param Populate: Faults in every page right away rather than on first touch, as MAP_POPULATE.
+	///
+	/// \returns False if the system is out of memory.
+	///
+	COMMON_UTILITIES_API NODISC bool Commit(std::byte* aMemory, std::size_t aSize, bool aHugePages, bool aPopulate);
+
+	/// Returns the memory behind committed pages to the system, the address space stays reserved.
+	///
+	COMMON_UTILITIES_API void Decommit(std::byte* aMemory, std::size_t aSize);
+
+	COMMON_UTILITIES_API void Release(const Range& aRange);
+
+	COMMON_UTILITIES_API NODISC std::size_t GetPageSize();
+}
@@ -3,6 +3,8 @@
 #ifdef _WIN32
 #	define COMMON_UTILITIES_SYSTEM_WIN
 #	define NOMINMAX
+#elif defined(__linux__)
+#	define COMMON_UTILITIES_SYSTEM_LINUX
 #endif
 
 #ifndef COMMON_UTILITIES_STATIC
@@ -97,6 +99,18 @@
 
 #define DEPREC [[deprecated]] // C14 support is assumed
 
+// Set to 1 to collect counters and latency histograms in ThreadPool and ThreadLoops. Changes the layout
+// of both classes, so the library and everything using it must be built with the same value.
+#ifndef COMMON_UTILITIES_THREAD_STATS
+#	define COMMON_UTILITIES_THREAD_STATS 0
+#endif
+
+// Set to 1 to collect memory statistics in the allocators, see AllocStats. Only the library itself has to
+// be built with it, although tags set from other code are ignored unless it is built with the same value.
+#ifndef COMMON_UTILITIES_ALLOC_STATS
+#	define COMMON_UTILITIES_ALLOC_STATS 0
+#endif
+
 #ifndef FULL_NAMESPACE
 	namespace CommonUtilities{}
 	namespace cu = CommonUtilities;
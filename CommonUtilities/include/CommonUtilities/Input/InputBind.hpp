@@ -1,9 +1,10 @@
 #pragma once
 
-#include <unordered_map>
 #include <variant>
 #include <stdexcept>
 
+#include <CommonUtilities/Structures/FlatHashMap.hpp>
+#include <CommonUtilities/Structures/SmallVector.hpp>
 #include <CommonUtilities/Utility/Traits.h>
 
 #include "KeyboardInput.h"
@@ -62,15 +63,15 @@ namespace CommonUtilities
 		NODISC bool IsAnyPressed() const;
 
 	private:
-		using ButtonReg = std::variant<Keyboard::Key, Mouse::Button>;
+		using ButtonReg		= std::variant<Keyboard::Key, Mouse::Button>;
+		using ButtonRegs	= SmallVector<ButtonReg, 2>;
 
-		NODISC auto At(const ButtonType& aBind) const;
-		NODISC auto At(const ButtonType& aBind);
+		NODISC auto At(const ButtonType& aBind) const -> const ButtonRegs&;
 
 		KeyboardInput* myKeyboard	{nullptr};
 		MouseInput* myMouse			{nullptr};
 
-		std::unordered_multimap<ButtonType, ButtonReg> myBinds;
+		FlatHashMap<ButtonType, ButtonRegs> myBinds;
 		bool myEnabled {true};
 	};
 
@@ -154,12 +155,12 @@ namespace CommonUtilities
 	template<typename Bind> requires (!std::same_as<Bind, Keyboard::Key> && !std::same_as<Bind, Mouse::Button>)
 	inline void InputBind<Bind>::Set(const ButtonType& aBind, Keyboard::Key aKey)
 	{
-		myBinds.insert(std::make_pair(aBind, ButtonReg{ aKey }));
+		myBinds[aBind].push_back(ButtonReg{ aKey });
 	}
 	template<typename Bind> requires (!std::same_as<Bind, Keyboard::Key> && !std::same_as<Bind, Mouse::Button>)
 	inline void InputBind<Bind>::Set(const ButtonType& aBind, Mouse::Button aButton)
 	{
-		myBinds.insert(std::make_pair(aBind, ButtonReg{ aButton }));
+		myBinds[aBind].push_back(ButtonReg{ aButton });
 	}
 
 	template<typename Bind> requires (!std::same_as<Bind, Keyboard::Key> && !std::same_as<Bind, Mouse::Button>)
@@ -171,7 +172,13 @@ namespace CommonUtilities
 			throw std::runtime_error("Bind could not be found");
 		}
 
-		myBinds.erase(it);
+		ButtonRegs& regs = it->second;
+		regs.erase(regs.begin());
+
+		if (regs.empty())
+		{
+			myBinds.erase(it);
+		}
 	}
 
 	template<typename Bind> requires (!std::same_as<Bind, Keyboard::Key> && !std::same_as<Bind, Mouse::Button>)
@@ -187,15 +194,13 @@ namespace CommonUtilities
 		if (!IsEnabled())
 			return false;
 
-		auto range = this->At(aBind);
-
-		for (auto it = range.first; it != range.second; ++it)
+		for (const ButtonReg& reg : At(aBind))
 		{
 			bool active = std::visit(tr::Overload
 			{
 				[this](Keyboard::Key aKey) { return IsKeyboardConnected() && myKeyboard->IsHeld(aKey); },
 				[this](Mouse::Button aButton) { return IsMouseConnected() && myMouse->IsHeld(aButton); }
-			}, it->second);
+			}, reg);
 
 			if (active)
 			{
@@ -212,15 +217,13 @@ namespace CommonUtilities
 		if (!IsEnabled())
 			return false;
 
-		auto range = this->At(aBind);
-
-		for (auto it = range.first; it != range.second; ++it)
+		for (const ButtonReg& reg : At(aBind))
 		{
 			bool active = std::visit(tr::Overload
 			{
 				[this](Keyboard::Key aKey) { return IsKeyboardConnected() && myKeyboard->IsPressed(aKey); },
 				[this](Mouse::Button aButton) { return IsMouseConnected() && myMouse->IsPressed(aButton); }
-			}, it->second);
+			}, reg);
 
 			if (active)
 			{
@@ -237,15 +240,13 @@ namespace CommonUtilities
 		if (!IsEnabled())
 			return false;
 
-		auto range = this->At(aBind);
-
-		for (auto it = range.first; it != range.second; ++it)
+		for (const ButtonReg& reg : At(aBind))
 		{
 			bool active = std::visit(tr::Overload
 			{
 				[this](Keyboard::Key aKey) { return IsKeyboardConnected() && myKeyboard->IsReleased(aKey); },
 				[this](Mouse::Button aButton) { return IsMouseConnected() && myMouse->IsReleased(aButton); }
-			}, it->second);
+			}, reg);
 
 			if (active)
 			{
@@ -272,27 +273,14 @@ namespace CommonUtilities
 	}
 
 	template<typename Bind> requires (!std::same_as<Bind, Keyboard::Key> && !std::same_as<Bind, Mouse::Button>)
-	inline auto InputBind<Bind>::At(const ButtonType& aBind) const
+	inline auto InputBind<Bind>::At(const ButtonType& aBind) const -> const ButtonRegs&
 	{
-		auto range = myBinds.equal_range(aBind);
-
-		if (range.first == myBinds.end() && range.second == myBinds.end())
-		{
-			throw std::runtime_error("Bind could not be found");
-		}
-
-		return range;
-	}
-	template<typename Bind> requires (!std::same_as<Bind, Keyboard::Key> && !std::same_as<Bind, Mouse::Button>)
-	inline auto InputBind<Bind>::At(const ButtonType& aBind)
-	{
-		auto range = myBinds.equal_range(aBind);
-
-		if (range.first == myBinds.end() && range.second == myBinds.end())
+		const auto it = myBinds.find(aBind);
+		if (it == myBinds.end())
 		{
 			throw std::runtime_error("Bind could not be found");
 		}
 
-		return range;
+		return it->second;
 	}
 }
\ No newline at end of file
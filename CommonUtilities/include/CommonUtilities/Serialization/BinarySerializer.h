@@ -41,19 +41,21 @@ namespace CommonUtilities
 		NODISC std::size_t operator()(SerializerState aState, const std::wstring& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset);
 	};
 
-	template<typename T>
-	struct SerializeAsBinary<std::vector<T>>
+	/// Vectors may use any allocator, e.g., FrameAlloc to read temporary data into scratch memory.
+	///
+	template<typename T, typename Alloc>
+	struct SerializeAsBinary<std::vector<T, Alloc>>
 	{
-		NODISC std::size_t operator()(SerializerState aState, std::vector<T>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
+		NODISC std::size_t operator()(SerializerState aState, std::vector<T, Alloc>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
 			requires (std::is_trivially_copyable_v<T>);
 
-		NODISC std::size_t operator()(SerializerState aState, const std::vector<T>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
+		NODISC std::size_t operator()(SerializerState aState, const std::vector<T, Alloc>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
 			requires (std::is_trivially_copyable_v<T>);
 
-		NODISC std::size_t operator()(SerializerState aState, std::vector<T>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
+		NODISC std::size_t operator()(SerializerState aState, std::vector<T, Alloc>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
 			requires (!std::is_trivially_copyable_v<T>); // user must provide their own custom specialization for this type to work
 
-		NODISC std::size_t operator()(SerializerState aState, const std::vector<T>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
+		NODISC std::size_t operator()(SerializerState aState, const std::vector<T, Alloc>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
 			requires (!std::is_trivially_copyable_v<T>);
 	};
 
@@ -163,8 +165,8 @@ namespace CommonUtilities
 		return numBytes;
 	}
 
-	template<typename T>
-	inline std::size_t SerializeAsBinary<std::vector<T>>::operator()(SerializerState aState, std::vector<T>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
+	template<typename T, typename Alloc>
+	inline std::size_t SerializeAsBinary<std::vector<T, Alloc>>::operator()(SerializerState aState, std::vector<T, Alloc>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
 		requires (std::is_trivially_copyable_v<T>)
 	{
 		static constexpr std::size_t typeSize = sizeof(T);
@@ -207,8 +209,8 @@ namespace CommonUtilities
 		return numBytes + sizeof(std::size_t);
 	}
 
-	template<typename T>
-	inline std::size_t SerializeAsBinary<std::vector<T>>::operator()(SerializerState aState, const std::vector<T>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
+	template<typename T, typename Alloc>
+	inline std::size_t SerializeAsBinary<std::vector<T, Alloc>>::operator()(SerializerState aState, const std::vector<T, Alloc>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
 		requires (std::is_trivially_copyable_v<T>)
 	{
 		static constexpr std::size_t typeSize = sizeof(T);
@@ -237,8 +239,8 @@ namespace CommonUtilities
 		return numBytes + sizeof(std::size_t);
 	}
 
-	template<typename T>
-	inline std::size_t SerializeAsBinary<std::vector<T>>::operator()(SerializerState aState, std::vector<T>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
+	template<typename T, typename Alloc>
+	inline std::size_t SerializeAsBinary<std::vector<T, Alloc>>::operator()(SerializerState aState, std::vector<T, Alloc>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
 		requires (!std::is_trivially_copyable_v<T>)
 	{
 		std::size_t numBytes = 0;
@@ -278,8 +280,8 @@ namespace CommonUtilities
 		return numBytes;
 	}
 
-	template<typename T>
-	inline std::size_t SerializeAsBinary<std::vector<T>>::operator()(SerializerState aState, const std::vector<T>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
+	template<typename T, typename Alloc>
+	inline std::size_t SerializeAsBinary<std::vector<T, Alloc>>::operator()(SerializerState aState, const std::vector<T, Alloc>& aInOutData, std::vector<std::byte>& aInOutBytes, std::size_t aOffset)
 		requires (!std::is_trivially_copyable_v<T>)
 	{
 		std::size_t numBytes = 0;
@@ -1,32 +1,40 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
 #include <memory>
+#include <memory_resource>
 #include <cassert>
 #include <shared_mutex>
 
 #include <CommonUtilities/System/IDGenerator.h>
 #include <CommonUtilities/Structures/FreeVector.hpp>
+#include <CommonUtilities/Structures/FlatHashMap.hpp>
 #include <CommonUtilities/Utility/Concepts.hpp>
-#include <CommonUtilities/Utility/Clonable.hpp>
 #include <CommonUtilities/Config.h>
 
 namespace CommonUtilities
 {
-	template<typename IDType = std::string_view, typename Hash = std::hash<IDType>> requires IsHashableType<Hash, IDType>
+	template<typename IDType = std::string_view, typename Hash = std::hash<IDType>, typename Alloc = std::allocator<std::byte>> requires IsHashableType<Hash, IDType>
 	class Blackboard
 	{
 	public:
+		using allocator_type = Alloc;
+
 		Blackboard() = default;
 		~Blackboard() = default;
 
+		/// \param Allocator: Allocator that the value maps and all values are allocated with.
+		///
+		explicit Blackboard(const Alloc& aAllocator);
+
 		Blackboard(Blackboard&& aOther);
 		Blackboard(const Blackboard& aOther);
 
 		Blackboard& operator=(Blackboard&& aOther);
 		Blackboard& operator=(const Blackboard& aOther);
 
+		NODISC allocator_type get_allocator() const noexcept;
+
 		template<typename T>
 		NODISC const T& Get(const IDType& aID) const;
 
@@ -67,25 +75,52 @@ namespace CommonUtilities
 		void Clear();
 
 	private:
+		template<typename U>
+		using Rebind = typename std::allocator_traits<Alloc>::template rebind_alloc<U>;
+
+		class ValueMapBase;
+
+		struct ValueMapDeleter
+		{
+			void operator()(ValueMapBase* aMap) const
+			{
+				aMap->Destroy();
+			}
+		};
+
+		using ValueMapPtr = std::unique_ptr<ValueMapBase, ValueMapDeleter>;
+
 		class ValueMapBase
 		{
 		public:
 			ValueMapBase() = default;
 			virtual ~ValueMapBase() = default;
 
-			NODISC virtual bool Has(const IDType& aID) = 0;
+			NODISC virtual bool Has(const IDType& aID) const = 0;
 
 			virtual void Erase(const IDType& aID) = 0;
 			virtual void Clear() = 0;
 
-			NODISC virtual std::unique_ptr<ValueMapBase> Clone() const = 0;
+			NODISC virtual ValueMapPtr Clone(const Alloc& aAllocator) const = 0;
+
+			/// Destroys and deallocates the map with the allocator it was created with.
+			///
+			virtual void Destroy() = 0;
 		};
 
+		template<typename T, typename... Args>
+		NODISC static ValueMapPtr MakeValueMap(const Alloc& aAllocator, Args&&... someArgs);
+
 		template<typename T>
-		class ValueMap final : public Clonable<ValueMapBase, ValueMap<T>>
+		class ValueMap final : public ValueMapBase
 		{
 		public:
-			ValueMap() = default;
+			explicit ValueMap(const Alloc& aAllocator)
+				: myValues(aAllocator), myIndices(aAllocator), myAllocator(aAllocator) {}
+
+			ValueMap(const ValueMap& aOther, const Alloc& aAllocator)
+				: myValues(aOther.myValues, aAllocator), myIndices(aOther.myIndices, aAllocator), myAllocator(aAllocator) {}
+
 			~ValueMap() = default;
 
 			NODISC const T& Get(const IDType& aID) const
@@ -137,7 +172,7 @@ namespace CommonUtilities
 				Emplace(aID, std::move(aValue));
 			}
 
-			NODISC bool Has(const IDType& aID) override
+			NODISC bool Has(const IDType& aID) const override
 			{
 				return myIndices.find(Hash{}(aID)) != myIndices.end();
 			}
@@ -156,11 +191,28 @@ namespace CommonUtilities
 				myIndices.clear();
 			}
 
+			NODISC ValueMapPtr Clone(const Alloc& aAllocator) const override
+			{
+				return MakeValueMap<T>(aAllocator, *this, aAllocator);
+			}
+
+			void Destroy() override
+			{
+				using MapTraits = std::allocator_traits<Rebind<ValueMap>>;
+
+				Rebind<ValueMap> alloc(myAllocator); // copied since the map owning it is destroyed first
+
+				MapTraits::destroy(alloc, this);
+				MapTraits::deallocate(alloc, this, 1);
+			}
+
 		private:
-			using IDIndicesMap = std::unordered_map<std::size_t, std::size_t>;
+			using IDIndicesMap = FlatHashMap<std::size_t, std::size_t,
+				std::hash<std::size_t>, std::equal_to<std::size_t>, Rebind<std::pair<const std::size_t, std::size_t>>>;
 
-			FreeVector<T>	myValues;
-			IDIndicesMap	myIndices;
+			FreeVector<T, Rebind<T>>	myValues;
+			IDIndicesMap				myIndices;
+			Alloc						myAllocator;
 		};
 
 		template<typename T>
@@ -169,31 +221,40 @@ namespace CommonUtilities
 		template<typename T>
 		NODISC auto FindValueMap() -> ValueMap<T>&;
 
-		using TypeValueMap = std::unordered_map<std::size_t, std::unique_ptr<ValueMapBase>>;
+		using TypeValueMap = FlatHashMap<std::size_t, ValueMapPtr,
+			std::hash<std::size_t>, std::equal_to<std::size_t>, Rebind<std::pair<const std::size_t, ValueMapPtr>>>;
 
 		TypeValueMap myData;
 		mutable std::shared_mutex myMutex;
 	};
 
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
-	inline Blackboard<IDType, Hash>::Blackboard(Blackboard&& aOther)
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
+	inline Blackboard<IDType, Hash, Alloc>::Blackboard(const Alloc& aAllocator)
+		: myData(aAllocator)
+	{
+
+	}
+
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
+	inline Blackboard<IDType, Hash, Alloc>::Blackboard(Blackboard&& aOther)
 	{
 		std::scoped_lock lock(aOther.myMutex);
 		myData = std::move(aOther.myData);
 	}
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
-	inline Blackboard<IDType, Hash>::Blackboard(const Blackboard& aOther)
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
+	inline Blackboard<IDType, Hash, Alloc>::Blackboard(const Blackboard& aOther)
+		: myData(std::allocator_traits<Alloc>::select_on_container_copy_construction(aOther.get_allocator()))
 	{
 		std::shared_lock lock(aOther.myMutex);
 
 		for (const auto& [id, map] : aOther.myData)
 		{
-			myData[id] = map->Clone();
+			myData[id] = map->Clone(get_allocator());
 		}
 	}
 
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
-	inline Blackboard<IDType, Hash>& Blackboard<IDType, Hash>::operator=(Blackboard&& aOther)
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
+	inline Blackboard<IDType, Hash, Alloc>& Blackboard<IDType, Hash, Alloc>::operator=(Blackboard&& aOther)
 	{
 		if (this == &aOther)
 			return *this;
@@ -205,8 +266,8 @@ namespace CommonUtilities
 
 		return *this;
 	}
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
-	inline Blackboard<IDType, Hash>& Blackboard<IDType, Hash>::operator=(const Blackboard& aOther)
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
+	inline Blackboard<IDType, Hash, Alloc>& Blackboard<IDType, Hash, Alloc>::operator=(const Blackboard& aOther)
 	{
 		if (this == &aOther)
 			return *this;
@@ -216,15 +277,21 @@ namespace CommonUtilities
 
 		for (const auto& [id, map] : aOther.myData)
 		{
-			myData[id] = map->Clone();
+			myData[id] = map->Clone(get_allocator());
 		}
 
 		return *this;
 	}
 
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
+	inline auto Blackboard<IDType, Hash, Alloc>::get_allocator() const noexcept -> allocator_type
+	{
+		return allocator_type(myData.get_allocator());
+	}
+
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
 	template<typename T>
-	inline const T& Blackboard<IDType, Hash>::Get(const IDType& aID) const
+	inline const T& Blackboard<IDType, Hash, Alloc>::Get(const IDType& aID) const
 	{
 		std::shared_lock lock(myMutex);
 
@@ -232,9 +299,9 @@ namespace CommonUtilities
 		return map.Get(aID);
 	}
 
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
 	template<typename T>
-	inline T& Blackboard<IDType, Hash>::Get(const IDType& aID)
+	inline T& Blackboard<IDType, Hash, Alloc>::Get(const IDType& aID)
 	{
 		std::scoped_lock lock(myMutex);
 
@@ -242,9 +309,9 @@ namespace CommonUtilities
 		return map.Get(aID);
 	}
 
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
 	template<typename T>
-	inline const T* Blackboard<IDType, Hash>::TryGet(const IDType& aID) const
+	inline const T* Blackboard<IDType, Hash, Alloc>::TryGet(const IDType& aID) const
 	{
 		std::scoped_lock lock(myMutex);
 
@@ -252,9 +319,9 @@ namespace CommonUtilities
 		return map.TryGet(aID);
 	}
 
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
 	template<typename T>
-	inline T* Blackboard<IDType, Hash>::TryGet(const IDType& aID)
+	inline T* Blackboard<IDType, Hash, Alloc>::TryGet(const IDType& aID)
 	{
 		std::scoped_lock lock(myMutex);
 
@@ -262,16 +329,16 @@ namespace CommonUtilities
 		return map.TryGet(aID);
 	}
 
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
 	template<typename T>
-	inline void Blackboard<IDType, Hash>::Set(const IDType& aID, T&& aValue)
+	inline void Blackboard<IDType, Hash, Alloc>::Set(const IDType& aID, T&& aValue)
 	{
 		Emplace<T>(aID, std::forward<T>(aValue));
 	}
 
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
 	template<typename T>
-	inline void Blackboard<IDType, Hash>::Erase(const IDType& aID)
+	inline void Blackboard<IDType, Hash, Alloc>::Erase(const IDType& aID)
 	{
 		std::scoped_lock lock(myMutex);
 
@@ -279,9 +346,9 @@ namespace CommonUtilities
 		map.Erase(aID);
 	}
 
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
 	template<typename T>
-	inline bool Blackboard<IDType, Hash>::Has(const IDType& aID) const
+	inline bool Blackboard<IDType, Hash, Alloc>::Has(const IDType& aID) const
 	{
 		std::shared_lock lock(myMutex);
 
@@ -289,9 +356,9 @@ namespace CommonUtilities
 		return map.Has(aID);
 	}
 
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
 	template<typename T>
-	inline bool Blackboard<IDType, Hash>::HasType() const
+	inline bool Blackboard<IDType, Hash, Alloc>::HasType() const
 	{
 		static constexpr std::size_t key = Type<T>::ID();
 
@@ -299,39 +366,39 @@ namespace CommonUtilities
 		return it != myData.end();
 	}
 
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
-	inline void Blackboard<IDType, Hash>::EraseKey(const IDType& aID)
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
+	inline void Blackboard<IDType, Hash, Alloc>::EraseKey(const IDType& aID)
 	{
 		std::scoped_lock lock(myMutex);
 
 		for (auto& [id, map] : myData)
 		{
-			map.Erase(aID);
+			map->Erase(aID);
 		}
 	}
 
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
-	inline void Blackboard<IDType, Hash>::Clear()
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
+	inline void Blackboard<IDType, Hash, Alloc>::Clear()
 	{
 		std::scoped_lock lock(myMutex);
 
 		for (auto& [id, map] : myData)
 		{
-			map.Clear();
+			map->Clear();
 		}
 	}
 
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
 	template<typename T>
-	inline auto Blackboard<IDType, Hash>::FindValueMap() const -> const ValueMap<T>&
+	inline auto Blackboard<IDType, Hash, Alloc>::FindValueMap() const -> const ValueMap<T>&
 	{
 		static constexpr std::size_t key = Type<T>::ID();
 		return *static_cast<ValueMap<T>*>(myData.at(key).get());
 	}
 
-	template<typename IDType, typename Hash> requires IsHashableType<Hash, IDType>
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
 	template<typename T>
-	inline auto Blackboard<IDType, Hash>::FindValueMap() -> ValueMap<T>&
+	inline auto Blackboard<IDType, Hash, Alloc>::FindValueMap() -> ValueMap<T>&
 	{
 		static constexpr std::size_t key = Type<T>::ID();
 
@@ -340,9 +407,37 @@ namespace CommonUtilities
 			return *static_cast<ValueMap<T>*>(it->second.get());
 		}
 
-		UNSD auto insert = myData.try_emplace(key, std::make_unique<ValueMap<T>>());
+		UNSD auto insert = myData.try_emplace(key, MakeValueMap<T>(get_allocator(), get_allocator()));
 		assert(insert.second);
 
 		return *static_cast<ValueMap<T>*>(insert.first->second.get());
 	}
+
+	template<typename IDType, typename Hash, typename Alloc> requires IsHashableType<Hash, IDType>
+	template<typename T, typename... Args>
+	inline auto Blackboard<IDType, Hash, Alloc>::MakeValueMap(const Alloc& aAllocator, Args&&... someArgs) -> ValueMapPtr
+	{
+		using MapTraits = std::allocator_traits<Rebind<ValueMap<T>>>;
+
+		Rebind<ValueMap<T>> alloc(aAllocator);
+		ValueMap<T>* map = MapTraits::allocate(alloc, 1);
+
+		try
+		{
+			MapTraits::construct(alloc, map, std::forward<Args>(someArgs)...);
+		}
+		catch (...)
+		{
+			MapTraits::deallocate(alloc, map, 1);
+			throw;
+		}
+
+		return ValueMapPtr(map);
+	}
+
+	namespace pmr
+	{
+		template<typename IDType = std::string_view, typename Hash = std::hash<IDType>>
+		using Blackboard = CommonUtilities::Blackboard<IDType, Hash, std::pmr::polymorphic_allocator<std::byte>>;
+	}
 }
\ No newline at end of file
@@ -0,0 +1,486 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <tuple>
+#include <span>
+#include <utility>
+#include <concepts>
+#include <type_traits>
+#include <cstdint>
+#include <cassert>
+
+#include <CommonUtilities/Structures/SparseSet.hpp>
+#include <CommonUtilities/System/IDGenerator.h>
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+	namespace details::ecs
+	{
+		struct ComponentTypes; // numbers component types separately from other generators
+
+		/// \returns Index of the component type, starting from zero in order of first use.
+		///
+		template<typename T>
+		NODISC std::size_t ComponentIndex()
+		{
+			static const std::size_t index = Generator<ComponentTypes>::Next() - 1;
+			return index;
+		}
+	}
+
+	/// Stores components of any type per entity, where each component type has its own sparse set of
+	/// entities and a packed array of components in the same order. Adding, removing, and finding a
+	/// component is O(1) and goes through an array indexed by type instead of a hash map, and views over
+	/// several component types iterate the smallest set while looking up the rest.
+	///
+	/// Entities are plain IDs managed by the user and should be reasonably dense, since the sparse arrays
+	/// grow to the largest ID (in pages allocated on first use). Component types are numbered on first use
+	/// through Generator, which should not happen for different types on several threads at once.
+	///
+	template<std::unsigned_integral Entity = std::uint32_t>
+	class ComponentRegistry
+	{
+	public:
+		using entity_type	= Entity;
+		using size_type		= std::size_t;
+		using EntitySet		= SparseSet<Entity>;
+
+		template<typename... Ts>
+		class View;
+
+		ComponentRegistry() = default;
+		~ComponentRegistry() = default;
+
+		ComponentRegistry(const ComponentRegistry&) = delete;
+		ComponentRegistry(ComponentRegistry&&) noexcept = default;
+
+		auto operator=(const ComponentRegistry&) -> ComponentRegistry& = delete;
+		auto operator=(ComponentRegistry&&) noexcept -> ComponentRegistry& = default;
+
+		/// \param Entity: Entity with the component.
+		///
+		/// \returns Reference to the component, entity must have it.
+		///
+		template<typename T>
+		NODISC auto Get(Entity aEntity) -> T&;
+
+		template<typename T>
+		NODISC auto Get(Entity aEntity) const -> const T&;
+
+		/// \returns Pointer to the component, or nullptr if the entity does not have it.
+		///
+		template<typename T>
+		NODISC auto TryGet(Entity aEntity) -> T*;
+
+		template<typename T>
+		NODISC auto TryGet(Entity aEntity) const -> const T*;
+
+		/// Constructs the component for the entity, or replaces it if it already has one.
+		///
+		/// \returns Reference to the component.
+		///
+		template<typename T, typename... Args>
+		auto Emplace(Entity aEntity, Args&&... someArgs) -> T&;
+
+		/// \returns Whether the entity has the component.
+		///
+		template<typename T>
+		NODISC bool Has(Entity aEntity) const;
+
+		/// Removes the component, moving the last component of its type into its place.
+		///
+		/// \returns Whether the entity had the component.
+		///
+		template<typename T>
+		bool Erase(Entity aEntity);
+
+		/// Removes every component of the entity.
+		///
+		void EraseEntity(Entity aEntity);
+
+		/// Removes every component of the type.
+		///
+		template<typename T>
+		void Clear();
+
+		/// Removes every component.
+		///
+		void Clear();
+
+		/// Reserve to reduce reallocation of the component type's packed arrays.
+		///
+		template<typename T>
+		void Reserve(size_type aCapacity);
+
+		/// \returns Number of entities with the component.
+		///
+		template<typename T>
+		NODISC auto Size() const -> size_type;
+
+		/// \returns Entities with the component, in the same order as Components.
+		///
+		template<typename T>
+		NODISC auto Entities() const -> const EntitySet&;
+
+		/// \returns Packed components of the type, in the same order as Entities.
+		///
+		template<typename T>
+		NODISC auto Components() -> std::span<T>;
+
+		template<typename T>
+		NODISC auto Components() const -> std::span<const T>;
+
+		/// \returns View over the entities that have all of the components, a const type gives read-only access.
+		///
+		template<typename... Ts> requires (sizeof...(Ts) > 0)
+		NODISC auto GetView() -> View<Ts...>;
+
+		template<typename... Ts> requires (sizeof...(Ts) > 0)
+		NODISC auto GetView() const -> View<const std::remove_const_t<Ts>...>;
+
+	private:
+		class PoolBase
+		{
+		public:
+			virtual ~PoolBase() = default;
+
+			virtual void Erase(Entity aEntity) = 0;
+			virtual void Clear() = 0;
+
+			EntitySet entities;
+		};
+
+		template<typename T>
+		class Pool final : public PoolBase
+		{
+		public:
+			NODISC T& Get(Entity aEntity) { return components[this->entities.index(aEntity)]; }
+			NODISC const T& Get(Entity aEntity) const { return components[this->entities.index(aEntity)]; }
+
+			void Erase(Entity aEntity) override
+			{
+				const size_type index = this->entities.index(aEntity);
+
+				if (index != components.size() - 1)
+					components[index] = std::move(components.back());
+
+				components.pop_back();
+				this->entities.erase(aEntity);
+			}
+
+			void Clear() override
+			{
+				components.clear();
+				this->entities.clear();
+			}
+
+			std::vector<T> components;
+		};
+
+		template<typename T>
+		using PoolOf = std::conditional_t<std::is_const_v<T>, const Pool<std::remove_const_t<T>>, Pool<T>>;
+
+		template<typename T>
+		NODISC auto FindPool() const -> Pool<T>*;
+
+		template<typename T>
+		NODISC auto AssurePool() -> Pool<T>&;
+
+		std::vector<std::unique_ptr<PoolBase>> myPools; // indexed by component type
+	};
+
+	/// Entities that have all of the components. The entities of the smallest set are visited and checked
+	/// against the others, so the cost follows the rarest component rather than the most common.
+	///
+	template<std::unsigned_integral Entity>
+	template<typename... Ts>
+	class ComponentRegistry<Entity>::View
+	{
+	public:
+		/// Calls func with the entity and a reference to each of its components. Func may erase components of
+		/// the current entity, since iteration goes from the back, but not of other entities.
+		///
+		template<typename Func> requires std::invocable<Func&, Entity, Ts&...>
+		void Each(Func&& aFunc) const;
+
+		/// \returns Whether the entity has all of the components.
+		///
+		NODISC bool Contains(Entity aEntity) const;
+
+		/// \returns Number of entities in the smallest set, an upper bound of how many are visited.
+		///
+		NODISC auto SizeHint() const noexcept -> size_type;
+
+	private:
+		explicit View(PoolOf<Ts>*... somePools);
+
+		template<std::size_t... Is>
+		NODISC bool ContainsImpl(Entity aEntity, std::index_sequence<Is...>) const;
+
+		template<typename Func, std::size_t... Is>
+		void EachImpl(Func& aFunc, std::index_sequence<Is...>) const;
+
+		std::tuple<PoolOf<Ts>*...>	myPools;
+		const EntitySet*			mySmallest {nullptr}; // nullptr if any type has no pool yet
+
+		friend class ComponentRegistry;
+	};
+
+	template<std::unsigned_integral Entity>
+	template<typename T>
+	auto ComponentRegistry<Entity>::Get(Entity aEntity) -> T&
+	{
+		return const_cast<T&>(std::as_const(*this).template Get<T>(aEntity));
+	}
+	template<std::unsigned_integral Entity>
+	template<typename T>
+	auto ComponentRegistry<Entity>::Get(Entity aEntity) const -> const T&
+	{
+		const Pool<T>* pool = FindPool<T>();
+		assert(pool != nullptr && pool->entities.contains(aEntity) && "Entity does not have the component");
+
+		return pool->Get(aEntity);
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename T>
+	auto ComponentRegistry<Entity>::TryGet(Entity aEntity) -> T*
+	{
+		return const_cast<T*>(std::as_const(*this).template TryGet<T>(aEntity));
+	}
+	template<std::unsigned_integral Entity>
+	template<typename T>
+	auto ComponentRegistry<Entity>::TryGet(Entity aEntity) const -> const T*
+	{
+		const Pool<T>* pool = FindPool<T>();
+		if (pool == nullptr || !pool->entities.contains(aEntity))
+			return nullptr;
+
+		return &pool->Get(aEntity);
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename T, typename... Args>
+	auto ComponentRegistry<Entity>::Emplace(Entity aEntity, Args&&... someArgs) -> T&
+	{
+		Pool<T>& pool = AssurePool<T>();
+
+		if (pool.entities.contains(aEntity))
+		{
+			T& component = pool.Get(aEntity);
+			component = T(std::forward<Args>(someArgs)...); // same initialization as emplace_back below
+
+			return component;
+		}
+
+		T& component = pool.components.emplace_back(std::forward<Args>(someArgs)...);
+
+		try
+		{
+			pool.entities.insert(aEntity);
+		}
+		catch (...)
+		{
+			pool.components.pop_back();
+			throw;
+		}
+
+		return component;
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename T>
+	bool ComponentRegistry<Entity>::Has(Entity aEntity) const
+	{
+		const Pool<T>* pool = FindPool<T>();
+		return pool != nullptr && pool->entities.contains(aEntity);
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename T>
+	bool ComponentRegistry<Entity>::Erase(Entity aEntity)
+	{
+		Pool<T>* pool = FindPool<T>();
+		if (pool == nullptr || !pool->entities.contains(aEntity))
+			return false;
+
+		pool->Erase(aEntity);
+
+		return true;
+	}
+
+	template<std::unsigned_integral Entity>
+	void ComponentRegistry<Entity>::EraseEntity(Entity aEntity)
+	{
+		for (const auto& pool : myPools)
+		{
+			if (pool && pool->entities.contains(aEntity))
+				pool->Erase(aEntity);
+		}
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename T>
+	void ComponentRegistry<Entity>::Clear()
+	{
+		if (Pool<T>* pool = FindPool<T>())
+			pool->Clear();
+	}
+
+	template<std::unsigned_integral Entity>
+	void ComponentRegistry<Entity>::Clear()
+	{
+		for (const auto& pool : myPools)
+		{
+			if (pool)
+				pool->Clear();
+		}
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename T>
+	void ComponentRegistry<Entity>::Reserve(size_type aCapacity)
+	{
+		Pool<T>& pool = AssurePool<T>();
+
+		pool.components.reserve(aCapacity);
+		pool.entities.reserve(aCapacity);
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename T>
+	auto ComponentRegistry<Entity>::Size() const -> size_type
+	{
+		const Pool<T>* pool = FindPool<T>();
+		return pool != nullptr ? pool->entities.size() : 0;
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename T>
+	auto ComponentRegistry<Entity>::Entities() const -> const EntitySet&
+	{
+		static const EntitySet empty;
+
+		const Pool<T>* pool = FindPool<T>();
+		return pool != nullptr ? pool->entities : empty;
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename T>
+	auto ComponentRegistry<Entity>::Components() -> std::span<T>
+	{
+		Pool<T>* pool = FindPool<T>();
+		return pool != nullptr ? std::span<T>(pool->components) : std::span<T>();
+	}
+	template<std::unsigned_integral Entity>
+	template<typename T>
+	auto ComponentRegistry<Entity>::Components() const -> std::span<const T>
+	{
+		const Pool<T>* pool = FindPool<T>();
+		return pool != nullptr ? std::span<const T>(pool->components) : std::span<const T>();
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename... Ts> requires (sizeof...(Ts) > 0)
+	auto ComponentRegistry<Entity>::GetView() -> View<Ts...>
+	{
+		return View<Ts...>(FindPool<std::remove_const_t<Ts>>()...);
+	}
+	template<std::unsigned_integral Entity>
+	template<typename... Ts> requires (sizeof...(Ts) > 0)
+	auto ComponentRegistry<Entity>::GetView() const -> View<const std::remove_const_t<Ts>...>
+	{
+		return View<const std::remove_const_t<Ts>...>(FindPool<std::remove_const_t<Ts>>()...);
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename T>
+	auto ComponentRegistry<Entity>::FindPool() const -> Pool<T>*
+	{
+		static_assert(!std::is_const_v<T> && !std::is_reference_v<T>, "Component type should not be const or a reference");
+
+		const std::size_t index = details::ecs::ComponentIndex<T>();
+		return index < myPools.size() ? static_cast<Pool<T>*>(myPools[index].get()) : nullptr;
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename T>
+	auto ComponentRegistry<Entity>::AssurePool() -> Pool<T>&
+	{
+		const std::size_t index = details::ecs::ComponentIndex<T>();
+
+		if (index >= myPools.size())
+			myPools.resize(index + 1);
+
+		if (!myPools[index])
+			myPools[index] = std::make_unique<Pool<T>>();
+
+		return static_cast<Pool<T>&>(*myPools[index]);
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename... Ts>
+	ComponentRegistry<Entity>::View<Ts...>::View(PoolOf<Ts>*... somePools)
+		: myPools(somePools...)
+	{
+		if (((somePools == nullptr) || ...))
+			return;
+
+		for (const PoolBase* pool : { static_cast<const PoolBase*>(somePools)... })
+		{
+			if (mySmallest == nullptr || pool->entities.size() < mySmallest->size())
+				mySmallest = &pool->entities;
+		}
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename... Ts>
+	template<typename Func> requires std::invocable<Func&, Entity, Ts&...>
+	void ComponentRegistry<Entity>::View<Ts...>::Each(Func&& aFunc) const
+	{
+		EachImpl(aFunc, std::index_sequence_for<Ts...>{});
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename... Ts>
+	bool ComponentRegistry<Entity>::View<Ts...>::Contains(Entity aEntity) const
+	{
+		return mySmallest != nullptr && ContainsImpl(aEntity, std::index_sequence_for<Ts...>{});
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename... Ts>
+	auto ComponentRegistry<Entity>::View<Ts...>::SizeHint() const noexcept -> size_type
+	{
+		return mySmallest != nullptr ? mySmallest->size() : 0;
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename... Ts>
+	template<std::size_t... Is>
+	bool ComponentRegistry<Entity>::View<Ts...>::ContainsImpl(Entity aEntity, std::index_sequence<Is...>) const
+	{
+		return (std::get<Is>(myPools)->entities.contains(aEntity) && ...);
+	}
+
+	template<std::unsigned_integral Entity>
+	template<typename... Ts>
+	template<typename Func, std::size_t... Is>
+	void ComponentRegistry<Entity>::View<Ts...>::EachImpl(Func& aFunc, std::index_sequence<Is...>) const
+	{
+		if (mySmallest == nullptr)
+			return;
+
+		const EntitySet& entities = *mySmallest;
+
+		for (size_type i = entities.size(); i-- > 0;)
+		{
+			const Entity entity = entities.data()[i];
+
+			if (ContainsImpl(entity, std::index_sequence<Is...>{}))
+				aFunc(entity, std::get<Is>(myPools)->Get(entity)...);
+		}
+	}
+}
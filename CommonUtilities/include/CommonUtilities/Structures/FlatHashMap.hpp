@@ -0,0 +1,1311 @@
+#pragma once
+
+#include <memory>
+#include <memory_resource>
+#include <functional>
+#include <utility>
+#include <iterator>
+#include <initializer_list>
+#include <algorithm>
+#include <stdexcept>
+#include <limits>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#	include <emmintrin.h>
+#	define COMMON_UTILITIES_FLAT_HASH_SSE2
+#endif
+
+#include <CommonUtilities/Utility/Relocation.hpp>
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+	namespace details::flat
+	{
+		using ctrl_t = std::int8_t;
+
+		// full slots store the lower 7 bits of their hash, so everything else has the top bit set
+
+		inline constexpr ctrl_t EMPTY		= -128;	// 0b10000000
+		inline constexpr ctrl_t DELETED		= -2;	// 0b11111110
+		inline constexpr ctrl_t SENTINEL	= -1;	// 0b11111111, marks the end for iterators
+
+		/// Control bytes of a table without slots, so that lookups in it need no special case.
+		///
+		alignas(16) inline constexpr ctrl_t EMPTY_GROUP[16] =
+		{
+			SENTINEL, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+			EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY
+		};
+
+		/// Spreads the bits of a hash, since std::hash of integers is often the identity and both the
+		/// lower bits (tag) and upper bits (position) have to vary.
+		///
+		NODISC constexpr std::size_t Mix(std::size_t aHash) noexcept
+		{
+			if constexpr (sizeof(std::size_t) == 8)
+			{
+				aHash ^= aHash >> 33;
+				aHash *= 0xff51afd7ed558ccdull;
+				aHash ^= aHash >> 33;
+			}
+			else
+			{
+				aHash ^= aHash >> 16;
+				aHash *= 0x45d9f3bu;
+				aHash ^= aHash >> 16;
+			}
+
+			return aHash;
+		}
+
+		NODISC constexpr std::size_t H1(std::size_t aHash) noexcept
+		{
+			return aHash >> 7;
+		}
+		NODISC constexpr ctrl_t H2(std::size_t aHash) noexcept
+		{
+			return static_cast<ctrl_t>(aHash & 0x7F);
+		}
+
+		NODISC constexpr bool IsFull(ctrl_t aCtrl) noexcept
+		{
+			return aCtrl >= 0;
+		}
+
+#if defined(COMMON_UTILITIES_FLAT_HASH_SSE2)
+		/// Control bytes of 16 consecutive slots, compared all at once. Masks have one bit per slot.
+		///
+		class Group
+		{
+		public:
+			using mask_type = std::uint32_t;
+
+			static constexpr std::size_t	WIDTH = 16;
+			static constexpr int			SHIFT = 0;
+
+			explicit Group(const ctrl_t* aCtrl) noexcept
+				: myCtrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(aCtrl))) {}
+
+			NODISC mask_type Match(ctrl_t aH2) const noexcept
+			{
+				return static_cast<mask_type>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(aH2), myCtrl)));
+			}
+			NODISC mask_type MatchEmpty() const noexcept
+			{
+				return Match(EMPTY);
+			}
+			NODISC mask_type MatchEmptyOrDeleted() const noexcept
+			{
+				return static_cast<mask_type>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(SENTINEL), myCtrl)));
+			}
+
+			NODISC static int LeadingZeros(mask_type aMask) noexcept
+			{
+				return std::countl_zero(aMask) - static_cast<int>(32 - WIDTH);
+			}
+
+		private:
+			__m128i myCtrl;
+		};
+#else
+		/// Control bytes of 8 consecutive slots, compared at once within a 64-bit word. Masks have the top
+		/// bit of each slot's byte set.
+		///
+		class Group
+		{
+		public:
+			using mask_type = std::uint64_t;
+
+			static constexpr std::size_t	WIDTH = 8;
+			static constexpr int			SHIFT = 3;
+
+			explicit Group(const ctrl_t* aCtrl) noexcept
+			{
+				std::memcpy(&myCtrl, aCtrl, sizeof(myCtrl));
+			}
+
+			NODISC mask_type Match(ctrl_t aH2) const noexcept
+			{
+				// may report a false match next to a real one, which is fine as keys are compared afterwards
+				const mask_type x = myCtrl ^ (LSBS * static_cast<std::uint8_t>(aH2));
+				return (x - LSBS) & ~x & MSBS;
+			}
+			NODISC mask_type MatchEmpty() const noexcept
+			{
+				return (myCtrl & ~(myCtrl << 6)) & MSBS;
+			}
+			NODISC mask_type MatchEmptyOrDeleted() const noexcept
+			{
+				return (myCtrl & ~(myCtrl << 7)) & MSBS;
+			}
+
+			NODISC static int LeadingZeros(mask_type aMask) noexcept
+			{
+				return std::countl_zero(aMask) >> SHIFT;
+			}
+
+		private:
+			static constexpr mask_type LSBS = 0x0101010101010101ull;
+			static constexpr mask_type MSBS = 0x8080808080808080ull;
+
+			mask_type myCtrl {0};
+		};
+#endif
+
+		NODISC inline std::size_t LowestIndex(Group::mask_type aMask) noexcept
+		{
+			return static_cast<std::size_t>(std::countr_zero(aMask)) >> Group::SHIFT;
+		}
+
+		template<class Hash, class KeyEqual>
+		concept IsTransparent = requires
+		{
+			typename Hash::is_transparent;
+			typename KeyEqual::is_transparent;
+		};
+
+		template<class K, class V>
+		struct MapPolicy
+		{
+			using key_type		= K;
+			using value_type	= std::pair<const K, V>;
+
+			static constexpr bool CONST_ITERATOR = false;
+
+			NODISC static const K& Key(const value_type& aValue) noexcept
+			{
+				return aValue.first;
+			}
+		};
+
+		template<class K>
+		struct SetPolicy
+		{
+			using key_type		= K;
+			using value_type	= K;
+
+			static constexpr bool CONST_ITERATOR = true;
+
+			NODISC static const K& Key(const value_type& aValue) noexcept
+			{
+				return aValue;
+			}
+		};
+	}
+
+	template<typename T>
+	class FlatHashIterator
+	{
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using difference_type	= std::ptrdiff_t;
+		using value_type		= std::remove_const_t<T>;
+		using pointer			= T*;
+		using reference			= T&;
+
+		FlatHashIterator() noexcept = default;
+
+		FlatHashIterator(const details::flat::ctrl_t* aCtrl, pointer aSlot) noexcept
+			: myCtrl(aCtrl), mySlot(aSlot)
+		{
+			SkipFree();
+		}
+
+		template<typename U> requires (std::is_const_v<T> && std::is_same_v<U, value_type>) // non-const to const
+		FlatHashIterator(const FlatHashIterator<U>& aOther) noexcept
+			: myCtrl(aOther.myCtrl), mySlot(aOther.mySlot) {}
+
+		reference operator*() const noexcept	{ return *mySlot; }
+		pointer operator->() const noexcept		{ return mySlot; }
+
+		FlatHashIterator& operator++() noexcept
+		{
+			++myCtrl;
+			++mySlot;
+
+			SkipFree();
+
+			return *this;
+		}
+
+		FlatHashIterator operator++(int) noexcept { FlatHashIterator temp = *this; ++(*this); return temp; }
+
+		template<typename U>
+		NODISC bool operator==(const FlatHashIterator<U>& aOther) const noexcept { return myCtrl == aOther.myCtrl; }
+
+	private:
+		void SkipFree() noexcept
+		{
+			while (*myCtrl < details::flat::SENTINEL)
+			{
+				++myCtrl;
+				++mySlot;
+			}
+		}
+
+		const details::flat::ctrl_t*	myCtrl	{details::flat::EMPTY_GROUP};
+		pointer							mySlot	{nullptr};
+
+		template<typename U>
+		friend class FlatHashIterator;
+	};
+
+	namespace details::flat
+	{
+		/// Open-addressing hash table where slots are grouped by 16 control bytes that hold a 7-bit tag of
+		/// each slot's hash, letting a lookup compare a whole group with one SIMD instruction before looking
+		/// at any keys. Used through FlatHashMap and FlatHashSet.
+		///
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		class Table
+		{
+		public:
+			using key_type			= typename Policy::key_type;
+			using value_type		= typename Policy::value_type;
+			using size_type			= std::size_t;
+			using difference_type	= std::ptrdiff_t;
+			using hasher			= Hash;
+			using key_equal			= KeyEqual;
+			using allocator_type	= Alloc;
+			using reference			= value_type&;
+			using const_reference	= const value_type&;
+			using pointer			= value_type*;
+			using const_pointer		= const value_type*;
+
+			using const_iterator	= FlatHashIterator<const value_type>;
+			using iterator			= std::conditional_t<Policy::CONST_ITERATOR, const_iterator, FlatHashIterator<value_type>>;
+
+			Table() = default;
+			~Table();
+
+			explicit Table(size_type aCapacity, const Hash& aHash = Hash(), const KeyEqual& aEqual = KeyEqual(), const Alloc& aAllocator = Alloc());
+			explicit Table(const Alloc& aAllocator);
+
+			Table(const Table& aOther);
+			Table(Table&& aOther) noexcept;
+
+			Table(const Table& aOther, const Alloc& aAllocator);
+			Table(Table&& aOther, const Alloc& aAllocator);
+
+			auto operator=(const Table& aOther) -> Table&;
+			auto operator=(Table&& aOther) noexcept(
+				std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+				std::allocator_traits<Alloc>::is_always_equal::value) -> Table&;
+
+			NODISC auto get_allocator() const noexcept -> allocator_type;
+			NODISC auto hash_function() const -> hasher;
+			NODISC auto key_eq() const -> key_equal;
+
+			NODISC auto begin() noexcept -> iterator;
+			NODISC auto end() noexcept -> iterator;
+			NODISC auto begin() const noexcept -> const_iterator;
+			NODISC auto end() const noexcept -> const_iterator;
+			NODISC auto cbegin() const noexcept -> const_iterator;
+			NODISC auto cend() const noexcept -> const_iterator;
+
+			NODISC bool empty() const noexcept;
+			NODISC auto size() const noexcept -> size_type;
+			NODISC auto capacity() const noexcept -> size_type;
+			NODISC auto max_size() const noexcept -> size_type;
+
+			NODISC auto find(const key_type& aKey) -> iterator;
+			NODISC auto find(const key_type& aKey) const -> const_iterator;
+
+			template<class K> requires IsTransparent<Hash, KeyEqual>
+			NODISC auto find(const K& aKey) -> iterator;
+			template<class K> requires IsTransparent<Hash, KeyEqual>
+			NODISC auto find(const K& aKey) const -> const_iterator;
+
+			NODISC bool contains(const key_type& aKey) const;
+			template<class K> requires IsTransparent<Hash, KeyEqual>
+			NODISC bool contains(const K& aKey) const;
+
+			NODISC auto count(const key_type& aKey) const -> size_type;
+			template<class K> requires IsTransparent<Hash, KeyEqual>
+			NODISC auto count(const K& aKey) const -> size_type;
+
+			auto insert(const value_type& aValue) -> std::pair<iterator, bool>;
+			auto insert(value_type&& aValue) -> std::pair<iterator, bool>;
+
+			template<std::input_iterator Iter>
+			void insert(Iter aFirst, Iter aLast);
+			void insert(std::initializer_list<value_type> aInitList);
+
+			/// Constructs the value first to find its key, prefer try_emplace for maps to avoid constructing
+			/// values whose key already exists.
+			///
+			template<typename... Args> requires std::constructible_from<typename Policy::value_type, Args...>
+			auto emplace(Args&&... someArgs) -> std::pair<iterator, bool>;
+
+			auto erase(const_iterator aPosition) -> iterator;
+			auto erase(iterator aPosition) -> iterator requires (!std::is_same_v<iterator, const_iterator>);
+			auto erase(const key_type& aKey) -> size_type;
+			template<class K> requires IsTransparent<Hash, KeyEqual>
+			auto erase(const K& aKey) -> size_type;
+
+			void clear() noexcept;
+
+			/// Makes room for Count elements without rehashing.
+			///
+			void reserve(size_type aCount);
+
+			/// Rebuilds the table with room for at least Count elements, also dropping erased slots.
+			///
+			void rehash(size_type aCount);
+
+			void swap(Table& aOther) noexcept;
+
+		protected:
+			using alloc_traits	= std::allocator_traits<Alloc>;
+			using ctrl_alloc	= typename alloc_traits::template rebind_alloc<ctrl_t>;
+			using ctrl_traits	= std::allocator_traits<ctrl_alloc>;
+
+			/// \returns Index of the slot with an equal key, or capacity if there is none.
+			///
+			template<class K>
+			NODISC auto FindIndex(const K& aKey, std::size_t aHash) const -> size_type;
+
+			/// \returns Index of the slot with an equal key and false, or a prepared free slot to construct the
+			/// value in and true.
+			///
+			template<class K>
+			auto FindOrPrepareInsert(const K& aKey) -> std::pair<size_type, bool>;
+
+			/// Claims a free slot for the hash, growing the table if needed.
+			///
+			NODISC auto PrepareInsert(std::size_t aHash) -> size_type;
+
+			/// Constructs a value in a slot returned by PrepareInsert, freeing the slot again if it throws.
+			///
+			template<typename... Args>
+			void ConstructAt(size_type aIndex, Args&&... someArgs);
+
+			NODISC auto HashOf(const auto& aKey) const -> std::size_t;
+
+			NODISC auto IteratorAt(size_type aIndex) noexcept -> iterator;
+			NODISC auto IteratorAt(size_type aIndex) const noexcept -> const_iterator;
+
+		private:
+			NODISC static constexpr auto MaxLoad(size_type aCapacity) noexcept -> size_type;
+			NODISC static constexpr auto CapacityFor(size_type aCount) noexcept -> size_type;
+
+			NODISC auto FindFirstNonFull(std::size_t aHash) const noexcept -> size_type;
+
+			void SetCtrl(size_type aIndex, ctrl_t aValue) noexcept;
+			void EraseAt(size_type aIndex) noexcept;
+
+			void Grow();
+			void Resize(size_type aCapacity);
+
+			template<class Other>
+			void Assign(Other&& aOther);
+
+			void Destroy() noexcept;
+			void Steal(Table& aOther) noexcept;
+
+			ctrl_t*				myCtrl		{const_cast<ctrl_t*>(EMPTY_GROUP)};
+			value_type*			mySlots		{nullptr};
+			size_type			mySize		{0};
+			size_type			myCapacity	{0};	// one less than a power of two, or zero before the first insertion
+			size_type			myGrowthLeft{0};	// free slots that may still be used before growing
+			NOADDRESS Hash		myHash;
+			NOADDRESS KeyEqual	myEqual;
+			NOADDRESS Alloc		myAllocator;
+		};
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		Table<Policy, Hash, KeyEqual, Alloc>::~Table()
+		{
+			Destroy();
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		Table<Policy, Hash, KeyEqual, Alloc>::Table(size_type aCapacity, const Hash& aHash, const KeyEqual& aEqual, const Alloc& aAllocator)
+			: myHash(aHash), myEqual(aEqual), myAllocator(aAllocator)
+		{
+			reserve(aCapacity);
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		Table<Policy, Hash, KeyEqual, Alloc>::Table(const Alloc& aAllocator)
+			: myAllocator(aAllocator)
+		{
+
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		Table<Policy, Hash, KeyEqual, Alloc>::Table(const Table& aOther)
+			: Table(aOther, alloc_traits::select_on_container_copy_construction(aOther.myAllocator))
+		{
+
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		Table<Policy, Hash, KeyEqual, Alloc>::Table(Table&& aOther) noexcept
+			: myHash(aOther.myHash), myEqual(aOther.myEqual), myAllocator(std::move(aOther.myAllocator))
+		{
+			Steal(aOther);
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		Table<Policy, Hash, KeyEqual, Alloc>::Table(const Table& aOther, const Alloc& aAllocator)
+			: myHash(aOther.myHash), myEqual(aOther.myEqual), myAllocator(aAllocator)
+		{
+			Assign(aOther);
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		Table<Policy, Hash, KeyEqual, Alloc>::Table(Table&& aOther, const Alloc& aAllocator)
+			: myHash(aOther.myHash), myEqual(aOther.myEqual), myAllocator(aAllocator)
+		{
+			if (myAllocator == aOther.myAllocator)
+				Steal(aOther);
+			else
+			{
+				Assign(std::move(aOther));
+				aOther.clear();
+			}
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::operator=(const Table& aOther) -> Table&
+		{
+			if (this != &aOther)
+			{
+				Destroy();
+
+				if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+				{
+					myAllocator = aOther.myAllocator;
+				}
+
+				myHash	= aOther.myHash;
+				myEqual = aOther.myEqual;
+
+				Assign(aOther);
+			}
+
+			return *this;
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::operator=(Table&& aOther) noexcept(
+			std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+			std::allocator_traits<Alloc>::is_always_equal::value) -> Table&
+		{
+			if (this != &aOther)
+			{
+				Destroy();
+
+				if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+				{
+					myAllocator = std::move(aOther.myAllocator);
+				}
+
+				myHash	= aOther.myHash;
+				myEqual = aOther.myEqual;
+
+				if (myAllocator == aOther.myAllocator)
+					Steal(aOther);
+				else
+				{
+					Assign(std::move(aOther));
+					aOther.clear();
+				}
+			}
+
+			return *this;
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::get_allocator() const noexcept -> allocator_type
+		{
+			return myAllocator;
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::hash_function() const -> hasher
+		{
+			return myHash;
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::key_eq() const -> key_equal
+		{
+			return myEqual;
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::begin() noexcept -> iterator
+		{
+			return iterator(myCtrl, mySlots);
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::end() noexcept -> iterator
+		{
+			return iterator(myCtrl + myCapacity, mySlots + myCapacity);
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::begin() const noexcept -> const_iterator
+		{
+			return const_iterator(myCtrl, mySlots);
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::end() const noexcept -> const_iterator
+		{
+			return const_iterator(myCtrl + myCapacity, mySlots + myCapacity);
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::cbegin() const noexcept -> const_iterator
+		{
+			return begin();
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::cend() const noexcept -> const_iterator
+		{
+			return end();
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		bool Table<Policy, Hash, KeyEqual, Alloc>::empty() const noexcept
+		{
+			return mySize == 0;
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::size() const noexcept -> size_type
+		{
+			return mySize;
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::capacity() const noexcept -> size_type
+		{
+			return myCapacity;
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::max_size() const noexcept -> size_type
+		{
+			return MaxLoad((std::numeric_limits<size_type>::max)() / (sizeof(value_type) + 1) / 2);
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::find(const key_type& aKey) -> iterator
+		{
+			return IteratorAt(FindIndex(aKey, HashOf(aKey)));
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::find(const key_type& aKey) const -> const_iterator
+		{
+			return IteratorAt(FindIndex(aKey, HashOf(aKey)));
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		template<class K> requires IsTransparent<Hash, KeyEqual>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::find(const K& aKey) -> iterator
+		{
+			return IteratorAt(FindIndex(aKey, HashOf(aKey)));
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		template<class K> requires IsTransparent<Hash, KeyEqual>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::find(const K& aKey) const -> const_iterator
+		{
+			return IteratorAt(FindIndex(aKey, HashOf(aKey)));
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		bool Table<Policy, Hash, KeyEqual, Alloc>::contains(const key_type& aKey) const
+		{
+			return FindIndex(aKey, HashOf(aKey)) != myCapacity;
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		template<class K> requires IsTransparent<Hash, KeyEqual>
+		bool Table<Policy, Hash, KeyEqual, Alloc>::contains(const K& aKey) const
+		{
+			return FindIndex(aKey, HashOf(aKey)) != myCapacity;
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::count(const key_type& aKey) const -> size_type
+		{
+			return contains(aKey) ? 1 : 0;
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		template<class K> requires IsTransparent<Hash, KeyEqual>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::count(const K& aKey) const -> size_type
+		{
+			return contains(aKey) ? 1 : 0;
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::insert(const value_type& aValue) -> std::pair<iterator, bool>
+		{
+			const auto [index, inserted] = FindOrPrepareInsert(Policy::Key(aValue));
+
+			if (inserted)
+				ConstructAt(index, aValue);
+
+			return { IteratorAt(index), inserted };
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::insert(value_type&& aValue) -> std::pair<iterator, bool>
+		{
+			const auto [index, inserted] = FindOrPrepareInsert(Policy::Key(aValue));
+
+			if (inserted)
+				ConstructAt(index, std::move(aValue));
+
+			return { IteratorAt(index), inserted };
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		template<std::input_iterator Iter>
+		void Table<Policy, Hash, KeyEqual, Alloc>::insert(Iter aFirst, Iter aLast)
+		{
+			if constexpr (std::forward_iterator<Iter>)
+				reserve(mySize + static_cast<size_type>(std::distance(aFirst, aLast)));
+
+			for (; aFirst != aLast; ++aFirst)
+				emplace(*aFirst);
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		void Table<Policy, Hash, KeyEqual, Alloc>::insert(std::initializer_list<value_type> aInitList)
+		{
+			insert(aInitList.begin(), aInitList.end());
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		template<typename... Args> requires std::constructible_from<typename Policy::value_type, Args...>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::emplace(Args&&... someArgs) -> std::pair<iterator, bool>
+		{
+			if constexpr (sizeof...(Args) == 1 && (std::is_same_v<std::remove_cvref_t<Args>, value_type> && ...))
+			{
+				return insert(std::forward<Args>(someArgs)...);
+			}
+			else
+			{
+				return insert(value_type(std::forward<Args>(someArgs)...));
+			}
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::erase(const_iterator aPosition) -> iterator
+		{
+			const auto index = static_cast<size_type>(aPosition.operator->() - mySlots);
+			EraseAt(index);
+
+			return IteratorAt(index + 1); // erasing never moves other elements
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::erase(iterator aPosition) -> iterator requires (!std::is_same_v<iterator, const_iterator>)
+		{
+			return erase(const_iterator(aPosition));
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::erase(const key_type& aKey) -> size_type
+		{
+			const size_type index = FindIndex(aKey, HashOf(aKey));
+			if (index == myCapacity)
+				return 0;
+
+			EraseAt(index);
+
+			return 1;
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		template<class K> requires IsTransparent<Hash, KeyEqual>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::erase(const K& aKey) -> size_type
+		{
+			const size_type index = FindIndex(aKey, HashOf(aKey));
+			if (index == myCapacity)
+				return 0;
+
+			EraseAt(index);
+
+			return 1;
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		void Table<Policy, Hash, KeyEqual, Alloc>::clear() noexcept
+		{
+			if (myCapacity == 0)
+				return;
+
+			if constexpr (!std::is_trivially_destructible_v<value_type>)
+			{
+				for (size_type i = 0; i < myCapacity; ++i)
+				{
+					if (IsFull(myCtrl[i]))
+						alloc_traits::destroy(myAllocator, mySlots + i);
+				}
+			}
+
+			std::memset(myCtrl, static_cast<std::uint8_t>(EMPTY), myCapacity + Group::WIDTH);
+			myCtrl[myCapacity] = SENTINEL;
+
+			mySize			= 0;
+			myGrowthLeft	= MaxLoad(myCapacity);
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		void Table<Policy, Hash, KeyEqual, Alloc>::reserve(size_type aCount)
+		{
+			if (aCount > mySize + myGrowthLeft)
+				Resize(CapacityFor(aCount));
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		void Table<Policy, Hash, KeyEqual, Alloc>::rehash(size_type aCount)
+		{
+			if (aCount == 0 && mySize == 0)
+			{
+				Destroy();
+				return;
+			}
+
+			Resize(CapacityFor((std::max)(aCount, mySize)));
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		void Table<Policy, Hash, KeyEqual, Alloc>::swap(Table& aOther) noexcept
+		{
+			using std::swap;
+
+			swap(myCtrl,		aOther.myCtrl);
+			swap(mySlots,		aOther.mySlots);
+			swap(mySize,		aOther.mySize);
+			swap(myCapacity,	aOther.myCapacity);
+			swap(myGrowthLeft,	aOther.myGrowthLeft);
+			swap(myHash,		aOther.myHash);
+			swap(myEqual,		aOther.myEqual);
+
+			if constexpr (alloc_traits::propagate_on_container_swap::value)
+			{
+				swap(myAllocator, aOther.myAllocator);
+			}
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		template<class K>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::FindIndex(const K& aKey, std::size_t aHash) const -> size_type
+		{
+			const ctrl_t h2 = H2(aHash);
+
+			size_type position	= H1(aHash) & myCapacity;
+			size_type step		= 0;
+
+			while (true)
+			{
+				const Group group(myCtrl + position);
+
+				for (auto mask = group.Match(h2); mask != 0; mask &= mask - 1)
+				{
+					const size_type index = (position + LowestIndex(mask)) & myCapacity;
+
+					if (myEqual(aKey, Policy::Key(mySlots[index]))) [[likely]]
+						return index;
+				}
+
+				if (group.MatchEmpty() != 0) [[likely]]
+					return myCapacity;
+
+				step		+= Group::WIDTH;
+				position	= (position + step) & myCapacity;
+
+				assert(step <= myCapacity && "Table is full");
+			}
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		template<class K>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::FindOrPrepareInsert(const K& aKey) -> std::pair<size_type, bool>
+		{
+			const std::size_t hash = HashOf(aKey);
+
+			if (const size_type index = FindIndex(aKey, hash); index != myCapacity)
+				return { index, false };
+
+			return { PrepareInsert(hash), true };
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::PrepareInsert(std::size_t aHash) -> size_type
+		{
+			size_type index = FindFirstNonFull(aHash);
+
+			if (myGrowthLeft == 0 && myCtrl[index] != DELETED) [[unlikely]]
+			{
+				Grow();
+				index = FindFirstNonFull(aHash);
+			}
+
+			if (myCtrl[index] == EMPTY)
+				--myGrowthLeft;
+
+			SetCtrl(index, H2(aHash));
+			++mySize;
+
+			return index;
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		template<typename... Args>
+		void Table<Policy, Hash, KeyEqual, Alloc>::ConstructAt(size_type aIndex, Args&&... someArgs)
+		{
+			try
+			{
+				alloc_traits::construct(myAllocator, mySlots + aIndex, std::forward<Args>(someArgs)...);
+			}
+			catch (...)
+			{
+				SetCtrl(aIndex, DELETED);
+				--mySize;
+
+				throw;
+			}
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::HashOf(const auto& aKey) const -> std::size_t
+		{
+			return Mix(static_cast<std::size_t>(myHash(aKey)));
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::IteratorAt(size_type aIndex) noexcept -> iterator
+		{
+			return iterator(myCtrl + aIndex, mySlots + aIndex);
+		}
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::IteratorAt(size_type aIndex) const noexcept -> const_iterator
+		{
+			return const_iterator(myCtrl + aIndex, mySlots + aIndex);
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		constexpr auto Table<Policy, Hash, KeyEqual, Alloc>::MaxLoad(size_type aCapacity) noexcept -> size_type
+		{
+			// at most 7/8 full, and at least one slot is always left empty to end probing
+			return (aCapacity == 0) ? 0 : (std::min)(aCapacity - aCapacity / 8, aCapacity - 1);
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		constexpr auto Table<Policy, Hash, KeyEqual, Alloc>::CapacityFor(size_type aCount) noexcept -> size_type
+		{
+			if (aCount == 0)
+				return 0;
+
+			size_type capacity = (std::max)(Group::WIDTH - 1, std::bit_ceil(aCount + aCount / 7 + 1) - 1);
+
+			while (MaxLoad(capacity) < aCount)
+				capacity = capacity * 2 + 1;
+
+			return capacity;
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		auto Table<Policy, Hash, KeyEqual, Alloc>::FindFirstNonFull(std::size_t aHash) const noexcept -> size_type
+		{
+			size_type position	= H1(aHash) & myCapacity;
+			size_type step		= 0;
+
+			while (true)
+			{
+				const Group group(myCtrl + position);
+
+				if (const auto mask = group.MatchEmptyOrDeleted(); mask != 0)
+					return (position + LowestIndex(mask)) & myCapacity;
+
+				step		+= Group::WIDTH;
+				position	= (position + step) & myCapacity;
+			}
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		void Table<Policy, Hash, KeyEqual, Alloc>::SetCtrl(size_type aIndex, ctrl_t aValue) noexcept
+		{
+			// the first bytes are mirrored after the sentinel so a group can be read from any position
+			constexpr size_type CLONED = Group::WIDTH - 1;
+
+			myCtrl[aIndex] = aValue;
+			myCtrl[((aIndex - CLONED) & myCapacity) + CLONED] = aValue;
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		void Table<Policy, Hash, KeyEqual, Alloc>::EraseAt(size_type aIndex) noexcept
+		{
+			assert(IsFull(myCtrl[aIndex]) && "Slot is not in use");
+
+			alloc_traits::destroy(myAllocator, mySlots + aIndex);
+			--mySize;
+
+			// if no group that covers the slot has ever been full, no probe could have passed it, so it can
+			// become empty again instead of leaving a tombstone
+
+			const size_type before = (aIndex - Group::WIDTH) & myCapacity;
+
+			const auto emptyAfter	= Group(myCtrl + aIndex).MatchEmpty();
+			const auto emptyBefore	= Group(myCtrl + before).MatchEmpty();
+
+			const bool wasNeverFull = emptyBefore != 0 && emptyAfter != 0 &&
+				LowestIndex(emptyAfter) + static_cast<size_type>(Group::LeadingZeros(emptyBefore)) < Group::WIDTH;
+
+			if (wasNeverFull)
+			{
+				SetCtrl(aIndex, EMPTY);
+				++myGrowthLeft;
+			}
+			else
+			{
+				SetCtrl(aIndex, DELETED);
+			}
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		void Table<Policy, Hash, KeyEqual, Alloc>::Grow()
+		{
+			// rebuilding at the same size is enough when most of the used up slots are tombstones
+			if (myCapacity > Group::WIDTH && mySize * 32 <= myCapacity * 25)
+				Resize(myCapacity);
+			else
+				Resize(myCapacity == 0 ? Group::WIDTH - 1 : myCapacity * 2 + 1);
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		void Table<Policy, Hash, KeyEqual, Alloc>::Resize(size_type aCapacity)
+		{
+			assert(std::has_single_bit(aCapacity + 1) && MaxLoad(aCapacity) >= mySize);
+
+			ctrl_alloc ctrlAlloc(myAllocator);
+
+			ctrl_t* ctrl		= ctrl_traits::allocate(ctrlAlloc, aCapacity + Group::WIDTH);
+			value_type* slots	= nullptr;
+
+			try
+			{
+				slots = alloc_traits::allocate(myAllocator, aCapacity);
+			}
+			catch (...)
+			{
+				ctrl_traits::deallocate(ctrlAlloc, ctrl, aCapacity + Group::WIDTH);
+				throw;
+			}
+
+			std::memset(ctrl, static_cast<std::uint8_t>(EMPTY), aCapacity + Group::WIDTH);
+			ctrl[aCapacity] = SENTINEL;
+
+			std::swap(myCtrl, ctrl);
+			std::swap(mySlots, slots);
+			std::swap(myCapacity, aCapacity);
+
+			// the old arrays are kept until every element is in place, so a throwing hash or copy leaves them usable
+
+			try
+			{
+				for (size_type i = 0; i < aCapacity; ++i)
+				{
+					if (!IsFull(ctrl[i]))
+						continue;
+
+					const std::size_t hash	= HashOf(Policy::Key(slots[i]));
+					const size_type index	= FindFirstNonFull(hash);
+
+					SetCtrl(index, H2(hash));
+
+					if constexpr (IsTriviallyRelocatable<value_type>)
+					{
+						details::relocate::Relocate(slots + i, slots + i + 1, mySlots + index);
+					}
+					else
+					{
+						try
+						{
+							alloc_traits::construct(myAllocator, mySlots + index, std::move_if_noexcept(slots[i]));
+						}
+						catch (...)
+						{
+							SetCtrl(index, EMPTY);
+							throw;
+						}
+					}
+				}
+			}
+			catch (...)
+			{
+				if constexpr (!IsTriviallyRelocatable<value_type>)
+				{
+					for (size_type i = 0; i < myCapacity; ++i)
+					{
+						if (IsFull(myCtrl[i]))
+							alloc_traits::destroy(myAllocator, mySlots + i);
+					}
+				}
+
+				std::swap(myCtrl, ctrl);
+				std::swap(mySlots, slots);
+				std::swap(myCapacity, aCapacity);
+
+				ctrl_traits::deallocate(ctrlAlloc, ctrl, aCapacity + Group::WIDTH);
+				alloc_traits::deallocate(myAllocator, slots, aCapacity);
+
+				throw;
+			}
+
+			if (aCapacity != 0)
+			{
+				if constexpr (!IsTriviallyRelocatable<value_type> && !std::is_trivially_destructible_v<value_type>)
+				{
+					for (size_type i = 0; i < aCapacity; ++i)
+					{
+						if (IsFull(ctrl[i]))
+							alloc_traits::destroy(myAllocator, slots + i);
+					}
+				}
+
+				ctrl_traits::deallocate(ctrlAlloc, ctrl, aCapacity + Group::WIDTH);
+				alloc_traits::deallocate(myAllocator, slots, aCapacity);
+			}
+
+			myGrowthLeft = MaxLoad(myCapacity) - mySize;
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		template<class Other>
+		void Table<Policy, Hash, KeyEqual, Alloc>::Assign(Other&& aOther)
+		{
+			assert(empty() && "Table has to be empty before assigning");
+
+			reserve(aOther.mySize);
+
+			for (size_type i = 0; i < aOther.myCapacity; ++i)
+			{
+				if (!IsFull(aOther.myCtrl[i]))
+					continue;
+
+				const size_type index = PrepareInsert(HashOf(Policy::Key(aOther.mySlots[i])));
+
+				if constexpr (std::is_lvalue_reference_v<Other>)
+					ConstructAt(index, aOther.mySlots[i]);
+				else
+					ConstructAt(index, std::move(aOther.mySlots[i]));
+			}
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		void Table<Policy, Hash, KeyEqual, Alloc>::Destroy() noexcept
+		{
+			if (myCapacity == 0)
+				return;
+
+			clear();
+
+			ctrl_alloc ctrlAlloc(myAllocator);
+
+			ctrl_traits::deallocate(ctrlAlloc, myCtrl, myCapacity + Group::WIDTH);
+			alloc_traits::deallocate(myAllocator, mySlots, myCapacity);
+
+			myCtrl			= const_cast<ctrl_t*>(EMPTY_GROUP);
+			mySlots			= nullptr;
+			myCapacity		= 0;
+			myGrowthLeft	= 0;
+		}
+
+		template<class Policy, class Hash, class KeyEqual, class Alloc>
+		void Table<Policy, Hash, KeyEqual, Alloc>::Steal(Table& aOther) noexcept
+		{
+			myCtrl			= std::exchange(aOther.myCtrl, const_cast<ctrl_t*>(EMPTY_GROUP));
+			mySlots			= std::exchange(aOther.mySlots, nullptr);
+			mySize			= std::exchange(aOther.mySize, 0);
+			myCapacity		= std::exchange(aOther.myCapacity, 0);
+			myGrowthLeft	= std::exchange(aOther.myGrowthLeft, 0);
+		}
+	}
+
+	/// Hash map that stores its elements in one flat array using open addressing, instead of a node per
+	/// element like std::unordered_map. Lookups compare the 7-bit tags of 16 slots at a time with SIMD and
+	/// usually touch a single cache line of elements.
+	///
+	/// Elements move when the table grows, so references, pointers, and iterators are invalidated by any
+	/// insertion that may rehash. Erasing leaves the other elements in place. Hash and KeyEqual that both
+	/// define is_transparent allow lookups with other types than the key, e.g., std::string_view for
+	/// std::string.
+	///
+	template<class K, class V, class Hash = std::hash<K>, class KeyEqual = std::equal_to<K>, class Alloc = std::allocator<std::pair<const K, V>>>
+	class FlatHashMap : public details::flat::Table<details::flat::MapPolicy<K, V>, Hash, KeyEqual, Alloc>
+	{
+		using Base = details::flat::Table<details::flat::MapPolicy<K, V>, Hash, KeyEqual, Alloc>;
+
+	public:
+		using mapped_type = V;
+
+		using typename Base::key_type;
+		using typename Base::value_type;
+		using typename Base::size_type;
+		using typename Base::iterator;
+		using typename Base::const_iterator;
+
+		using Base::Base;
+		using Base::insert;
+
+		FlatHashMap() = default;
+
+		FlatHashMap(std::initializer_list<value_type> aInitList, const Alloc& aAllocator = Alloc());
+
+		template<typename... Args> requires std::constructible_from<V, Args...>
+		auto try_emplace(const K& aKey, Args&&... someArgs) -> std::pair<iterator, bool>;
+		template<typename... Args> requires std::constructible_from<V, Args...>
+		auto try_emplace(K&& aKey, Args&&... someArgs) -> std::pair<iterator, bool>;
+
+		template<typename M> requires std::assignable_from<V&, M&&>
+		auto insert_or_assign(const K& aKey, M&& aValue) -> std::pair<iterator, bool>;
+		template<typename M> requires std::assignable_from<V&, M&&>
+		auto insert_or_assign(K&& aKey, M&& aValue) -> std::pair<iterator, bool>;
+
+		NODISC auto operator[](const K& aKey) -> V&;
+		NODISC auto operator[](K&& aKey) -> V&;
+
+		NODISC auto at(const K& aKey) -> V&;
+		NODISC auto at(const K& aKey) const -> const V&;
+
+		template<class U> requires details::flat::IsTransparent<Hash, KeyEqual>
+		NODISC auto at(const U& aKey) -> V&;
+		template<class U> requires details::flat::IsTransparent<Hash, KeyEqual>
+		NODISC auto at(const U& aKey) const -> const V&;
+	};
+
+	template<class K, class V, class Hash, class KeyEqual, class Alloc>
+	FlatHashMap<K, V, Hash, KeyEqual, Alloc>::FlatHashMap(std::initializer_list<value_type> aInitList, const Alloc& aAllocator)
+		: Base(aAllocator)
+	{
+		insert(aInitList);
+	}
+
+	template<class K, class V, class Hash, class KeyEqual, class Alloc>
+	template<typename... Args> requires std::constructible_from<V, Args...>
+	auto FlatHashMap<K, V, Hash, KeyEqual, Alloc>::try_emplace(const K& aKey, Args&&... someArgs) -> std::pair<iterator, bool>
+	{
+		const auto [index, inserted] = this->FindOrPrepareInsert(aKey);
+
+		if (inserted)
+		{
+			this->ConstructAt(index, std::piecewise_construct,
+				std::forward_as_tuple(aKey), std::forward_as_tuple(std::forward<Args>(someArgs)...));
+		}
+
+		return { this->IteratorAt(index), inserted };
+	}
+	template<class K, class V, class Hash, class KeyEqual, class Alloc>
+	template<typename... Args> requires std::constructible_from<V, Args...>
+	auto FlatHashMap<K, V, Hash, KeyEqual, Alloc>::try_emplace(K&& aKey, Args&&... someArgs) -> std::pair<iterator, bool>
+	{
+		const auto [index, inserted] = this->FindOrPrepareInsert(aKey);
+
+		if (inserted)
+		{
+			this->ConstructAt(index, std::piecewise_construct,
+				std::forward_as_tuple(std::move(aKey)), std::forward_as_tuple(std::forward<Args>(someArgs)...));
+		}
+
+		return { this->IteratorAt(index), inserted };
+	}
+
+	template<class K, class V, class Hash, class KeyEqual, class Alloc>
+	template<typename M> requires std::assignable_from<V&, M&&>
+	auto FlatHashMap<K, V, Hash, KeyEqual, Alloc>::insert_or_assign(const K& aKey, M&& aValue) -> std::pair<iterator, bool>
+	{
+		auto result = try_emplace(aKey, std::forward<M>(aValue));
+
+		if (!result.second)
+			result.first->second = std::forward<M>(aValue);
+
+		return result;
+	}
+	template<class K, class V, class Hash, class KeyEqual, class Alloc>
+	template<typename M> requires std::assignable_from<V&, M&&>
+	auto FlatHashMap<K, V, Hash, KeyEqual, Alloc>::insert_or_assign(K&& aKey, M&& aValue) -> std::pair<iterator, bool>
+	{
+		auto result = try_emplace(std::move(aKey), std::forward<M>(aValue));
+
+		if (!result.second)
+			result.first->second = std::forward<M>(aValue);
+
+		return result;
+	}
+
+	template<class K, class V, class Hash, class KeyEqual, class Alloc>
+	auto FlatHashMap<K, V, Hash, KeyEqual, Alloc>::operator[](const K& aKey) -> V&
+	{
+		return try_emplace(aKey).first->second;
+	}
+	template<class K, class V, class Hash, class KeyEqual, class Alloc>
+	auto FlatHashMap<K, V, Hash, KeyEqual, Alloc>::operator[](K&& aKey) -> V&
+	{
+		return try_emplace(std::move(aKey)).first->second;
+	}
+
+	template<class K, class V, class Hash, class KeyEqual, class Alloc>
+	auto FlatHashMap<K, V, Hash, KeyEqual, Alloc>::at(const K& aKey) -> V&
+	{
+		return const_cast<V&>(std::as_const(*this).at(aKey));
+	}
+	template<class K, class V, class Hash, class KeyEqual, class Alloc>
+	auto FlatHashMap<K, V, Hash, KeyEqual, Alloc>::at(const K& aKey) const -> const V&
+	{
+		const auto it = this->find(aKey);
+		if (it == this->end())
+			throw std::out_of_range("Key is not in the map");
+
+		return it->second;
+	}
+
+	template<class K, class V, class Hash, class KeyEqual, class Alloc>
+	template<class U> requires details::flat::IsTransparent<Hash, KeyEqual>
+	auto FlatHashMap<K, V, Hash, KeyEqual, Alloc>::at(const U& aKey) -> V&
+	{
+		return const_cast<V&>(std::as_const(*this).at(aKey));
+	}
+	template<class K, class V, class Hash, class KeyEqual, class Alloc>
+	template<class U> requires details::flat::IsTransparent<Hash, KeyEqual>
+	auto FlatHashMap<K, V, Hash, KeyEqual, Alloc>::at(const U& aKey) const -> const V&
+	{
+		const auto it = this->find(aKey);
+		if (it == this->end())
+			throw std::out_of_range("Key is not in the map");
+
+		return it->second;
+	}
+
+	/// Set counterpart of FlatHashMap, with the same layout and invalidation rules.
+	///
+	template<class K, class Hash = std::hash<K>, class KeyEqual = std::equal_to<K>, class Alloc = std::allocator<K>>
+	class FlatHashSet : public details::flat::Table<details::flat::SetPolicy<K>, Hash, KeyEqual, Alloc>
+	{
+		using Base = details::flat::Table<details::flat::SetPolicy<K>, Hash, KeyEqual, Alloc>;
+
+	public:
+		using typename Base::value_type;
+
+		using Base::Base;
+
+		FlatHashSet() = default;
+
+		FlatHashSet(std::initializer_list<value_type> aInitList, const Alloc& aAllocator = Alloc());
+	};
+
+	template<class K, class Hash, class KeyEqual, class Alloc>
+	FlatHashSet<K, Hash, KeyEqual, Alloc>::FlatHashSet(std::initializer_list<value_type> aInitList, const Alloc& aAllocator)
+		: Base(aAllocator)
+	{
+		this->insert(aInitList);
+	}
+
+	namespace pmr
+	{
+		template<class K, class V, class Hash = std::hash<K>, class KeyEqual = std::equal_to<K>>
+		using FlatHashMap = CommonUtilities::FlatHashMap<K, V, Hash, KeyEqual, std::pmr::polymorphic_allocator<std::pair<const K, V>>>;
+
+		template<class K, class Hash = std::hash<K>, class KeyEqual = std::equal_to<K>>
+		using FlatHashSet = CommonUtilities::FlatHashSet<K, Hash, KeyEqual, std::pmr::polymorphic_allocator<K>>;
+	}
+}
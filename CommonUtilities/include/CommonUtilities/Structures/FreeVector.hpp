@@ -1,8 +1,16 @@
 #pragma once
 
 #include <vector>
-#include <variant>
+#include <memory>
+#include <memory_resource>
 #include <functional>
+#include <algorithm>
+#include <utility>
+#include <stdexcept>
+#include <limits>
+#include <cstdint>
+#include <bit>
+#include <cstring>
 #include <cassert>
 
 #include <CommonUtilities/Config.h>
@@ -10,8 +18,12 @@
 namespace CommonUtilities
 {
 	/// Structure that enables for quick insertion and removal from anywhere in the container.
-	/// 
-	template<class T, class Alloc = std::allocator<std::variant<T, std::int64_t>>>
+	///
+	/// Removed slots hold the index of the next free slot in their own storage, and which slots are valid
+	/// is kept in a separate bitset. The index is 32 bits unless the element is at least 8 bytes in both
+	/// size and alignment, so a slot is no larger than the element it holds if that is at least 4 bytes.
+	///
+	template<class T, class Alloc = std::allocator<T>>
 	class FreeVector
 	{
 	public:
@@ -21,111 +33,119 @@ namespace CommonUtilities
 		using pointer			= T*;
 		using const_pointer		= const T*;
 		using size_type			= std::size_t;
-
-		using container_type = std::vector<std::variant<T, std::int64_t>, Alloc>;
+		using allocator_type	= Alloc;
 
 		constexpr explicit FreeVector(const Alloc& aAllocator);
 
 		constexpr FreeVector() = default;
-		constexpr ~FreeVector() = default;
+		constexpr ~FreeVector();
+
+		constexpr FreeVector(const FreeVector& aOther);
+		constexpr FreeVector(FreeVector&& aOther) noexcept;
+
+		constexpr FreeVector(const FreeVector& aOther, const Alloc& aAllocator);
+		constexpr FreeVector(FreeVector&& aOther, const Alloc& aAllocator);
 
-		constexpr FreeVector(const FreeVector&) = default;
-		constexpr FreeVector(FreeVector&&) noexcept = default;
+		constexpr auto operator=(const FreeVector& aOther) -> FreeVector&;
+		constexpr auto operator=(FreeVector&& aOther) noexcept(
+			std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+			std::allocator_traits<Alloc>::is_always_equal::value) -> FreeVector&;
 
-		constexpr auto operator=(const FreeVector&) -> FreeVector& = default;
-		constexpr auto operator=(FreeVector&&) noexcept -> FreeVector& = default;
+		/// \returns Copy of the allocator the elements are allocated with.
+		///
+		NODISC constexpr auto get_allocator() const noexcept -> allocator_type;
 
 		/// \param anIndex: Index to element in container.
-		/// 
+		///
 		/// \returns Reference to element.
-		/// 
+		///
 		NODISC constexpr auto operator[](size_type anIndex) -> reference;
 
 		/// \param anIndex: Index to element in container.
-		/// 
+		///
 		/// \returns Const reference to element.
-		/// 
+		///
 		NODISC constexpr auto operator[](size_type anIndex) const -> const_reference;
 
 		/// \param anIndex: Index to element in container.
-		/// 
+		///
 		/// \returns Reference to element.
-		/// 
+		///
 		NODISC constexpr auto at(size_type anIndex) -> reference;
 
 		/// \param anIndex: Index to element in container.
-		/// 
+		///
 		/// \returns Const reference to element.
-		/// 
+		///
 		NODISC constexpr auto at(size_type anIndex) const -> const_reference;
 
 		/// \param anIndex: Index to element in container.
-		/// 
+		///
 		/// \returns Whether element is valid or not.
-		/// 
+		///
 		NODISC constexpr bool valid(size_type anIndex) const;
 
 		/// \returns If it contains any valid elements.
-		/// 
+		///
 		NODISC constexpr bool empty() const noexcept;
 
 		/// \returns Number of elements in the container.
-		/// 
+		///
 		NODISC constexpr auto size() const noexcept -> size_type;
 
 		/// \returns Number of valid elements in the container.
-		/// 
+		///
 		NODISC constexpr auto count() const noexcept -> size_type;
 
 		/// \returns Capacity of the container.
-		/// 
+		///
 		NODISC constexpr auto capacity() const noexcept -> size_type;
 
 		/// \returns Maximum number of elements allowed.
-		/// 
+		///
 		NODISC constexpr auto max_size() const noexcept -> size_type;
 
 		/// Emplace element in container.
-		/// 
+		///
 		/// \param someArgs: Optional parameters to construct element.
-		/// 
+		///
 		/// \returns Index to access constructed element.
-		/// 
+		///
 		template<typename... Args> requires std::constructible_from<T, Args...>
 		constexpr auto emplace(Args&&... someArgs) -> size_type;
 
 		/// Add element to container.
-		/// 
+		///
 		/// \param anElement: Element to add.
-		/// 
+		///
 		/// \returns Index to access added element.
-		/// 
+		///
 		constexpr auto insert(const T& anElement) -> size_type;
 
 		/// Add element to container.
-		/// 
+		///
 		/// \param anElement: Element to add.
-		/// 
+		///
 		/// \returns Index to access added element.
-		/// 
+		///
 		constexpr auto insert(T&& anElement) -> size_type;
 
 		/// Removes element at index. Element at index must be valid.
-		/// 
+		///
 		/// \param anIndex: Index to remove element at.
-		/// 
+		///
 		constexpr void erase(size_type anIndex);
 
 		/// Clears structure of all elements and resets itself to initial state.
-		/// 
+		///
 		constexpr void clear();
 
 		/// Reserve to reduce reallocation.
-		/// 
+		///
 		constexpr void reserve(size_type aCapacity);
 
 		/// Swap two FreeVector.
-		/// 
+		///
 		constexpr void swap(FreeVector& aOther);
 
 		template<typename Func>
@@ -134,49 +154,205 @@ namespace CommonUtilities
 		template<typename Func>
 		constexpr void for_each(const Func& func);
 
-		constexpr friend bool operator==(FreeVector& aLeft, FreeVector& aRight);
+		/// Iterates the valid elements in order, skipping 64 slots at a time where there are none.
+		///
+		/// \param func: Called with the index and the element.
+		///
+		template<typename Func>
+		constexpr void for_each_valid(const Func& func) const;
+
+		template<typename Func>
+		constexpr void for_each_valid(const Func& func);
+
+		template<class U, class A>
+		friend constexpr bool operator==(const FreeVector<U, A>& aLeft, const FreeVector<U, A>& aRight);
 
 	private:
-		container_type	myData;
-		std::int64_t	myFirstFree {-1};
-		size_type		myCount		{0};
+		using link_type		= std::conditional_t<(sizeof(T) < 8 || alignof(T) < 8), std::uint32_t, size_type>; // smaller links for small or loosely aligned elements
+		using word_type		= std::uint64_t;
+
+		static constexpr link_type	NO_FREE		= (std::numeric_limits<link_type>::max)();
+		static constexpr size_type	WORD_BITS	= 64;
+
+		struct Slot
+		{
+			alignas(T) std::byte bytes[(std::max)(sizeof(T), sizeof(link_type))]; // links are copied in and out, so they need no alignment
+		};
+
+		static_assert(sizeof(T) < sizeof(std::uint32_t) || sizeof(Slot) == sizeof(T), "slots should be no larger than the elements");
+
+		using alloc_traits	= std::allocator_traits<Alloc>;
+		using slot_alloc	= typename alloc_traits::template rebind_alloc<Slot>;
+		using slot_traits	= std::allocator_traits<slot_alloc>;
+		using word_alloc	= typename alloc_traits::template rebind_alloc<word_type>;
+
+		NODISC constexpr T& Value(size_type anIndex);
+		NODISC constexpr const T& Value(size_type anIndex) const;
+
+		NODISC constexpr link_type Link(size_type anIndex) const;
+		constexpr void SetLink(size_type anIndex, link_type aLink);
+
+		constexpr void Reallocate(size_type aCapacity);
+
+		/// Reallocates and constructs a new element at the end, before the old slots are moved, so that the
+		/// arguments may refer to elements in the container.
+		///
+		template<typename... Args>
+		constexpr void ReallocateEmplace(size_type aCapacity, Args&&... someArgs);
+
+		/// Moves the slots into new storage and frees the old.
+		///
+		constexpr void MoveSlots(Slot* aData, size_type aCapacity);
+
+		/// Copies or moves the slots of another, who must have the same size and free list.
+		///
+		template<class Other>
+		constexpr void Assign(Other&& aOther);
+
+		constexpr void Destroy();
+		constexpr void Steal(FreeVector& aOther) noexcept;
+
+		Alloc									myAllocator;
+		Slot*									myData		{nullptr};
+		size_type								mySize		{0};
+		size_type								myCapacity	{0};
+		std::vector<word_type, word_alloc>		myValid;	// bit per slot, set if it holds an element
+		link_type								myFirstFree {NO_FREE};
+		size_type								myCount		{0};
 	};
 
 	template<class T, class Alloc>
 	constexpr FreeVector<T, Alloc>::FreeVector(const Alloc& aAllocator)
-		: myData(aAllocator)
+		: myAllocator(aAllocator), myValid(word_alloc(aAllocator))
 	{
 
 	}
 
+	template<class T, class Alloc>
+	constexpr FreeVector<T, Alloc>::~FreeVector()
+	{
+		Destroy();
+	}
+
+	template<class T, class Alloc>
+	constexpr FreeVector<T, Alloc>::FreeVector(const FreeVector& aOther)
+		: FreeVector(aOther, alloc_traits::select_on_container_copy_construction(aOther.myAllocator))
+	{
+
+	}
+
+	template<class T, class Alloc>
+	constexpr FreeVector<T, Alloc>::FreeVector(FreeVector&& aOther) noexcept
+		: myAllocator(std::move(aOther.myAllocator)), myValid(word_alloc(myAllocator))
+	{
+		Steal(aOther);
+	}
+
+	template<class T, class Alloc>
+	constexpr FreeVector<T, Alloc>::FreeVector(const FreeVector& aOther, const Alloc& aAllocator)
+		: myAllocator(aAllocator), myValid(word_alloc(aAllocator))
+	{
+		Assign(aOther);
+	}
+
+	template<class T, class Alloc>
+	constexpr FreeVector<T, Alloc>::FreeVector(FreeVector&& aOther, const Alloc& aAllocator)
+		: myAllocator(aAllocator), myValid(word_alloc(aAllocator))
+	{
+		if (myAllocator == aOther.myAllocator)
+			Steal(aOther);
+		else
+		{
+			Assign(std::move(aOther));
+			aOther.clear();
+		}
+	}
+
+	template<class T, class Alloc>
+	constexpr auto FreeVector<T, Alloc>::operator=(const FreeVector& aOther) -> FreeVector&
+	{
+		if (this != &aOther)
+		{
+			Destroy();
+
+			if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+			{
+				myAllocator = aOther.myAllocator;
+				myValid = std::vector<word_type, word_alloc>(word_alloc(myAllocator));
+			}
+
+			Assign(aOther);
+		}
+
+		return *this;
+	}
+
+	template<class T, class Alloc>
+	constexpr auto FreeVector<T, Alloc>::operator=(FreeVector&& aOther) noexcept(
+		std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+		std::allocator_traits<Alloc>::is_always_equal::value) -> FreeVector&
+	{
+		if (this != &aOther)
+		{
+			Destroy();
+
+			if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+			{
+				myAllocator = std::move(aOther.myAllocator);
+				myValid = std::vector<word_type, word_alloc>(word_alloc(myAllocator));
+			}
+
+			if (myAllocator == aOther.myAllocator)
+				Steal(aOther);
+			else
+			{
+				Assign(std::move(aOther));
+				aOther.clear();
+			}
+		}
+
+		return *this;
+	}
+
+	template<class T, class Alloc>
+	constexpr auto FreeVector<T, Alloc>::get_allocator() const noexcept -> allocator_type
+	{
+		return myAllocator;
+	}
+
 	template<class T, class Alloc>
 	constexpr auto FreeVector<T, Alloc>::operator[](size_type anIndex) -> reference
 	{
-		return std::get<T>(myData[anIndex]);
+		assert(valid(anIndex) && "Element is not valid");
+		return Value(anIndex);
 	}
 
 	template<class T, class Alloc>
 	constexpr auto FreeVector<T, Alloc>::operator[](size_type anIndex) const -> const_reference
 	{
-		return std::get<T>(myData[anIndex]);
+		assert(valid(anIndex) && "Element is not valid");
+		return Value(anIndex);
 	}
 
 	template<class T, class Alloc>
 	constexpr auto FreeVector<T, Alloc>::at(size_type anIndex) -> reference
 	{
-		return std::get<T>(myData.at(anIndex));
+		return const_cast<reference>(std::as_const(*this).at(anIndex));
 	}
 
 	template<class T, class Alloc>
 	constexpr auto FreeVector<T, Alloc>::at(size_type anIndex) const -> const_reference
 	{
-		return std::get<T>(myData.at(anIndex));
+		if (!valid(anIndex))
+			throw std::out_of_range("No valid element at index");
+
+		return Value(anIndex);
 	}
 
 	template<class T, class Alloc>
 	constexpr bool FreeVector<T, Alloc>::valid(size_type anIndex) const
 	{
-		return myData.at(anIndex).index() == 0;
+		return anIndex < mySize && (myValid[anIndex / WORD_BITS] >> (anIndex % WORD_BITS)) & 1;
 	}
 
 	template<class T, class Alloc>
@@ -188,7 +364,7 @@ namespace CommonUtilities
 	template<class T, class Alloc>
 	constexpr auto FreeVector<T, Alloc>::size() const noexcept -> size_type
 	{
-		return static_cast<size_type>(myData.size());
+		return mySize;
 	}
 
 	template<class T, class Alloc>
@@ -200,13 +376,13 @@ namespace CommonUtilities
 	template<class T, class Alloc>
 	constexpr auto FreeVector<T, Alloc>::capacity() const noexcept -> size_type
 	{
-		return static_cast<size_type>(myData.capacity());
+		return myCapacity;
 	}
 
 	template<class T, class Alloc>
 	constexpr auto FreeVector<T, Alloc>::max_size() const noexcept -> size_type
 	{
-		return static_cast<size_type>(myData.max_size());
+		return (std::min)(static_cast<size_type>(slot_traits::max_size(slot_alloc(myAllocator))), static_cast<size_type>(NO_FREE));
 	}
 
 	template<class T, class Alloc>
@@ -215,23 +391,42 @@ namespace CommonUtilities
 	{
 		size_type index = 0;
 
-		if (myFirstFree != -1)
+		if (myFirstFree != NO_FREE)
 		{
 			assert(!valid(myFirstFree));
 
 			index = myFirstFree;
 
-			myFirstFree		= std::get<std::int64_t>(myData[myFirstFree]);
-			myData[index]	= std::variant<T, std::int64_t>(std::in_place_index<0>, std::forward<Args>(someArgs)...);
+			const link_type next = Link(index);
+			alloc_traits::construct(myAllocator, reinterpret_cast<T*>(myData[index].bytes), std::forward<Args>(someArgs)...); // overwrites the link
+
+			myFirstFree = next;
 		}
 		else
 		{
-			assert(myData.size() == myCount); // should be the same if no more available space
+			assert(mySize == myCount); // should be the same if no more available space
+
+			index = mySize;
+
+			if (index % WORD_BITS == 0 && myValid.size() == myValid.capacity())
+				myValid.reserve(myValid.capacity() * 2 + 1); // grows geometrically, and so that adding the word below cannot throw
 
-			index = myData.size();
-			myData.emplace_back(std::in_place_index<0>, std::forward<Args>(someArgs)...);
+			if (mySize == myCapacity)
+			{
+				ReallocateEmplace(myCapacity ? myCapacity * 2 : 8, std::forward<Args>(someArgs)...);
+			}
+			else
+			{
+				alloc_traits::construct(myAllocator, reinterpret_cast<T*>(myData[index].bytes), std::forward<Args>(someArgs)...);
+			}
+
+			if (index % WORD_BITS == 0)
+				myValid.emplace_back(0);
+
+			++mySize;
 		}
 
+		myValid[index / WORD_BITS] |= word_type(1) << (index % WORD_BITS);
 		++myCount;
 
 		return index;
@@ -252,10 +447,13 @@ namespace CommonUtilities
 	template<class T, class Alloc>
 	constexpr void FreeVector<T, Alloc>::erase(size_type anIndex)
 	{
-		assert(anIndex >= 0 && anIndex < myData.size() && valid(anIndex));
+		assert(anIndex < mySize && valid(anIndex));
+
+		alloc_traits::destroy(myAllocator, &Value(anIndex));
+		SetLink(anIndex, myFirstFree);
 
-		myData[anIndex] = myFirstFree;
-		myFirstFree = anIndex;
+		myValid[anIndex / WORD_BITS] &= ~(word_type(1) << (anIndex % WORD_BITS));
+		myFirstFree = static_cast<link_type>(anIndex);
 
 		--myCount;
 	}
@@ -263,21 +461,34 @@ namespace CommonUtilities
 	template<class T, class Alloc>
 	constexpr void FreeVector<T, Alloc>::clear()
 	{
-		myData.clear();
-		myFirstFree = -1;
+		for_each([this](T& aElement) { alloc_traits::destroy(myAllocator, &aElement); });
+
+		mySize = 0;
+		myValid.clear();
+		myFirstFree = NO_FREE;
 		myCount = 0;
 	}
 
 	template<class T, class Alloc>
 	constexpr void FreeVector<T, Alloc>::reserve(size_type aCapacity)
 	{
-		myData.reserve(aCapacity);
+		if (aCapacity > myCapacity)
+		{
+			Reallocate(aCapacity);
+			myValid.reserve((aCapacity + WORD_BITS - 1) / WORD_BITS);
+		}
 	}
 
 	template<class T, class Alloc>
 	constexpr void FreeVector<T, Alloc>::swap(FreeVector& aOther)
 	{
+		if constexpr (alloc_traits::propagate_on_container_swap::value)
+			std::swap(myAllocator, aOther.myAllocator);
+
 		std::swap(myData,		aOther.myData);
+		std::swap(mySize,		aOther.mySize);
+		std::swap(myCapacity,	aOther.myCapacity);
+		std::swap(myValid,		aOther.myValid);
 		std::swap(myFirstFree,	aOther.myFirstFree);
 		std::swap(myCount,		aOther.myCount);
 	}
@@ -286,22 +497,166 @@ namespace CommonUtilities
 	template<typename Func>
 	constexpr void FreeVector<T, Alloc>::for_each(const Func& func) const
 	{
-		for (const auto& elt : myData)
+		for_each_valid([&func](size_type, const T& aElement) { func(aElement); });
+	}
+
+	template<class T, class Alloc>
+	template<typename Func>
+	constexpr void FreeVector<T, Alloc>::for_each(const Func& func)
+	{
+		for_each_valid([&func](size_type, T& aElement) { func(aElement); });
+	}
+
+	template<class T, class Alloc>
+	template<typename Func>
+	constexpr void FreeVector<T, Alloc>::for_each_valid(const Func& func) const
+	{
+		for (size_type i = 0; i < myValid.size(); ++i)
 		{
-			if (elt.index() == 0)
-				func(std::get<T>(elt));
+			for (word_type word = myValid[i]; word != 0; word &= word - 1)
+			{
+				const size_type index = i * WORD_BITS + std::countr_zero(word);
+				func(index, Value(index));
+			}
 		}
 	}
 
 	template<class T, class Alloc>
 	template<typename Func>
-	constexpr void FreeVector<T, Alloc>::for_each(const Func& func)
+	constexpr void FreeVector<T, Alloc>::for_each_valid(const Func& func)
 	{
-		for (auto& elt : myData)
+		std::as_const(*this).for_each_valid(
+			[&func](size_type aIndex, const T& aElement) { func(aIndex, const_cast<T&>(aElement)); });
+	}
+
+	template<class T, class Alloc>
+	constexpr T& FreeVector<T, Alloc>::Value(size_type anIndex)
+	{
+		return *std::launder(reinterpret_cast<T*>(myData[anIndex].bytes));
+	}
+
+	template<class T, class Alloc>
+	constexpr const T& FreeVector<T, Alloc>::Value(size_type anIndex) const
+	{
+		return *std::launder(reinterpret_cast<const T*>(myData[anIndex].bytes));
+	}
+
+	template<class T, class Alloc>
+	constexpr auto FreeVector<T, Alloc>::Link(size_type anIndex) const -> link_type
+	{
+		link_type link;
+		std::memcpy(&link, myData[anIndex].bytes, sizeof(link_type));
+
+		return link;
+	}
+
+	template<class T, class Alloc>
+	constexpr void FreeVector<T, Alloc>::SetLink(size_type anIndex, link_type aLink)
+	{
+		std::memcpy(myData[anIndex].bytes, &aLink, sizeof(link_type));
+	}
+
+	template<class T, class Alloc>
+	constexpr void FreeVector<T, Alloc>::Reallocate(size_type aCapacity)
+	{
+		slot_alloc allocator(myAllocator);
+		MoveSlots(slot_traits::allocate(allocator, aCapacity), aCapacity);
+	}
+
+	template<class T, class Alloc>
+	template<typename... Args>
+	constexpr void FreeVector<T, Alloc>::ReallocateEmplace(size_type aCapacity, Args&&... someArgs)
+	{
+		slot_alloc allocator(myAllocator);
+		Slot* data = slot_traits::allocate(allocator, aCapacity);
+
+		try
+		{
+			alloc_traits::construct(myAllocator, reinterpret_cast<T*>(data[mySize].bytes), std::forward<Args>(someArgs)...);
+		}
+		catch (...)
 		{
-			if (elt.index() == 0)
-				func(std::get<T>(elt));
+			slot_traits::deallocate(allocator, data, aCapacity);
+			throw;
 		}
+
+		MoveSlots(data, aCapacity);
+	}
+
+	template<class T, class Alloc>
+	constexpr void FreeVector<T, Alloc>::MoveSlots(Slot* aData, size_type aCapacity)
+	{
+		slot_alloc allocator(myAllocator);
+
+		for (size_type i = 0; i < mySize; ++i)
+		{
+			if (valid(i))
+			{
+				alloc_traits::construct(myAllocator, reinterpret_cast<T*>(aData[i].bytes), std::move(Value(i)));
+				alloc_traits::destroy(myAllocator, &Value(i));
+			}
+			else
+			{
+				std::memcpy(aData[i].bytes, myData[i].bytes, sizeof(link_type));
+			}
+		}
+
+		if (myData)
+			slot_traits::deallocate(allocator, myData, myCapacity);
+
+		myData		= aData;
+		myCapacity	= aCapacity;
+	}
+
+	template<class T, class Alloc>
+	template<class Other>
+	constexpr void FreeVector<T, Alloc>::Assign(Other&& aOther)
+	{
+		if (aOther.mySize > myCapacity)
+			Reallocate(aOther.mySize);
+
+		for (size_type i = 0; i < aOther.mySize; ++i)
+		{
+			if (!aOther.valid(i))
+				SetLink(i, aOther.Link(i));
+			else if constexpr (std::is_lvalue_reference_v<Other>)
+				alloc_traits::construct(myAllocator, reinterpret_cast<T*>(myData[i].bytes), aOther.Value(i));
+			else
+				alloc_traits::construct(myAllocator, reinterpret_cast<T*>(myData[i].bytes), std::move(aOther.Value(i)));
+		}
+
+		mySize		= aOther.mySize;
+		myValid.assign(aOther.myValid.begin(), aOther.myValid.end());
+		myFirstFree	= aOther.myFirstFree;
+		myCount		= aOther.myCount;
+	}
+
+	template<class T, class Alloc>
+	constexpr void FreeVector<T, Alloc>::Destroy()
+	{
+		clear();
+
+		if (myData)
+		{
+			slot_alloc allocator(myAllocator);
+			slot_traits::deallocate(allocator, myData, myCapacity);
+		}
+
+		myData		= nullptr;
+		myCapacity	= 0;
+	}
+
+	template<class T, class Alloc>
+	constexpr void FreeVector<T, Alloc>::Steal(FreeVector& aOther) noexcept
+	{
+		myData		= std::exchange(aOther.myData, nullptr);
+		mySize		= std::exchange(aOther.mySize, 0);
+		myCapacity	= std::exchange(aOther.myCapacity, 0);
+		myValid		= std::move(aOther.myValid);
+		myFirstFree	= std::exchange(aOther.myFirstFree, NO_FREE);
+		myCount		= std::exchange(aOther.myCount, 0);
+
+		aOther.myValid.clear();
 	}
 
 	// GLOBAL FUNCTIONS
@@ -313,16 +668,32 @@ namespace CommonUtilities
 	}
 
 	template<class T, class Alloc>
-	NODISC constexpr bool operator==(const FreeVector<T, Alloc>& aLeft, const FreeVector<T, Alloc>& aRight) noexcept
+	NODISC constexpr bool operator==(const FreeVector<T, Alloc>& aLeft, const FreeVector<T, Alloc>& aRight)
 	{
-		return	(aLeft.myData == aRight.myData) &&
-				(aLeft.myFirstFree == aRight.myFirstFree) &&
-				(aLeft.myCount == aRight.myCount);
+		if (aLeft.mySize != aRight.mySize || aLeft.myFirstFree != aRight.myFirstFree ||
+			aLeft.myCount != aRight.myCount || aLeft.myValid != aRight.myValid)
+		{
+			return false;
+		}
+
+		for (std::size_t i = 0; i < aLeft.mySize; ++i)
+		{
+			if (aLeft.valid(i) ? !(aLeft.Value(i) == aRight.Value(i)) : aLeft.Link(i) != aRight.Link(i))
+				return false;
+		}
+
+		return true;
 	}
 
 	template<class T, class Alloc>
-	NODISC constexpr bool operator!=(const FreeVector<T, Alloc>& aLeft, const FreeVector<T, Alloc>& aRight) noexcept
+	NODISC constexpr bool operator!=(const FreeVector<T, Alloc>& aLeft, const FreeVector<T, Alloc>& aRight)
 	{
 		return !(aLeft == aRight);
 	}
-}
\ No newline at end of file
+
+	namespace pmr
+	{
+		template<class T>
+		using FreeVector = CommonUtilities::FreeVector<T, std::pmr::polymorphic_allocator<T>>;
+	}
+}
@@ -0,0 +1,446 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <cassert>
+
+#include <CommonUtilities/Structures/PriorityQueue.hpp>
+#include <CommonUtilities/Structures/SlotMap.hpp>
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+	/// Priority queue where pushed items can be reached through a handle, to change their priority or remove
+	/// them in O(log n), e.g., decrease-key in Dijkstra or A* instead of pushing duplicates.
+	///
+	/// Each node has D children, where 4 is usually faster than a binary heap as the children of a node share
+	/// a cache line and the tree is half as deep.
+	///
+	/// Keeping track of where every item is costs a write per level moved, so pushing duplicates into a
+	/// PriorityQueue and skipping stale entries may still be faster when the extra entries are affordable.
+	///
+	template<typename T, pq::HeapType C = pq::HeapType::Min, std::size_t D = 4, class Alloc = std::allocator<T>>
+	class IndexedPriorityQueue
+	{
+	public:
+		static_assert(D >= 2, "Heap must have an arity of at least two");
+
+		using value_type		= T;
+		using reference			= T&;
+		using const_reference	= const T&;
+		using size_type			= std::size_t;
+		using allocator_type	= Alloc;
+		using handle_type		= SlotHandle;
+
+		static constexpr size_type ARITY = D;
+
+		constexpr IndexedPriorityQueue() = default;
+		constexpr ~IndexedPriorityQueue() = default;
+
+		constexpr explicit IndexedPriorityQueue(const Alloc& aAllocator);
+
+		NODISC constexpr auto get_allocator() const noexcept -> allocator_type;
+
+		/// \param Handle: Handle to item, must be valid.
+		///
+		/// \returns The item, change it through update to keep the order.
+		///
+		NODISC constexpr auto operator[](handle_type aHandle) const -> const_reference;
+
+		/// \returns Whether the handle refers to an item still in the queue.
+		///
+		NODISC constexpr bool contains(handle_type aHandle) const;
+
+		NODISC constexpr bool empty() const noexcept;
+		NODISC constexpr auto size() const noexcept -> size_type;
+
+		NODISC constexpr auto top() const noexcept -> const_reference;
+		NODISC constexpr auto top_handle() const noexcept -> handle_type;
+
+		constexpr auto push(const T& aItem) -> handle_type;
+		constexpr auto push(T&& aItem) -> handle_type;
+
+		template<typename... Args> requires std::constructible_from<T, Args...>
+		constexpr auto emplace(Args&&... someArgs) -> handle_type;
+
+		constexpr void pop();
+
+		/// Replaces an item and moves it up or down to its new place.
+		///
+		/// \param Handle: Handle to item, must be valid.
+		/// \param Item: New value of item.
+		///
+		constexpr void update(handle_type aHandle, const T& aItem);
+
+		/// Replaces an item with one of higher priority, e.g., a lower cost for a min-heap. Cheaper than
+		/// update as the item can only move up.
+		///
+		/// \param Handle: Handle to item, must be valid.
+		/// \param Item: New value of item, may not have lower priority than before.
+		///
+		constexpr void decrease_key(handle_type aHandle, const T& aItem);
+
+		/// Removes an item from anywhere in the queue.
+		///
+		/// \returns True if removed, false if the handle was stale.
+		///
+		constexpr bool erase(handle_type aHandle);
+
+		/// Adds all items in a range and restores the order once in O(n), rather than O(log n) per item.
+		///
+		/// \param Range: Items to add.
+		/// \param Handles: Receives the handle of each item in the order of the range.
+		///
+		template<std::ranges::input_range R, class Out = std::nullptr_t>
+			requires std::constructible_from<T, std::ranges::range_reference_t<R>>
+		constexpr void heapify(R&& aRange, Out aHandles = nullptr);
+
+		constexpr void reserve(size_type aCapacity);
+
+		constexpr void clear();
+
+	private:
+		struct Entry
+		{
+			T				item;
+			std::uint32_t	slot {0};
+		};
+
+		template<typename U>
+		using Rebind = typename std::allocator_traits<Alloc>::template rebind_alloc<U>;
+
+		/// \returns Whether lhs should be closer to the top than rhs.
+		///
+		NODISC static constexpr bool Before(const T& lhs, const T& rhs);
+
+		constexpr auto AddSlot(size_type aPosition) -> handle_type;
+
+		constexpr void SiftUp(size_type aPosition);
+		constexpr void SiftDown(size_type aPosition);
+
+		constexpr void Place(size_type aPosition, Entry&& aEntry);
+
+		static constexpr std::uint32_t NO_SLOT = (std::numeric_limits<std::uint32_t>::max)();
+
+		constexpr void FreeSlot(std::uint32_t aSlot);
+
+		std::vector<Entry, Rebind<Entry>>					myHeap;
+		std::vector<std::uint32_t, Rebind<std::uint32_t>>	myPositions;	// where in the heap each slot's item is, or the next free slot
+		std::vector<std::uint32_t, Rebind<std::uint32_t>>	myGenerations;	// advanced when the slot is freed, so only live handles match
+		std::uint32_t										myFirstFree {NO_SLOT};
+	};
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr IndexedPriorityQueue<T, C, D, Alloc>::IndexedPriorityQueue(const Alloc& aAllocator)
+		: myHeap(aAllocator), myPositions(aAllocator), myGenerations(aAllocator)
+	{
+
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr auto IndexedPriorityQueue<T, C, D, Alloc>::get_allocator() const noexcept -> allocator_type
+	{
+		return allocator_type(myHeap.get_allocator());
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr auto IndexedPriorityQueue<T, C, D, Alloc>::operator[](handle_type aHandle) const -> const_reference
+	{
+		assert(contains(aHandle) && "Handle is stale");
+		return myHeap[myPositions[aHandle.index]].item;
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr bool IndexedPriorityQueue<T, C, D, Alloc>::contains(handle_type aHandle) const
+	{
+		return aHandle.index < myGenerations.size() && myGenerations[aHandle.index] == aHandle.generation;
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr bool IndexedPriorityQueue<T, C, D, Alloc>::empty() const noexcept
+	{
+		return myHeap.empty();
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr auto IndexedPriorityQueue<T, C, D, Alloc>::size() const noexcept -> size_type
+	{
+		return myHeap.size();
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr auto IndexedPriorityQueue<T, C, D, Alloc>::top() const noexcept -> const_reference
+	{
+		return myHeap.front().item;
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr auto IndexedPriorityQueue<T, C, D, Alloc>::top_handle() const noexcept -> handle_type
+	{
+		const std::uint32_t slot = myHeap.front().slot;
+		return handle_type{slot, myGenerations[slot]};
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr auto IndexedPriorityQueue<T, C, D, Alloc>::push(const T& aItem) -> handle_type
+	{
+		return emplace(aItem);
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr auto IndexedPriorityQueue<T, C, D, Alloc>::push(T&& aItem) -> handle_type
+	{
+		return emplace(std::move(aItem));
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	template<typename... Args> requires std::constructible_from<T, Args...>
+	constexpr auto IndexedPriorityQueue<T, C, D, Alloc>::emplace(Args&&... someArgs) -> handle_type
+	{
+		const size_type position = myHeap.size();
+
+		myHeap.emplace_back(T(std::forward<Args>(someArgs)...));
+
+		const handle_type handle = AddSlot(position);
+		SiftUp(position);
+
+		return handle;
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr void IndexedPriorityQueue<T, C, D, Alloc>::pop()
+	{
+		assert(!empty() && "Queue is empty");
+
+		FreeSlot(myHeap.front().slot);
+
+		if (myHeap.size() > 1)
+		{
+			Place(0, std::move(myHeap.back()));
+			myHeap.pop_back();
+
+			SiftDown(0);
+		}
+		else
+		{
+			myHeap.pop_back();
+		}
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr void IndexedPriorityQueue<T, C, D, Alloc>::update(handle_type aHandle, const T& aItem)
+	{
+		assert(contains(aHandle) && "Handle is stale");
+
+		const size_type position = myPositions[aHandle.index];
+		const bool up = Before(aItem, myHeap[position].item);
+
+		myHeap[position].item = aItem;
+
+		if (up)
+			SiftUp(position);
+		else
+			SiftDown(position);
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr void IndexedPriorityQueue<T, C, D, Alloc>::decrease_key(handle_type aHandle, const T& aItem)
+	{
+		assert(contains(aHandle) && "Handle is stale");
+
+		const size_type position = myPositions[aHandle.index];
+
+		assert(!Before(myHeap[position].item, aItem) && "Item may not have lower priority than before");
+
+		myHeap[position].item = aItem;
+		SiftUp(position);
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr bool IndexedPriorityQueue<T, C, D, Alloc>::erase(handle_type aHandle)
+	{
+		if (!contains(aHandle))
+			return false;
+
+		const size_type position = myPositions[aHandle.index];
+
+		FreeSlot(aHandle.index);
+
+		if (position + 1 == myHeap.size())
+		{
+			myHeap.pop_back();
+			return true;
+		}
+
+		// the last item fills the hole and may need to move either way
+
+		Place(position, std::move(myHeap.back()));
+		myHeap.pop_back();
+
+		if (position > 0 && Before(myHeap[position].item, myHeap[(position - 1) / D].item))
+			SiftUp(position);
+		else
+			SiftDown(position);
+
+		return true;
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	template<std::ranges::input_range R, class Out>
+		requires std::constructible_from<T, std::ranges::range_reference_t<R>>
+	constexpr void IndexedPriorityQueue<T, C, D, Alloc>::heapify(R&& aRange, Out aHandles)
+	{
+		if constexpr (std::ranges::sized_range<R>)
+			reserve(myHeap.size() + std::ranges::size(aRange));
+
+		for (auto&& item : aRange)
+		{
+			const size_type position = myHeap.size();
+			myHeap.emplace_back(T(std::forward<decltype(item)>(item)));
+
+			const handle_type handle = AddSlot(position);
+
+			if constexpr (!std::is_same_v<Out, std::nullptr_t>)
+				*aHandles++ = handle;
+		}
+
+		// Floyd's method, sift down every parent starting from the last
+
+		if (myHeap.size() > 1)
+		{
+			for (size_type i = (myHeap.size() - 2) / D + 1; i-- > 0;)
+			{
+				SiftDown(i);
+			}
+		}
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr void IndexedPriorityQueue<T, C, D, Alloc>::reserve(size_type aCapacity)
+	{
+		myHeap.reserve(aCapacity);
+		myPositions.reserve(aCapacity);
+		myGenerations.reserve(aCapacity);
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr void IndexedPriorityQueue<T, C, D, Alloc>::clear()
+	{
+		for (const Entry& entry : myHeap)
+		{
+			FreeSlot(entry.slot);
+		}
+
+		myHeap.clear();
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr bool IndexedPriorityQueue<T, C, D, Alloc>::Before(const T& lhs, const T& rhs)
+	{
+		if constexpr (C == pq::HeapType::Min)
+			return lhs < rhs;
+		else
+			return rhs < lhs;
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr auto IndexedPriorityQueue<T, C, D, Alloc>::AddSlot(size_type aPosition) -> handle_type
+	{
+		std::uint32_t slot = myFirstFree;
+
+		if (slot != NO_SLOT)
+		{
+			myFirstFree = myPositions[slot];
+			myPositions[slot] = static_cast<std::uint32_t>(aPosition);
+		}
+		else
+		{
+			slot = static_cast<std::uint32_t>(myPositions.size());
+
+			myPositions.emplace_back(static_cast<std::uint32_t>(aPosition));
+			myGenerations.emplace_back(details::slot::FIRST_GENERATION);
+		}
+
+		myHeap[aPosition].slot = slot;
+
+		return handle_type{slot, myGenerations[slot]};
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr void IndexedPriorityQueue<T, C, D, Alloc>::FreeSlot(std::uint32_t aSlot)
+	{
+		myPositions[aSlot] = myFirstFree;
+		myFirstFree = aSlot;
+
+		myGenerations[aSlot] = details::slot::NextGeneration(myGenerations[aSlot]);
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr void IndexedPriorityQueue<T, C, D, Alloc>::SiftUp(size_type aPosition)
+	{
+		Entry entry = std::move(myHeap[aPosition]);
+
+		while (aPosition > 0)
+		{
+			const size_type parent = (aPosition - 1) / D;
+			if (!Before(entry.item, myHeap[parent].item))
+				break;
+
+			Place(aPosition, std::move(myHeap[parent]));
+			aPosition = parent;
+		}
+
+		Place(aPosition, std::move(entry));
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr void IndexedPriorityQueue<T, C, D, Alloc>::SiftDown(size_type aPosition)
+	{
+		const size_type count = myHeap.size();
+
+		Entry entry = std::move(myHeap[aPosition]);
+
+		while (true)
+		{
+			const size_type first = aPosition * D + 1;
+			if (first >= count)
+				break;
+
+			const size_type last = (std::min)(first + D, count);
+
+			size_type best = first;
+			for (size_type child = first + 1; child < last; ++child)
+			{
+				if (Before(myHeap[child].item, myHeap[best].item))
+					best = child;
+			}
+
+			if (!Before(myHeap[best].item, entry.item))
+				break;
+
+			Place(aPosition, std::move(myHeap[best]));
+			aPosition = best;
+		}
+
+		Place(aPosition, std::move(entry));
+	}
+
+	template<typename T, pq::HeapType C, std::size_t D, class Alloc>
+	constexpr void IndexedPriorityQueue<T, C, D, Alloc>::Place(size_type aPosition, Entry&& aEntry)
+	{
+		myPositions[aEntry.slot] = static_cast<std::uint32_t>(aPosition);
+		myHeap[aPosition] = std::move(aEntry);
+	}
+
+	namespace pmr
+	{
+		template<typename T, pq::HeapType C = pq::HeapType::Min, std::size_t D = 4>
+		using IndexedPriorityQueue = CommonUtilities::IndexedPriorityQueue<T, C, D, std::pmr::polymorphic_allocator<T>>;
+	}
+}
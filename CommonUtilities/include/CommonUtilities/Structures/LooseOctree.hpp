@@ -0,0 +1,925 @@
+#pragma once
+
+#include <vector>
+#include <shared_mutex>
+#include <concepts>
+#include <cassert>
+
+#include <CommonUtilities/Math/AABB.hpp>
+#include <CommonUtilities/Math/Vector3.hpp>
+#include <CommonUtilities/Math/Frustum.hpp>
+#include <CommonUtilities/Math/Intersection.hpp>
+#include <CommonUtilities/Math/Sphere.hpp>
+
+#include <CommonUtilities/Structures/Octree.hpp>
+#include <CommonUtilities/Structures/FreeVector.hpp>
+#include <CommonUtilities/Structures/SlotMap.hpp>
+#include <CommonUtilities/Alloc/FrameAlloc.hpp>
+
+namespace CommonUtilities
+{
+	/// Loose octree where every node's bounds are its cell enlarged by a looseness factor, so that each element
+	/// lives in exactly one node, chosen by its centre and how deep it can go while still fitting. Unlike Octree,
+	/// elements spanning several cells are never duplicated, insertion descends a single path, erasure unlinks
+	/// the element directly, and queries need no pass to remove duplicates. In exchange, queries visit more
+	/// nodes since the loose bounds of siblings overlap.
+	///
+	/// Has the same interface as Octree and is preferable when elements vary a lot in size or are updated often.
+	///
+	template<std::equality_comparable T, typename Alloc = std::allocator<T>>
+	class LooseOctree
+	{
+		typedef std::shared_mutex MutexType;
+
+	public:
+		using ElementType	= T;
+		using ValueType		= std::remove_const_t<T>;
+		using SizeType		= int;
+		using allocator_type	= Alloc;
+		using Handle			= SlotHandle;
+
+		static constexpr SizeType ourChildCount = 8;
+
+		struct Element
+		{
+			cu::AABBf	aabb;	// aabb encompassing the item
+			ValueType	item;
+		};
+
+		LooseOctree();
+
+		/// \param Allocator: Allocator that the elements and nodes are allocated with.
+		///
+		explicit LooseOctree(const Alloc& aAllocator);
+
+		/// \param RootAABB: Bounds of the root cell.
+		/// \param MaxElements: Elements a leaf holds before it is subdivided.
+		/// \param MaxDepth: Depth at which leaves are no longer subdivided.
+		/// \param Looseness: Factor each cell is enlarged by to get the node's bounds, at least 1. At 2, any element
+		///                   no larger than a cell fits in the node whose cell holds its centre.
+		/// \param Allocator: Allocator that the elements and nodes are allocated with.
+		///
+		LooseOctree(const cu::AABBf& aRootAABB, int aMaxElements = 16, int aMaxDepth = 16, float aLooseness = 2.0f, const Alloc& aAllocator = Alloc());
+
+		LooseOctree(const LooseOctree&) = default;
+		LooseOctree(LooseOctree&&) = default;
+
+		LooseOctree& operator=(const LooseOctree&) = default;
+		LooseOctree& operator=(LooseOctree&&) = default;
+
+		NODISC allocator_type get_allocator() const;
+
+		int ElementCount() const;
+
+		const cu::AABBf& GetRootAABB() const;
+
+		void SetRootAABB(const cu::AABBf& aRootAABB);
+
+		/// Inserts given element into the tree.
+		///
+		/// \param AABB: Bounding box encompassing item.
+		/// \param Args: Constructor parameters for item.
+		///
+		/// \returns Index to element, can be used to directly access it when, e.g., erasing it from the tree.
+		///
+		template<typename... Args> requires std::constructible_from<T, Args...>
+		auto Insert(const cu::AABBf& aAABB, Args&&... someArgs) -> SizeType;
+
+		/// Attempts to erase element from tree.
+		///
+		/// \param Index: Index to element to erase.
+		///
+		/// \returns True if successfully removed the element, otherwise false.
+		///
+		bool Erase(SizeType aIndex);
+
+		/// Inserts given element into the tree.
+		///
+		/// \param AABB: Bounding box encompassing item.
+		/// \param Args: Constructor parameters for item.
+		///
+		/// \returns Handle to element that, unlike an index, is detected as stale once the element is erased.
+		///          Invalid if the element is outside the tree.
+		///
+		template<typename... Args> requires std::constructible_from<T, Args...>
+		auto InsertHandle(const cu::AABBf& aAABB, Args&&... someArgs) -> Handle;
+
+		/// Attempts to erase element from tree.
+		///
+		/// \param Handle: Handle to element to erase.
+		///
+		/// \returns True if successfully removed the element, false if it was already erased.
+		///
+		bool Erase(Handle aHandle);
+
+		/// \returns Whether the handle refers to an element that has not been erased.
+		///
+		NODISC bool Contains(Handle aHandle) const;
+
+		/// \returns Pointer to element, or nullptr if it has been erased.
+		///
+		NODISC auto Find(Handle aHandle) -> ValueType*;
+
+		/// \returns Const pointer to element, or nullptr if it has been erased.
+		///
+		NODISC auto Find(Handle aHandle) const -> const ValueType*;
+
+		/// Converts an index, e.g., from a query, to a handle that can be held onto.
+		///
+		/// \param Index: Index to a valid element.
+		///
+		NODISC auto GetHandle(SizeType aIndex) const -> Handle;
+
+		/// Updates the given element with new data.
+		///
+		/// \param Index: index to element.
+		/// \param Args: Data to update the current element.
+		///
+		/// \returns True if successfully updated the element, otherwise false.
+		///
+		template<typename... Args> requires std::constructible_from<T, Args...>
+		bool Update(SizeType aIndex, Args&&... someArgs);
+
+		/// Retrieves an element.
+		///
+		/// \param Index: index to element.
+		///
+		NODISC auto Get(SizeType aIndex) -> ValueType&;
+
+		/// Retrieves an element.
+		///
+		/// \param Index: index to element.
+		///
+		NODISC auto Get(SizeType aIndex) const -> const ValueType&;
+
+		/// Retrieves the aabb encompassing item.
+		///
+		/// \param Index: index to item.
+		///
+		NODISC auto GetAABB(SizeType aIndex) const -> const cu::AABBf&;
+
+		/// Queries the tree for elements.
+		///
+		/// \param Frustum: Frustum to search for overlapping elements.
+		///
+		/// \returns List of entities intersecting the frustum.
+		///
+		template<typename ResultAlloc>
+		void Query(const cu::Frustumf& aFrustum, std::vector<SizeType, ResultAlloc>& outResult) const;
+
+		/// Queries the tree for elements.
+		///
+		/// \param Frustum: Frustum to search for overlapping elements.
+		///
+		/// \returns List of entities intersecting the frustum.
+		///
+		template<typename ResultAlloc>
+		void QueryNoDepth(const cu::Frustumf& aFrustum, std::vector<SizeType, ResultAlloc>& outResult) const;
+
+		/// Queries the tree for elements.
+		///
+		/// \param StartPos: Start of the segment.
+		/// \param EndPos: End of the segment.
+		///
+		/// \returns List of entities intersecting the segment.
+		///
+		template<typename ResultAlloc>
+		void Query(const cu::Vector3f& aStartPos, const cu::Vector3f& aEndPos, std::vector<SizeType, ResultAlloc>& outResult) const;
+
+		/// Queries the tree for elements.
+		///
+		/// \param AABB: Bounding box to search for overlapping elements.
+		///
+		/// \returns List of entities intersecting the aabb.
+		///
+		template<typename ResultAlloc>
+		void Query(const cu::AABBf& aAABB, std::vector<SizeType, ResultAlloc>& outResult) const;
+
+		/// Queries the tree for elements.
+		///
+		/// \param Sphere: Sphere to search for overlapping elements.
+		///
+		/// \returns List of entities intersecting the sphere.
+		///
+		template<typename ResultAlloc>
+		void Query(const cu::Spheref& aSphere, std::vector<SizeType, ResultAlloc>& outResult) const;
+
+		/// Queries the tree for elements.
+		///
+		/// \param Point: Point to search for overlapping elements.
+		///
+		/// \returns List of entities intersecting the point.
+		///
+		template<typename ResultAlloc>
+		void Query(const cu::Vector3f& aPoint, std::vector<SizeType, ResultAlloc>& outResult) const;
+
+		/// Removes the children of nodes whose subtrees have become empty, should be called after items have been erased.
+		///
+		void Cleanup();
+
+		/// Clears the tree.
+		///
+		void Clear();
+
+		/// \returns Loose bounds of every node.
+		///
+		std::vector<cu::AABBf> GetBranchAABBs() const;
+
+	private:
+		template<typename U>
+		using ScratchVector = std::vector<U, FrameAlloc<U>>; // only valid within a FrameAllocator::Scope on the scratch
+
+		template<typename U>
+		using Rebind = typename std::allocator_traits<Alloc>::template rebind_alloc<U>;
+
+		struct Node
+		{
+			SizeType firstChild		{-1};	// points to first of the eight children, -1 for leaf
+			SizeType firstElement	{-1};	// points to first element that lives in this node
+			SizeType count			{0};	// number of elements in this node, not counting its children
+		};
+
+		struct ElementLink
+		{
+			SizeType node	{-1};	// node the element lives in
+			SizeType prev	{-1};	// previous element in the same node, or -1 if first
+			SizeType next	{-1};	// next element in the same node, or -1 if last
+		};
+
+		struct NodeReg
+		{
+			cu::AABBf	aabb;	// cell of the node, not its loose bounds
+			SizeType	index {0};
+			SizeType	depth {0};
+		};
+
+		struct NodeRegQuery
+		{
+			cu::AABBf	aabb;
+			SizeType	index {0};
+			bool		insideQuery {false};
+		};
+
+		template<typename... Args>
+		auto InsertImpl(const cu::AABBf& aAABB, Args&&... someArgs) -> SizeType;
+
+		bool EraseImpl(SizeType aIndex);
+
+		bool ContainsImpl(Handle aHandle) const;
+
+		/// Descends from Node along the children holding the element's centre for as long as it fits in their
+		/// loose bounds, then links it there and subdivides the node if it became too full.
+		///
+		void NodeInsert(const NodeReg& aNode, SizeType aEltIndex);
+
+		/// Creates the children of a full leaf and moves down the elements that fit in them. Is not subdivided
+		/// if none of them would fit.
+		///
+		void Subdivide(const NodeReg& aNode);
+
+		void Link(SizeType aNodeIndex, SizeType aEltIndex);
+		void Unlink(SizeType aEltIndex);
+
+		/// Visits the nodes whose loose bounds overlap the query, testing the elements individually unless the
+		/// query contains the node's loose bounds. The root's own elements are always tested, since elements
+		/// that stick out of the tree end up there.
+		///
+		template<typename ResultAlloc, typename OverlapsFunc, typename ContainsFunc, typename ElementFunc>
+		void QueryImpl(std::vector<SizeType, ResultAlloc>& outResult, const OverlapsFunc& aOverlaps, const ContainsFunc& aContains, const ElementFunc& aElementTest) const;
+
+		NODISC bool Fits(const cu::AABBf& aCell, const cu::AABBf& aAABB) const;
+		NODISC auto Loosen(const cu::AABBf& aCell) const -> cu::AABBf;
+
+		NODISC static auto ChildAABB(const cu::AABBf& aCell, SizeType aChild) -> cu::AABBf;
+		NODISC static auto ChildIndex(const cu::AABBf& aCell, const cu::Vector3f& aPoint) -> SizeType;
+
+		static bool IsLeaf(const Node& aNode);
+		static bool IsBranch(const Node& aNode);
+
+		cu::FreeVector<Element, Rebind<Element>>	myElements;	// all the elements
+		cu::FreeVector<Node, Rebind<Node>>			myNodes;
+
+		std::vector<ElementLink, Rebind<ElementLink>> myLinks; // of each element slot, which node it lives in
+		std::vector<std::uint32_t, Rebind<std::uint32_t>> myGenerations; // of each element slot, advanced on erase to detect stale handles
+
+		cu::AABBf	myRootAABB;
+
+		SizeType	myMaxElements	{16}; // max elements before subdivision
+		SizeType	myMaxDepth		{8}; // max depth before no more leaves will be created
+		float		myLooseness		{2.0f};
+
+		mutable MutexHolder<MutexType> myMutex = {};
+	};
+
+	template<std::equality_comparable T, typename Alloc>
+	inline LooseOctree<T, Alloc>::LooseOctree() : LooseOctree({Vector3f(-4096.0f), Vector3f(4096.0f) })
+	{
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline LooseOctree<T, Alloc>::LooseOctree(const Alloc& aAllocator) : LooseOctree({Vector3f(-4096.0f), Vector3f(4096.0f) }, 16, 16, 2.0f, aAllocator)
+	{
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline LooseOctree<T, Alloc>::LooseOctree(const cu::AABBf& aRootAABB, int aMaxElements, int aMaxDepth, float aLooseness, const Alloc& aAllocator)
+		: myElements(aAllocator), myNodes(aAllocator), myLinks(aAllocator), myGenerations(aAllocator)
+		, myRootAABB(aRootAABB), myMaxElements(aMaxElements), myMaxDepth(aMaxDepth), myLooseness(aLooseness)
+	{
+		assert(aLooseness >= 1.0f && "Nodes cannot be smaller than their cells");
+
+		myNodes.emplace();
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline auto LooseOctree<T, Alloc>::get_allocator() const -> allocator_type
+	{
+		return allocator_type(myNodes.get_allocator());
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline int LooseOctree<T, Alloc>::ElementCount() const
+	{
+		return (int)myElements.count();
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline const cu::AABBf& LooseOctree<T, Alloc>::GetRootAABB() const
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+		return myRootAABB;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline void LooseOctree<T, Alloc>::SetRootAABB(const cu::AABBf& aRootAABB)
+	{
+		std::scoped_lock<MutexType> lock(myMutex);
+
+		if (myRootAABB == aRootAABB)
+			return;
+
+		myRootAABB = aRootAABB;
+
+		myNodes.clear();
+		myNodes.emplace();
+
+		myElements.for_each_valid([this](std::size_t aIndex, const Element&)
+			{
+				NodeInsert({ myRootAABB, 0, 0 }, (SizeType)aIndex); // every element is linked exactly once, so no need to gather them first
+			});
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename... Args> requires std::constructible_from<T, Args...>
+	inline auto LooseOctree<T, Alloc>::Insert(const cu::AABBf& aAABB, Args&&... someArgs) -> SizeType
+	{
+		std::scoped_lock<MutexType> lock(myMutex);
+		return InsertImpl(aAABB, std::forward<Args>(someArgs)...);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline bool LooseOctree<T, Alloc>::Erase(SizeType aIndex)
+	{
+		std::scoped_lock<MutexType> lock(myMutex);
+		return EraseImpl(aIndex);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename... Args> requires std::constructible_from<T, Args...>
+	inline auto LooseOctree<T, Alloc>::InsertHandle(const cu::AABBf& aAABB, Args&&... someArgs) -> Handle
+	{
+		std::scoped_lock<MutexType> lock(myMutex);
+
+		const SizeType index = InsertImpl(aAABB, std::forward<Args>(someArgs)...);
+		if (index == -1)
+			return Handle{};
+
+		return Handle{static_cast<std::uint32_t>(index), myGenerations[index]};
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline bool LooseOctree<T, Alloc>::Erase(Handle aHandle)
+	{
+		std::scoped_lock<MutexType> lock(myMutex);
+
+		if (!ContainsImpl(aHandle))
+			return false;
+
+		return EraseImpl(static_cast<SizeType>(aHandle.index));
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline bool LooseOctree<T, Alloc>::Contains(Handle aHandle) const
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+		return ContainsImpl(aHandle);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline auto LooseOctree<T, Alloc>::Find(Handle aHandle) -> ValueType*
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+		return ContainsImpl(aHandle) ? &myElements[aHandle.index].item : nullptr;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline auto LooseOctree<T, Alloc>::Find(Handle aHandle) const -> const ValueType*
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+		return ContainsImpl(aHandle) ? &myElements[aHandle.index].item : nullptr;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline auto LooseOctree<T, Alloc>::GetHandle(SizeType aIndex) const -> Handle
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+
+		assert(myElements.valid(aIndex) && "Element is not valid");
+		return Handle{static_cast<std::uint32_t>(aIndex), myGenerations[aIndex]};
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename... Args>
+	inline auto LooseOctree<T, Alloc>::InsertImpl(const cu::AABBf& aAABB, Args&&... someArgs) -> SizeType
+	{
+		if (!myRootAABB.Overlaps(aAABB)) // dont attempt to add if outside boundary
+			return -1;
+
+		const auto aIndex = (SizeType)myElements.emplace(aAABB, std::forward<Args>(someArgs)...);
+
+		if (aIndex >= static_cast<SizeType>(myGenerations.size()))
+		{
+			myGenerations.resize(aIndex + 1, details::slot::FIRST_GENERATION);
+			myLinks.resize(aIndex + 1);
+		}
+
+		NodeInsert({ myRootAABB, 0, 0 }, aIndex);
+
+		return aIndex;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline bool LooseOctree<T, Alloc>::EraseImpl(SizeType aIndex)
+	{
+		if (!myElements.valid(aIndex))
+			return false;
+
+		Unlink(aIndex);
+
+		myElements.erase(aIndex);
+		myGenerations[aIndex] = details::slot::NextGeneration(myGenerations[aIndex]);
+
+		return true;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline bool LooseOctree<T, Alloc>::ContainsImpl(Handle aHandle) const
+	{
+		// the generation only advances on erase, so a match means the element is still there
+
+		return aHandle.index < myGenerations.size() && myGenerations[aHandle.index] == aHandle.generation && myElements.valid(aHandle.index);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename... Args> requires std::constructible_from<T, Args...>
+	inline bool LooseOctree<T, Alloc>::Update(SizeType aIndex, Args&&... someArgs)
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+
+		if (aIndex >= myElements.size() || !myElements.valid(aIndex))
+			return false;
+
+		myElements[aIndex].item = T{std::forward<Args>(someArgs)...};
+
+		return true;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	auto LooseOctree<T, Alloc>::Get(SizeType aIndex) -> ValueType&
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+		return myElements[aIndex].item;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	auto LooseOctree<T, Alloc>::Get(SizeType aIndex) const -> const ValueType&
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+		return myElements[aIndex].item;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline auto LooseOctree<T, Alloc>::GetAABB(SizeType aIndex) const -> const cu::AABBf&
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+		return myElements[aIndex].aabb;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc>
+	inline void LooseOctree<T, Alloc>::Query(const cu::Frustumf& aFrustum, std::vector<SizeType, ResultAlloc>& outResult) const
+	{
+		QueryImpl(outResult,
+			[&aFrustum](const cu::AABBf& aAABB) { return aFrustum.IsInside(aAABB); },
+			[&aFrustum](const cu::AABBf& aAABB) { return aFrustum.Contains(aAABB); },
+			[&aFrustum](const cu::AABBf& aAABB) { return aFrustum.IsInside(aAABB); });
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc>
+	inline void LooseOctree<T, Alloc>::QueryNoDepth(const cu::Frustumf& aFrustum, std::vector<SizeType, ResultAlloc>& outResult) const
+	{
+		QueryImpl(outResult,
+			[&aFrustum](const cu::AABBf& aAABB) { return aFrustum.IsInsideNoDepth(aAABB); },
+			[&aFrustum](const cu::AABBf& aAABB) { return aFrustum.ContainsNoDepth(aAABB); },
+			[&aFrustum](const cu::AABBf& aAABB) { return aFrustum.IsInsideNoDepth(aAABB); });
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc>
+	inline void LooseOctree<T, Alloc>::Query(const cu::Vector3f& aStartPos, const cu::Vector3f& aEndPos, std::vector<SizeType, ResultAlloc>& outResult) const
+	{
+		QueryImpl(outResult,
+			[&aStartPos, &aEndPos](const cu::AABBf& aAABB) { return cu::IntersectionAABBSegment(aAABB, aStartPos, aEndPos); },
+			[](const cu::AABBf&) { return false; },
+			[&aStartPos, &aEndPos](const cu::AABBf& aAABB) { return cu::IntersectionAABBSegment(aAABB, aStartPos, aEndPos); });
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc>
+	inline void LooseOctree<T, Alloc>::Query(const cu::AABBf& aAABB, std::vector<SizeType, ResultAlloc>& outResult) const
+	{
+		QueryImpl(outResult,
+			[&aAABB](const cu::AABBf& aOther) { return aAABB.Overlaps(aOther); },
+			[&aAABB](const cu::AABBf& aOther) { return aAABB.Contains(aOther); },
+			[&aAABB](const cu::AABBf& aOther) { return aOther.Overlaps(aAABB); });
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc>
+	inline void LooseOctree<T, Alloc>::Query(const cu::Spheref& aSphere, std::vector<SizeType, ResultAlloc>& outResult) const
+	{
+		QueryImpl(outResult,
+			[&aSphere](const cu::AABBf& aAABB) { return aSphere.Overlaps(aAABB); },
+			[](const cu::AABBf&) { return false; },
+			[&aSphere](const cu::AABBf& aAABB) { return aSphere.Overlaps(aAABB); });
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc>
+	inline void LooseOctree<T, Alloc>::Query(const cu::Vector3f& aPoint, std::vector<SizeType, ResultAlloc>& outResult) const
+	{
+		Query(cu::AABBf(aPoint, aPoint), outResult);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline void LooseOctree<T, Alloc>::Cleanup()
+	{
+		std::scoped_lock<MutexType> lock(myMutex);
+
+		FrameAllocator::Scope scope(details::frame::GetScratch());
+
+		if (myNodes.empty())
+			return;
+
+		ScratchVector<SizeType> branches(details::frame::GetScratch());
+		ScratchVector<SizeType> toProcess(details::frame::GetScratch());
+
+		toProcess.reserve(ourChildCount * myMaxDepth / 2);
+
+		if (IsBranch(myNodes[0]))
+		{
+			toProcess.emplace_back(0); // push root
+		}
+
+		while (!toProcess.empty())
+		{
+			const SizeType index = toProcess.back();
+			toProcess.pop_back();
+
+			branches.emplace_back(index);
+
+			for (int i = 0; i < ourChildCount; ++i)
+			{
+				const int childIndex = myNodes[index].firstChild + i;
+
+				if (IsBranch(myNodes[childIndex]))
+				{
+					toProcess.emplace_back(childIndex);
+				}
+			}
+		}
+
+		for (auto it = branches.rbegin(); it != branches.rend(); ++it) // children before parents, so empty subtrees collapse all the way up
+		{
+			Node& node = myNodes[*it];
+
+			int numEmpty = 0;
+			for (int i = 0; i < ourChildCount; ++i)
+			{
+				const Node& child = myNodes[node.firstChild + i];
+
+				if (IsLeaf(child) && child.count == 0)
+				{
+					++numEmpty;
+				}
+			}
+
+			if (numEmpty == ourChildCount)
+			{
+				for (int i = ourChildCount - 1; i >= 0; --i)
+				{
+					myNodes.erase(node.firstChild + i);
+				}
+
+				node.firstChild = -1; // elements too large for the children stay
+			}
+		}
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline void LooseOctree<T, Alloc>::Clear()
+	{
+		std::scoped_lock<MutexType> lock(myMutex);
+
+		myElements.for_each_valid([this](std::size_t aIndex, const Element&)
+			{
+				myGenerations[aIndex] = details::slot::NextGeneration(myGenerations[aIndex]); // handles stay stale after the slots are reused
+			});
+
+		myElements.clear();
+		myNodes.clear();
+
+		myNodes.emplace(); // root
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline std::vector<cu::AABBf> LooseOctree<T, Alloc>::GetBranchAABBs() const
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+
+		FrameAllocator::Scope scope(details::frame::GetScratch());
+
+		std::vector<cu::AABBf> result;
+
+		if (myNodes.empty())
+			return result;
+
+		ScratchVector<NodeReg> toProcess(details::frame::GetScratch());
+		toProcess.reserve(ourChildCount * myMaxDepth / 2);
+
+		toProcess.emplace_back(myRootAABB, 0, 0);
+
+		while (!toProcess.empty())
+		{
+			const auto nd = toProcess.back();
+			toProcess.pop_back();
+
+			result.emplace_back(Loosen(nd.aabb));
+
+			if (IsBranch(myNodes[nd.index]))
+			{
+				const auto fc = myNodes[nd.index].firstChild;
+
+				for (SizeType i = 0; i < ourChildCount; ++i)
+				{
+					toProcess.emplace_back(ChildAABB(nd.aabb, i), fc + i, nd.depth + 1);
+				}
+			}
+		}
+
+		return result;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline void LooseOctree<T, Alloc>::NodeInsert(const NodeReg& aNode, SizeType aEltIndex)
+	{
+		const cu::AABBf& aabb		= myElements[aEltIndex].aabb;
+		const cu::Vector3f center	= aabb.GetCenter();
+
+		NodeReg nd = aNode;
+
+		while (IsBranch(myNodes[nd.index]))
+		{
+			const SizeType child		= ChildIndex(nd.aabb, center);
+			const cu::AABBf childAABB	= ChildAABB(nd.aabb, child);
+
+			if (!Fits(childAABB, aabb))
+				break;
+
+			nd = { childAABB, myNodes[nd.index].firstChild + child, nd.depth + 1 };
+		}
+
+		Link(nd.index, aEltIndex);
+
+		const Node& node = myNodes[nd.index];
+		if (IsLeaf(node) && node.count > myMaxElements && nd.depth < myMaxDepth)
+		{
+			Subdivide(nd);
+		}
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline void LooseOctree<T, Alloc>::Subdivide(const NodeReg& aNode)
+	{
+		bool anyFits = false;
+		for (SizeType elt = myNodes[aNode.index].firstElement; elt != -1 && !anyFits; elt = myLinks[elt].next)
+		{
+			const cu::AABBf& aabb = myElements[elt].aabb;
+			anyFits = Fits(ChildAABB(aNode.aabb, ChildIndex(aNode.aabb, aabb.GetCenter())), aabb);
+		}
+
+		if (!anyFits) // nodes whose elements are all too large for the children cannot get divided
+			return;
+
+		const auto fc = myNodes.emplace();
+		for (int i = 0; i < ourChildCount - 1; ++i)
+		{
+			myNodes.emplace();
+		}
+
+		myNodes[aNode.index].firstChild = (SizeType)fc;
+
+		for (SizeType elt = myNodes[aNode.index].firstElement; elt != -1;)
+		{
+			const SizeType next = myLinks[elt].next;
+
+			const cu::AABBf& aabb		= myElements[elt].aabb;
+			const SizeType child		= ChildIndex(aNode.aabb, aabb.GetCenter());
+			const cu::AABBf childAABB	= ChildAABB(aNode.aabb, child);
+
+			if (Fits(childAABB, aabb))
+			{
+				Unlink(elt);
+				NodeInsert({ childAABB, (SizeType)fc + child, aNode.depth + 1 }, elt);
+			}
+
+			elt = next;
+		}
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline void LooseOctree<T, Alloc>::Link(SizeType aNodeIndex, SizeType aEltIndex)
+	{
+		Node& node = myNodes[aNodeIndex];
+
+		myLinks[aEltIndex] = { aNodeIndex, -1, node.firstElement };
+
+		if (node.firstElement != -1)
+		{
+			myLinks[node.firstElement].prev = aEltIndex;
+		}
+
+		node.firstElement = aEltIndex;
+		++node.count;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline void LooseOctree<T, Alloc>::Unlink(SizeType aEltIndex)
+	{
+		const ElementLink link = myLinks[aEltIndex];
+		Node& node = myNodes[link.node];
+
+		if (link.prev == -1)
+		{
+			node.firstElement = link.next;
+		}
+		else
+		{
+			myLinks[link.prev].next = link.next;
+		}
+
+		if (link.next != -1)
+		{
+			myLinks[link.next].prev = link.prev;
+		}
+
+		--node.count;
+
+		assert(node.count >= 0 && "Node cannot have a negative count of elements");
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc, typename OverlapsFunc, typename ContainsFunc, typename ElementFunc>
+	inline void LooseOctree<T, Alloc>::QueryImpl(std::vector<SizeType, ResultAlloc>& outResult, const OverlapsFunc& aOverlaps, const ContainsFunc& aContains, const ElementFunc& aElementTest) const
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+
+		FrameAllocator::Scope scope(details::frame::GetScratch());
+
+		outResult.clear();
+
+		if (myNodes.empty())
+			return;
+
+		ScratchVector<NodeRegQuery> toProcess(details::frame::GetScratch());
+		toProcess.reserve(ourChildCount * myMaxDepth / 2);
+
+		toProcess.emplace_back(myRootAABB, 0, false);
+
+		while (!toProcess.empty())
+		{
+			const auto nd = toProcess.back();
+			toProcess.pop_back();
+
+			const Node& node = myNodes[nd.index];
+
+			if (nd.insideQuery)
+			{
+				for (SizeType elt = node.firstElement; elt != -1; elt = myLinks[elt].next)
+				{
+					outResult.emplace_back(elt);
+				}
+
+				if (IsBranch(node))
+				{
+					for (SizeType i = 0; i < ourChildCount; ++i)
+					{
+						toProcess.emplace_back(nd.aabb, node.firstChild + i, true); // bounds are no longer needed
+					}
+				}
+			}
+			else
+			{
+				for (SizeType elt = node.firstElement; elt != -1; elt = myLinks[elt].next)
+				{
+					if (aElementTest(myElements[elt].aabb))
+					{
+						outResult.emplace_back(elt);
+					}
+				}
+
+				if (IsBranch(node))
+				{
+					for (SizeType i = 0; i < ourChildCount; ++i)
+					{
+						const cu::AABBf childAABB = ChildAABB(nd.aabb, i);
+						const cu::AABBf looseAABB = Loosen(childAABB);
+
+						if (aContains(looseAABB))
+						{
+							toProcess.emplace_back(childAABB, node.firstChild + i, true);
+						}
+						else if (aOverlaps(looseAABB))
+						{
+							toProcess.emplace_back(childAABB, node.firstChild + i, false);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline bool LooseOctree<T, Alloc>::Fits(const cu::AABBf& aCell, const cu::AABBf& aAABB) const
+	{
+		return Loosen(aCell).Contains(aAABB);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline auto LooseOctree<T, Alloc>::Loosen(const cu::AABBf& aCell) const -> cu::AABBf
+	{
+		const cu::Vector3f center	= aCell.GetCenter();
+		const cu::Vector3f extends	= aCell.GetExtends() * myLooseness;
+
+		return cu::AABBf(center - extends, center + extends);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline auto LooseOctree<T, Alloc>::ChildAABB(const cu::AABBf& aCell, SizeType aChild) -> cu::AABBf
+	{
+		// same order as Octree, bit 0 is set for the children below the centre in x, bit 1 in y, and bit 2 in z
+
+		const cu::Vector3f c	= aCell.GetCenter();
+		const cu::Vector3f& min	= aCell.GetMin();
+		const cu::Vector3f& max	= aCell.GetMax();
+
+		return cu::AABBf(
+			(aChild & 1) ? min.x : c.x, (aChild & 2) ? min.y : c.y, (aChild & 4) ? min.z : c.z,
+			(aChild & 1) ? c.x : max.x, (aChild & 2) ? c.y : max.y, (aChild & 4) ? c.z : max.z);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline auto LooseOctree<T, Alloc>::ChildIndex(const cu::AABBf& aCell, const cu::Vector3f& aPoint) -> SizeType
+	{
+		const cu::Vector3f c = aCell.GetCenter();
+		return (aPoint.x < c.x ? 1 : 0) | (aPoint.y < c.y ? 2 : 0) | (aPoint.z < c.z ? 4 : 0);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline bool LooseOctree<T, Alloc>::IsLeaf(const Node& aNode)
+	{
+		return aNode.firstChild == -1;
+	}
+	template<std::equality_comparable T, typename Alloc>
+	inline bool LooseOctree<T, Alloc>::IsBranch(const Node& aNode)
+	{
+		return aNode.firstChild != -1;
+	}
+
+	namespace pmr
+	{
+		template<std::equality_comparable T>
+		using LooseOctree = CommonUtilities::LooseOctree<T, std::pmr::polymorphic_allocator<T>>;
+	}
+}
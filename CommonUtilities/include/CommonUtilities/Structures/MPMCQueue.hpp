@@ -0,0 +1,314 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <iterator>
+#include <new>
+#include <cstdint>
+#include <cstddef>
+#include <type_traits>
+
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+	/// Lock-free bounded queue for any number of producers and consumers. Each slot has a sequence number
+	/// that tells whether it is ready to be written or read in the current lap around the ring, so threads
+	/// only contend on the index they claim from and never wait on each other, except when a consumer
+	/// reaches a slot whose producer has claimed but not yet finished writing it.
+	///
+	/// Elements have to be nothrow move constructible, since a claimed slot cannot be given back.
+	///
+	/// Based on Dmitry Vyukov's bounded MPMC queue.
+	///
+	template<typename T> requires (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+	class MPMCQueue
+	{
+	public:
+		using value_type	= T;
+		using size_type		= std::size_t;
+
+		/// \param Capacity: Rounded up to a power of two.
+		///
+		explicit MPMCQueue(size_type aCapacity = 1024);
+		~MPMCQueue();
+
+		MPMCQueue(const MPMCQueue&) = delete;
+		MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+		/// \returns Approximate number of elements, may be outdated as soon as it is returned.
+		///
+		NODISC auto size() const noexcept -> size_type;
+
+		/// \returns Whether the queue appeared empty at the time of the call.
+		///
+		NODISC bool empty() const noexcept;
+
+		NODISC auto capacity() const noexcept -> size_type;
+
+		/// \returns Whether there was room for the element.
+		///
+		NODISC bool try_push(const T& aItem);
+
+		/// \returns Whether there was room for the element, it is left untouched if not.
+		///
+		NODISC bool try_push(T&& aItem);
+
+		/// Constructs the element in place when that cannot throw, otherwise before claiming a slot.
+		///
+		/// \returns Whether there was room for the element.
+		///
+		template<typename... Args> requires std::constructible_from<T, Args...>
+		NODISC bool try_emplace(Args&&... someArgs);
+
+		/// Pushes as many elements from the range as there is room for, claiming the slots all at once.
+		///
+		/// \returns Number of elements pushed from the start of the range.
+		///
+		template<std::input_iterator Iter> requires std::constructible_from<T, std::iter_reference_t<Iter>>
+		auto try_push(Iter aFirst, Iter aLast) -> size_type;
+
+		/// \returns Popped element, or nothing if empty.
+		///
+		NODISC auto try_pop() -> std::optional<T>;
+
+		/// Pops up to MaxCount elements into Out, claiming the slots all at once. If writing to Out throws,
+		/// the claimed elements that were not yet written are dropped.
+		///
+		/// \returns Number of elements popped.
+		///
+		template<std::weakly_incrementable OutIter> requires std::indirectly_writable<OutIter, T&&>
+		auto try_pop(OutIter aOut, size_type aMaxCount) -> size_type;
+
+	private:
+		struct Cell
+		{
+			std::atomic<size_type>				sequence;
+			alignas(T) std::byte				storage[sizeof(T)];
+
+			NODISC T* Get() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+		};
+
+		NODISC Cell& At(size_type aPosition) const noexcept;
+
+		/// Claims up to Count consecutive slots at Index whose sequence matches Offset.
+		///
+		/// \returns Position of the first claimed slot and how many were claimed.
+		///
+		NODISC auto Claim(std::atomic<size_type>& aIndex, size_type aCount, size_type aOffset) noexcept -> std::pair<size_type, size_type>;
+
+		alignas(std::hardware_destructive_interference_size) std::atomic<size_type> myTail {0};
+		alignas(std::hardware_destructive_interference_size) std::atomic<size_type> myHead {0};
+		alignas(std::hardware_destructive_interference_size) std::unique_ptr<Cell[]> myCells;
+		size_type myMask {0};
+	};
+
+	template<typename T> requires (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+	MPMCQueue<T>::MPMCQueue(size_type aCapacity)
+	{
+		size_type capacity = 2;
+		while (capacity < aCapacity) // capacity must be a power of two for the index mask
+			capacity <<= 1;
+
+		myCells = std::make_unique<Cell[]>(capacity);
+		myMask	= capacity - 1;
+
+		for (size_type i = 0; i < capacity; ++i)
+			myCells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+
+	template<typename T> requires (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+	MPMCQueue<T>::~MPMCQueue()
+	{
+		if constexpr (!std::is_trivially_destructible_v<T>)
+		{
+			const size_type tail = myTail.load(std::memory_order_relaxed);
+			for (size_type i = myHead.load(std::memory_order_relaxed); i != tail; ++i)
+				std::destroy_at(At(i).Get());
+		}
+	}
+
+	template<typename T> requires (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+	auto MPMCQueue<T>::size() const noexcept -> size_type
+	{
+		const size_type head = myHead.load(std::memory_order_relaxed);
+		const size_type tail = myTail.load(std::memory_order_relaxed);
+		return tail > head ? tail - head : 0;
+	}
+
+	template<typename T> requires (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+	bool MPMCQueue<T>::empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	template<typename T> requires (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+	auto MPMCQueue<T>::capacity() const noexcept -> size_type
+	{
+		return myMask + 1;
+	}
+
+	template<typename T> requires (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+	bool MPMCQueue<T>::try_push(const T& aItem)
+	{
+		return try_emplace(aItem);
+	}
+	template<typename T> requires (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+	bool MPMCQueue<T>::try_push(T&& aItem)
+	{
+		return try_emplace(std::move(aItem));
+	}
+
+	template<typename T> requires (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+	template<typename... Args> requires std::constructible_from<T, Args...>
+	bool MPMCQueue<T>::try_emplace(Args&&... someArgs)
+	{
+		if constexpr (std::is_nothrow_constructible_v<T, Args...>)
+		{
+			const auto [position, count] = Claim(myTail, 1, 0);
+			if (count == 0)
+				return false;
+
+			Cell& cell = At(position);
+
+			std::construct_at(cell.Get(), std::forward<Args>(someArgs)...);
+			cell.sequence.store(position + 1, std::memory_order_release); // publishes the element to consumers
+
+			return true;
+		}
+		else
+		{
+			if (size() >= capacity())
+				return false; // avoid constructing when clearly full
+
+			return try_emplace(T(std::forward<Args>(someArgs)...));
+		}
+	}
+
+	template<typename T> requires (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+	template<std::input_iterator Iter> requires std::constructible_from<T, std::iter_reference_t<Iter>>
+	auto MPMCQueue<T>::try_push(Iter aFirst, Iter aLast) -> size_type
+	{
+		if constexpr (std::forward_iterator<Iter> && std::is_nothrow_constructible_v<T, std::iter_reference_t<Iter>>)
+		{
+			const auto [position, count] = Claim(myTail, static_cast<size_type>(std::distance(aFirst, aLast)), 0);
+
+			for (size_type i = 0; i < count; ++i, ++aFirst)
+			{
+				Cell& cell = At(position + i);
+
+				std::construct_at(cell.Get(), *aFirst);
+				cell.sequence.store(position + i + 1, std::memory_order_release);
+			}
+
+			return count;
+		}
+		else // each element has to be constructed before its slot is claimed
+		{
+			size_type count = 0;
+			for (; aFirst != aLast; ++aFirst, ++count)
+			{
+				if (!try_emplace(*aFirst))
+					break;
+			}
+
+			return count;
+		}
+	}
+
+	template<typename T> requires (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+	auto MPMCQueue<T>::try_pop() -> std::optional<T>
+	{
+		const auto [position, count] = Claim(myHead, 1, 1);
+		if (count == 0)
+			return std::nullopt;
+
+		Cell& cell = At(position);
+
+		std::optional<T> result(std::move(*cell.Get()));
+		std::destroy_at(cell.Get());
+
+		cell.sequence.store(position + myMask + 1, std::memory_order_release); // frees the slot for the next lap
+
+		return result;
+	}
+
+	template<typename T> requires (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+	template<std::weakly_incrementable OutIter> requires std::indirectly_writable<OutIter, T&&>
+	auto MPMCQueue<T>::try_pop(OutIter aOut, size_type aMaxCount) -> size_type
+	{
+		const auto [position, count] = Claim(myHead, aMaxCount, 1);
+
+		size_type i = 0;
+
+		try
+		{
+			for (; i < count; ++i)
+			{
+				Cell& cell = At(position + i);
+
+				*aOut = std::move(*cell.Get());
+				++aOut;
+
+				std::destroy_at(cell.Get());
+				cell.sequence.store(position + i + myMask + 1, std::memory_order_release);
+			}
+		}
+		catch (...)
+		{
+			for (; i < count; ++i)
+			{
+				Cell& cell = At(position + i);
+
+				std::destroy_at(cell.Get());
+				cell.sequence.store(position + i + myMask + 1, std::memory_order_release);
+			}
+
+			throw;
+		}
+
+		return count;
+	}
+
+	template<typename T> requires (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+	auto MPMCQueue<T>::At(size_type aPosition) const noexcept -> Cell&
+	{
+		return myCells[aPosition & myMask];
+	}
+
+	template<typename T> requires (std::is_nothrow_move_constructible_v<T> && std::is_nothrow_destructible_v<T>)
+	auto MPMCQueue<T>::Claim(std::atomic<size_type>& aIndex, size_type aCount, size_type aOffset) noexcept -> std::pair<size_type, size_type>
+	{
+		// a slot at position is ready for producers when its sequence equals position, and for consumers
+		// when it equals position + 1
+
+		size_type position = aIndex.load(std::memory_order_relaxed);
+
+		if (aCount == 0)
+			return { position, 0 };
+
+		while (true)
+		{
+			size_type count = 0;
+			while (count < aCount && count <= myMask &&
+				At(position + count).sequence.load(std::memory_order_acquire) == position + count + aOffset)
+			{
+				++count;
+			}
+
+			if (count == 0)
+			{
+				const auto diff = static_cast<std::ptrdiff_t>(At(position).sequence.load(std::memory_order_acquire) - (position + aOffset));
+				if (diff < 0) // slot is still in use from the previous lap, so full or empty
+					return { position, 0 };
+
+				position = aIndex.load(std::memory_order_relaxed); // another thread claimed it first
+				continue;
+			}
+
+			if (aIndex.compare_exchange_weak(position, position + count, std::memory_order_relaxed, std::memory_order_relaxed))
+				return { position, count };
+		}
+	}
+}
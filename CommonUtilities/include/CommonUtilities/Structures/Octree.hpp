@@ -11,6 +11,8 @@
 #include <CommonUtilities/Math/Sphere.hpp>
 
 #include <CommonUtilities/Structures/FreeVector.hpp>
+#include <CommonUtilities/Structures/SlotMap.hpp>
+#include <CommonUtilities/Alloc/FrameAlloc.hpp>
 
 template<typename MutexType>
 class MutexHolder
@@ -34,8 +36,11 @@ private:
 namespace CommonUtilities
 { 
 	///	Octree based upon: https://stackoverflow.com/questions/41946007/efficient-and-well-explained-implementation-of-a-quadtree-for-2d-collision-det
+	/// 
+	/// Query results may use any allocator, e.g., FrameAlloc for results that only live for the frame.
+	/// Temporaries used while traversing the tree are taken from the thread's scratch FrameAllocator.
 	///
-	template<std::equality_comparable T>
+	template<std::equality_comparable T, typename Alloc = std::allocator<T>>
 	class Octree
 	{
 		typedef std::shared_mutex MutexType;
@@ -44,6 +49,8 @@ namespace CommonUtilities
 		using ElementType	= T;
 		using ValueType		= std::remove_const_t<T>;
 		using SizeType		= int;
+		using allocator_type	= Alloc;
+		using Handle			= SlotHandle;
 
 		static constexpr SizeType ourChildCount = 8;
 
@@ -55,7 +62,11 @@ namespace CommonUtilities
 
 		Octree();
 
-		Octree(const cu::AABBf& aRootAABB, int aMaxElements = 16, int aMaxDepth = 16);
+		/// \param Allocator: Allocator that the elements and nodes are allocated with.
+		///
+		explicit Octree(const Alloc& aAllocator);
+
+		Octree(const cu::AABBf& aRootAABB, int aMaxElements = 16, int aMaxDepth = 16, const Alloc& aAllocator = Alloc());
 
 		Octree(const Octree&) = default;
 		Octree(Octree&&) = default;
@@ -63,6 +74,8 @@ namespace CommonUtilities
 		Octree& operator=(const Octree&) = default;
 		Octree& operator=(Octree&&) = default;
 
+		NODISC allocator_type get_allocator() const;
+
 		int ElementCount() const;
 
 		const cu::AABBf& GetRootAABB() const;
@@ -87,6 +100,43 @@ namespace CommonUtilities
 		/// 
 		bool Erase(SizeType aIndex);
 
+		/// Inserts given element into the tree.
+		/// 
+		/// \param AABB: Bounding box encompassing item.
+		/// \param Args: Constructor parameters for item.
+		/// 
+		/// \returns Handle to element that, unlike an index, is detected as stale once the element is erased.
+		///          Invalid if the element is outside the tree.
+		/// 
+		template<typename... Args> requires std::constructible_from<T, Args...>
+		auto InsertHandle(const cu::AABBf& aAABB, Args&&... someArgs) -> Handle;
+
+		/// Attempts to erase element from tree.
+		/// 
+		/// \param Handle: Handle to element to erase.
+		/// 
+		/// \returns True if successfully removed the element, false if it was already erased.
+		/// 
+		bool Erase(Handle aHandle);
+
+		/// \returns Whether the handle refers to an element that has not been erased.
+		/// 
+		NODISC bool Contains(Handle aHandle) const;
+
+		/// \returns Pointer to element, or nullptr if it has been erased.
+		/// 
+		NODISC auto Find(Handle aHandle) -> ValueType*;
+
+		/// \returns Const pointer to element, or nullptr if it has been erased.
+		/// 
+		NODISC auto Find(Handle aHandle) const -> const ValueType*;
+
+		/// Converts an index, e.g., from a query, to a handle that can be held onto.
+		/// 
+		/// \param Index: Index to a valid element.
+		/// 
+		NODISC auto GetHandle(SizeType aIndex) const -> Handle;
+
 		/// Updates the given element with new data.
 		/// 
 		/// \param Index: index to element.
@@ -121,7 +171,8 @@ namespace CommonUtilities
 		/// 
 		/// \returns List of entities intersecting the frustum.
 		/// 
-		NODISC void Query(const cu::Frustumf& aFrustum, std::vector<SizeType>& outResult) const;
+		template<typename ResultAlloc>
+		void Query(const cu::Frustumf& aFrustum, std::vector<SizeType, ResultAlloc>& outResult) const;
 
 		/// Queries the tree for elements.
 		/// 
@@ -129,7 +180,8 @@ namespace CommonUtilities
 		/// 
 		/// \returns List of entities intersecting the frustum.
 		/// 
-		NODISC void QueryNoDepth(const cu::Frustumf& aFrustum, std::vector<SizeType>& outResult) const;
+		template<typename ResultAlloc>
+		void QueryNoDepth(const cu::Frustumf& aFrustum, std::vector<SizeType, ResultAlloc>& outResult) const;
 
 		/// Queries the tree for elements.
 		/// 
@@ -137,7 +189,8 @@ namespace CommonUtilities
 		/// 
 		/// \returns List of entities intersecting the frustum.
 		/// 
-		NODISC void Query(const cu::Vector3f& aStartPos, const cu::Vector3f& aEndPos, std::vector<SizeType>& outResult) const;
+		template<typename ResultAlloc>
+		void Query(const cu::Vector3f& aStartPos, const cu::Vector3f& aEndPos, std::vector<SizeType, ResultAlloc>& outResult) const;
 
 		/// Queries the tree for elements.
 		/// 
@@ -145,7 +198,8 @@ namespace CommonUtilities
 		/// 
 		/// \returns List of entities intersecting the aabb.
 		/// 
-		NODISC void Query(const cu::AABBf& aAABB, std::vector<SizeType>& outResult) const;
+		template<typename ResultAlloc>
+		void Query(const cu::AABBf& aAABB, std::vector<SizeType, ResultAlloc>& outResult) const;
 
 		/// Queries the tree for elements.
 		/// 
@@ -153,7 +207,8 @@ namespace CommonUtilities
 		/// 
 		/// \returns List of entities intersecting the point.
 		/// 
-		NODISC void Query(const cu::Spheref& aSphere, std::vector<SizeType>& outResult) const;
+		template<typename ResultAlloc>
+		void Query(const cu::Spheref& aSphere, std::vector<SizeType, ResultAlloc>& outResult) const;
 
 		/// Queries the tree for elements.
 		/// 
@@ -161,7 +216,8 @@ namespace CommonUtilities
 		/// 
 		/// \returns List of entities intersecting the point.
 		/// 
-		NODISC void Query(const cu::Vector3f& aPoint, std::vector<SizeType>& outResult) const;
+		template<typename ResultAlloc>
+		void Query(const cu::Vector3f& aPoint, std::vector<SizeType, ResultAlloc>& outResult) const;
 
 		/// Performs a lazy cleanup of the tree, should be called after items have been erased.
 		/// 
@@ -174,6 +230,12 @@ namespace CommonUtilities
 		std::vector<cu::AABBf> GetBranchAABBs() const;
 
 	private:
+		template<typename U>
+		using ScratchVector = std::vector<U, FrameAlloc<U>>; // only valid within a FrameAllocator::Scope on the scratch
+
+		template<typename U>
+		using Rebind = typename std::allocator_traits<Alloc>::template rebind_alloc<U>;
+
 		struct Node
 		{
 			SizeType firstChild	 {-1};	// points to first sub-branch or first element ptr index
@@ -205,65 +267,89 @@ namespace CommonUtilities
 			SizeType	index {0};
 		};
 
+		template<typename... Args>
+		auto InsertImpl(const cu::AABBf& aAABB, Args&&... someArgs) -> SizeType;
+
+		bool EraseImpl(SizeType aIndex);
+
+		bool ContainsImpl(Handle aHandle) const;
+
 		void NodeInsert(const NodeReg& aNode, SizeType aEltIndex);
 		void LeafInsert(const NodeReg& aNode, SizeType aEltIndex);
 
-		auto FindLeaves(const NodeReg& aNode, const cu::AABBf& aAABB) const -> std::vector<NodeReg>;
+		auto FindLeaves(const NodeReg& aNode, const cu::AABBf& aAABB) const -> ScratchVector<NodeReg>;
 
-		auto QFindLeaves(const NodeRegQuery& aNode, const cu::Vector3f& aStartPos, const cu::Vector3f& aEndPos) const -> std::vector<NodeQuery>;
-		auto QFindLeaves(const NodeRegQuery& aNode, const cu::Frustumf& aFrustum) const -> std::vector<NodeQuery>;
-		auto QFindLeavesNoDepth(const NodeRegQuery& aNode, const cu::Frustumf& aFrustum) const -> std::vector<NodeQuery>;
-		auto QFindLeaves(const NodeRegQuery& aNode, const cu::AABBf& aAABB) const -> std::vector<NodeQuery>;
-		auto QFindLeaves(const NodeRegQuery& aNode, const cu::Spheref& aSphere) const -> std::vector<NodeQuery>;
+		auto QFindLeaves(const NodeRegQuery& aNode, const cu::Vector3f& aStartPos, const cu::Vector3f& aEndPos) const -> ScratchVector<NodeQuery>;
+		auto QFindLeaves(const NodeRegQuery& aNode, const cu::Frustumf& aFrustum) const -> ScratchVector<NodeQuery>;
+		auto QFindLeavesNoDepth(const NodeRegQuery& aNode, const cu::Frustumf& aFrustum) const -> ScratchVector<NodeQuery>;
+		auto QFindLeaves(const NodeRegQuery& aNode, const cu::AABBf& aAABB) const -> ScratchVector<NodeQuery>;
+		auto QFindLeaves(const NodeRegQuery& aNode, const cu::Spheref& aSphere) const -> ScratchVector<NodeQuery>;
 
-		void GetNodeLeaves(SizeType aNodeIndex, std::vector<NodeQuery>& outLeaves, std::vector<SizeType>& aProcessNodes, bool aInsideQuery = false) const;
+		void GetNodeLeaves(SizeType aNodeIndex, ScratchVector<NodeQuery>& outLeaves, ScratchVector<SizeType>& aProcessNodes, bool aInsideQuery = false) const;
 
 		static bool IsLeaf(const Node& aNode);
 		static bool IsBranch(const Node& aNode);
 
-		cu::FreeVector<Element>		myElements;		// all the elements
-		cu::FreeVector<ElementPtr>	myElementsPtr;	// all the element ptrs
-		cu::FreeVector<Node>		myNodes;
+		cu::FreeVector<Element, Rebind<Element>>		myElements;		// all the elements
+		cu::FreeVector<ElementPtr, Rebind<ElementPtr>>	myElementsPtr;	// all the element ptrs
+		cu::FreeVector<Node, Rebind<Node>>				myNodes;
+
+		std::vector<std::uint32_t, Rebind<std::uint32_t>> myGenerations; // of each element slot, advanced on erase to detect stale handles
 
 		cu::AABBf	myRootAABB;
 
 		SizeType	myMaxElements	{16}; // max elements before subdivision
 		SizeType	myMaxDepth		{8}; // max depth before no more leaves will be created
 
-		mutable std::vector<std::uint8_t> myVisited;
+		mutable std::vector<std::uint8_t, Rebind<std::uint8_t>> myVisited;
 		mutable MutexHolder<MutexType> myMutex = {};
 	};
 
-	template <std::equality_comparable T>
-	inline Octree<T>::Octree() : Octree({Vector3f(-4096.0f), Vector3f(4096.0f) })
+	template<std::equality_comparable T, typename Alloc>
+	inline Octree<T, Alloc>::Octree() : Octree({Vector3f(-4096.0f), Vector3f(4096.0f) })
+	{
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline Octree<T, Alloc>::Octree(const Alloc& aAllocator) : Octree({Vector3f(-4096.0f), Vector3f(4096.0f) }, 16, 16, aAllocator)
 	{
 	}
 
-	template<std::equality_comparable T>
-	inline Octree<T>::Octree(const cu::AABBf& aRootAABB, int aMaxElements, int aMaxDepth)
-		: myRootAABB(aRootAABB), myMaxElements(aMaxElements), myMaxDepth(aMaxDepth)
+	template<std::equality_comparable T, typename Alloc>
+	inline Octree<T, Alloc>::Octree(const cu::AABBf& aRootAABB, int aMaxElements, int aMaxDepth, const Alloc& aAllocator)
+		: myElements(aAllocator), myElementsPtr(aAllocator), myNodes(aAllocator), myGenerations(aAllocator)
+		, myRootAABB(aRootAABB), myMaxElements(aMaxElements), myMaxDepth(aMaxDepth)
+		, myVisited(aAllocator)
 	{
 		myNodes.emplace();
 	}
 
-	template<std::equality_comparable T>
-	inline int Octree<T>::ElementCount() const
+	template<std::equality_comparable T, typename Alloc>
+	inline auto Octree<T, Alloc>::get_allocator() const -> allocator_type
+	{
+		return allocator_type(myNodes.get_allocator());
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline int Octree<T, Alloc>::ElementCount() const
 	{
 		return (int)myElements.count();
 	}
 
-	template<std::equality_comparable T>
-	inline const cu::AABBf& Octree<T>::GetRootAABB() const
+	template<std::equality_comparable T, typename Alloc>
+	inline const cu::AABBf& Octree<T, Alloc>::GetRootAABB() const
 	{
 		std::shared_lock<MutexType> lock(myMutex);
 		return myRootAABB;
 	}
 
-	template<std::equality_comparable T>
-	inline void Octree<T>::SetRootAABB(const cu::AABBf& aRootAABB)
+	template<std::equality_comparable T, typename Alloc>
+	inline void Octree<T, Alloc>::SetRootAABB(const cu::AABBf& aRootAABB)
 	{
 		std::scoped_lock<MutexType> lock(myMutex);
 
+		FrameAllocator::Scope scope(details::frame::GetScratch());
+
 		if (myRootAABB == aRootAABB)
 			return;
 
@@ -272,8 +358,8 @@ namespace CommonUtilities
 		if (myElements.empty())
 			return;
 
-		std::vector<NodeQuery> leaves;
-		std::vector<SizeType> toProcess;
+		ScratchVector<NodeQuery> leaves(details::frame::GetScratch());
+		ScratchVector<SizeType> toProcess(details::frame::GetScratch());
 
 		leaves.reserve(ourChildCount * myMaxDepth / 2);
 		toProcess.reserve(ourChildCount * myMaxDepth / 2);
@@ -321,25 +407,95 @@ namespace CommonUtilities
 		}
 	}
 
-	template<std::equality_comparable T>
+	template<std::equality_comparable T, typename Alloc>
 	template<typename... Args> requires std::constructible_from<T, Args...>
-	inline auto Octree<T>::Insert(const cu::AABBf& aAABB, Args&&... someArgs) -> SizeType
+	inline auto Octree<T, Alloc>::Insert(const cu::AABBf& aAABB, Args&&... someArgs) -> SizeType
+	{
+		std::scoped_lock<MutexType> lock(myMutex);
+		return InsertImpl(aAABB, std::forward<Args>(someArgs)...);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline bool Octree<T, Alloc>::Erase(SizeType aIndex)
+	{
+		std::scoped_lock<MutexType> lock(myMutex);
+		return EraseImpl(aIndex);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename... Args> requires std::constructible_from<T, Args...>
+	inline auto Octree<T, Alloc>::InsertHandle(const cu::AABBf& aAABB, Args&&... someArgs) -> Handle
+	{
+		std::scoped_lock<MutexType> lock(myMutex);
+
+		const SizeType index = InsertImpl(aAABB, std::forward<Args>(someArgs)...);
+		if (index == -1)
+			return Handle{};
+
+		return Handle{static_cast<std::uint32_t>(index), myGenerations[index]};
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline bool Octree<T, Alloc>::Erase(Handle aHandle)
 	{
 		std::scoped_lock<MutexType> lock(myMutex);
 
+		if (!ContainsImpl(aHandle))
+			return false;
+
+		return EraseImpl(static_cast<SizeType>(aHandle.index));
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline bool Octree<T, Alloc>::Contains(Handle aHandle) const
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+		return ContainsImpl(aHandle);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline auto Octree<T, Alloc>::Find(Handle aHandle) -> ValueType*
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+		return ContainsImpl(aHandle) ? &myElements[aHandle.index].item : nullptr;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline auto Octree<T, Alloc>::Find(Handle aHandle) const -> const ValueType*
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+		return ContainsImpl(aHandle) ? &myElements[aHandle.index].item : nullptr;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline auto Octree<T, Alloc>::GetHandle(SizeType aIndex) const -> Handle
+	{
+		std::shared_lock<MutexType> lock(myMutex);
+
+		assert(myElements.valid(aIndex) && "Element is not valid");
+		return Handle{static_cast<std::uint32_t>(aIndex), myGenerations[aIndex]};
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename... Args>
+	inline auto Octree<T, Alloc>::InsertImpl(const cu::AABBf& aAABB, Args&&... someArgs) -> SizeType
+	{
 		if (!myRootAABB.Overlaps(aAABB)) // dont attempt to add if outside boundary
 			return -1;
 
 		const auto aIndex = (SizeType)myElements.emplace(aAABB, std::forward<Args>(someArgs)...);
 		NodeInsert({ myRootAABB, 0, 0 }, aIndex);
 
+		if (aIndex >= static_cast<SizeType>(myGenerations.size()))
+			myGenerations.resize(aIndex + 1, details::slot::FIRST_GENERATION);
+
 		return aIndex;
 	}
 
-	template<std::equality_comparable T>
-	inline bool Octree<T>::Erase(SizeType aIndex)
+	template<std::equality_comparable T, typename Alloc>
+	inline bool Octree<T, Alloc>::EraseImpl(SizeType aIndex)
 	{
-		std::scoped_lock<MutexType> lock(myMutex);
+		FrameAllocator::Scope scope(details::frame::GetScratch());
 
 		const cu::AABBf& aabb	= myElements[aIndex].aabb;
 		const auto leaves		= QFindLeaves({ myRootAABB, 0 }, aabb);
@@ -382,13 +538,22 @@ namespace CommonUtilities
 		}
 
 		myElements.erase(aIndex);
+		myGenerations[aIndex] = details::slot::NextGeneration(myGenerations[aIndex]);
 
 		return true;
 	}
 
-	template<std::equality_comparable T>
+	template<std::equality_comparable T, typename Alloc>
+	inline bool Octree<T, Alloc>::ContainsImpl(Handle aHandle) const
+	{
+		// the generation only advances on erase, so a match means the element is still there
+
+		return aHandle.index < myGenerations.size() && myGenerations[aHandle.index] == aHandle.generation && myElements.valid(aHandle.index);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
 	template<typename... Args> requires std::constructible_from<T, Args...>
-	inline bool Octree<T>::Update(SizeType aIndex, Args&&... someArgs)
+	inline bool Octree<T, Alloc>::Update(SizeType aIndex, Args&&... someArgs)
 	{
 		std::shared_lock<MutexType> lock(myMutex);
 
@@ -400,32 +565,35 @@ namespace CommonUtilities
 		return true;
 	}
 
-	template<std::equality_comparable T>
-	auto Octree<T>::Get(SizeType aIndex) -> ValueType&
+	template<std::equality_comparable T, typename Alloc>
+	auto Octree<T, Alloc>::Get(SizeType aIndex) -> ValueType&
 	{
 		std::shared_lock<MutexType> lock(myMutex);
 		return myElements[aIndex].item;
 	}
 
-	template<std::equality_comparable T>
-	auto Octree<T>::Get(SizeType aIndex) const -> const ValueType&
+	template<std::equality_comparable T, typename Alloc>
+	auto Octree<T, Alloc>::Get(SizeType aIndex) const -> const ValueType&
 	{
 		std::shared_lock<MutexType> lock(myMutex);
 		return myElements[aIndex].item;
 	}
 
-	template<std::equality_comparable T>
-	inline auto Octree<T>::GetAABB(SizeType aIndex) const -> const cu::AABBf&
+	template<std::equality_comparable T, typename Alloc>
+	inline auto Octree<T, Alloc>::GetAABB(SizeType aIndex) const -> const cu::AABBf&
 	{
 		std::shared_lock<MutexType> lock(myMutex);
 		return myElements[aIndex].aabb;
 	}
 
-	template<std::equality_comparable T>
-	inline void Octree<T>::Query(const cu::Frustumf& aFrustum, std::vector<SizeType>& outResult) const
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc>
+	inline void Octree<T, Alloc>::Query(const cu::Frustumf& aFrustum, std::vector<SizeType, ResultAlloc>& outResult) const
 	{
 		std::scoped_lock<MutexType> lock(myMutex);
 
+		FrameAllocator::Scope scope(details::frame::GetScratch());
+
 		outResult.clear();
 
 		if (myNodes.empty())
@@ -476,11 +644,14 @@ namespace CommonUtilities
 		}
 	}
 
-	template<std::equality_comparable T>
-	inline void Octree<T>::QueryNoDepth(const cu::Frustumf& aFrustum, std::vector<SizeType>& outResult) const
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc>
+	inline void Octree<T, Alloc>::QueryNoDepth(const cu::Frustumf& aFrustum, std::vector<SizeType, ResultAlloc>& outResult) const
 	{
 		std::scoped_lock<MutexType> lock(myMutex);
 
+		FrameAllocator::Scope scope(details::frame::GetScratch());
+
 		outResult.clear();
 
 		if (myNodes.empty())
@@ -531,11 +702,14 @@ namespace CommonUtilities
 		}
 	}
 
-	template<std::equality_comparable T>
-	inline void Octree<T>::Query(const cu::Vector3f& aStartPos, const cu::Vector3f& aEndPos, std::vector<SizeType>& outResult) const
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc>
+	inline void Octree<T, Alloc>::Query(const cu::Vector3f& aStartPos, const cu::Vector3f& aEndPos, std::vector<SizeType, ResultAlloc>& outResult) const
 	{
 		std::scoped_lock<MutexType> lock(myMutex);
 
+		FrameAllocator::Scope scope(details::frame::GetScratch());
+
 		outResult.clear();
 
 		if (myNodes.empty())
@@ -586,11 +760,14 @@ namespace CommonUtilities
 		}
 	}
 
-	template<std::equality_comparable T>
-	inline void Octree<T>::Query(const cu::AABBf& aAABB, std::vector<SizeType>& outResult) const
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc>
+	inline void Octree<T, Alloc>::Query(const cu::AABBf& aAABB, std::vector<SizeType, ResultAlloc>& outResult) const
 	{
 		std::scoped_lock<MutexType> lock(myMutex);
 
+		FrameAllocator::Scope scope(details::frame::GetScratch());
+
 		outResult.clear();
 
 		if (myNodes.empty())
@@ -641,11 +818,14 @@ namespace CommonUtilities
 		}
 	}
 
-	template<std::equality_comparable T>
-	inline void Octree<T>::Query(const cu::Spheref& aSphere, std::vector<SizeType>& outResult) const
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc>
+	inline void Octree<T, Alloc>::Query(const cu::Spheref& aSphere, std::vector<SizeType, ResultAlloc>& outResult) const
 	{
 		std::scoped_lock<MutexType> lock(myMutex);
 
+		FrameAllocator::Scope scope(details::frame::GetScratch());
+
 		outResult.clear();
 
 		if (myNodes.empty())
@@ -696,21 +876,24 @@ namespace CommonUtilities
 		}
 	}
 
-	template<std::equality_comparable T>
-	inline void Octree<T>::Query(const cu::Vector3f& aPoint, std::vector<SizeType>& outResult) const
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc>
+	inline void Octree<T, Alloc>::Query(const cu::Vector3f& aPoint, std::vector<SizeType, ResultAlloc>& outResult) const
 	{
 		Query(cu::AABBf(aPoint, aPoint), outResult);
 	}
 
-	template<std::equality_comparable T>
-	inline void Octree<T>::Cleanup()
+	template<std::equality_comparable T, typename Alloc>
+	inline void Octree<T, Alloc>::Cleanup()
 	{
 		std::scoped_lock<MutexType> lock(myMutex);
 
+		FrameAllocator::Scope scope(details::frame::GetScratch());
+
 		if (myNodes.empty())
 			return;
 
-		std::vector<SizeType> toProcess;
+		ScratchVector<SizeType> toProcess(details::frame::GetScratch());
 		toProcess.reserve(ourChildCount * myMaxDepth / 2);
 
 		if (IsBranch(myNodes[0]))
@@ -751,27 +934,36 @@ namespace CommonUtilities
 		}
 	}
 
-	template<std::equality_comparable T>
-	inline void Octree<T>::Clear()
+	template<std::equality_comparable T, typename Alloc>
+	inline void Octree<T, Alloc>::Clear()
 	{
 		std::scoped_lock<MutexType> lock(myMutex);
 
+		myElements.for_each_valid([this](std::size_t aIndex, const Element&)
+			{
+				myGenerations[aIndex] = details::slot::NextGeneration(myGenerations[aIndex]); // handles stay stale after the slots are reused
+			});
+
 		myElements.clear();
 		myElementsPtr.clear();
 		myNodes.clear();
+
+		myNodes.emplace(); // root
 	}
 
-	template<std::equality_comparable T>
-	inline std::vector<cu::AABBf> Octree<T>::GetBranchAABBs() const
+	template<std::equality_comparable T, typename Alloc>
+	inline std::vector<cu::AABBf> Octree<T, Alloc>::GetBranchAABBs() const
 	{
 		std::shared_lock<MutexType> lock(myMutex);
 
+		FrameAllocator::Scope scope(details::frame::GetScratch());
+
 		std::vector<cu::AABBf> result;
 
 		if (myNodes.empty())
 			return result;
 
-		std::vector<NodeRegQuery> toProcess;
+		ScratchVector<NodeRegQuery> toProcess(details::frame::GetScratch());
 		toProcess.reserve(ourChildCount * myMaxDepth / 2);
 
 		toProcess.emplace_back(myRootAABB, 0);
@@ -819,9 +1011,11 @@ namespace CommonUtilities
 		return result;
 	}
 
-	template<std::equality_comparable T>
-	inline void Octree<T>::NodeInsert(const NodeReg& aNode, SizeType aEltIndex)
+	template<std::equality_comparable T, typename Alloc>
+	inline void Octree<T, Alloc>::NodeInsert(const NodeReg& aNode, SizeType aEltIndex)
 	{
+		FrameAllocator::Scope scope(details::frame::GetScratch());
+
 		const cu::AABBf& aabb	= myElements[aEltIndex].aabb;
 		auto leaves				= FindLeaves(aNode, aabb);
 
@@ -831,8 +1025,8 @@ namespace CommonUtilities
 		}
 	}
 
-	template<std::equality_comparable T>
-	inline void Octree<T>::LeafInsert(const NodeReg& aNode, SizeType aEltIndex)
+	template<std::equality_comparable T, typename Alloc>
+	inline void Octree<T, Alloc>::LeafInsert(const NodeReg& aNode, SizeType aEltIndex)
 	{
 		Node* node = &myNodes[aNode.index];
 
@@ -876,12 +1070,12 @@ namespace CommonUtilities
 			++node->count;
 	}
 
-	template<std::equality_comparable T>
-	inline auto Octree<T>::FindLeaves(const NodeReg& aNode, const cu::AABBf& aAABB) const -> std::vector<NodeReg>
+	template<std::equality_comparable T, typename Alloc>
+	inline auto Octree<T, Alloc>::FindLeaves(const NodeReg& aNode, const cu::AABBf& aAABB) const -> ScratchVector<NodeReg>
 	{
-		std::vector<NodeReg>	leaves;
-		std::vector<NodeReg>	toProcess;
-		std::vector<SizeType>	toProcessContained;
+		ScratchVector<NodeReg>	leaves(details::frame::GetScratch());
+		ScratchVector<NodeReg>	toProcess(details::frame::GetScratch());
+		ScratchVector<SizeType>	toProcessContained(details::frame::GetScratch());
 
 		leaves.reserve(ourChildCount / 2);
 		toProcess.reserve(ourChildCount * myMaxDepth / 2);
@@ -967,11 +1161,11 @@ namespace CommonUtilities
 		return leaves;
 	}
 
-	template<std::equality_comparable T>
-	inline auto Octree<T>::QFindLeaves(const NodeRegQuery& aNode, const cu::Vector3f& aStartPos, const cu::Vector3f& aEndPos) const -> std::vector<NodeQuery>
+	template<std::equality_comparable T, typename Alloc>
+	inline auto Octree<T, Alloc>::QFindLeaves(const NodeRegQuery& aNode, const cu::Vector3f& aStartPos, const cu::Vector3f& aEndPos) const -> ScratchVector<NodeQuery>
 	{
-		std::vector<NodeQuery> leaves;
-		std::vector<NodeRegQuery> toProcess;
+		ScratchVector<NodeQuery> leaves(details::frame::GetScratch());
+		ScratchVector<NodeRegQuery> toProcess(details::frame::GetScratch());
 
 		leaves.reserve(ourChildCount / 2);
 		toProcess.reserve(ourChildCount * myMaxDepth / 2);
@@ -1023,12 +1217,12 @@ namespace CommonUtilities
 		return leaves;
 	}
 
-	template<std::equality_comparable T>
-	inline auto Octree<T>::QFindLeaves(const NodeRegQuery& aNode, const cu::Frustumf& aFrustum) const -> std::vector<NodeQuery>
+	template<std::equality_comparable T, typename Alloc>
+	inline auto Octree<T, Alloc>::QFindLeaves(const NodeRegQuery& aNode, const cu::Frustumf& aFrustum) const -> ScratchVector<NodeQuery>
 	{
-		std::vector<NodeQuery>		leaves;
-		std::vector<NodeRegQuery>	toProcess;
-		std::vector<SizeType>		toProcessContained;
+		ScratchVector<NodeQuery>		leaves(details::frame::GetScratch());
+		ScratchVector<NodeRegQuery>	toProcess(details::frame::GetScratch());
+		ScratchVector<SizeType>		toProcessContained(details::frame::GetScratch());
 
 		leaves.reserve(ourChildCount / 2);
 		toProcess.reserve(ourChildCount * myMaxDepth / 2);
@@ -1087,12 +1281,12 @@ namespace CommonUtilities
 
 		return leaves;
 	}
-	template<std::equality_comparable T>
-	inline auto Octree<T>::QFindLeavesNoDepth(const NodeRegQuery& aNode, const cu::Frustumf& aFrustum) const -> std::vector<NodeQuery>
+	template<std::equality_comparable T, typename Alloc>
+	inline auto Octree<T, Alloc>::QFindLeavesNoDepth(const NodeRegQuery& aNode, const cu::Frustumf& aFrustum) const -> ScratchVector<NodeQuery>
 	{
-		std::vector<NodeQuery>		leaves;
-		std::vector<NodeRegQuery>	toProcess;
-		std::vector<SizeType>		toProcessContained;
+		ScratchVector<NodeQuery>		leaves(details::frame::GetScratch());
+		ScratchVector<NodeRegQuery>	toProcess(details::frame::GetScratch());
+		ScratchVector<SizeType>		toProcessContained(details::frame::GetScratch());
 
 		leaves.reserve(ourChildCount / 2);
 		toProcess.reserve(ourChildCount * myMaxDepth / 2);
@@ -1151,12 +1345,12 @@ namespace CommonUtilities
 
 		return leaves;
 	}
-	template<std::equality_comparable T>
-	inline auto Octree<T>::QFindLeaves(const NodeRegQuery& aNode, const cu::AABBf& aAABB) const -> std::vector<NodeQuery>
+	template<std::equality_comparable T, typename Alloc>
+	inline auto Octree<T, Alloc>::QFindLeaves(const NodeRegQuery& aNode, const cu::AABBf& aAABB) const -> ScratchVector<NodeQuery>
 	{
-		std::vector<NodeQuery>		leaves;
-		std::vector<NodeRegQuery>	toProcess;
-		std::vector<SizeType>		toProcessContained;
+		ScratchVector<NodeQuery>		leaves(details::frame::GetScratch());
+		ScratchVector<NodeRegQuery>	toProcess(details::frame::GetScratch());
+		ScratchVector<SizeType>		toProcessContained(details::frame::GetScratch());
 
 		leaves.reserve(ourChildCount / 2);
 		toProcess.reserve(ourChildCount * myMaxDepth / 2);
@@ -1249,11 +1443,11 @@ namespace CommonUtilities
 		return leaves;
 	}
 
-	template<std::equality_comparable T>
-	inline auto Octree<T>::QFindLeaves(const NodeRegQuery& aNode, const cu::Spheref& aSphere) const -> std::vector<NodeQuery>
+	template<std::equality_comparable T, typename Alloc>
+	inline auto Octree<T, Alloc>::QFindLeaves(const NodeRegQuery& aNode, const cu::Spheref& aSphere) const -> ScratchVector<NodeQuery>
 	{
-		std::vector<NodeQuery> leaves;
-		std::vector<NodeRegQuery> toProcess;
+		ScratchVector<NodeQuery> leaves(details::frame::GetScratch());
+		ScratchVector<NodeRegQuery> toProcess(details::frame::GetScratch());
 
 		leaves.reserve(ourChildCount / 2);
 		toProcess.reserve(ourChildCount * myMaxDepth / 2);
@@ -1305,8 +1499,8 @@ namespace CommonUtilities
 		return leaves;
 	}
 
-	template<std::equality_comparable T>
-	inline void Octree<T>::GetNodeLeaves(SizeType aNodeIndex, std::vector<NodeQuery>& outLeaves, std::vector<SizeType>& aProcessNodes, bool aInsideQuery) const
+	template<std::equality_comparable T, typename Alloc>
+	inline void Octree<T, Alloc>::GetNodeLeaves(SizeType aNodeIndex, ScratchVector<NodeQuery>& outLeaves, ScratchVector<SizeType>& aProcessNodes, bool aInsideQuery) const
 	{
 		aProcessNodes.clear();
 
@@ -1337,14 +1531,20 @@ namespace CommonUtilities
 		}
 	}
 
-	template<std::equality_comparable T>
-	inline bool Octree<T>::IsLeaf(const Node& aNode)
+	template<std::equality_comparable T, typename Alloc>
+	inline bool Octree<T, Alloc>::IsLeaf(const Node& aNode)
 	{
 		return aNode.count != -1;
 	}
-	template<std::equality_comparable T>
-	inline bool Octree<T>::IsBranch(const Node& aNode)
+	template<std::equality_comparable T, typename Alloc>
+	inline bool Octree<T, Alloc>::IsBranch(const Node& aNode)
 	{
 		return aNode.count == -1;
 	}
+
+	namespace pmr
+	{
+		template<std::equality_comparable T>
+		using Octree = CommonUtilities::Octree<T, std::pmr::polymorphic_allocator<T>>;
+	}
 }
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <vector>
+#include <memory_resource>
 #include <ranges>
 #include <algorithm>
 
@@ -17,7 +18,7 @@ namespace CommonUtilities
 		};
 	}
 
-	template<typename T, pq::HeapType C = pq::HeapType::Min>
+	template<typename T, pq::HeapType C = pq::HeapType::Min, class Alloc = std::allocator<T>>
 	class PriorityQueue
 	{
 	public:
@@ -25,10 +26,11 @@ namespace CommonUtilities
 		using reference			= T&;
 		using const_reference	= const T&;
 		using size_type			= std::size_t;
+		using allocator_type	= Alloc;
 
 		using Node				= value_type;
 
-		using container_type = std::vector<Node>;
+		using container_type = std::vector<Node, Alloc>;
 
 		using iterator					= typename container_type::iterator;
 		using const_iterator			= typename container_type::const_iterator;
@@ -38,10 +40,14 @@ namespace CommonUtilities
 		PriorityQueue() = default;
 		~PriorityQueue() noexcept(std::is_nothrow_destructible_v<T>) = default;
 
+		constexpr explicit PriorityQueue(const Alloc& aAllocator);
+
 		template<typename Iter> requires(std::forward_iterator<Iter> && std::constructible_from<T, typename Iter::value_type>)
-		constexpr PriorityQueue(Iter aFirst, Iter aLast);
+		constexpr PriorityQueue(Iter aFirst, Iter aLast, const Alloc& aAllocator = Alloc());
+
+		constexpr PriorityQueue(std::initializer_list<T> aInitList, const Alloc& aAllocator = Alloc());
 
-		constexpr PriorityQueue(std::initializer_list<T> aInitList);
+		NODISC constexpr auto get_allocator() const noexcept -> allocator_type;
 
 		NODISC constexpr auto operator[](size_type aIndex) const -> const_reference;
 
@@ -106,143 +112,163 @@ namespace CommonUtilities
 		NOADDRESS Comp<C>	myComp;
 	};
 
-	template<typename T, pq::HeapType C>
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr PriorityQueue<T, C, Alloc>::PriorityQueue(const Alloc& aAllocator)
+		: myNodes(aAllocator)
+		, myComp()
+	{
+
+	}
+
+	template<typename T, pq::HeapType C, class Alloc>
 	template<typename Iter> requires(std::forward_iterator<Iter>&& std::constructible_from<T, typename Iter::value_type>)
-	constexpr PriorityQueue<T, C>::PriorityQueue(Iter aFirst, Iter aLast)
-		: myNodes(aFirst, aLast)
+	constexpr PriorityQueue<T, C, Alloc>::PriorityQueue(Iter aFirst, Iter aLast, const Alloc& aAllocator)
+		: myNodes(aFirst, aLast, aAllocator)
 		, myComp()
 	{
 		std::ranges::make_heap(myNodes, myComp);
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr PriorityQueue<T, C>::PriorityQueue(std::initializer_list<T> aInitList)
-		: myNodes(aInitList)
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr PriorityQueue<T, C, Alloc>::PriorityQueue(std::initializer_list<T> aInitList, const Alloc& aAllocator)
+		: myNodes(aInitList, aAllocator)
 		, myComp()
 	{
 		std::ranges::make_heap(myNodes, myComp);
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr auto PriorityQueue<T, C>::operator[](size_type aIndex) const -> const_reference
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr auto PriorityQueue<T, C, Alloc>::get_allocator() const noexcept -> allocator_type
+	{
+		return myNodes.get_allocator();
+	}
+
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr auto PriorityQueue<T, C, Alloc>::operator[](size_type aIndex) const -> const_reference
 	{
 		return myNodes[aIndex];
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr auto PriorityQueue<T, C>::at(size_type aIndex) const -> const_reference
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr auto PriorityQueue<T, C, Alloc>::at(size_type aIndex) const -> const_reference
 	{
 		return myNodes.at(aIndex);
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr bool PriorityQueue<T, C>::empty() const noexcept
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr bool PriorityQueue<T, C, Alloc>::empty() const noexcept
 	{
 		return myNodes.empty();
 	}
-	template<typename T, pq::HeapType C>
-	constexpr auto PriorityQueue<T, C>::size() const noexcept -> size_type
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr auto PriorityQueue<T, C, Alloc>::size() const noexcept -> size_type
 	{
 		return myNodes.size();
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr auto PriorityQueue<T, C>::max_size() const noexcept -> size_type
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr auto PriorityQueue<T, C, Alloc>::max_size() const noexcept -> size_type
 	{
 		return myNodes.max_size();
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr auto PriorityQueue<T, C>::top() const noexcept -> const_reference
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr auto PriorityQueue<T, C, Alloc>::top() const noexcept -> const_reference
 	{
 		return myNodes.front();
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr void PriorityQueue<T, C>::push(const T& aItem)
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr void PriorityQueue<T, C, Alloc>::push(const T& aItem)
 	{
 		emplace(aItem);
 	}
-	template<typename T, pq::HeapType C>
-	constexpr void PriorityQueue<T, C>::push(T&& aItem)
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr void PriorityQueue<T, C, Alloc>::push(T&& aItem)
 	{
 		emplace(std::move(aItem));
 	}
 
-	template<typename T, pq::HeapType C>
+	template<typename T, pq::HeapType C, class Alloc>
 	template<typename... Args> requires std::constructible_from<T, Args...>
-	constexpr void PriorityQueue<T, C>::emplace(Args&&... someArgs)
+	constexpr void PriorityQueue<T, C, Alloc>::emplace(Args&&... someArgs)
 	{
 		myNodes.emplace_back(std::forward<Args>(someArgs)...);
 		std::ranges::push_heap(myNodes.begin(), myNodes.end(), myComp);
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr void PriorityQueue<T, C>::pop()
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr void PriorityQueue<T, C, Alloc>::pop()
 	{
 		std::ranges::pop_heap(myNodes.begin(), myNodes.end(), myComp);
 		myNodes.pop_back();
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr void PriorityQueue<T, C>::reserve(size_type aCapacity)
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr void PriorityQueue<T, C, Alloc>::reserve(size_type aCapacity)
 	{
 		myNodes.reserve(aCapacity);
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr void PriorityQueue<T, C>::clear()
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr void PriorityQueue<T, C, Alloc>::clear()
 	{
 		myNodes.clear();
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr void PriorityQueue<T, C>::shrink_to_fit()
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr void PriorityQueue<T, C, Alloc>::shrink_to_fit()
 	{
 		myNodes.shrink_to_fit();
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr auto PriorityQueue<T, C>::begin() const noexcept -> const_iterator
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr auto PriorityQueue<T, C, Alloc>::begin() const noexcept -> const_iterator
 	{
 		return myNodes.begin();
 	}
-	template<typename T, pq::HeapType C>
-	constexpr auto PriorityQueue<T, C>::end() const noexcept -> const_iterator
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr auto PriorityQueue<T, C, Alloc>::end() const noexcept -> const_iterator
 	{
 		return myNodes.begin();
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr auto PriorityQueue<T, C>::cbegin() const noexcept -> const_iterator
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr auto PriorityQueue<T, C, Alloc>::cbegin() const noexcept -> const_iterator
 	{
 		return myNodes.cbegin();
 	}
-	template<typename T, pq::HeapType C>
-	constexpr auto PriorityQueue<T, C>::cend() const noexcept -> const_iterator
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr auto PriorityQueue<T, C, Alloc>::cend() const noexcept -> const_iterator
 	{
 		return myNodes.cbegin();
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr auto PriorityQueue<T, C>::rbegin() const noexcept -> const_reverse_iterator
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr auto PriorityQueue<T, C, Alloc>::rbegin() const noexcept -> const_reverse_iterator
 	{
 		return myNodes.rbegin();
 	}
-	template<typename T, pq::HeapType C>
-	constexpr auto PriorityQueue<T, C>::rend() const noexcept -> const_reverse_iterator
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr auto PriorityQueue<T, C, Alloc>::rend() const noexcept -> const_reverse_iterator
 	{
 		return myNodes.rbegin();
 	}
 
-	template<typename T, pq::HeapType C>
-	constexpr auto PriorityQueue<T, C>::crbegin() const noexcept -> const_reverse_iterator
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr auto PriorityQueue<T, C, Alloc>::crbegin() const noexcept -> const_reverse_iterator
 	{
 		return myNodes.crbegin();
 	}
-	template<typename T, pq::HeapType C>
-	constexpr auto PriorityQueue<T, C>::crend() const noexcept -> const_reverse_iterator
+	template<typename T, pq::HeapType C, class Alloc>
+	constexpr auto PriorityQueue<T, C, Alloc>::crend() const noexcept -> const_reverse_iterator
 	{
 		return myNodes.crbegin();
 	}
+
+	namespace pmr
+	{
+		template<typename T, pq::HeapType C = pq::HeapType::Min>
+		using PriorityQueue = CommonUtilities::PriorityQueue<T, C, std::pmr::polymorphic_allocator<T>>;
+	}
 }
\ No newline at end of file
@@ -9,18 +9,25 @@
 #include <CommonUtilities/Config.h>
 
 #include <CommonUtilities/Structures/FreeVector.hpp>
+#include <CommonUtilities/Structures/SlotMap.hpp>
+#include <CommonUtilities/Alloc/FrameAlloc.hpp>
 
 namespace CommonUtilities
 {
 	///	Quadtree based upon: https://stackoverflow.com/questions/41946007/efficient-and-well-explained-implementation-of-a-quadtree-for-2d-collision-det
+	/// 
+	/// Query results may use any allocator, e.g., FrameAlloc for results that only live for the frame.
+	/// Temporaries used while traversing the tree are taken from the thread's scratch FrameAllocator.
 	///
-	template<std::equality_comparable T>
+	template<std::equality_comparable T, typename Alloc = std::allocator<T>>
 	class QuadTree
 	{
 	public:
 		using ElementType	= T;
 		using ValueType		= std::remove_const_t<T>;
 		using SizeType		= int;
+		using allocator_type	= Alloc;
+		using Handle			= SlotHandle;
 
 		static constexpr int ourChildCount = 4;
 
@@ -30,7 +37,11 @@ namespace CommonUtilities
 			ValueType	item;
 		};
 
-		QuadTree(const Rectf& aRootRect, int aMaxElements = 8, int aMaxDepth = 8);
+		/// \param Allocator: Allocator that the elements and nodes are allocated with.
+		///
+		QuadTree(const Rectf& aRootRect, int aMaxElements = 8, int aMaxDepth = 8, const Alloc& aAllocator = Alloc());
+
+		NODISC allocator_type get_allocator() const;
 
 		/// Inserts given element into the quadtree.
 		/// 
@@ -50,6 +61,43 @@ namespace CommonUtilities
 		/// 
 		bool Erase(SizeType aIndex);
 
+		/// Inserts given element into the tree.
+		/// 
+		/// \param Rect: Rectangle encompassing item.
+		/// \param Args: Constructor parameters for item.
+		/// 
+		/// \returns Handle to element that, unlike an index, is detected as stale once the element is erased.
+		///          Invalid if the element is outside the tree.
+		/// 
+		template<typename... Args> requires std::constructible_from<T, Args...>
+		auto InsertHandle(const Rectf& aRect, Args&&... someArgs) -> Handle;
+
+		/// Attempts to erase element from tree.
+		/// 
+		/// \param Handle: Handle to element to erase.
+		/// 
+		/// \returns True if successfully removed the element, false if it was already erased.
+		/// 
+		bool Erase(Handle aHandle);
+
+		/// \returns Whether the handle refers to an element that has not been erased.
+		/// 
+		NODISC bool Contains(Handle aHandle) const;
+
+		/// \returns Pointer to element, or nullptr if it has been erased.
+		/// 
+		NODISC auto Find(Handle aHandle) -> ValueType*;
+
+		/// \returns Const pointer to element, or nullptr if it has been erased.
+		/// 
+		NODISC auto Find(Handle aHandle) const -> const ValueType*;
+
+		/// Converts an index, e.g., from a query, to a handle that can be held onto.
+		/// 
+		/// \param Index: Index to a valid element.
+		/// 
+		NODISC auto GetHandle(SizeType aIndex) const -> Handle;
+
 		/// Updates the given element with new data.
 		/// 
 		/// \param Index: index to element.
@@ -81,18 +129,22 @@ namespace CommonUtilities
 		/// Queries the tree for elements.
 		/// 
 		/// \param Rect: Bounding rectangle where all the elements are contained.
+		/// \param Alloc: Allocator for the result.
 		/// 
 		/// \returns List of entities contained within the bounding rectangle.
 		/// 
-		NODISC auto Query(const Rectf& aRect) const -> std::vector<SizeType>;
+		template<typename ResultAlloc = std::allocator<SizeType>>
+		NODISC auto Query(const Rectf& aRect, const ResultAlloc& aAlloc = ResultAlloc()) const -> std::vector<SizeType, ResultAlloc>;
 
 		/// Queries the tree for elements.
 		/// 
 		/// \param Point: Point to search for overlapping elements.
+		/// \param Alloc: Allocator for the result.
 		/// 
 		/// \returns List of entities contained at the point.
 		/// 
-		NODISC auto Query(const Vector2f& aPoint) const-> std::vector<SizeType>;
+		template<typename ResultAlloc = std::allocator<SizeType>>
+		NODISC auto Query(const Vector2f& aPoint, const ResultAlloc& aAlloc = ResultAlloc()) const -> std::vector<SizeType, ResultAlloc>;
 
 		/// Performs a lazy cleanup of the tree, should be called after items have been erased.
 		/// 
@@ -103,6 +155,12 @@ namespace CommonUtilities
 		void Clear();
 
 	private:
+		template<typename U>
+		using ScratchVector = std::vector<U, FrameAlloc<U>>; // only valid within a FrameAllocator::Scope on the scratch
+
+		template<typename U>
+		using Rebind = typename std::allocator_traits<Alloc>::template rebind_alloc<U>;
+
 		struct Node
 		{
 			SizeType firstChild	 {-1};	// points to first sub-branch or first element index
@@ -122,53 +180,140 @@ namespace CommonUtilities
 			SizeType next	 {-1};	// points to next elt ptr, or -1 means end of items
 		};
 
+		template<typename... Args>
+		auto InsertImpl(const Rectf& aRect, Args&&... someArgs) -> SizeType;
+
+		bool EraseImpl(SizeType aIndex);
+
+		bool ContainsImpl(Handle aHandle) const;
+
 		void NodeInsert(const NodeReg& aNode, SizeType aEltIndex);
 		void LeafInsert(const NodeReg& aNode, SizeType aEltIndex);
 
-		auto FindLeaves(const NodeReg& aNode, const Rectf& aRect) const -> std::vector<NodeReg>;
+		auto FindLeaves(const NodeReg& aNode, const Rectf& aRect) const -> ScratchVector<NodeReg>;
 
 		static bool IsLeaf(const Node& aNode);
 		static bool IsBranch(const Node& aNode);
 
-		FreeVector<Element>		myElements;		// all the elements
-		FreeVector<ElementPtr>	myElementsPtr;	// all the element ptrs
-		FreeVector<Node>		myNodes;
+		FreeVector<Element, Rebind<Element>>		myElements;		// all the elements
+		FreeVector<ElementPtr, Rebind<ElementPtr>>	myElementsPtr;	// all the element ptrs
+		FreeVector<Node, Rebind<Node>>				myNodes;
+
+		std::vector<std::uint32_t, Rebind<std::uint32_t>> myGenerations; // of each element slot, advanced on erase to detect stale handles
 
 		Rectf	myRootRect;
 
 		SizeType	myMaxElements	{8}; // max elements before subdivision
 		SizeType	myMaxDepth		{8}; // max depth before no more leaves will be created
 
-		mutable std::vector<bool> myVisited;
+		mutable std::vector<bool, Rebind<bool>> myVisited;
 		mutable std::shared_mutex myMutex;
 	};
 
-	template<std::equality_comparable T>
-	inline QuadTree<T>::QuadTree(const Rectf& aRootRect, int aMaxElements, int aMaxDepth)
-		: myRootRect(aRootRect), myMaxElements(aMaxElements), myMaxDepth(aMaxDepth)
+	template<std::equality_comparable T, typename Alloc>
+	inline QuadTree<T, Alloc>::QuadTree(const Rectf& aRootRect, int aMaxElements, int aMaxDepth, const Alloc& aAllocator)
+		: myElements(aAllocator), myElementsPtr(aAllocator), myNodes(aAllocator), myGenerations(aAllocator)
+		, myRootRect(aRootRect), myMaxElements(aMaxElements), myMaxDepth(aMaxDepth)
+		, myVisited(aAllocator)
 	{
 		myNodes.emplace();
 	}
 
-	template<std::equality_comparable T>
+	template<std::equality_comparable T, typename Alloc>
+	inline auto QuadTree<T, Alloc>::get_allocator() const -> allocator_type
+	{
+		return allocator_type(myNodes.get_allocator());
+	}
+
+	template<std::equality_comparable T, typename Alloc>
 	template<typename... Args> requires std::constructible_from<T, Args...>
-	inline auto QuadTree<T>::Insert(const Rectf& aRect, Args&&... someArgs) -> SizeType
+	inline auto QuadTree<T, Alloc>::Insert(const Rectf& aRect, Args&&... someArgs) -> SizeType
+	{
+		std::scoped_lock lock(myMutex);
+		return InsertImpl(aRect, std::forward<Args>(someArgs)...);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline bool QuadTree<T, Alloc>::Erase(SizeType aIndex)
+	{
+		std::scoped_lock lock(myMutex);
+		return EraseImpl(aIndex);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename... Args> requires std::constructible_from<T, Args...>
+	inline auto QuadTree<T, Alloc>::InsertHandle(const Rectf& aRect, Args&&... someArgs) -> Handle
+	{
+		std::scoped_lock lock(myMutex);
+
+		const SizeType index = InsertImpl(aRect, std::forward<Args>(someArgs)...);
+		if (index == -1)
+			return Handle{};
+
+		return Handle{static_cast<std::uint32_t>(index), myGenerations[index]};
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline bool QuadTree<T, Alloc>::Erase(Handle aHandle)
 	{
 		std::scoped_lock lock(myMutex);
 
+		if (!ContainsImpl(aHandle))
+			return false;
+
+		return EraseImpl(static_cast<SizeType>(aHandle.index));
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline bool QuadTree<T, Alloc>::Contains(Handle aHandle) const
+	{
+		std::shared_lock lock(myMutex);
+		return ContainsImpl(aHandle);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline auto QuadTree<T, Alloc>::Find(Handle aHandle) -> ValueType*
+	{
+		std::shared_lock lock(myMutex);
+		return ContainsImpl(aHandle) ? &myElements[aHandle.index].item : nullptr;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline auto QuadTree<T, Alloc>::Find(Handle aHandle) const -> const ValueType*
+	{
+		std::shared_lock lock(myMutex);
+		return ContainsImpl(aHandle) ? &myElements[aHandle.index].item : nullptr;
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	inline auto QuadTree<T, Alloc>::GetHandle(SizeType aIndex) const -> Handle
+	{
+		std::shared_lock lock(myMutex);
+
+		assert(myElements.valid(aIndex) && "Element is not valid");
+		return Handle{static_cast<std::uint32_t>(aIndex), myGenerations[aIndex]};
+	}
+
+	template<std::equality_comparable T, typename Alloc>
+	template<typename... Args>
+	inline auto QuadTree<T, Alloc>::InsertImpl(const Rectf& aRect, Args&&... someArgs) -> SizeType
+	{
 		if (!myRootRect.Overlaps(aRect)) // dont attempt to add if outside boundary
 			return -1;
 
 		const auto aIndex = static_cast<SizeType>(myElements.emplace(aRect, std::forward<Args>(someArgs)...));
 		NodeInsert({ myRootRect, 0, 0 }, aIndex);
 
+		if (aIndex >= static_cast<SizeType>(myGenerations.size()))
+			myGenerations.resize(aIndex + 1, details::slot::FIRST_GENERATION);
+
 		return aIndex;
 	}
 
-	template<std::equality_comparable T>
-	inline bool QuadTree<T>::Erase(SizeType aIndex)
+	template<std::equality_comparable T, typename Alloc>
+	inline bool QuadTree<T, Alloc>::EraseImpl(SizeType aIndex)
 	{
-		std::scoped_lock lock(myMutex);
+		FrameAllocator::Scope scope(details::frame::GetScratch());
 
 		const Rectf& rect	= myElements[aIndex].rect;
 		const auto& leaves	= FindLeaves({ myRootRect, 0, 0 }, rect);
@@ -211,13 +356,22 @@ namespace CommonUtilities
 		}
 
 		myElements.erase(aIndex);
+		myGenerations[aIndex] = details::slot::NextGeneration(myGenerations[aIndex]);
 
 		return true;
 	}
 
-	template<std::equality_comparable T>
+	template<std::equality_comparable T, typename Alloc>
+	inline bool QuadTree<T, Alloc>::ContainsImpl(Handle aHandle) const
+	{
+		// the generation only advances on erase, so a match means the element is still there
+
+		return aHandle.index < myGenerations.size() && myGenerations[aHandle.index] == aHandle.generation && myElements.valid(aHandle.index);
+	}
+
+	template<std::equality_comparable T, typename Alloc>
 	template<typename... Args> requires std::constructible_from<T, Args...>
-	inline bool QuadTree<T>::Update(SizeType aIndex, Args&&... someArgs)
+	inline bool QuadTree<T, Alloc>::Update(SizeType aIndex, Args&&... someArgs)
 	{
 		std::scoped_lock lock(myMutex);
 
@@ -229,30 +383,33 @@ namespace CommonUtilities
 		return true;
 	}
 
-	template<std::equality_comparable T>
-	auto QuadTree<T>::Get(SizeType aIndex) -> ValueType&
+	template<std::equality_comparable T, typename Alloc>
+	auto QuadTree<T, Alloc>::Get(SizeType aIndex) -> ValueType&
 	{
 		return myElements[aIndex].item;
 	}
 
-	template<std::equality_comparable T>
-	auto QuadTree<T>::Get(SizeType aIndex) const -> const ValueType&
+	template<std::equality_comparable T, typename Alloc>
+	auto QuadTree<T, Alloc>::Get(SizeType aIndex) const -> const ValueType&
 	{
 		return myElements[aIndex].item;
 	}
 
-	template<std::equality_comparable T>
-	inline auto QuadTree<T>::GetRect(SizeType aIndex) const -> const Rectf&
+	template<std::equality_comparable T, typename Alloc>
+	inline auto QuadTree<T, Alloc>::GetRect(SizeType aIndex) const -> const Rectf&
 	{
 		return myElements[aIndex].rect;
 	}
 
-	template<std::equality_comparable T>
-	inline auto QuadTree<T>::Query(const Rectf& aRect) const -> std::vector<SizeType>
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc>
+	inline auto QuadTree<T, Alloc>::Query(const Rectf& aRect, const ResultAlloc& aAlloc) const -> std::vector<SizeType, ResultAlloc>
 	{
 		std::shared_lock lock(myMutex);
 
-		std::vector<SizeType> result;
+		FrameAllocator::Scope scope(details::frame::GetScratch());
+
+		std::vector<SizeType, ResultAlloc> result(aAlloc);
 
 		myVisited.resize(myElements.size());
 
@@ -283,14 +440,15 @@ namespace CommonUtilities
 		return result;
 	}
 
-	template<std::equality_comparable T>
-	inline auto QuadTree<T>::Query(const Vector2f& aPoint) const -> std::vector<SizeType>
+	template<std::equality_comparable T, typename Alloc>
+	template<typename ResultAlloc>
+	inline auto QuadTree<T, Alloc>::Query(const Vector2f& aPoint, const ResultAlloc& aAlloc) const -> std::vector<SizeType, ResultAlloc>
 	{
-		return Query(Rectf(aPoint.x, aPoint.y, aPoint.x, aPoint.y);
+		return Query(Rectf(aPoint.x, aPoint.y, aPoint.x, aPoint.y), aAlloc);
 	}
 
-	template<std::equality_comparable T>
-	inline void QuadTree<T>::Cleanup()
+	template<std::equality_comparable T, typename Alloc>
+	inline void QuadTree<T, Alloc>::Cleanup()
 	{
 		std::scoped_lock lock(myMutex);
 
@@ -335,17 +493,26 @@ namespace CommonUtilities
 		}
 	}
 
-	template<std::equality_comparable T>
-	inline void QuadTree<T>::Clear()
+	template<std::equality_comparable T, typename Alloc>
+	inline void QuadTree<T, Alloc>::Clear()
 	{
+		myElements.for_each_valid([this](std::size_t aIndex, const Element&)
+			{
+				myGenerations[aIndex] = details::slot::NextGeneration(myGenerations[aIndex]); // handles stay stale after the slots are reused
+			});
+
 		myElements.clear();
 		myElementsPtr.clear();
 		myNodes.clear();
+
+		myNodes.emplace(); // root
 	}
 
-	template<std::equality_comparable T>
-	inline void QuadTree<T>::NodeInsert(const NodeReg& aNode, SizeType aEltIndex)
+	template<std::equality_comparable T, typename Alloc>
+	inline void QuadTree<T, Alloc>::NodeInsert(const NodeReg& aNode, SizeType aEltIndex)
 	{
+		FrameAllocator::Scope scope(details::frame::GetScratch());
+
 		const Rectf& rect = myElements[aEltIndex].rect;
 		for (const auto& leaf : FindLeaves(aNode, rect))
 		{
@@ -353,8 +520,8 @@ namespace CommonUtilities
 		}
 	}
 
-	template<std::equality_comparable T>
-	inline void QuadTree<T>::LeafInsert(const NodeReg& aNode, SizeType aEltIndex)
+	template<std::equality_comparable T, typename Alloc>
+	inline void QuadTree<T, Alloc>::LeafInsert(const NodeReg& aNode, SizeType aEltIndex)
 	{
 		Node* node = &myNodes[aNode.index];
 
@@ -363,9 +530,9 @@ namespace CommonUtilities
 		if (node->count == myMaxElements && aNode.depth < myMaxDepth && aNode.rect.Contains(myElements[aEltIndex].rect))
 		{
 			std::vector<SizeType> elements;
-			while (node.firstChild != -1)
+			while (node->firstChild != -1)
 			{
-				const auto index = node.firstChild;
+				const auto index = node->firstChild;
 
 				const auto next = myElementsPtr[index].next;
 				const auto elt = myElementsPtr[index].element;
@@ -396,11 +563,11 @@ namespace CommonUtilities
 			++node->count;
 	}
 
-	template<std::equality_comparable T>
-	inline auto QuadTree<T>::FindLeaves(const NodeReg& aNode, const Rectf& aRect) const -> std::vector<NodeReg>
+	template<std::equality_comparable T, typename Alloc>
+	inline auto QuadTree<T, Alloc>::FindLeaves(const NodeReg& aNode, const Rectf& aRect) const -> ScratchVector<NodeReg>
 	{
-		std::vector<NodeReg> leaves;
-		std::vector<NodeReg> toProcess;
+		ScratchVector<NodeReg> leaves(details::frame::GetScratch());
+		ScratchVector<NodeReg> toProcess(details::frame::GetScratch());
 
 		toProcess.emplace_back(aNode);
 
@@ -444,14 +611,20 @@ namespace CommonUtilities
 		return leaves;
 	}
 
-	template<std::equality_comparable T>
-	inline bool QuadTree<T>::IsLeaf(const Node& aNode)
+	template<std::equality_comparable T, typename Alloc>
+	inline bool QuadTree<T, Alloc>::IsLeaf(const Node& aNode)
 	{
 		return aNode.count != -1;
 	}
-	template<std::equality_comparable T>
-	inline bool QuadTree<T>::IsBranch(const Node& aNode)
+	template<std::equality_comparable T, typename Alloc>
+	inline bool QuadTree<T, Alloc>::IsBranch(const Node& aNode)
 	{
 		return aNode.count == -1;
 	}
+
+	namespace pmr
+	{
+		template<std::equality_comparable T>
+		using QuadTree = CommonUtilities::QuadTree<T, std::pmr::polymorphic_allocator<T>>;
+	}
 }
\ No newline at end of file
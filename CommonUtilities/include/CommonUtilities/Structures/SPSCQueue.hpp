@@ -0,0 +1,287 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <iterator>
+#include <algorithm>
+#include <new>
+#include <cstddef>
+#include <type_traits>
+
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+	/// Lock-free bounded ring buffer for exactly one producer and one consumer thread. Each side keeps a
+	/// cached copy of the other side's index on its own cache line and only reloads it when the cached
+	/// value says the ring is full or empty, so in the common case a push or pop touches no shared line
+	/// other than the slot itself.
+	///
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	class SPSCQueue
+	{
+	public:
+		using value_type	= T;
+		using size_type		= std::size_t;
+
+		/// \param Capacity: Rounded up to a power of two.
+		///
+		explicit SPSCQueue(size_type aCapacity = 1024);
+		~SPSCQueue();
+
+		SPSCQueue(const SPSCQueue&) = delete;
+		SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+		/// \returns Approximate number of elements, may be outdated as soon as it is returned.
+		///
+		NODISC auto size() const noexcept -> size_type;
+
+		/// \returns Whether the queue appeared empty at the time of the call.
+		///
+		NODISC bool empty() const noexcept;
+
+		NODISC auto capacity() const noexcept -> size_type;
+
+		/// \returns Whether there was room for the element. May only be called by the producer.
+		///
+		NODISC bool try_push(const T& aItem);
+
+		/// \returns Whether there was room for the element, it is left untouched if not. May only be called by
+		/// the producer.
+		///
+		NODISC bool try_push(T&& aItem);
+
+		/// \returns Whether there was room for the element. May only be called by the producer.
+		///
+		template<typename... Args> requires std::constructible_from<T, Args...>
+		NODISC bool try_emplace(Args&&... someArgs);
+
+		/// Pushes as many elements from the range as there is room for and publishes them together. May only
+		/// be called by the producer.
+		///
+		/// \returns Number of elements pushed from the start of the range.
+		///
+		template<std::input_iterator Iter> requires std::constructible_from<T, std::iter_reference_t<Iter>>
+		auto try_push(Iter aFirst, Iter aLast) -> size_type;
+
+		/// \returns Popped element, or nothing if empty. May only be called by the consumer.
+		///
+		NODISC auto try_pop() -> std::optional<T>;
+
+		/// Pops up to MaxCount elements into Out and frees their slots together. If writing to Out throws, the
+		/// element being written and those after it stay in the queue. May only be called by the consumer.
+		///
+		/// \returns Number of elements popped.
+		///
+		template<std::weakly_incrementable OutIter> requires std::indirectly_writable<OutIter, T&&>
+		auto try_pop(OutIter aOut, size_type aMaxCount) -> size_type;
+
+	private:
+		struct Slot
+		{
+			alignas(T) std::byte storage[sizeof(T)];
+
+			NODISC T* Get() noexcept { return std::launder(reinterpret_cast<T*>(storage)); }
+		};
+
+		NODISC Slot& At(size_type aPosition) const noexcept;
+
+		/// \returns Number of free slots, only reloads the consumer's index when fewer than Count are known.
+		///
+		NODISC auto FreeSlots(size_type aTail, size_type aCount) noexcept -> size_type;
+
+		/// \returns Number of filled slots, only reloads the producer's index when fewer than Count are known.
+		///
+		NODISC auto FilledSlots(size_type aHead, size_type aCount) noexcept -> size_type;
+
+		alignas(std::hardware_destructive_interference_size) std::atomic<size_type> myTail {0};
+		size_type myHeadCache {0}; // producer's view of head
+
+		alignas(std::hardware_destructive_interference_size) std::atomic<size_type> myHead {0};
+		size_type myTailCache {0}; // consumer's view of tail
+
+		alignas(std::hardware_destructive_interference_size) std::unique_ptr<Slot[]> mySlots;
+		size_type myMask {0};
+	};
+
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	SPSCQueue<T>::SPSCQueue(size_type aCapacity)
+	{
+		size_type capacity = 2;
+		while (capacity < aCapacity) // capacity must be a power of two for the index mask
+			capacity <<= 1;
+
+		mySlots	= std::make_unique_for_overwrite<Slot[]>(capacity);
+		myMask	= capacity - 1;
+	}
+
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	SPSCQueue<T>::~SPSCQueue()
+	{
+		if constexpr (!std::is_trivially_destructible_v<T>)
+		{
+			const size_type tail = myTail.load(std::memory_order_relaxed);
+			for (size_type i = myHead.load(std::memory_order_relaxed); i != tail; ++i)
+				std::destroy_at(At(i).Get());
+		}
+	}
+
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	auto SPSCQueue<T>::size() const noexcept -> size_type
+	{
+		const size_type head = myHead.load(std::memory_order_relaxed);
+		const size_type tail = myTail.load(std::memory_order_relaxed);
+		return tail > head ? tail - head : 0;
+	}
+
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	bool SPSCQueue<T>::empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	auto SPSCQueue<T>::capacity() const noexcept -> size_type
+	{
+		return myMask + 1;
+	}
+
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	bool SPSCQueue<T>::try_push(const T& aItem)
+	{
+		return try_emplace(aItem);
+	}
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	bool SPSCQueue<T>::try_push(T&& aItem)
+	{
+		return try_emplace(std::move(aItem));
+	}
+
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	template<typename... Args> requires std::constructible_from<T, Args...>
+	bool SPSCQueue<T>::try_emplace(Args&&... someArgs)
+	{
+		const size_type tail = myTail.load(std::memory_order_relaxed);
+
+		if (FreeSlots(tail, 1) == 0)
+			return false;
+
+		std::construct_at(At(tail).Get(), std::forward<Args>(someArgs)...); // slot is not published if this throws
+		myTail.store(tail + 1, std::memory_order_release);
+
+		return true;
+	}
+
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	template<std::input_iterator Iter> requires std::constructible_from<T, std::iter_reference_t<Iter>>
+	auto SPSCQueue<T>::try_push(Iter aFirst, Iter aLast) -> size_type
+	{
+		const size_type tail = myTail.load(std::memory_order_relaxed);
+
+		size_type count = capacity();
+		if constexpr (std::forward_iterator<Iter>)
+			count = static_cast<size_type>(std::distance(aFirst, aLast));
+
+		count = (std::min)(count, FreeSlots(tail, count));
+
+		size_type i = 0;
+
+		try
+		{
+			for (; i < count && aFirst != aLast; ++i, ++aFirst)
+				std::construct_at(At(tail + i).Get(), *aFirst);
+		}
+		catch (...)
+		{
+			myTail.store(tail + i, std::memory_order_release); // keep what was constructed
+			throw;
+		}
+
+		myTail.store(tail + i, std::memory_order_release);
+
+		return i;
+	}
+
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	auto SPSCQueue<T>::try_pop() -> std::optional<T>
+	{
+		const size_type head = myHead.load(std::memory_order_relaxed);
+
+		if (FilledSlots(head, 1) == 0)
+			return std::nullopt;
+
+		T* item = At(head).Get();
+
+		std::optional<T> result(std::move(*item)); // slot is not freed if this throws
+		std::destroy_at(item);
+
+		myHead.store(head + 1, std::memory_order_release);
+
+		return result;
+	}
+
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	template<std::weakly_incrementable OutIter> requires std::indirectly_writable<OutIter, T&&>
+	auto SPSCQueue<T>::try_pop(OutIter aOut, size_type aMaxCount) -> size_type
+	{
+		const size_type head	= myHead.load(std::memory_order_relaxed);
+		const size_type count	= (std::min)(aMaxCount, FilledSlots(head, aMaxCount));
+
+		size_type i = 0;
+
+		try
+		{
+			for (; i < count; ++i)
+			{
+				T* item = At(head + i).Get();
+
+				*aOut = std::move(*item);
+				++aOut;
+
+				std::destroy_at(item);
+			}
+		}
+		catch (...)
+		{
+			myHead.store(head + i, std::memory_order_release);
+			throw;
+		}
+
+		myHead.store(head + count, std::memory_order_release);
+
+		return count;
+	}
+
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	auto SPSCQueue<T>::At(size_type aPosition) const noexcept -> Slot&
+	{
+		return mySlots[aPosition & myMask];
+	}
+
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	auto SPSCQueue<T>::FreeSlots(size_type aTail, size_type aCount) noexcept -> size_type
+	{
+		size_type free = capacity() - (aTail - myHeadCache);
+		if (free < aCount)
+		{
+			myHeadCache = myHead.load(std::memory_order_acquire); // slots freed by the consumer are safe to reuse
+			free = capacity() - (aTail - myHeadCache);
+		}
+
+		return free;
+	}
+
+	template<typename T> requires (std::is_nothrow_destructible_v<T>)
+	auto SPSCQueue<T>::FilledSlots(size_type aHead, size_type aCount) noexcept -> size_type
+	{
+		size_type filled = myTailCache - aHead;
+		if (filled < aCount)
+		{
+			myTailCache = myTail.load(std::memory_order_acquire); // elements written by the producer are visible
+			filled = myTailCache - aHead;
+		}
+
+		return filled;
+	}
+}
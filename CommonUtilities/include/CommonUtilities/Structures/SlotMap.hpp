@@ -0,0 +1,445 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <functional>
+#include <stdexcept>
+#include <cstdint>
+#include <cassert>
+
+#include <CommonUtilities/Structures/FreeVector.hpp>
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+	/// Index to a slot together with the generation it was handed out in. Erasing a slot advances its
+	/// generation, so a handle that outlives its element is detected rather than reaching whatever
+	/// reuses the slot. Default constructed handles are never valid.
+	///
+	struct SlotHandle
+	{
+		std::uint32_t index			{0};
+		std::uint32_t generation	{0};
+
+		NODISC constexpr explicit operator bool() const noexcept { return generation != 0; }
+
+		NODISC friend constexpr bool operator==(const SlotHandle&, const SlotHandle&) noexcept = default;
+	};
+
+	namespace details::slot
+	{
+		inline constexpr std::uint32_t FIRST_GENERATION = 1;
+
+		NODISC constexpr std::uint32_t NextGeneration(std::uint32_t aGeneration) noexcept
+		{
+			return aGeneration + 1 != 0 ? aGeneration + 1 : FIRST_GENERATION; // zero is left for invalid handles
+		}
+	}
+
+	/// Stores values densely packed in a vector for fast iteration, while the handles returned stay stable.
+	/// Handles go through a FreeVector of slots that point to the values, and erasing moves the last
+	/// value into the hole, so iteration order is not preserved.
+	///
+	template<class T, class Alloc = std::allocator<T>>
+	class SlotMap
+	{
+	public:
+		using value_type		= T;
+		using reference			= T&;
+		using const_reference	= const T&;
+		using pointer			= T*;
+		using const_pointer		= const T*;
+		using size_type			= std::size_t;
+		using allocator_type	= Alloc;
+		using handle_type		= SlotHandle;
+
+		template<typename U>
+		using Rebind = typename std::allocator_traits<Alloc>::template rebind_alloc<U>;
+
+		using container_type	= std::vector<T, Rebind<T>>;
+		using iterator			= typename container_type::iterator;
+		using const_iterator	= typename container_type::const_iterator;
+
+		constexpr explicit SlotMap(const Alloc& aAllocator);
+
+		constexpr SlotMap() = default;
+		constexpr ~SlotMap() = default;
+
+		constexpr SlotMap(const SlotMap&) = default;
+		constexpr SlotMap(SlotMap&&) noexcept = default;
+
+		constexpr auto operator=(const SlotMap&) -> SlotMap& = default;
+		constexpr auto operator=(SlotMap&&) noexcept -> SlotMap& = default;
+
+		/// \returns Copy of the allocator the values are allocated with.
+		///
+		NODISC constexpr auto get_allocator() const noexcept -> allocator_type;
+
+		/// \param Handle: Handle to element, must be valid.
+		///
+		/// \returns Reference to element.
+		///
+		NODISC constexpr auto operator[](handle_type aHandle) -> reference;
+
+		/// \param Handle: Handle to element, must be valid.
+		///
+		/// \returns Const reference to element.
+		///
+		NODISC constexpr auto operator[](handle_type aHandle) const -> const_reference;
+
+		/// \param Handle: Handle to element.
+		///
+		/// \returns Reference to element, throws std::out_of_range if the handle is stale.
+		///
+		NODISC constexpr auto at(handle_type aHandle) -> reference;
+
+		/// \param Handle: Handle to element.
+		///
+		/// \returns Const reference to element, throws std::out_of_range if the handle is stale.
+		///
+		NODISC constexpr auto at(handle_type aHandle) const -> const_reference;
+
+		/// \param Handle: Handle to element.
+		///
+		/// \returns Pointer to element, or nullptr if the handle is stale.
+		///
+		NODISC constexpr auto find(handle_type aHandle) -> pointer;
+
+		/// \param Handle: Handle to element.
+		///
+		/// \returns Const pointer to element, or nullptr if the handle is stale.
+		///
+		NODISC constexpr auto find(handle_type aHandle) const -> const_pointer;
+
+		/// \param Handle: Handle to element.
+		///
+		/// \returns Whether the handle refers to an element that has not been erased.
+		///
+		NODISC constexpr bool contains(handle_type aHandle) const;
+
+		/// \param Index: Position of element in the packed values, e.g., while iterating.
+		///
+		/// \returns Handle to the element.
+		///
+		NODISC constexpr auto get_handle(size_type aIndex) const -> handle_type;
+
+		/// \returns If it contains any elements.
+		///
+		NODISC constexpr bool empty() const noexcept;
+
+		/// \returns Number of elements in the container.
+		///
+		NODISC constexpr auto size() const noexcept -> size_type;
+
+		/// \returns Capacity of the packed values.
+		///
+		NODISC constexpr auto capacity() const noexcept -> size_type;
+
+		/// \returns Pointer to the packed values.
+		///
+		NODISC constexpr auto data() noexcept -> pointer;
+
+		/// \returns Const pointer to the packed values.
+		///
+		NODISC constexpr auto data() const noexcept -> const_pointer;
+
+		NODISC constexpr auto begin() noexcept -> iterator;
+		NODISC constexpr auto end() noexcept -> iterator;
+
+		NODISC constexpr auto begin() const noexcept -> const_iterator;
+		NODISC constexpr auto end() const noexcept -> const_iterator;
+
+		/// Emplace element in container.
+		///
+		/// \param someArgs: Optional parameters to construct element.
+		///
+		/// \returns Handle to access constructed element.
+		///
+		template<typename... Args> requires std::constructible_from<T, Args...>
+		constexpr auto emplace(Args&&... someArgs) -> handle_type;
+
+		/// Add element to container.
+		///
+		/// \param anElement: Element to add.
+		///
+		/// \returns Handle to access added element.
+		///
+		constexpr auto insert(const T& anElement) -> handle_type;
+
+		/// Add element to container.
+		///
+		/// \param anElement: Element to add.
+		///
+		/// \returns Handle to access added element.
+		///
+		constexpr auto insert(T&& anElement) -> handle_type;
+
+		/// Removes element, moving the last element into its place.
+		///
+		/// \param Handle: Handle to element to remove.
+		///
+		/// \returns True if removed, false if the handle was stale.
+		///
+		constexpr bool erase(handle_type aHandle);
+
+		/// Removes all elements, every handle handed out so far becomes stale.
+		///
+		constexpr void clear();
+
+		/// Reserve to reduce reallocation.
+		///
+		constexpr void reserve(size_type aCapacity);
+
+		/// Calls func with the handle and element for each element, in packed order.
+		///
+		template<typename Func>
+		constexpr void for_each(const Func& func) const;
+
+		template<typename Func>
+		constexpr void for_each(const Func& func);
+
+	private:
+		container_type										myValues;
+		std::vector<std::uint32_t, Rebind<std::uint32_t>>	myValueSlots;	// slot of each value
+		FreeVector<std::uint32_t, Rebind<std::uint32_t>>	mySlots;		// position of the value in each slot
+		std::vector<std::uint32_t, Rebind<std::uint32_t>>	myGenerations;	// outlives the slot, so it is kept apart from it
+	};
+
+	template<class T, class Alloc>
+	constexpr SlotMap<T, Alloc>::SlotMap(const Alloc& aAllocator)
+		: myValues(aAllocator), myValueSlots(aAllocator), mySlots(aAllocator), myGenerations(aAllocator)
+	{
+
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::get_allocator() const noexcept -> allocator_type
+	{
+		return allocator_type(myValues.get_allocator());
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::operator[](handle_type aHandle) -> reference
+	{
+		assert(contains(aHandle) && "Handle is stale");
+		return myValues[mySlots[aHandle.index]];
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::operator[](handle_type aHandle) const -> const_reference
+	{
+		assert(contains(aHandle) && "Handle is stale");
+		return myValues[mySlots[aHandle.index]];
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::at(handle_type aHandle) -> reference
+	{
+		return const_cast<reference>(std::as_const(*this).at(aHandle));
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::at(handle_type aHandle) const -> const_reference
+	{
+		if (!contains(aHandle))
+			throw std::out_of_range("Handle is stale");
+
+		return myValues[mySlots[aHandle.index]];
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::find(handle_type aHandle) -> pointer
+	{
+		return const_cast<pointer>(std::as_const(*this).find(aHandle));
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::find(handle_type aHandle) const -> const_pointer
+	{
+		return contains(aHandle) ? &myValues[mySlots[aHandle.index]] : nullptr;
+	}
+
+	template<class T, class Alloc>
+	constexpr bool SlotMap<T, Alloc>::contains(handle_type aHandle) const
+	{
+		// a slot's generation is only advanced on erase, so it matching means the slot is still valid
+
+		return aHandle.index < myGenerations.size() && myGenerations[aHandle.index] == aHandle.generation && mySlots.valid(aHandle.index);
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::get_handle(size_type aIndex) const -> handle_type
+	{
+		const std::uint32_t slot = myValueSlots[aIndex];
+		return handle_type{slot, myGenerations[slot]};
+	}
+
+	template<class T, class Alloc>
+	constexpr bool SlotMap<T, Alloc>::empty() const noexcept
+	{
+		return myValues.empty();
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::size() const noexcept -> size_type
+	{
+		return myValues.size();
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::capacity() const noexcept -> size_type
+	{
+		return myValues.capacity();
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::data() noexcept -> pointer
+	{
+		return myValues.data();
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::data() const noexcept -> const_pointer
+	{
+		return myValues.data();
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::begin() noexcept -> iterator
+	{
+		return myValues.begin();
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::end() noexcept -> iterator
+	{
+		return myValues.end();
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::begin() const noexcept -> const_iterator
+	{
+		return myValues.begin();
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::end() const noexcept -> const_iterator
+	{
+		return myValues.end();
+	}
+
+	template<class T, class Alloc>
+	template<typename... Args> requires std::constructible_from<T, Args...>
+	constexpr auto SlotMap<T, Alloc>::emplace(Args&&... someArgs) -> handle_type
+	{
+		const auto index = static_cast<std::uint32_t>(myValues.size());
+
+		myValues.emplace_back(std::forward<Args>(someArgs)...);
+
+		const auto slot = static_cast<std::uint32_t>(mySlots.emplace(index));
+		if (slot == myGenerations.size())
+			myGenerations.emplace_back(details::slot::FIRST_GENERATION);
+
+		myValueSlots.emplace_back(slot);
+
+		return handle_type{slot, myGenerations[slot]};
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::insert(const T& anElement) -> handle_type
+	{
+		return emplace(anElement);
+	}
+
+	template<class T, class Alloc>
+	constexpr auto SlotMap<T, Alloc>::insert(T&& anElement) -> handle_type
+	{
+		return emplace(std::move(anElement));
+	}
+
+	template<class T, class Alloc>
+	constexpr bool SlotMap<T, Alloc>::erase(handle_type aHandle)
+	{
+		if (!contains(aHandle))
+			return false;
+
+		const std::uint32_t index	= mySlots[aHandle.index];
+		const std::uint32_t last	= static_cast<std::uint32_t>(myValues.size() - 1);
+
+		if (index != last)
+		{
+			myValues[index]		= std::move(myValues[last]);
+			myValueSlots[index]	= myValueSlots[last];
+
+			mySlots[myValueSlots[index]] = index;
+		}
+
+		myValues.pop_back();
+		myValueSlots.pop_back();
+
+		mySlots.erase(aHandle.index);
+		myGenerations[aHandle.index] = details::slot::NextGeneration(myGenerations[aHandle.index]);
+
+		return true;
+	}
+
+	template<class T, class Alloc>
+	constexpr void SlotMap<T, Alloc>::clear()
+	{
+		// generations are kept so that the handles stay stale once their slots are reused
+
+		for (const std::uint32_t slot : myValueSlots)
+		{
+			myGenerations[slot] = details::slot::NextGeneration(myGenerations[slot]);
+		}
+
+		myValues.clear();
+		myValueSlots.clear();
+		mySlots.clear();
+	}
+
+	template<class T, class Alloc>
+	constexpr void SlotMap<T, Alloc>::reserve(size_type aCapacity)
+	{
+		myValues.reserve(aCapacity);
+		myValueSlots.reserve(aCapacity);
+		mySlots.reserve(aCapacity);
+		myGenerations.reserve(aCapacity);
+	}
+
+	template<class T, class Alloc>
+	template<typename Func>
+	constexpr void SlotMap<T, Alloc>::for_each(const Func& func) const
+	{
+		for (size_type i = 0; i < myValues.size(); ++i)
+		{
+			func(get_handle(i), myValues[i]);
+		}
+	}
+
+	template<class T, class Alloc>
+	template<typename Func>
+	constexpr void SlotMap<T, Alloc>::for_each(const Func& func)
+	{
+		for (size_type i = 0; i < myValues.size(); ++i)
+		{
+			func(get_handle(i), myValues[i]);
+		}
+	}
+
+	namespace pmr
+	{
+		template<class T>
+		using SlotMap = CommonUtilities::SlotMap<T, std::pmr::polymorphic_allocator<T>>;
+	}
+}
+
+template<>
+struct std::hash<CommonUtilities::SlotHandle>
+{
+	NODISC std::size_t operator()(const CommonUtilities::SlotHandle& aHandle) const noexcept
+	{
+		return std::hash<std::uint64_t>{}((std::uint64_t(aHandle.generation) << 32) | aHandle.index);
+	}
+};
@@ -1,9 +1,17 @@
 #pragma once
 
-#include <array>
-#include <vector>
+#include <memory>
+#include <memory_resource>
 #include <iterator>
-
+#include <algorithm>
+#include <initializer_list>
+#include <stdexcept>
+#include <limits>
+#include <concepts>
+#include <cstddef>
+#include <cassert>
+
+#include <CommonUtilities/Utility/Relocation.hpp>
 #include <CommonUtilities/Config.h>
 
 namespace CommonUtilities
@@ -78,12 +86,56 @@ namespace CommonUtilities
 		friend class SmallIterator;
 	};
 
-	template<typename T, std::size_t N = 32, class Alloc = std::allocator<T>>
+	namespace smallvec
+	{
+		/// Doubles the capacity, fewest reallocations when adding one element at a time.
+		///
+		struct GrowDouble
+		{
+			NODISC static constexpr auto Grow(std::size_t aCapacity, std::size_t aRequired) noexcept -> std::size_t
+			{
+				return (std::max)(aCapacity * 2, aRequired);
+			}
+		};
+
+		/// Grows by half, trading more reallocations for less unused capacity.
+		///
+		struct GrowHalf
+		{
+			NODISC static constexpr auto Grow(std::size_t aCapacity, std::size_t aRequired) noexcept -> std::size_t
+			{
+				return (std::max)(aCapacity + aCapacity / 2, aRequired);
+			}
+		};
+
+		/// Grows to exactly what is required, for vectors that are rarely added to after being filled.
+		///
+		struct GrowExact
+		{
+			NODISC static constexpr auto Grow(std::size_t, std::size_t aRequired) noexcept -> std::size_t
+			{
+				return aRequired;
+			}
+		};
+
+		template<class G>
+		concept GrowthPolicy = requires(std::size_t aCapacity, std::size_t aRequired)
+		{
+			{ G::Grow(aCapacity, aRequired) } -> std::convertible_to<std::size_t>;
+		};
+	}
+
+	/// Vector that stores up to N elements inside itself and only allocates once it grows past that. The
+	/// heap buffer is kept when the size drops below N again, use shrink_to_fit to move back.
+	///
+	/// Elements that are TriviallyRelocatable are moved with memcpy and memmove when growing, inserting,
+	/// erasing, and swapping, instead of being moved one by one. Growth decides how much the capacity is
+	/// increased by when it runs out, see smallvec::GrowDouble.
+	///
+	template<typename T, std::size_t N = 32, class Alloc = std::allocator<T>, smallvec::GrowthPolicy Growth = smallvec::GrowDouble>
 	class SmallVector
 	{
 	public:
-		static_assert(!std::is_same_v<T, bool>, "Small vector is not compatible with bool because of std::vector<bool> specialization");
-
 		using value_type		= T;
 		using reference			= T&;
 		using const_reference	= const T&;
@@ -98,8 +150,10 @@ namespace CommonUtilities
 		using reverse_iterator			= SmallIterator<value_type, true>;
 		using const_reverse_iterator	= SmallIterator<const value_type, true>;
 
+		static constexpr size_type INLINE_CAPACITY = N;
+
 		constexpr SmallVector() = default;
-		constexpr ~SmallVector() = default;
+		constexpr ~SmallVector();
 
 		constexpr SmallVector(const allocator_type& aAlloc);
 		constexpr SmallVector(size_type aSize, const allocator_type& aAlloc = allocator_type());
@@ -108,11 +162,16 @@ namespace CommonUtilities
 		constexpr SmallVector(Iter aFirst, Iter aLast, const allocator_type& aAlloc = allocator_type());
 		constexpr SmallVector(std::initializer_list<T> aInitList, const allocator_type& aAlloc = allocator_type());
 
-		constexpr SmallVector(const SmallVector& aOther, const allocator_type& aAlloc = allocator_type());
-		constexpr SmallVector(SmallVector&& aOther, const allocator_type& aAlloc = allocator_type()) noexcept;
+		constexpr SmallVector(const SmallVector& aOther);
+		constexpr SmallVector(SmallVector&& aOther) noexcept(NOTHROW_RELOCATE);
+
+		constexpr SmallVector(const SmallVector& aOther, const allocator_type& aAlloc);
+		constexpr SmallVector(SmallVector&& aOther, const allocator_type& aAlloc);
 
 		constexpr auto operator=(const SmallVector& aRhs) -> SmallVector&;
-		constexpr auto operator=(SmallVector&& aRhs) noexcept -> SmallVector&;
+		constexpr auto operator=(SmallVector&& aRhs) noexcept(NOTHROW_RELOCATE && (
+			std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+			std::allocator_traits<Alloc>::is_always_equal::value)) -> SmallVector&;
 		constexpr auto operator=(std::initializer_list<T> aInitList) -> SmallVector&;
 
 		NODISC constexpr bool operator==(const SmallVector& aRhs) const;
@@ -134,6 +193,7 @@ namespace CommonUtilities
 
 		NODISC constexpr bool empty() const noexcept;
 		NODISC constexpr auto size() const noexcept -> size_type;
+		NODISC constexpr auto capacity() const noexcept -> size_type;
 
 		NODISC constexpr auto max_size() const noexcept -> size_type;
 
@@ -157,13 +217,26 @@ namespace CommonUtilities
 		constexpr auto insert(const_iterator aIterator, T&& aElement) -> iterator;
 
 		constexpr void fill(const_reference aElement);
-		constexpr void resize(size_type aSize, const_reference aValue = T());
 
+		constexpr void resize(size_type aSize);
+		constexpr void resize(size_type aSize, const_reference aValue);
+
+		/// Makes room for at least Capacity elements without applying the growth policy.
+		///
+		constexpr void reserve(size_type aCapacity);
+
+		/// Releases unused capacity, moving the elements back inside the vector if they fit.
+		///
 		constexpr void shrink_to_fit();
 
-		constexpr void clear();
+		constexpr void clear() noexcept;
 
-		constexpr friend void swap(SmallVector& aLhs, SmallVector& aRhs);
+		constexpr void swap(SmallVector& aOther);
+
+		constexpr friend void swap(SmallVector& aLhs, SmallVector& aRhs)
+		{
+			aLhs.swap(aRhs);
+		}
 
 		NODISC constexpr auto begin() noexcept -> iterator;
 		NODISC constexpr auto end() noexcept -> iterator;
@@ -184,529 +257,820 @@ namespace CommonUtilities
 		NODISC constexpr auto crend() const noexcept -> const_reverse_iterator;
 
 	private:
-		using signed_type = std::make_signed_t<size_type>;
+		using alloc_traits = std::allocator_traits<Alloc>;
+
+		static constexpr bool NOTHROW_RELOCATE = IsTriviallyRelocatable<T> || std::is_nothrow_move_constructible_v<T>;
+
+		NODISC constexpr auto InlineData() noexcept -> pointer;
+		NODISC constexpr auto InlineData() const noexcept -> const_pointer;
+
+		NODISC constexpr bool IsInline() const noexcept;
+
+		NODISC constexpr auto NextCapacity(size_type aRequired) const -> size_type;
+
+		constexpr void Reallocate(size_type aCapacity);
+
+		/// Moves the elements to a larger buffer with a new element constructed at Index. The element is
+		/// constructed first, as the arguments may refer to the elements being moved.
+		///
+		template<typename... Args>
+		constexpr auto ReallocateEmplace(size_type aIndex, Args&&... someArgs) -> pointer;
+
+		/// Moves elements into uninitialized memory, destroying what was constructed if one throws.
+		///
+		constexpr auto MoveInto(pointer aFirst, pointer aLast, pointer aDest) -> pointer;
+
+		/// Moves elements into uninitialized memory and destroys the originals.
+		///
+		constexpr void Relocate(pointer aFirst, pointer aLast, pointer aDest);
 
-		NODISC constexpr __forceinline bool IsStack() const noexcept;
-		NODISC constexpr __forceinline bool IsHeap() const noexcept;
+		constexpr void DestroyRange(pointer aFirst, pointer aLast) noexcept;
 
-		std::array<T, N>		myStack	{};
-		std::vector<T, Alloc>	myHeap	{};
-		size_type				mySize	{0};
+		template<class Iter>
+		constexpr void Assign(Iter aFirst, Iter aLast);
+
+		constexpr void Destroy() noexcept;
+		constexpr void Steal(SmallVector& aOther);
+
+		pointer				myData		{InlineData()};
+		size_type			mySize		{0};
+		size_type			myCapacity	{N};
+		NOADDRESS Alloc		myAllocator;
+		alignas(T) std::byte myInline[sizeof(T) * (N > 0 ? N : 1)];
 	};
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr SmallVector<T, N, Alloc>::SmallVector(const allocator_type& aAlloc)
-		: myStack(), myHeap(aAlloc), mySize()
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr SmallVector<T, N, Alloc, Growth>::~SmallVector()
+	{
+		Destroy();
+	}
+
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr SmallVector<T, N, Alloc, Growth>::SmallVector(const allocator_type& aAlloc)
+		: myAllocator(aAlloc)
 	{
 
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr SmallVector<T, N, Alloc>::SmallVector(size_type aSize, const allocator_type& aAlloc)
-		: myStack(), myHeap(aAlloc), mySize(aSize)
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr SmallVector<T, N, Alloc, Growth>::SmallVector(size_type aSize, const allocator_type& aAlloc)
+		: SmallVector(aAlloc)
 	{
-		if (IsHeap())
-		{
-			myHeap = std::vector<T>(mySize, aAlloc);
-		}
+		resize(aSize);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr SmallVector<T, N, Alloc>::SmallVector(size_type aSize, const_reference aValue, const allocator_type& aAlloc)
-		: myStack(), myHeap(aAlloc), mySize(aSize)
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr SmallVector<T, N, Alloc, Growth>::SmallVector(size_type aSize, const_reference aValue, const allocator_type& aAlloc)
+		: SmallVector(aAlloc)
 	{
-		if (IsStack())
-		{
-			std::fill(myStack.begin(), myStack.begin() + mySize, aValue);
-		}
-		else
-		{
-			myHeap = std::vector<T>(mySize, aValue, aAlloc);
-		}
+		resize(aSize, aValue);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
 	template<class Iter> requires (std::forward_iterator<Iter> && std::constructible_from<T, typename Iter::value_type>)
-	constexpr SmallVector<T, N, Alloc>::SmallVector(Iter aFirst, Iter aLast, const allocator_type& aAlloc)
-		: myStack(), myHeap(), mySize(std::distance(aFirst, aLast))
+	constexpr SmallVector<T, N, Alloc, Growth>::SmallVector(Iter aFirst, Iter aLast, const allocator_type& aAlloc)
+		: SmallVector(aAlloc)
 	{
-		if (IsStack())
-		{
-			std::copy(aFirst, aLast, myStack.begin());
-		}
-		else
-		{
-			myHeap = std::vector<T>(aFirst, aLast, aAlloc);
-		}
+		Assign(aFirst, aLast);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr SmallVector<T, N, Alloc>::SmallVector(std::initializer_list<T> aInitList, const allocator_type& aAlloc)
-		: SmallVector(const_iterator(aInitList.begin()), const_iterator(aInitList.end()), aAlloc)
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr SmallVector<T, N, Alloc, Growth>::SmallVector(std::initializer_list<T> aInitList, const allocator_type& aAlloc)
+		: SmallVector(aAlloc)
 	{
-
+		Assign(aInitList.begin(), aInitList.end());
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr SmallVector<T, N, Alloc>::SmallVector(const SmallVector& aOther, const allocator_type& aAlloc)
-		: SmallVector(aOther.begin(), aOther.end(), aAlloc)
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr SmallVector<T, N, Alloc, Growth>::SmallVector(const SmallVector& aOther)
+		: SmallVector(aOther, alloc_traits::select_on_container_copy_construction(aOther.myAllocator))
 	{
 
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr SmallVector<T, N, Alloc>::SmallVector(SmallVector&& aOther, const allocator_type& aAlloc) noexcept
-		: myStack(), myHeap(aAlloc), mySize(aOther.mySize) 
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr SmallVector<T, N, Alloc, Growth>::SmallVector(SmallVector&& aOther) noexcept(NOTHROW_RELOCATE)
+		: SmallVector(aOther.myAllocator)
 	{
-		if (IsStack())
-		{
-			std::move(aOther.myStack.begin(), aOther.myStack.begin() + mySize, myStack.begin());
-		}
-		else
-		{
-			myHeap = std::move(aOther.myHeap);
-		}
+		Steal(aOther);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::operator=(const SmallVector& aRhs) -> SmallVector&
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr SmallVector<T, N, Alloc, Growth>::SmallVector(const SmallVector& aOther, const allocator_type& aAlloc)
+		: SmallVector(aAlloc)
 	{
-		if (aRhs.mySize <= N)
-		{
-			std::copy(aRhs.myStack.begin(), aRhs.myStack.begin() + aRhs.mySize, myStack.begin());
-		}
-		else
-		{
-			myHeap = aRhs.myHeap;
-		}
-
-		mySize = aRhs.mySize;
+		Assign(aOther.myData, aOther.myData + aOther.mySize);
+	}
 
-		return *this;
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr SmallVector<T, N, Alloc, Growth>::SmallVector(SmallVector&& aOther, const allocator_type& aAlloc)
+		: SmallVector(aAlloc)
+	{
+		Steal(aOther);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::operator=(SmallVector&& aRhs) noexcept -> SmallVector&
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::operator=(const SmallVector& aRhs) -> SmallVector&
 	{
-		if (aRhs.mySize <= N)
+		if (this != &aRhs)
 		{
-			std::move(aRhs.myStack.begin(), aRhs.myStack.begin() + aRhs.mySize, myStack.begin());
-		}
-		else
-		{
-			myHeap = std::move(aRhs.myHeap);
-		}
+			if constexpr (alloc_traits::propagate_on_container_copy_assignment::value)
+			{
+				if (myAllocator != aRhs.myAllocator)
+					Destroy(); // buffer has to be freed by the allocator that made it
 
-		mySize = aRhs.mySize;
-		aRhs.mySize = 0;
+				myAllocator = aRhs.myAllocator;
+			}
+
+			clear();
+			Assign(aRhs.myData, aRhs.myData + aRhs.mySize);
+		}
 
 		return *this;
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::operator=(std::initializer_list<T> aInitList) -> SmallVector&
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::operator=(SmallVector&& aRhs) noexcept(NOTHROW_RELOCATE && (
+		std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+		std::allocator_traits<Alloc>::is_always_equal::value)) -> SmallVector&
 	{
-		if (aInitList.size() <= N)
-		{
-			std::copy(aInitList.begin(), aInitList.end(), myStack.begin());
-		}
-		else
+		if (this != &aRhs)
 		{
-			myHeap = aInitList;
+			Destroy();
+
+			if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+			{
+				myAllocator = std::move(aRhs.myAllocator);
+			}
+
+			Steal(aRhs);
 		}
 
-		mySize = aInitList.size();
+		return *this;
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr bool SmallVector<T, N, Alloc>::operator==(const SmallVector& aRhs) const
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::operator=(std::initializer_list<T> aInitList) -> SmallVector&
 	{
-		if (mySize != aRhs.mySize)
-			return false;
+		clear();
+		Assign(aInitList.begin(), aInitList.end());
 
-		if (IsStack())
-		{
-			for (size_type index = 0; index < mySize; ++index)
-			{
-				if (myStack[index] != aRhs[index])
-					return false;
-			}
+		return *this;
+	}
 
-			return true;
-		}
-		
-		return (myHeap == aRhs.myHeap);
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr bool SmallVector<T, N, Alloc, Growth>::operator==(const SmallVector& aRhs) const
+	{
+		return std::equal(begin(), end(), aRhs.begin(), aRhs.end());
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::operator[](size_type aIndex) -> reference
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::operator[](size_type aIndex) -> reference
 	{
-		return (IsStack()) ? myStack[aIndex] : myHeap[aIndex];
+		assert(aIndex < mySize && "Index is out of bounds!");
+		return myData[aIndex];
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::operator[](size_type aIndex) const -> const_reference
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::operator[](size_type aIndex) const -> const_reference
 	{
-		return (IsStack()) ? myStack[aIndex] : myHeap[aIndex];
+		assert(aIndex < mySize && "Index is out of bounds!");
+		return myData[aIndex];
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::at(size_type aIndex) -> reference
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::at(size_type aIndex) -> reference
 	{
-		return (IsStack()) ? myStack.at(aIndex) : myHeap.at(aIndex);
+		if (aIndex >= mySize)
+			throw std::out_of_range("Index is out of bounds!");
+
+		return myData[aIndex];
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::at(size_type aIndex) const -> const_reference
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::at(size_type aIndex) const -> const_reference
 	{
-		return (IsStack()) ? myStack.at(aIndex) : myHeap.at(aIndex);
+		if (aIndex >= mySize)
+			throw std::out_of_range("Index is out of bounds!");
+
+		return myData[aIndex];
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::front() -> reference
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::front() -> reference
 	{
-		return (IsStack()) ? myStack.front() : myHeap.front();
+		return myData[0];
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::front() const -> const_reference
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::front() const -> const_reference
 	{
-		return (IsStack()) ? myStack.front() : myHeap.front();
+		return myData[0];
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::back() -> reference
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::back() -> reference
 	{
-		return (IsStack()) ? myStack[mySize - 1] : myHeap.back();
+		return myData[mySize - 1];
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::back() const -> const_reference
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::back() const -> const_reference
 	{
-		return (IsStack()) ? myStack[mySize - 1] : myHeap.back();
+		return myData[mySize - 1];
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::data() noexcept -> pointer
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::data() noexcept -> pointer
 	{
-		return (IsStack()) ? myStack.data() : myHeap.data();
+		return myData;
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::data() const noexcept -> const_pointer
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::data() const noexcept -> const_pointer
 	{
-		return (IsStack()) ? myStack.data() : myHeap.data();
+		return myData;
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr bool SmallVector<T, N, Alloc>::empty() const noexcept
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr bool SmallVector<T, N, Alloc, Growth>::empty() const noexcept
 	{
 		return mySize == 0;
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::size() const noexcept -> size_type
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::size() const noexcept -> size_type
 	{
 		return mySize;
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::max_size() const noexcept -> size_type
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::capacity() const noexcept -> size_type
 	{
-		return (IsStack()) ? myStack.max_size() : myHeap.max_size();
+		return myCapacity;
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::get_allocator() const noexcept -> allocator_type
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::max_size() const noexcept -> size_type
 	{
-		return myHeap.get_allocator();
+		return (std::min)(static_cast<size_type>(alloc_traits::max_size(myAllocator)),
+			static_cast<size_type>((std::numeric_limits<difference_type>::max)()) / sizeof(T));
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	template<typename... Args>
-	constexpr auto SmallVector<T, N, Alloc>::emplace_back(Args&&... someArgs) -> reference
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::get_allocator() const noexcept -> allocator_type
 	{
-		if (mySize < N)
-		{
-			myStack[mySize] = T(std::forward<Args>(someArgs)...);
-		}
-		else
-		{
-			if (mySize == N)
-				std::move(myStack.begin(), myStack.end(), std::back_inserter(myHeap));
+		return myAllocator;
+	}
 
-			myHeap.emplace_back(std::forward<Args>(someArgs)...);
-		}
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	template<typename... Args>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::emplace_back(Args&&... someArgs) -> reference
+	{
+		if (mySize == myCapacity)
+			return *ReallocateEmplace(mySize, std::forward<Args>(someArgs)...);
 
+		alloc_traits::construct(myAllocator, myData + mySize, std::forward<Args>(someArgs)...);
 		++mySize;
 
 		return back();
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr void SmallVector<T, N, Alloc>::push_back(const T& aElement)
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::push_back(const T& aElement)
 	{
 		emplace_back(aElement);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr void SmallVector<T, N, Alloc>::push_back(T&& aElement)
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::push_back(T&& aElement)
 	{
 		emplace_back(std::move(aElement));
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr void SmallVector<T, N, Alloc>::pop_back()
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::pop_back()
 	{
 		if (empty())
 			return;
 
-		if (IsStack())
-		{
-			--mySize;
-		}
-		else
-		{
-			myHeap.pop_back();
-			--mySize;
-
-			if (mySize == N)
-			{
-				std::move(myHeap.begin(), myHeap.end(), myStack.begin());
-				myHeap.clear();
-			}
-		}
+		--mySize;
+		alloc_traits::destroy(myAllocator, myData + mySize);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::erase(const_iterator aPosition) -> iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::erase(const_iterator aPosition) -> iterator
 	{
 		if (empty()) // nothing to erase
 			return end();
 
-		const auto posIndex = std::distance(cbegin(), aPosition);
+		pointer position = myData + std::distance(cbegin(), aPosition);
 
-		if (IsStack())
+		if constexpr (IsTriviallyRelocatable<T>)
 		{
-			for (auto index = static_cast<size_type>(posIndex); index < mySize - 1; ++index)
-				myStack[index] = std::move(myStack[index + 1]);
-
-			--mySize;
+			alloc_traits::destroy(myAllocator, position);
+			details::relocate::Shift(position + 1, myData + mySize, position);
 		}
 		else
 		{
-			myHeap.erase(myHeap.begin() + posIndex);
-			--mySize;
-
-			if (mySize == N)
-			{
-				std::move(myHeap.begin(), myHeap.end(), myStack.begin());
-				myHeap.clear();
-			}
+			std::move(position + 1, myData + mySize, position);
+			alloc_traits::destroy(myAllocator, myData + mySize - 1);
 		}
 
-		return begin() + posIndex;
+		--mySize;
+
+		return iterator(position);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::erase(const_iterator aFirst, const_iterator aLast) -> iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::erase(const_iterator aFirst, const_iterator aLast) -> iterator
 	{
-		assert(aFirst < aLast && "Invalid iterators provided");
+		assert(aFirst <= aLast && "Invalid iterators provided");
 
-		if (empty()) // nothing to erase
-			return end();
+		pointer first	= myData + std::distance(cbegin(), aFirst);
+		pointer last	= myData + std::distance(cbegin(), aLast);
 
-		const auto firstPos = std::distance(cbegin(), aFirst);
-		const auto lastPos	= std::distance(cbegin(), aLast);
-		const auto count	= lastPos - firstPos;
+		const auto count = static_cast<size_type>(last - first);
 
-		if (IsStack())
-		{
-			for (auto index = static_cast<size_type>(firstPos); index < mySize - count; ++index)
-				myStack[index] = std::move(myStack[index + count]);
+		if (count == 0) // nothing to erase
+			return iterator(first);
 
-			mySize -= count;
+		if constexpr (IsTriviallyRelocatable<T>)
+		{
+			DestroyRange(first, last);
+			details::relocate::Shift(last, myData + mySize, first);
 		}
 		else
 		{
-			myHeap.erase(myHeap.begin() + firstPos, myHeap.begin() + lastPos);
-			mySize -= count;
-
-			if (IsStack())
-			{
-				std::move(myHeap.begin(), myHeap.end(), myStack.begin());
-				myHeap.clear();
-			}
+			std::move(last, myData + mySize, first);
+			DestroyRange(myData + mySize - count, myData + mySize);
 		}
 
-		return begin() + firstPos;
+		mySize -= count;
+
+		return iterator(first);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
 	template<typename... Args> requires (std::constructible_from<T, Args...>)
-	constexpr auto SmallVector<T, N, Alloc>::emplace(const_iterator aPosition, Args&&... someArgs) -> iterator
+	constexpr auto SmallVector<T, N, Alloc, Growth>::emplace(const_iterator aPosition, Args&&... someArgs) -> iterator
 	{
-		const auto posIndex = std::distance(cbegin(), aPosition);
+		const auto index = static_cast<size_type>(std::distance(cbegin(), aPosition));
+
+		if (mySize == myCapacity)
+			return iterator(ReallocateEmplace(index, std::forward<Args>(someArgs)...));
+
+		pointer position = myData + index;
 
-		if (mySize < N)
+		if (index == mySize)
 		{
-			if (posIndex < static_cast<decltype(posIndex)>(mySize))
-			{
-				std::move_backward(myStack.begin() + posIndex, myStack.begin() + mySize - 1, myStack.begin() + mySize);
-			}
+			alloc_traits::construct(myAllocator, position, std::forward<Args>(someArgs)...);
+		}
+		else if constexpr (IsTriviallyRelocatable<T>)
+		{
+			// construct aside first as the arguments may refer to elements that are about to be shifted
+			alignas(T) std::byte temp[sizeof(T)];
+			pointer element = reinterpret_cast<pointer>(temp);
 
-			myStack[posIndex] = T{ std::forward<Args>(someArgs)... };
+			alloc_traits::construct(myAllocator, element, std::forward<Args>(someArgs)...);
+
+			details::relocate::Shift(position, myData + mySize, position + 1);
+			details::relocate::Relocate(element, element + 1, position);
 		}
 		else
 		{
-			if (mySize == N)
-				std::move(myStack.begin(), myStack.end(), std::back_inserter(myHeap));
+			T element(std::forward<Args>(someArgs)...);
+
+			alloc_traits::construct(myAllocator, myData + mySize, std::move(myData[mySize - 1]));
+			std::move_backward(position, myData + mySize - 1, myData + mySize);
 
-			myHeap.emplace(myHeap.begin() + posIndex, std::forward<Args>(someArgs)...);
+			*position = std::move(element);
 		}
 
 		++mySize;
 
-		return iterator(data() + posIndex);
+		return iterator(position);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::insert(const_iterator aPosition, const T& aElement) -> iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::insert(const_iterator aPosition, const T& aElement) -> iterator
 	{
 		return emplace(aPosition, aElement);
 	}
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::insert(const_iterator aPosition, T&& aElement) -> iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::insert(const_iterator aPosition, T&& aElement) -> iterator
 	{
 		return emplace(aPosition, std::move(aElement));
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr void SmallVector<T, N, Alloc>::fill(const_reference aValue)
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::fill(const_reference aValue)
 	{
 		std::fill(begin(), end(), aValue);
 	}
-	template<typename T, std::size_t N, class Alloc>
-	constexpr void SmallVector<T, N, Alloc>::resize(size_type aSize, const_reference aValue)
+
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::resize(size_type aSize)
 	{
-		if (aSize <= N)
+		if (aSize <= mySize)
 		{
-			if (IsHeap())
-			{
-				std::move(myHeap.begin(), myHeap.begin() + aSize, myStack.begin());
-				myHeap.clear();
-			}
+			DestroyRange(myData + aSize, myData + mySize);
+			mySize = aSize;
 
-			if (aSize > mySize)
-				std::fill(myStack.begin() + mySize, myStack.begin() + aSize, aValue);
+			return;
 		}
-		else
+
+		if (aSize > myCapacity)
+			Reallocate(NextCapacity(aSize));
+
+		for (; mySize < aSize; ++mySize)
+			alloc_traits::construct(myAllocator, myData + mySize);
+	}
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::resize(size_type aSize, const_reference aValue)
+	{
+		if (aSize <= mySize)
 		{
-			if (IsStack())
-				std::move(myStack.begin(), myStack.end(), std::back_inserter(myHeap));
+			DestroyRange(myData + aSize, myData + mySize);
+			mySize = aSize;
 
-			myHeap.resize(aSize, aValue);
+			return;
+		}
+
+		if (aSize > myCapacity)
+		{
+			const T value = aValue; // may refer to an element that is about to move
+			Reallocate(NextCapacity(aSize));
+
+			for (; mySize < aSize; ++mySize)
+				alloc_traits::construct(myAllocator, myData + mySize, value);
+		}
+		else
+		{
+			for (; mySize < aSize; ++mySize)
+				alloc_traits::construct(myAllocator, myData + mySize, aValue);
 		}
-		
-		mySize = aSize;
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr void SmallVector<T, N, Alloc>::shrink_to_fit()
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::reserve(size_type aCapacity)
 	{
-		if (IsHeap())
-			myHeap.shrink_to_fit();
+		if (aCapacity <= myCapacity)
+			return;
+
+		if (aCapacity > max_size())
+			throw std::length_error("SmallVector can't store that many elements!");
+
+		Reallocate(aCapacity);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr void SmallVector<T, N, Alloc>::clear()
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::shrink_to_fit()
 	{
-		if (IsHeap())
-			myHeap.clear();
+		if (IsInline() || mySize == myCapacity)
+			return;
+
+		if (mySize > N)
+		{
+			Reallocate(mySize);
+			return;
+		}
+
+		Relocate(myData, myData + mySize, InlineData());
+		alloc_traits::deallocate(myAllocator, myData, myCapacity);
+
+		myData		= InlineData();
+		myCapacity	= N;
+	}
 
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::clear() noexcept
+	{
+		DestroyRange(myData, myData + mySize);
 		mySize = 0;
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr void swap(SmallVector<T, N, Alloc>& aLhs, SmallVector<T, N, Alloc>& aRhs)
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::swap(SmallVector& aOther)
 	{
-		std::swap(aLhs, aRhs);
+		if (this == &aOther)
+			return;
+
+		if constexpr (alloc_traits::propagate_on_container_swap::value)
+		{
+			using std::swap;
+			swap(myAllocator, aOther.myAllocator);
+		}
+
+		if (!IsInline() && !aOther.IsInline())
+		{
+			std::swap(myData, aOther.myData);
+			std::swap(myCapacity, aOther.myCapacity);
+		}
+		else if (!IsInline() || !aOther.IsInline())
+		{
+			// the elements stored inline move into the other's unused inline storage, which then takes the heap buffer
+
+			SmallVector& heap	= IsInline() ? aOther : *this;
+			SmallVector& local	= IsInline() ? *this : aOther;
+
+			Relocate(local.myData, local.myData + local.mySize, heap.InlineData());
+
+			local.myData		= heap.myData;
+			local.myCapacity	= heap.myCapacity;
+
+			heap.myData			= heap.InlineData();
+			heap.myCapacity		= N;
+		}
+		else if constexpr (IsTriviallyRelocatable<T>)
+		{
+			details::relocate::SwapBytes(myInline, aOther.myInline, sizeof(T) * (std::max)(mySize, aOther.mySize));
+		}
+		else
+		{
+			SmallVector& larger		= (mySize < aOther.mySize) ? aOther : *this;
+			SmallVector& smaller	= (mySize < aOther.mySize) ? *this : aOther;
+
+			std::swap_ranges(smaller.myData, smaller.myData + smaller.mySize, larger.myData);
+			Relocate(larger.myData + smaller.mySize, larger.myData + larger.mySize, smaller.myData + smaller.mySize);
+		}
+
+		std::swap(mySize, aOther.mySize);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::begin() noexcept -> iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::begin() noexcept -> iterator
 	{
-		return iterator(IsStack() ? myStack.data() : myHeap.data());
+		return iterator(myData);
 	}
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::end() noexcept -> iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::end() noexcept -> iterator
 	{
-		return iterator(IsStack() ? (myStack.data() + mySize) : (myHeap.data() + mySize));
+		return iterator(myData + mySize);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::begin() const noexcept -> const_iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::begin() const noexcept -> const_iterator
 	{
-		return const_iterator(IsStack() ? myStack.data() : myHeap.data());
+		return const_iterator(myData);
 	}
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::end() const noexcept -> const_iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::end() const noexcept -> const_iterator
 	{
-		return const_iterator(IsStack() ? (myStack.data() + mySize) : (myHeap.data() + mySize));
+		return const_iterator(myData + mySize);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::cbegin() const noexcept -> const_iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::cbegin() const noexcept -> const_iterator
 	{
 		return begin();
 	}
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::cend() const noexcept -> const_iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::cend() const noexcept -> const_iterator
 	{
 		return end();
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::rbegin() noexcept -> reverse_iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::rbegin() noexcept -> reverse_iterator
 	{
-		return reverse_iterator(IsStack() ? (myStack.data() + mySize - 1) : (myHeap.data() + mySize - 1));
+		return reverse_iterator(myData + mySize - 1);
 	}
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::rend() noexcept -> reverse_iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::rend() noexcept -> reverse_iterator
 	{
-		return reverse_iterator(IsStack() ? (myStack.data() - 1) : (myHeap.data() - 1));
+		return reverse_iterator(myData - 1);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::rbegin() const noexcept -> const_reverse_iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::rbegin() const noexcept -> const_reverse_iterator
 	{
-		return const_reverse_iterator(IsStack() ? (myStack.data() + mySize - 1) : (myHeap.data() + mySize - 1));
+		return const_reverse_iterator(myData + mySize - 1);
 	}
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::rend() const noexcept -> const_reverse_iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::rend() const noexcept -> const_reverse_iterator
 	{
-		return const_reverse_iterator(IsStack() ? (myStack.data() - 1) : (myHeap.data() - 1));
+		return const_reverse_iterator(myData - 1);
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::crbegin() const noexcept -> const_reverse_iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::crbegin() const noexcept -> const_reverse_iterator
 	{
 		return rbegin();
 	}
-	template<typename T, std::size_t N, class Alloc>
-	constexpr auto SmallVector<T, N, Alloc>::crend() const noexcept -> const_reverse_iterator
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::crend() const noexcept -> const_reverse_iterator
 	{
 		return rend();
 	}
 
-	template<typename T, std::size_t N, class Alloc>
-	constexpr bool SmallVector<T, N, Alloc>::IsStack() const noexcept
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::InlineData() noexcept -> pointer
+	{
+		return reinterpret_cast<pointer>(myInline);
+	}
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::InlineData() const noexcept -> const_pointer
+	{
+		return reinterpret_cast<const_pointer>(myInline);
+	}
+
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr bool SmallVector<T, N, Alloc, Growth>::IsInline() const noexcept
+	{
+		return myData == InlineData();
+	}
+
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::NextCapacity(size_type aRequired) const -> size_type
+	{
+		const size_type maxSize = max_size();
+
+		if (aRequired > maxSize)
+			throw std::length_error("SmallVector can't store that many elements!");
+
+		const auto capacity = static_cast<size_type>(Growth::Grow(myCapacity, aRequired));
+		return std::clamp(capacity, aRequired, maxSize);
+	}
+
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::Reallocate(size_type aCapacity)
+	{
+		pointer buffer = alloc_traits::allocate(myAllocator, aCapacity);
+
+		try
+		{
+			Relocate(myData, myData + mySize, buffer);
+		}
+		catch (...)
+		{
+			alloc_traits::deallocate(myAllocator, buffer, aCapacity);
+			throw;
+		}
+
+		if (!IsInline())
+			alloc_traits::deallocate(myAllocator, myData, myCapacity);
+
+		myData		= buffer;
+		myCapacity	= aCapacity;
+	}
+
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	template<typename... Args>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::ReallocateEmplace(size_type aIndex, Args&&... someArgs) -> pointer
+	{
+		const size_type capacity = NextCapacity(mySize + 1);
+
+		pointer buffer	= alloc_traits::allocate(myAllocator, capacity);
+		pointer element = buffer + aIndex;
+
+		try
+		{
+			alloc_traits::construct(myAllocator, element, std::forward<Args>(someArgs)...);
+		}
+		catch (...)
+		{
+			alloc_traits::deallocate(myAllocator, buffer, capacity);
+			throw;
+		}
+
+		if constexpr (IsTriviallyRelocatable<T>)
+		{
+			details::relocate::Relocate(myData, myData + aIndex, buffer);
+			details::relocate::Relocate(myData + aIndex, myData + mySize, element + 1);
+		}
+		else
+		{
+			try
+			{
+				MoveInto(myData, myData + aIndex, buffer);
+
+				try
+				{
+					MoveInto(myData + aIndex, myData + mySize, element + 1);
+				}
+				catch (...)
+				{
+					DestroyRange(buffer, element);
+					throw;
+				}
+			}
+			catch (...)
+			{
+				alloc_traits::destroy(myAllocator, element);
+				alloc_traits::deallocate(myAllocator, buffer, capacity);
+				throw;
+			}
+
+			DestroyRange(myData, myData + mySize);
+		}
+
+		if (!IsInline())
+			alloc_traits::deallocate(myAllocator, myData, myCapacity);
+
+		myData		= buffer;
+		myCapacity	= capacity;
+
+		++mySize;
+
+		return element;
+	}
+
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr auto SmallVector<T, N, Alloc, Growth>::MoveInto(pointer aFirst, pointer aLast, pointer aDest) -> pointer
 	{
-		return mySize <= N;
+		pointer dest = aDest;
+
+		try
+		{
+			for (; aFirst != aLast; ++aFirst, ++dest)
+				alloc_traits::construct(myAllocator, dest, std::move_if_noexcept(*aFirst));
+		}
+		catch (...)
+		{
+			DestroyRange(aDest, dest);
+			throw;
+		}
+
+		return dest;
 	}
-	template<typename T, std::size_t N, class Alloc>
-	constexpr bool SmallVector<T, N, Alloc>::IsHeap() const noexcept
+
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::Relocate(pointer aFirst, pointer aLast, pointer aDest)
+	{
+		if constexpr (IsTriviallyRelocatable<T>)
+		{
+			details::relocate::Relocate(aFirst, aLast, aDest);
+		}
+		else
+		{
+			MoveInto(aFirst, aLast, aDest);
+			DestroyRange(aFirst, aLast);
+		}
+	}
+
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::DestroyRange(pointer aFirst, pointer aLast) noexcept
+	{
+		if constexpr (!std::is_trivially_destructible_v<T>)
+		{
+			for (; aFirst != aLast; ++aFirst)
+				alloc_traits::destroy(myAllocator, aFirst);
+		}
+	}
+
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	template<class Iter>
+	constexpr void SmallVector<T, N, Alloc, Growth>::Assign(Iter aFirst, Iter aLast)
+	{
+		assert(empty() && "Elements have to be cleared before assigning");
+
+		reserve(static_cast<size_type>(std::distance(aFirst, aLast)));
+
+		for (; aFirst != aLast; ++aFirst, ++mySize)
+			alloc_traits::construct(myAllocator, myData + mySize, *aFirst);
+	}
+
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::Destroy() noexcept
+	{
+		clear();
+
+		if (!IsInline())
+			alloc_traits::deallocate(myAllocator, myData, myCapacity);
+
+		myData		= InlineData();
+		myCapacity	= N;
+	}
+
+	template<typename T, std::size_t N, class Alloc, smallvec::GrowthPolicy Growth>
+	constexpr void SmallVector<T, N, Alloc, Growth>::Steal(SmallVector& aOther)
+	{
+		assert(empty() && IsInline() && "Storage has to be released before stealing");
+
+		if (!aOther.IsInline() && myAllocator == aOther.myAllocator)
+		{
+			myData		= aOther.myData;
+			mySize		= aOther.mySize;
+			myCapacity	= aOther.myCapacity;
+
+			aOther.myData		= aOther.InlineData();
+			aOther.myCapacity	= N;
+		}
+		else
+		{
+			reserve(aOther.mySize);
+			Relocate(aOther.myData, aOther.myData + aOther.mySize, myData);
+
+			mySize = aOther.mySize;
+		}
+
+		aOther.mySize = 0;
+	}
+
+	namespace pmr
 	{
-		return mySize > N;
+		template<typename T, std::size_t N = 32>
+		using SmallVector = CommonUtilities::SmallVector<T, N, std::pmr::polymorphic_allocator<T>>;
 	}
 }
\ No newline at end of file
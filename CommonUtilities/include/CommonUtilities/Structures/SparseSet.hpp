@@ -0,0 +1,240 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <algorithm>
+#include <limits>
+#include <concepts>
+#include <cstdint>
+#include <cassert>
+
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+	/// Set of integer IDs with O(1) insertion, removal, and lookup that keeps its members densely packed
+	/// for iteration. A sparse array maps each ID to its position in the packed array, and is split into
+	/// pages allocated on first use so that large or scattered IDs do not cost memory for the gaps.
+	///
+	/// Erasing moves the last ID into the hole, so iteration order is not preserved.
+	///
+	template<std::unsigned_integral ID = std::uint32_t, std::size_t PageSize = 4096>
+		requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	class SparseSet
+	{
+	public:
+		using value_type		= ID;
+		using size_type			= std::size_t;
+		using const_iterator	= typename std::vector<ID>::const_iterator;
+
+		static constexpr ID NULL_INDEX = (std::numeric_limits<ID>::max)(); // also the one ID that cannot be stored
+
+		SparseSet() = default;
+		~SparseSet() = default;
+
+		SparseSet(const SparseSet& aOther);
+		SparseSet(SparseSet&&) noexcept = default;
+
+		auto operator=(const SparseSet& aOther) -> SparseSet&;
+		auto operator=(SparseSet&&) noexcept -> SparseSet& = default;
+
+		/// \returns Whether the ID is in the set.
+		///
+		NODISC bool contains(ID aID) const noexcept;
+
+		/// \param ID: ID in the set.
+		///
+		/// \returns Position of the ID in the packed array.
+		///
+		NODISC auto index(ID aID) const noexcept -> size_type;
+
+		/// \returns If it contains any IDs.
+		///
+		NODISC bool empty() const noexcept;
+
+		/// \returns Number of IDs in the set.
+		///
+		NODISC auto size() const noexcept -> size_type;
+
+		/// \returns Pointer to the packed IDs.
+		///
+		NODISC auto data() const noexcept -> const ID*;
+
+		NODISC auto begin() const noexcept -> const_iterator;
+		NODISC auto end() const noexcept -> const_iterator;
+
+		/// Adds ID to the end of the packed array.
+		///
+		/// \param ID: ID not in the set.
+		///
+		/// \returns Position of the ID in the packed array.
+		///
+		auto insert(ID aID) -> size_type;
+
+		/// Removes ID, moving the last ID into its place.
+		///
+		/// \param ID: ID in the set.
+		///
+		void erase(ID aID) noexcept;
+
+		/// Removes all IDs, the allocated pages are kept.
+		///
+		void clear() noexcept;
+
+		/// Reserve to reduce reallocation of the packed array.
+		///
+		void reserve(size_type aCapacity);
+
+	private:
+		using Page = std::unique_ptr<ID[]>;
+
+		NODISC static constexpr auto PageOf(ID aID) noexcept -> size_type { return static_cast<size_type>(aID) / PageSize; }
+		NODISC static constexpr auto OffsetOf(ID aID) noexcept -> size_type { return static_cast<size_type>(aID) & (PageSize - 1); }
+
+		NODISC auto Sparse(ID aID) noexcept -> ID&;
+		NODISC auto Assure(ID aID) -> ID&;
+
+		std::vector<Page>	mySparse;
+		std::vector<ID>		myDense;
+	};
+
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	SparseSet<ID, PageSize>::SparseSet(const SparseSet& aOther)
+		: myDense(aOther.myDense)
+	{
+		mySparse.resize(aOther.mySparse.size());
+		for (size_type i = 0; i < mySparse.size(); ++i)
+		{
+			if (aOther.mySparse[i])
+			{
+				mySparse[i] = std::make_unique_for_overwrite<ID[]>(PageSize);
+				std::copy_n(aOther.mySparse[i].get(), PageSize, mySparse[i].get());
+			}
+		}
+	}
+
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	auto SparseSet<ID, PageSize>::operator=(const SparseSet& aOther) -> SparseSet&
+	{
+		if (this != &aOther)
+		{
+			SparseSet copy(aOther);
+			*this = std::move(copy);
+		}
+
+		return *this;
+	}
+
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	bool SparseSet<ID, PageSize>::contains(ID aID) const noexcept
+	{
+		const size_type page = PageOf(aID);
+		return page < mySparse.size() && mySparse[page] && mySparse[page][OffsetOf(aID)] != NULL_INDEX;
+	}
+
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	auto SparseSet<ID, PageSize>::index(ID aID) const noexcept -> size_type
+	{
+		assert(contains(aID) && "ID is not in the set");
+		return static_cast<size_type>(mySparse[PageOf(aID)][OffsetOf(aID)]);
+	}
+
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	bool SparseSet<ID, PageSize>::empty() const noexcept
+	{
+		return myDense.empty();
+	}
+
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	auto SparseSet<ID, PageSize>::size() const noexcept -> size_type
+	{
+		return myDense.size();
+	}
+
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	auto SparseSet<ID, PageSize>::data() const noexcept -> const ID*
+	{
+		return myDense.data();
+	}
+
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	auto SparseSet<ID, PageSize>::begin() const noexcept -> const_iterator
+	{
+		return myDense.begin();
+	}
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	auto SparseSet<ID, PageSize>::end() const noexcept -> const_iterator
+	{
+		return myDense.end();
+	}
+
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	auto SparseSet<ID, PageSize>::insert(ID aID) -> size_type
+	{
+		assert(aID != NULL_INDEX && "ID is reserved");
+		assert(!contains(aID) && "ID is already in the set");
+
+		ID& sparse = Assure(aID);
+
+		const size_type index = myDense.size();
+		myDense.push_back(aID);
+
+		sparse = static_cast<ID>(index);
+
+		return index;
+	}
+
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	void SparseSet<ID, PageSize>::erase(ID aID) noexcept
+	{
+		assert(contains(aID) && "ID is not in the set");
+
+		ID& sparse = Sparse(aID);
+
+		const ID last = myDense.back();
+
+		myDense[sparse]	= last;
+		Sparse(last)	= sparse;
+
+		sparse = NULL_INDEX;
+		myDense.pop_back();
+	}
+
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	void SparseSet<ID, PageSize>::clear() noexcept
+	{
+		for (const ID id : myDense)
+			Sparse(id) = NULL_INDEX;
+
+		myDense.clear();
+	}
+
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	void SparseSet<ID, PageSize>::reserve(size_type aCapacity)
+	{
+		myDense.reserve(aCapacity);
+	}
+
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	auto SparseSet<ID, PageSize>::Sparse(ID aID) noexcept -> ID&
+	{
+		return mySparse[PageOf(aID)][OffsetOf(aID)];
+	}
+
+	template<std::unsigned_integral ID, std::size_t PageSize> requires (PageSize != 0 && (PageSize & (PageSize - 1)) == 0)
+	auto SparseSet<ID, PageSize>::Assure(ID aID) -> ID&
+	{
+		const size_type page = PageOf(aID);
+
+		if (page >= mySparse.size())
+			mySparse.resize(page + 1);
+
+		if (!mySparse[page])
+		{
+			mySparse[page] = std::make_unique_for_overwrite<ID[]>(PageSize);
+			std::fill_n(mySparse[page].get(), PageSize, NULL_INDEX);
+		}
+
+		return mySparse[page][OffsetOf(aID)];
+	}
+}
@@ -8,7 +8,9 @@
 #include <stdexcept>
 #include <limits>
 #include <type_traits>
+#include <algorithm>
 
+#include <CommonUtilities/Utility/Relocation.hpp>
 #include <CommonUtilities/Config.h>
 
 namespace CommonUtilities
@@ -748,7 +750,7 @@ namespace CommonUtilities
 		std::construct_at(ptr_at(mySize), std::forward<Args>(someArgs)...);
 		++mySize;
 
-		return *end();
+		return back();
 	}
 
 	template<typename T, std::size_t Capacity>
@@ -776,6 +778,13 @@ namespace CommonUtilities
 		{
 			pop_back();
 		}
+		else if constexpr (IsTriviallyRelocatable<T>)
+		{
+			std::destroy_at(std::to_address(eraseIter));
+			details::relocate::Shift(std::to_address(eraseIter + 1), std::to_address(end()), std::to_address(eraseIter));
+
+			--mySize;
+		}
 		else
 		{
 			for (auto it = eraseIter; it != (end() - 1); ++it)
@@ -797,6 +806,16 @@ namespace CommonUtilities
 		const auto eraseIterFirst = begin() + std::distance(cbegin(), aFirst);
 		const auto eraseIterLast = begin() + std::distance(cbegin(), aLast);
 
+		if constexpr (IsTriviallyRelocatable<T>)
+		{
+			std::destroy(eraseIterFirst, eraseIterLast);
+			details::relocate::Shift(std::to_address(eraseIterLast), std::to_address(end()), std::to_address(eraseIterFirst));
+
+			mySize -= std::distance(eraseIterFirst, eraseIterLast);
+
+			return eraseIterFirst;
+		}
+
 		auto it1 = eraseIterFirst;
 		auto it2 = eraseIterLast;
 
@@ -830,6 +849,17 @@ namespace CommonUtilities
 		{
 			emplace_back(std::forward<Args>(someArgs)...);
 		}
+		else if constexpr (IsTriviallyRelocatable<T>)
+		{
+			// construct aside first as the arguments may refer to elements that are about to be shifted
+			alignas(T) std::byte temp[sizeof(T)];
+			T* element = std::construct_at(reinterpret_cast<T*>(temp), std::forward<Args>(someArgs)...);
+
+			details::relocate::Shift(std::to_address(insertIter), std::to_address(end()), std::to_address(insertIter + 1));
+			details::relocate::Relocate(element, element + 1, std::to_address(insertIter));
+
+			++mySize;
+		}
 		else
 		{
 			std::construct_at(std::to_address(end()), std::move(*(end() - 1)));
@@ -873,6 +903,21 @@ namespace CommonUtilities
 		{
 			std::uninitialized_copy(aFirst, aLast, end());
 		}
+		else if constexpr (IsTriviallyRelocatable<T>)
+		{
+			T* gap = std::to_address(insertIter);
+			details::relocate::Shift(gap, std::to_address(end()), gap + count);
+
+			try
+			{
+				std::uninitialized_copy(aFirst, aLast, gap);
+			}
+			catch (...)
+			{
+				details::relocate::Shift(gap + count, std::to_address(end()) + count, gap);
+				throw;
+			}
+		}
 		else
 		{
 			std::uninitialized_move(end() - count, end(), end());
@@ -937,6 +982,15 @@ namespace CommonUtilities
 			return;
 		}
 
+		if constexpr (IsTriviallyRelocatable<T>)
+		{
+			// exchange the bytes of the occupied parts, the objects are relocated into each other's storage
+			details::relocate::SwapBytes(myData, aOther.myData, sizeof(T) * (std::max)(mySize, aOther.mySize));
+			std::swap(mySize, aOther.mySize);
+
+			return;
+		}
+
 		auto leftIt = begin();
 		auto rightIt = aOther.begin();
 
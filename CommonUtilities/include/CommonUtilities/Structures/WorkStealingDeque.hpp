@@ -0,0 +1,188 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <optional>
+#include <new>
+#include <cstdint>
+#include <type_traits>
+
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+	/// Lock-free Chase-Lev deque. Only the owning thread may push and pop at the bottom, while
+	/// any number of other threads may steal from the top. Elements are copied in and out atomically
+	/// and should therefore be small and trivially copyable, e.g., pointers or indices.
+	///
+	/// Based on "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al. 2013).
+	///
+	template<typename T> requires (std::is_trivially_copyable_v<T>)
+	class WorkStealingDeque
+	{
+	public:
+		using value_type	= T;
+		using size_type		= std::size_t;
+
+		explicit WorkStealingDeque(size_type aCapacity = 256);
+		~WorkStealingDeque() = default;
+
+		WorkStealingDeque(const WorkStealingDeque&) = delete;
+		WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+		/// \returns Approximate number of elements, may be outdated as soon as it is returned.
+		///
+		NODISC auto size() const noexcept -> size_type;
+
+		/// \returns Whether the deque appeared empty at the time of the call.
+		///
+		NODISC bool empty() const noexcept;
+
+		/// Pushes element at the bottom, grows the storage if full. May only be called by the owner.
+		///
+		void push(T aItem);
+
+		/// Pops element from the bottom. May only be called by the owner.
+		///
+		/// \returns Popped element, or nothing if empty or lost the race for the last element.
+		///
+		NODISC auto pop() -> std::optional<T>;
+
+		/// Steals element from the top. May be called by any thread.
+		///
+		/// \returns Stolen element, or nothing if empty or lost the race to another thread.
+		///
+		NODISC auto steal() -> std::optional<T>;
+
+	private:
+		class Array
+		{
+		public:
+			explicit Array(std::int64_t aCapacity)
+				: myCapacity(aCapacity)
+				, myMask(aCapacity - 1)
+				, myData(std::make_unique<std::atomic<T>[]>(aCapacity)) {}
+
+			NODISC std::int64_t Capacity() const noexcept { return myCapacity; }
+
+			void Put(std::int64_t aIndex, T aItem) noexcept { myData[aIndex & myMask].store(aItem, std::memory_order_relaxed); }
+			NODISC T Get(std::int64_t aIndex) const noexcept { return myData[aIndex & myMask].load(std::memory_order_relaxed); }
+
+			NODISC std::unique_ptr<Array> Grow(std::int64_t aBottom, std::int64_t aTop) const
+			{
+				auto result = std::make_unique<Array>(2 * myCapacity);
+				for (std::int64_t i = aTop; i != aBottom; ++i)
+				{
+					result->Put(i, Get(i));
+				}
+				return result;
+			}
+
+		private:
+			std::int64_t					myCapacity;
+			std::int64_t					myMask;
+			std::unique_ptr<std::atomic<T>[]>	myData;
+		};
+
+		alignas(std::hardware_destructive_interference_size) std::atomic<std::int64_t> myTop		{0};
+		alignas(std::hardware_destructive_interference_size) std::atomic<std::int64_t> myBottom	{0};
+		alignas(std::hardware_destructive_interference_size) std::atomic<Array*> myArray			{nullptr};
+
+		std::vector<std::unique_ptr<Array>> myArrays; // retired arrays are kept alive since thieves may still read from them
+	};
+
+	template<typename T> requires (std::is_trivially_copyable_v<T>)
+	WorkStealingDeque<T>::WorkStealingDeque(size_type aCapacity)
+	{
+		size_type capacity = 1;
+		while (capacity < aCapacity) // capacity must be a power of two for the index mask
+			capacity <<= 1;
+
+		myArrays.emplace_back(std::make_unique<Array>(static_cast<std::int64_t>(capacity)));
+		myArray.store(myArrays.back().get(), std::memory_order_relaxed);
+	}
+
+	template<typename T> requires (std::is_trivially_copyable_v<T>)
+	auto WorkStealingDeque<T>::size() const noexcept -> size_type
+	{
+		const std::int64_t b = myBottom.load(std::memory_order_relaxed);
+		const std::int64_t t = myTop.load(std::memory_order_relaxed);
+		return static_cast<size_type>(b >= t ? b - t : 0);
+	}
+
+	template<typename T> requires (std::is_trivially_copyable_v<T>)
+	bool WorkStealingDeque<T>::empty() const noexcept
+	{
+		return size() == 0;
+	}
+
+	template<typename T> requires (std::is_trivially_copyable_v<T>)
+	void WorkStealingDeque<T>::push(T aItem)
+	{
+		const std::int64_t b = myBottom.load(std::memory_order_relaxed);
+		const std::int64_t t = myTop.load(std::memory_order_acquire);
+
+		Array* array = myArray.load(std::memory_order_relaxed);
+
+		if (b - t > array->Capacity() - 1)
+		{
+			myArrays.emplace_back(array->Grow(b, t));
+			array = myArrays.back().get();
+			myArray.store(array, std::memory_order_release);
+		}
+
+		array->Put(b, aItem);
+
+		myBottom.store(b + 1, std::memory_order_release); // publishes the element to thieves
+	}
+
+	template<typename T> requires (std::is_trivially_copyable_v<T>)
+	auto WorkStealingDeque<T>::pop() -> std::optional<T>
+	{
+		const std::int64_t b = myBottom.load(std::memory_order_relaxed) - 1;
+		Array* array = myArray.load(std::memory_order_relaxed);
+
+		myBottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+
+		std::int64_t t = myTop.load(std::memory_order_relaxed);
+
+		if (t > b) // was empty
+		{
+			myBottom.store(b + 1, std::memory_order_relaxed);
+			return std::nullopt;
+		}
+
+		std::optional<T> result = array->Get(b);
+
+		if (t == b) // last element, race against thieves
+		{
+			if (!myTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				result.reset();
+
+			myBottom.store(b + 1, std::memory_order_relaxed);
+		}
+
+		return result;
+	}
+
+	template<typename T> requires (std::is_trivially_copyable_v<T>)
+	auto WorkStealingDeque<T>::steal() -> std::optional<T>
+	{
+		std::int64_t t = myTop.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const std::int64_t b = myBottom.load(std::memory_order_acquire);
+
+		if (t >= b)
+			return std::nullopt;
+
+		const Array* array = myArray.load(std::memory_order_acquire);
+		const T result = array->Get(t);
+
+		if (!myTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			return std::nullopt;
+
+		return result;
+	}
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+	struct LogicalProcessor
+	{
+		std::uint32_t id		{0}; // index used by the OS, e.g., for affinity
+		std::uint32_t core		{0}; // physical core, shared by SMT siblings
+		std::uint32_t smt		{0}; // index among the siblings on the same physical core
+		std::uint32_t cache		{0}; // last-level cache domain
+		std::uint32_t package	{0}; // socket
+		std::uint32_t node		{0}; // NUMA node
+	};
+
+	enum class Placement
+	{
+		None,		// let the OS schedule the workers freely
+		Compact,	// fill one socket and cache domain before moving on to the next, physical cores before SMT siblings
+		Spread		// alternate between sockets so that workers get as much cache and memory bandwidth as possible
+	};
+
+	struct PlacementPolicy
+	{
+		Placement		placement		{Placement::None};
+		std::size_t		reservedCores	{0}; // physical cores left for the main thread, taken from the start of the first socket
+	};
+
+	/// Layout of the logical processors on the machine, read from sysfs on Linux and from
+	/// GetLogicalProcessorInformationEx on Windows. Falls back to one flat socket if neither is available.
+	///
+	class COMMON_UTILITIES_API CpuTopology
+	{
+	public:
+		/// \returns Topology of the machine, detected on first call.
+		///
+		NODISC static const CpuTopology& Get();
+
+		NODISC static CpuTopology Detect();
+
+		NODISC const std::vector<LogicalProcessor>& GetProcessors() const noexcept;
+
+		NODISC std::size_t GetCoreCount() const noexcept;
+		NODISC std::size_t GetPackageCount() const noexcept;
+		NODISC std::size_t GetNodeCount() const noexcept;
+
+		/// \returns Processor with the OS index, or nullptr if there is none.
+		///
+		NODISC const LogicalProcessor* Find(std::uint32_t aID) const noexcept;
+
+		/// Picks a processor for each thread following the policy, threads wrap around when there are
+		/// more of them than processors.
+		///
+		/// \returns Processor per thread, or nothing if the policy does not pin threads.
+		///
+		NODISC std::vector<LogicalProcessor> Assign(const PlacementPolicy& aPolicy, std::size_t aThreadCount) const;
+
+		/// Processors that the policy reserves for the main thread, e.g., to pin it with SetThreadAffinity.
+		///
+		NODISC std::vector<LogicalProcessor> GetReserved(const PlacementPolicy& aPolicy) const;
+
+		/// Pins the calling thread to a single logical processor.
+		///
+		/// \returns Whether the affinity could be set.
+		///
+		static bool SetThreadAffinity(std::uint32_t aID);
+
+		/// \returns OS index of the processor the calling thread is currently running on.
+		///
+		NODISC static std::uint32_t GetCurrentProcessor();
+
+		/// \returns NUMA node of the processor the calling thread is currently running on.
+		///
+		NODISC std::uint32_t GetCurrentNode() const;
+
+	private:
+		void Finalize();
+
+		NODISC std::vector<LogicalProcessor> Order(Placement aPlacement) const;
+
+		std::vector<LogicalProcessor>	myProcessors; // sorted by id
+		std::size_t						myCoreCount		{0};
+		std::size_t						myPackageCount	{0};
+		std::size_t						myNodeCount		{0};
+	};
+}
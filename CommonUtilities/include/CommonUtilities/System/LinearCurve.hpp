@@ -1,5 +1,9 @@
 #pragma once
 
+#include <vector>
+#include <algorithm>
+
+#include <CommonUtilities/Structures/FlatHashMap.hpp>
 #include <CommonUtilities/Utility/ArithmeticUtils.hpp>
 
 #include <CommonUtilities/Config.h>
@@ -17,8 +21,8 @@ namespace CommonUtilities
 
 		constexpr LinearCurve(const T& aMin, const T& aMax);
 
-		NODISC constexpr const std::unordered_map<unsigned, T>& GetKeyPositions() const;
-		NODISC constexpr const std::unordered_map<unsigned, T>& GetKeys() const;
+		NODISC constexpr const std::vector<unsigned>& GetKeyPositions() const;
+		NODISC constexpr const FlatHashMap<unsigned, T>& GetKeys() const;
 
 		NODISC constexpr T Get(float aPosition) const;
 
@@ -34,8 +38,8 @@ namespace CommonUtilities
 	private:
 		static constexpr float ourPrecision = 100000.0f;
 
-		std::vector<unsigned>			myKeyPositions;
-		std::unordered_map<unsigned, T> myKeys;
+		std::vector<unsigned>		myKeyPositions; // kept sorted
+		FlatHashMap<unsigned, T>	myKeys;
 	};
 
 	template<typename T>
@@ -45,12 +49,12 @@ namespace CommonUtilities
 	}
 
 	template<typename T>
-	constexpr const std::unordered_map<unsigned, T>& LinearCurve<T>::GetKeyPositions() const
+	constexpr const std::vector<unsigned>& LinearCurve<T>::GetKeyPositions() const
 	{
 		return myKeyPositions;
 	}
 	template<typename T>
-	constexpr const std::unordered_map<unsigned, T>& LinearCurve<T>::GetKeys() const
+	constexpr const FlatHashMap<unsigned, T>& LinearCurve<T>::GetKeys() const
 	{
 		return myKeys;
 	}
@@ -109,13 +113,11 @@ namespace CommonUtilities
 
 		const unsigned realValue = static_cast<unsigned>(aPosition * ourPrecision);
 
-		if (std::find(myKeyPositions.begin(), myKeyPositions.end(), realValue) == myKeyPositions.end())
+		if (myKeys.try_emplace(realValue, aValue).second)
 		{
-			myKeyPositions.emplace_back(realValue);
+			myKeyPositions.insert(std::upper_bound(myKeyPositions.begin(), myKeyPositions.end(), realValue), realValue);
 		}
 
-		myKeys.emplace(realValue, aValue);
-
 		return realValue;
 	}
 	template<typename T>
@@ -144,8 +146,8 @@ namespace CommonUtilities
 		{
 			if (Equal(*it, realValue, realTolerance))
 			{
-				myKeyPositions.erase(it);
 				myKeys.erase(*it);
+				myKeyPositions.erase(it);
 
 				return true;
 			}
@@ -1,11 +1,11 @@
 #pragma once
 
-#include <unordered_map>
 #include <vector>
 #include <memory>
 #include <functional>
 #include <cassert>
 
+#include <CommonUtilities/Structures/FlatHashMap.hpp>
 #include <CommonUtilities/Utility/ContainerUtils.hpp>
 #include <CommonUtilities/Utility/NonCopyable.h>
 #include <CommonUtilities/Utility/Concepts.hpp>
@@ -171,7 +171,7 @@ namespace CommonUtilities
 		using StatePtr		= typename State::Ptr;
 		using StateFunc		= typename State::Func;
 		using Stack			= std::vector<StatePtr>;
-		using Factory		= std::unordered_map<IDType, StateFunc, Hash>;
+		using Factory		= FlatHashMap<IDType, StateFunc, Hash>;
 		using PendingList	= std::vector<PendingChange>;
 
 		auto CreateState(const IDType& aStateID) -> StatePtr;
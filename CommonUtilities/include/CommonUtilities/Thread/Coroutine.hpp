@@ -0,0 +1,740 @@
+#pragma once
+
+#include <coroutine>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <variant>
+#include <vector>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+
+#include <CommonUtilities/Thread/ThreadPool.h>
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+    template<typename T = void>
+    class Task;
+
+    namespace details::coroutine
+    {
+        using DeallocFunc = void(*)(void* aFrame, std::size_t aSize) noexcept;
+
+        struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) FrameBlock
+        {
+            std::byte data[__STDCPP_DEFAULT_NEW_ALIGNMENT__];
+        };
+
+        NODISC constexpr std::size_t AlignUp(std::size_t aSize, std::size_t aAlignment) noexcept
+        {
+            return (aSize + aAlignment - 1) & ~(aAlignment - 1);
+        }
+
+        /// Coroutine frame allocation shared by all promise types. Frames come from the same block pool
+        /// as ThreadPool tasks by default. A coroutine whose first parameters are std::allocator_arg and
+        /// an allocator (after the object for member functions) has its frame allocated by a copy of
+        /// that allocator instead, which is stored after the frame along with how to release it.
+        ///
+        class PromiseAlloc
+        {
+        public:
+            NODISC static void* operator new(std::size_t aSize)
+            {
+                const std::size_t funcOffset = AlignUp(aSize, alignof(DeallocFunc));
+
+                void* memory = threadpool::Allocate(funcOffset + sizeof(DeallocFunc));
+                ::new (static_cast<std::byte*>(memory) + funcOffset) DeallocFunc(&DefaultDeallocate);
+
+                return memory;
+            }
+
+            template<class Alloc, typename... Args>
+            NODISC static void* operator new(std::size_t aSize, std::allocator_arg_t, const Alloc& aAlloc, const Args&...)
+            {
+                return AllocateWith(aSize, aAlloc);
+            }
+
+            template<class This, class Alloc, typename... Args>
+            NODISC static void* operator new(std::size_t aSize, const This&, std::allocator_arg_t, const Alloc& aAlloc, const Args&...)
+            {
+                return AllocateWith(aSize, aAlloc);
+            }
+
+            static void operator delete(void* aFrame, std::size_t aSize) noexcept
+            {
+                const std::size_t funcOffset = AlignUp(aSize, alignof(DeallocFunc));
+
+                const DeallocFunc func = *std::launder(reinterpret_cast<DeallocFunc*>(static_cast<std::byte*>(aFrame) + funcOffset));
+                func(aFrame, aSize);
+            }
+
+        private:
+            template<class Alloc>
+            using BlockAlloc = typename std::allocator_traits<Alloc>::template rebind_alloc<FrameBlock>;
+
+            template<class Alloc>
+            NODISC static constexpr std::size_t AllocOffset(std::size_t aSize) noexcept
+            {
+                return AlignUp(AlignUp(aSize, alignof(DeallocFunc)) + sizeof(DeallocFunc), alignof(BlockAlloc<Alloc>));
+            }
+
+            template<class Alloc>
+            NODISC static constexpr std::size_t BlockCount(std::size_t aSize) noexcept
+            {
+                return AlignUp(AllocOffset<Alloc>(aSize) + sizeof(BlockAlloc<Alloc>), sizeof(FrameBlock)) / sizeof(FrameBlock);
+            }
+
+            template<class Alloc>
+            NODISC static void* AllocateWith(std::size_t aSize, const Alloc& aAlloc)
+            {
+                using Traits = std::allocator_traits<BlockAlloc<Alloc>>;
+
+                BlockAlloc<Alloc> alloc(aAlloc);
+                std::byte* memory = reinterpret_cast<std::byte*>(std::to_address(Traits::allocate(alloc, BlockCount<Alloc>(aSize))));
+
+                ::new (memory + AlignUp(aSize, alignof(DeallocFunc))) DeallocFunc(&DeallocateWith<Alloc>);
+                ::new (memory + AllocOffset<Alloc>(aSize)) BlockAlloc<Alloc>(std::move(alloc));
+
+                return memory;
+            }
+
+            static void DefaultDeallocate(void* aFrame, std::size_t aSize) noexcept
+            {
+                threadpool::Deallocate(aFrame, AlignUp(aSize, alignof(DeallocFunc)) + sizeof(DeallocFunc));
+            }
+
+            template<class Alloc>
+            static void DeallocateWith(void* aFrame, std::size_t aSize) noexcept
+            {
+                using Traits = std::allocator_traits<BlockAlloc<Alloc>>;
+
+                auto* stored = std::launder(reinterpret_cast<BlockAlloc<Alloc>*>(static_cast<std::byte*>(aFrame) + AllocOffset<Alloc>(aSize)));
+
+                BlockAlloc<Alloc> alloc(std::move(*stored));
+                stored->~BlockAlloc<Alloc>();
+
+                Traits::deallocate(alloc, static_cast<FrameBlock*>(aFrame), BlockCount<Alloc>(aSize));
+            }
+        };
+
+        template<typename T>
+        using NonVoid = std::conditional_t<std::is_void_v<T>, std::monostate, T>;
+
+        class TaskPromiseBase : public PromiseAlloc
+        {
+        public:
+            struct FinalAwaiter
+            {
+                NODISC bool await_ready() const noexcept { return false; }
+
+                template<class Promise>
+                NODISC std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> aHandle) const noexcept
+                {
+                    // resume whoever awaited us directly instead of going through the scheduler
+
+                    const std::coroutine_handle<> continuation = aHandle.promise().myContinuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            NODISC std::suspend_always initial_suspend() const noexcept { return {}; }
+            NODISC FinalAwaiter final_suspend() const noexcept { return {}; }
+
+            void SetContinuation(std::coroutine_handle<> aContinuation) noexcept
+            {
+                myContinuation = aContinuation;
+            }
+
+        private:
+            std::coroutine_handle<> myContinuation;
+        };
+
+        template<typename T>
+        class TaskPromise final : public TaskPromiseBase
+        {
+        public:
+            NODISC Task<T> get_return_object() noexcept;
+
+            template<typename U> requires(std::is_convertible_v<U&&, T>)
+            void return_value(U&& aValue) noexcept(std::is_nothrow_constructible_v<T, U&&>)
+            {
+                myResult.template emplace<1>(std::forward<U>(aValue));
+            }
+
+            void unhandled_exception() noexcept
+            {
+                myResult.template emplace<2>(std::current_exception());
+            }
+
+            NODISC T& GetResult() &
+            {
+                if (myResult.index() == 2)
+                    std::rethrow_exception(std::get<2>(myResult));
+
+                return std::get<1>(myResult);
+            }
+
+            NODISC T&& GetResult() &&
+            {
+                if (myResult.index() == 2)
+                    std::rethrow_exception(std::get<2>(myResult));
+
+                return std::move(std::get<1>(myResult));
+            }
+
+        private:
+            std::variant<std::monostate, T, std::exception_ptr> myResult;
+        };
+
+        template<>
+        class TaskPromise<void> final : public TaskPromiseBase
+        {
+        public:
+            NODISC Task<void> get_return_object() noexcept;
+
+            void return_void() const noexcept {}
+
+            void unhandled_exception() noexcept
+            {
+                myException = std::current_exception();
+            }
+
+            void GetResult() const
+            {
+                if (myException)
+                    std::rethrow_exception(myException);
+            }
+
+        private:
+            std::exception_ptr myException;
+        };
+    }
+
+    /// Lazily started coroutine that produces a T. The task begins running when it is awaited, and
+    /// resumes the awaiting coroutine directly once it completes, so no thread is blocked in between.
+    /// Use co_await pool.Schedule() inside the task to move it onto a ThreadPool worker.
+    ///
+    /// Frames are allocated from a block pool, or from a caller-supplied allocator when the coroutine
+    /// takes std::allocator_arg and an allocator as its first parameters, e.g.,
+    /// Task<int> Load(std::allocator_arg_t, const Alloc& aAlloc, Asset& aAsset).
+    ///
+    template<typename T>
+    class Task
+    {
+    public:
+        static_assert(!std::is_reference_v<T>, "Task does not support references, return a pointer or std::reference_wrapper instead");
+
+        using promise_type  = details::coroutine::TaskPromise<T>;
+        using value_type    = T;
+
+        Task() noexcept = default;
+        ~Task();
+
+        Task(const Task&) = delete;
+        Task(Task&& aOther) noexcept;
+
+        auto operator=(const Task&) -> Task& = delete;
+        auto operator=(Task&& aOther) noexcept -> Task&;
+
+        /// \returns Whether the task has a coroutine associated with it.
+        ///
+        NODISC bool IsValid() const noexcept;
+
+        /// \returns Whether the task has run to completion.
+        ///
+        NODISC bool IsReady() const noexcept;
+
+        /// Awaits the result of the task, starting it if it has not been started yet. Rethrows any
+        /// exception that escaped the task.
+        ///
+        NODISC auto operator co_await() & noexcept;
+        NODISC auto operator co_await() && noexcept;
+
+        /// Awaits completion of the task without retrieving the result, never throws.
+        ///
+        NODISC auto WhenReady() noexcept;
+
+        /// \returns Result of a finished task, rethrows any exception that escaped it.
+        ///
+        NODISC decltype(auto) GetResult() &;
+        NODISC decltype(auto) GetResult() &&;
+
+    private:
+        friend class details::coroutine::TaskPromise<T>;
+
+        using Handle = std::coroutine_handle<promise_type>;
+
+        explicit Task(Handle aHandle) noexcept;
+
+        class AwaiterBase
+        {
+        public:
+            explicit AwaiterBase(Handle aHandle) noexcept : myHandle(aHandle) {}
+
+            NODISC bool await_ready() const noexcept
+            {
+                return !myHandle || myHandle.done();
+            }
+
+            NODISC std::coroutine_handle<> await_suspend(std::coroutine_handle<> aAwaiting) noexcept
+            {
+                myHandle.promise().SetContinuation(aAwaiting);
+                return myHandle; // start the task on this thread
+            }
+
+        protected:
+            Handle myHandle;
+        };
+
+        Handle myHandle;
+    };
+
+    template<typename T>
+    struct WhenAnyResult
+    {
+        std::size_t                         index {0}; // index of the task that finished first
+        details::coroutine::NonVoid<T>      value;
+    };
+
+    namespace details::coroutine
+    {
+        /// Internal coroutine that awaits a task and then reports to its owner, used to fan out
+        /// tasks without having them resume the awaiting coroutine directly.
+        ///
+        class Runner
+        {
+        public:
+            using NotifyFunc = std::coroutine_handle<>(*)(void* aContext) noexcept;
+
+            class promise_type : public PromiseAlloc
+            {
+            public:
+                struct FinalAwaiter
+                {
+                    NODISC bool await_ready() const noexcept { return false; }
+
+                    NODISC std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> aHandle) const noexcept
+                    {
+                        promise_type& promise = aHandle.promise();
+                        return promise.myNotify(promise.myContext);
+                    }
+
+                    void await_resume() const noexcept {}
+                };
+
+                NODISC Runner get_return_object() noexcept { return Runner(std::coroutine_handle<promise_type>::from_promise(*this)); }
+
+                NODISC std::suspend_always initial_suspend() const noexcept { return {}; }
+                NODISC FinalAwaiter final_suspend() const noexcept { return {}; }
+
+                void return_void() const noexcept {}
+                void unhandled_exception() const noexcept { std::terminate(); } // only awaits WhenReady, which never throws
+
+            private:
+                friend class Runner;
+
+                NotifyFunc  myNotify    {nullptr};
+                void*       myContext   {nullptr};
+            };
+
+            Runner() noexcept = default;
+            ~Runner() { if (myHandle) myHandle.destroy(); }
+
+            Runner(const Runner&) = delete;
+            Runner(Runner&& aOther) noexcept : myHandle(std::exchange(aOther.myHandle, nullptr)) {}
+
+            Runner& operator=(const Runner&) = delete;
+            Runner& operator=(Runner&&) = delete;
+
+            void Start(NotifyFunc aNotify, void* aContext) const noexcept
+            {
+                myHandle.promise().myNotify = aNotify;
+                myHandle.promise().myContext = aContext;
+                myHandle.resume();
+            }
+
+        private:
+            explicit Runner(std::coroutine_handle<promise_type> aHandle) noexcept : myHandle(aHandle) {}
+
+            std::coroutine_handle<promise_type> myHandle;
+        };
+
+        template<typename T>
+        Runner MakeRunner(Task<T>& aTask)
+        {
+            co_await aTask.WhenReady();
+        }
+
+        /// Resumes the awaiting coroutine once all runners and the starting thread have arrived,
+        /// the extra count keeps it suspended until every runner has been started.
+        ///
+        class WhenAllAwaiter
+        {
+        public:
+            explicit WhenAllAwaiter(std::vector<Runner>& someRunners) noexcept
+                : myRunners(&someRunners), myCount(someRunners.size() + 1) {}
+
+            NODISC bool await_ready() const noexcept { return myRunners->empty(); }
+
+            NODISC bool await_suspend(std::coroutine_handle<> aAwaiting) noexcept
+            {
+                myContinuation = aAwaiting;
+
+                for (const Runner& runner : *myRunners)
+                {
+                    runner.Start(&Arrive, this);
+                }
+
+                return myCount.fetch_sub(1, std::memory_order_acq_rel) != 1;
+            }
+
+            void await_resume() const noexcept {}
+
+        private:
+            static std::coroutine_handle<> Arrive(void* aContext) noexcept
+            {
+                auto* self = static_cast<WhenAllAwaiter*>(aContext);
+                if (self->myCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    return self->myContinuation;
+
+                return std::noop_coroutine();
+            }
+
+            std::vector<Runner>*        myRunners;
+            std::atomic<std::size_t>    myCount;
+            std::coroutine_handle<>     myContinuation;
+        };
+
+        template<typename T>
+        struct WhenAnyState
+        {
+            explicit WhenAnyState(std::size_t aCount) : myTasks(aCount) {}
+
+            void Finish(std::size_t aIndex) noexcept
+            {
+                if (myWinner.exchange(true, std::memory_order_acq_rel))
+                    return;
+
+                myIndex = aIndex;
+
+                if (myCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    myContinuation.resume();
+            }
+
+            std::vector<Task<T>>        myTasks; // kept here so tasks that lose the race can finish on their own
+            std::coroutine_handle<>     myContinuation;
+            std::size_t                 myIndex {0};
+            std::atomic<std::size_t>    myCount {2}; // first finished task and the starting thread
+            std::atomic<bool>           myWinner {false};
+        };
+
+        struct Detached
+        {
+            struct promise_type : public PromiseAlloc
+            {
+                NODISC Detached get_return_object() const noexcept { return {}; }
+
+                NODISC std::suspend_never initial_suspend() const noexcept { return {}; }
+                NODISC std::suspend_never final_suspend() const noexcept { return {}; }
+
+                void return_void() const noexcept {}
+                void unhandled_exception() const noexcept { std::terminate(); }
+            };
+        };
+
+        template<typename T>
+        Detached RunWhenAny(std::shared_ptr<WhenAnyState<T>> aState, std::size_t aIndex)
+        {
+            co_await aState->myTasks[aIndex].WhenReady();
+            aState->Finish(aIndex);
+        }
+
+        template<typename T>
+        class WhenAnyAwaiter
+        {
+        public:
+            explicit WhenAnyAwaiter(std::shared_ptr<WhenAnyState<T>> aState) noexcept
+                : myState(std::move(aState)) {}
+
+            NODISC bool await_ready() const noexcept { return false; }
+
+            NODISC bool await_suspend(std::coroutine_handle<> aAwaiting)
+            {
+                myState->myContinuation = aAwaiting;
+
+                for (std::size_t i = 0; i < myState->myTasks.size(); ++i)
+                {
+                    RunWhenAny(myState, i);
+                }
+
+                return myState->myCount.fetch_sub(1, std::memory_order_acq_rel) != 1;
+            }
+
+            void await_resume() const noexcept {}
+
+        private:
+            std::shared_ptr<WhenAnyState<T>> myState;
+        };
+
+        /// Blocks the calling thread until signaled, the mutex ensures the signaling thread is done
+        /// with the event before the waiting thread can return and destroy it.
+        ///
+        class SyncWaitEvent
+        {
+        public:
+            static std::coroutine_handle<> Set(void* aContext) noexcept
+            {
+                auto* self = static_cast<SyncWaitEvent*>(aContext);
+
+                std::lock_guard<std::mutex> lock(self->myMutex);
+                self->mySet = true;
+                self->myCV.notify_all();
+
+                return std::noop_coroutine();
+            }
+
+            void Wait()
+            {
+                std::unique_lock<std::mutex> lock(myMutex);
+                myCV.wait(lock, [this] { return mySet; });
+            }
+
+        private:
+            std::mutex              myMutex;
+            std::condition_variable myCV;
+            bool                    mySet {false};
+        };
+
+        template<typename T>
+        decltype(auto) TakeResult(Task<T>& aTask)
+        {
+            if constexpr (std::is_void_v<T>)
+            {
+                aTask.GetResult();
+                return std::monostate{};
+            }
+            else
+            {
+                return std::move(aTask).GetResult();
+            }
+        }
+    }
+
+    /// Runs all tasks and resumes once every one of them has finished. The tasks are started one after
+    /// another on the awaiting thread, so they should co_await a ThreadPool::Schedule to run in parallel.
+    /// Rethrows the exception of the first task, in argument order, that failed.
+    ///
+    /// \returns Tuple of results, where void results are replaced by std::monostate.
+    ///
+    template<typename... Ts>
+    NODISC auto WhenAll(Task<Ts>... someTasks) -> Task<std::tuple<details::coroutine::NonVoid<Ts>...>>
+    {
+        std::vector<details::coroutine::Runner> runners;
+        runners.reserve(sizeof...(Ts));
+
+        (runners.emplace_back(details::coroutine::MakeRunner(someTasks)), ...);
+
+        co_await details::coroutine::WhenAllAwaiter(runners);
+
+        co_return std::tuple<details::coroutine::NonVoid<Ts>...>{ details::coroutine::TakeResult(someTasks)... };
+    }
+
+    /// Runs all tasks and resumes once every one of them has finished, see the variadic WhenAll.
+    ///
+    /// \returns Results in the same order as the tasks, or nothing if the tasks return void.
+    ///
+    template<typename T>
+    NODISC auto WhenAll(std::vector<Task<T>> someTasks) -> Task<std::conditional_t<std::is_void_v<T>, void, std::vector<T>>>
+    {
+        std::vector<details::coroutine::Runner> runners;
+        runners.reserve(someTasks.size());
+
+        for (Task<T>& task : someTasks)
+        {
+            runners.emplace_back(details::coroutine::MakeRunner(task));
+        }
+
+        co_await details::coroutine::WhenAllAwaiter(runners);
+
+        if constexpr (std::is_void_v<T>)
+        {
+            for (Task<T>& task : someTasks)
+            {
+                task.GetResult();
+            }
+        }
+        else
+        {
+            std::vector<T> result;
+            result.reserve(someTasks.size());
+
+            for (Task<T>& task : someTasks)
+            {
+                result.emplace_back(std::move(task).GetResult());
+            }
+
+            co_return result;
+        }
+    }
+
+    /// Runs all tasks and resumes as soon as the first one finishes. The remaining tasks are not
+    /// cancelled, they keep running and clean up after themselves once done, so pass them a
+    /// std::stop_token if they should stop early.
+    ///
+    /// \returns Index and result of the first task that finished, rethrows if it failed.
+    ///
+    template<typename T>
+    NODISC auto WhenAny(std::vector<Task<T>> someTasks) -> Task<WhenAnyResult<T>>
+    {
+        if (someTasks.empty())
+            throw std::invalid_argument("WhenAny requires at least one task");
+
+        auto state = std::make_shared<details::coroutine::WhenAnyState<T>>(someTasks.size());
+        for (std::size_t i = 0; i < someTasks.size(); ++i)
+        {
+            state->myTasks[i] = std::move(someTasks[i]);
+        }
+
+        co_await details::coroutine::WhenAnyAwaiter<T>(state);
+
+        co_return WhenAnyResult<T>{ state->myIndex, details::coroutine::TakeResult(state->myTasks[state->myIndex]) };
+    }
+
+    /// Blocks the calling thread until the task has finished, used to bridge from regular code into
+    /// coroutines, e.g., from main or a test. Never call from a worker the task depends on.
+    ///
+    /// \returns Result of the task, rethrows if it failed.
+    ///
+    template<typename T>
+    auto SyncWait(Task<T> aTask) -> T
+    {
+        details::coroutine::SyncWaitEvent event;
+
+        details::coroutine::Runner runner = details::coroutine::MakeRunner(aTask);
+        runner.Start(&details::coroutine::SyncWaitEvent::Set, &event);
+
+        event.Wait();
+
+        if constexpr (std::is_void_v<T>)
+        {
+            aTask.GetResult();
+        }
+        else
+        {
+            return std::move(aTask).GetResult();
+        }
+    }
+
+    template<typename T>
+    inline Task<T> details::coroutine::TaskPromise<T>::get_return_object() noexcept
+    {
+        return Task<T>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+    }
+
+    inline Task<void> details::coroutine::TaskPromise<void>::get_return_object() noexcept
+    {
+        return Task<void>(std::coroutine_handle<TaskPromise>::from_promise(*this));
+    }
+
+    template<typename T>
+    inline Task<T>::Task(Handle aHandle) noexcept
+        : myHandle(aHandle)
+    {
+
+    }
+
+    template<typename T>
+    inline Task<T>::~Task()
+    {
+        if (myHandle)
+            myHandle.destroy();
+    }
+
+    template<typename T>
+    inline Task<T>::Task(Task&& aOther) noexcept
+        : myHandle(std::exchange(aOther.myHandle, nullptr))
+    {
+
+    }
+
+    template<typename T>
+    inline auto Task<T>::operator=(Task&& aOther) noexcept -> Task&
+    {
+        if (this != &aOther)
+        {
+            if (myHandle)
+                myHandle.destroy();
+
+            myHandle = std::exchange(aOther.myHandle, nullptr);
+        }
+
+        return *this;
+    }
+
+    template<typename T>
+    inline bool Task<T>::IsValid() const noexcept
+    {
+        return static_cast<bool>(myHandle);
+    }
+
+    template<typename T>
+    inline bool Task<T>::IsReady() const noexcept
+    {
+        return !myHandle || myHandle.done();
+    }
+
+    template<typename T>
+    inline auto Task<T>::operator co_await() & noexcept
+    {
+        struct Awaiter : AwaiterBase
+        {
+            using AwaiterBase::AwaiterBase;
+            decltype(auto) await_resume() { return this->myHandle.promise().GetResult(); }
+        };
+
+        return Awaiter(myHandle);
+    }
+
+    template<typename T>
+    inline auto Task<T>::operator co_await() && noexcept
+    {
+        struct Awaiter : AwaiterBase
+        {
+            using AwaiterBase::AwaiterBase;
+            decltype(auto) await_resume() { return std::move(this->myHandle.promise()).GetResult(); }
+        };
+
+        return Awaiter(myHandle);
+    }
+
+    template<typename T>
+    inline auto Task<T>::WhenReady() noexcept
+    {
+        struct Awaiter : AwaiterBase
+        {
+            using AwaiterBase::AwaiterBase;
+            void await_resume() const noexcept {}
+        };
+
+        return Awaiter(myHandle);
+    }
+
+    template<typename T>
+    inline decltype(auto) Task<T>::GetResult() &
+    {
+        return myHandle.promise().GetResult();
+    }
+
+    template<typename T>
+    inline decltype(auto) Task<T>::GetResult() &&
+    {
+        return std::move(myHandle.promise()).GetResult();
+    }
+}
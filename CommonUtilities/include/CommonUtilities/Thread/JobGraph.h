@@ -0,0 +1,83 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
+#include <CommonUtilities/Thread/TaskGroup.h>
+#include <CommonUtilities/Utility/SmallFunction.hpp>
+#include <CommonUtilities/Utility/NonCopyable.h>
+
+namespace CommonUtilities
+{
+    /// Graph of jobs with dependencies between them. A job is scheduled as soon as all of the jobs it
+    /// depends on have finished, without blocking any thread in between. The graph is built once and
+    /// may then be run any number of times, e.g., once per frame.
+    ///
+    class JobGraph : private NonCopyable
+    {
+    public:
+        using JobID         = std::size_t;
+        using JobFunction   = SmallFunction<void(), ThreadPool::TASK_CAPACITY>;
+
+        static constexpr JobID NULL_JOB = (std::numeric_limits<JobID>::max)();
+
+        explicit JobGraph(ThreadPool& aPool);
+        ~JobGraph();
+
+        /// Adds a job to the graph, may not be called while the graph is running.
+        ///
+        /// \returns ID to refer to the job when adding dependencies.
+        ///
+        JobID Add(JobFunction&& aFunc);
+
+        /// Makes aSuccessor wait for aJob to finish before it can start.
+        ///
+        void Precede(JobID aJob, JobID aSuccessor);
+
+        /// Makes all of someSuccessors wait for aJob to finish (fan-out).
+        ///
+        void Precede(JobID aJob, std::initializer_list<JobID> someSuccessors);
+
+        /// Makes aJob wait for all of someDependencies to finish (fan-in).
+        ///
+        void Succeed(JobID aJob, std::initializer_list<JobID> someDependencies);
+
+        /// Schedules all jobs without dependencies, the rest are scheduled as their dependencies
+        /// finish. The graph must not already be running.
+        ///
+        void Run();
+
+        /// Waits for the graph to finish, running pending tasks on the calling thread in the meantime.
+        /// Rethrows the first exception thrown by a job, successors of the job that threw are not run.
+        ///
+        void Wait();
+
+        /// Convenience for calling Run followed by Wait.
+        ///
+        void RunAndWait();
+
+        NODISC bool IsDone() const noexcept;
+        NODISC std::size_t Count() const noexcept;
+
+        /// Removes all jobs, may not be called while the graph is running.
+        ///
+        void Clear();
+
+    private:
+        struct Job
+        {
+            JobFunction                 func;
+            std::vector<JobID>          successors;
+            std::uint32_t               dependencies {0};
+            std::atomic<std::uint32_t>  remaining {0};
+        };
+
+        void Execute(JobID aJob);
+
+        std::deque<Job> myJobs; // deque since jobs hold atomics and may not be moved
+        TaskGroup       myGroup;
+    };
+}
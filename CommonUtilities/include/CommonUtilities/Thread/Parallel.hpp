@@ -1,6 +1,18 @@
 #pragma once
 
+#include <atomic>
+#include <array>
+#include <bit>
+#include <limits>
+#include <vector>
+#include <ranges>
+#include <optional>
+#include <iterator>
+#include <concepts>
+#include <algorithm>
+
 #include <CommonUtilities/Utility/ExecPolicy.h>
+#include <CommonUtilities/Thread/TaskGroup.h>
 
 namespace CommonUtilities
 {
@@ -39,4 +51,432 @@ namespace CommonUtilities
 				std::sort(policy, aContainer.begin(), aContainer.end());
 			}, threadLoop);
 	}
+
+	namespace details::parallel
+	{
+		/// \returns Number of elements per chunk, a grain size of zero picks one that gives each thread
+		/// a few chunks to balance the load with.
+		///
+		NODISC inline std::size_t GrainSize(const ThreadPool& aPool, std::size_t aCount, std::size_t aGrainSize)
+		{
+			if (aGrainSize != 0)
+				return aGrainSize;
+
+			const std::size_t participants = aPool.GetThreadCount() + 1;
+			return (std::max)(aCount / (participants * 4), std::size_t(1));
+		}
+
+		/// Splits [0, aCount) into chunks of aGrainSize that are claimed dynamically by the pool and the
+		/// calling thread. aFunc is called as aFunc(chunkIndex, begin, end), returns once all chunks are done.
+		///
+		template<class Func>
+		void RunChunks(ThreadPool& aPool, std::size_t aCount, std::size_t aGrainSize, const Func& aFunc)
+		{
+			const std::size_t chunkCount = (aCount + aGrainSize - 1) / aGrainSize;
+			if (chunkCount == 0)
+				return;
+
+			const std::size_t helperCount = (std::min)(chunkCount - 1, aPool.GetThreadCount());
+
+			if (helperCount == 0)
+			{
+				for (std::size_t i = 0; i < chunkCount; ++i)
+				{
+					aFunc(i, i * aGrainSize, (std::min)((i + 1) * aGrainSize, aCount));
+				}
+
+				return;
+			}
+
+			std::atomic<std::size_t> nextChunk {0};
+
+			const auto work = [&]()
+			{
+				for (std::size_t i = nextChunk.fetch_add(1, std::memory_order_relaxed); i < chunkCount; i = nextChunk.fetch_add(1, std::memory_order_relaxed))
+				{
+					aFunc(i, i * aGrainSize, (std::min)((i + 1) * aGrainSize, aCount));
+				}
+			};
+
+			TaskGroup group(aPool);
+			for (std::size_t i = 0; i < helperCount; ++i)
+			{
+				group.Run(work);
+			}
+
+			std::exception_ptr exception;
+			try
+			{
+				work(); // calling thread participates
+			}
+			catch (...)
+			{
+				nextChunk.store(chunkCount, std::memory_order_relaxed); // stop handing out chunks
+				exception = std::current_exception();
+			}
+
+			group.Wait();
+
+			if (exception)
+				std::rethrow_exception(exception);
+		}
+	}
+
+	/// Calls aFunc for every index in [aBegin, aEnd), split into chunks of aGrainSize indices that
+	/// are run on the pool with the calling thread participating.
+	///
+	/// \param aGrainSize: Number of indices per chunk, zero to let it be chosen from the thread count.
+	///
+	template<std::integral I, typename Func> requires(std::invocable<Func&, I>)
+	void ParallelFor(ThreadPool& aPool, I aBegin, I aEnd, std::size_t aGrainSize, Func&& aFunc)
+	{
+		if (aEnd <= aBegin)
+			return;
+
+		const std::size_t count = static_cast<std::size_t>(aEnd - aBegin);
+
+		details::parallel::RunChunks(aPool, count, details::parallel::GrainSize(aPool, count, aGrainSize),
+			[&aFunc, aBegin](std::size_t, std::size_t aFirst, std::size_t aLast)
+			{
+				for (std::size_t i = aFirst; i < aLast; ++i)
+				{
+					aFunc(static_cast<I>(aBegin + static_cast<I>(i)));
+				}
+			});
+	}
+
+	/// Reduces the transformed elements in [aFirst, aLast) in chunks on the pool. The reduction must be
+	/// associative, but need not be commutative as the chunks are combined in order.
+	///
+	template<std::random_access_iterator Iter, typename T, typename ReduceOp, typename TransformOp>
+	NODISC T ParallelTransformReduce(ThreadPool& aPool, Iter aFirst, Iter aLast, std::size_t aGrainSize, T aInit, ReduceOp aReduce, TransformOp aTransform)
+	{
+		const std::size_t count = static_cast<std::size_t>(std::distance(aFirst, aLast));
+		if (count == 0)
+			return aInit;
+
+		const std::size_t grainSize = details::parallel::GrainSize(aPool, count, aGrainSize);
+
+		std::vector<std::optional<T>> partials((count + grainSize - 1) / grainSize);
+
+		details::parallel::RunChunks(aPool, count, grainSize,
+			[&](std::size_t aChunk, std::size_t aBegin, std::size_t aEnd)
+			{
+				T result = aTransform(aFirst[aBegin]);
+				for (std::size_t i = aBegin + 1; i < aEnd; ++i)
+				{
+					result = aReduce(std::move(result), aTransform(aFirst[i]));
+				}
+				partials[aChunk].emplace(std::move(result));
+			});
+
+		for (auto& partial : partials)
+		{
+			aInit = aReduce(std::move(aInit), std::move(*partial));
+		}
+
+		return aInit;
+	}
+
+	/// Reduces the elements in [aFirst, aLast) in chunks on the pool. The reduction must be associative,
+	/// but need not be commutative as the chunks are combined in order.
+	///
+	template<std::random_access_iterator Iter, typename T, typename ReduceOp = std::plus<>>
+	NODISC T ParallelReduce(ThreadPool& aPool, Iter aFirst, Iter aLast, std::size_t aGrainSize, T aInit, ReduceOp aReduce = {})
+	{
+		return ParallelTransformReduce(aPool, aFirst, aLast, aGrainSize, std::move(aInit), std::move(aReduce),
+			[](const auto& aValue) -> decltype(auto) { return aValue; });
+	}
+
+	/// Writes the inclusive prefix of [aFirst, aLast) to aOutput, computed in two passes over chunks on
+	/// the pool. The operation must be associative.
+	///
+	/// \returns Iterator past the last written element.
+	///
+	template<std::random_access_iterator Iter, std::random_access_iterator OutIter, typename BinaryOp = std::plus<>>
+	OutIter ParallelInclusiveScan(ThreadPool& aPool, Iter aFirst, Iter aLast, OutIter aOutput, std::size_t aGrainSize, BinaryOp aOp = {})
+	{
+		using T = typename std::iterator_traits<Iter>::value_type;
+
+		const std::size_t count = static_cast<std::size_t>(std::distance(aFirst, aLast));
+		if (count == 0)
+			return aOutput;
+
+		const std::size_t grainSize = details::parallel::GrainSize(aPool, count, aGrainSize);
+
+		std::vector<std::optional<T>> offsets((count + grainSize - 1) / grainSize);
+
+		// first pass, sum of each chunk
+
+		details::parallel::RunChunks(aPool, count, grainSize,
+			[&](std::size_t aChunk, std::size_t aBegin, std::size_t aEnd)
+			{
+				T sum = aFirst[aBegin];
+				for (std::size_t i = aBegin + 1; i < aEnd; ++i)
+				{
+					sum = aOp(std::move(sum), aFirst[i]);
+				}
+				offsets[aChunk].emplace(std::move(sum));
+			});
+
+		// exclusive prefix of the chunk sums, the first chunk has no offset
+
+		std::optional<T> running;
+		for (auto& offset : offsets)
+		{
+			T sum = std::move(*offset);
+			offset = running;
+			running = running ? aOp(std::move(*running), std::move(sum)) : std::move(sum);
+		}
+
+		// second pass, scan each chunk starting from its offset
+
+		details::parallel::RunChunks(aPool, count, grainSize,
+			[&](std::size_t aChunk, std::size_t aBegin, std::size_t aEnd)
+			{
+				T sum = offsets[aChunk] ? aOp(*offsets[aChunk], aFirst[aBegin]) : T(aFirst[aBegin]);
+				aOutput[aBegin] = sum;
+
+				for (std::size_t i = aBegin + 1; i < aEnd; ++i)
+				{
+					sum = aOp(std::move(sum), aFirst[i]);
+					aOutput[i] = sum;
+				}
+			});
+
+		return aOutput + count;
+	}
+
+	namespace details::radix
+	{
+		inline constexpr std::size_t DIGIT_BITS		= 8;
+		inline constexpr std::size_t DIGIT_COUNT	= std::size_t(1) << DIGIT_BITS;
+		inline constexpr std::size_t THRESHOLD		= 2048; // below this a comparison sort is faster than the radix passes
+		inline constexpr std::size_t MIN_GRAIN		= 8192; // fewer elements per chunk than this and the histograms dominate
+
+		/// Keys that can be sorted by their bits, i.e., integers and IEEE floats.
+		///
+		template<typename T>
+		concept Key =
+			(std::is_integral_v<T> && !std::is_same_v<T, bool>) ||
+			(std::is_floating_point_v<T> && std::numeric_limits<T>::is_iec559 && (sizeof(T) == 4 || sizeof(T) == 8));
+
+		template<Key T>
+		struct UnsignedKeyImpl : std::make_unsigned<T> {};
+
+		template<Key T> requires(std::is_floating_point_v<T>)
+		struct UnsignedKeyImpl<T> : std::conditional<sizeof(T) == 4, std::uint32_t, std::uint64_t> {};
+
+		template<Key T>
+		using UnsignedKey = typename UnsignedKeyImpl<T>::type;
+
+		/// Maps the key to an unsigned integer that orders the same way.
+		///
+		template<Key T>
+		NODISC constexpr UnsignedKey<T> ToUnsigned(T aValue) noexcept
+		{
+			using U = UnsignedKey<T>;
+
+			constexpr U signBit = U(1) << (sizeof(U) * 8 - 1);
+
+			if constexpr (std::is_floating_point_v<T>)
+			{
+				const U bits = std::bit_cast<U>(aValue);
+				return (bits & signBit) ? U(~bits) : U(bits | signBit); // negatives are reversed, positives placed above them
+			}
+			else if constexpr (std::is_signed_v<T>)
+			{
+				return U(U(aValue) ^ signBit);
+			}
+			else
+			{
+				return aValue;
+			}
+		}
+
+		/// Stable LSD radix sort of aData, using aBuffer of the same size as scratch. Each pass builds
+		/// histograms per chunk on the pool, turns them into offsets, and scatters the chunks in parallel.
+		/// Passes where every element has the same digit are skipped.
+		///
+		template<typename T, typename KeyFunc>
+		void Sort(ThreadPool& aPool, T* aData, T* aBuffer, std::size_t aCount, const KeyFunc& aKey)
+		{
+			using U = std::remove_cvref_t<decltype(aKey(*aData))>;
+
+			static_assert(std::is_unsigned_v<U>, "Radix keys must be mapped to unsigned integers");
+
+			constexpr std::size_t passCount = (sizeof(U) * 8 + DIGIT_BITS - 1) / DIGIT_BITS;
+
+			const std::size_t participants	= aPool.GetThreadCount() + 1;
+			const std::size_t grainSize		= (std::max)((aCount + participants - 1) / participants, MIN_GRAIN);
+			const std::size_t chunkCount	= (aCount + grainSize - 1) / grainSize;
+
+			std::vector<std::array<std::size_t, DIGIT_COUNT>> histograms(chunkCount);
+
+			T* source		= aData;
+			T* destination	= aBuffer;
+
+			for (std::size_t pass = 0; pass < passCount; ++pass)
+			{
+				const std::size_t shift = pass * DIGIT_BITS;
+
+				const auto digit = [&aKey, shift](const T& aValue)
+				{
+					return static_cast<std::size_t>((aKey(aValue) >> shift) & (DIGIT_COUNT - 1));
+				};
+
+				details::parallel::RunChunks(aPool, aCount, grainSize,
+					[&](std::size_t aChunk, std::size_t aBegin, std::size_t aEnd)
+					{
+						auto& histogram = histograms[aChunk];
+						histogram.fill(0);
+
+						for (std::size_t i = aBegin; i < aEnd; ++i)
+						{
+							++histogram[digit(source[i])];
+						}
+					});
+
+				// offsets are laid out digit by digit, and chunk by chunk within each digit to stay stable
+
+				bool skip = false;
+				std::size_t offset = 0;
+
+				for (std::size_t d = 0; d < DIGIT_COUNT && !skip; ++d)
+				{
+					const std::size_t start = offset;
+					for (auto& histogram : histograms)
+					{
+						const std::size_t count = histogram[d];
+						histogram[d] = offset;
+						offset += count;
+					}
+
+					skip = (offset - start == aCount);
+				}
+
+				if (skip)
+					continue;
+
+				details::parallel::RunChunks(aPool, aCount, grainSize,
+					[&](std::size_t aChunk, std::size_t aBegin, std::size_t aEnd)
+					{
+						auto& offsets = histograms[aChunk];
+						for (std::size_t i = aBegin; i < aEnd; ++i)
+						{
+							destination[offsets[digit(source[i])]++] = std::move(source[i]);
+						}
+					});
+
+				std::swap(source, destination);
+			}
+
+			if (source != aData)
+			{
+				details::parallel::RunChunks(aPool, aCount, grainSize,
+					[&](std::size_t, std::size_t aBegin, std::size_t aEnd)
+					{
+						std::move(source + aBegin, source + aEnd, aData + aBegin);
+					});
+			}
+		}
+	}
+
+	/// Sorts the container in ascending order using the pool. Contiguous containers of integers or IEEE
+	/// floats are radix sorted, everything else falls back to std::sort with a parallel policy.
+	///
+	template<typename C>
+	void ParallelSort(ThreadPool& aPool, C& aContainer)
+	{
+		using T = std::ranges::range_value_t<C>;
+
+		const std::size_t count = std::ranges::size(aContainer);
+
+		if constexpr (details::radix::Key<T> && std::ranges::contiguous_range<C>)
+		{
+			if (count >= details::radix::THRESHOLD)
+			{
+				std::vector<T> buffer(count);
+				details::radix::Sort(aPool, std::ranges::data(aContainer), buffer.data(), count,
+					[](T aValue) { return details::radix::ToUnsigned(aValue); });
+
+				return;
+			}
+		}
+
+		ExecPolicy(
+			[&aContainer](auto& policy)
+			{
+				std::sort(policy, std::ranges::begin(aContainer), std::ranges::end(aContainer));
+			}, count >= details::radix::THRESHOLD ? Policy::ParUnseq : Policy::Unseq);
+	}
+
+	/// Sorts the container with the comparison, always uses std::sort with a parallel policy.
+	///
+	template<typename C, typename Comp> requires(std::predicate<Comp&, std::ranges::range_reference_t<C>, std::ranges::range_reference_t<C>>)
+	void ParallelSort(ThreadPool&, C& aContainer, Comp&& aComp)
+	{
+		ExecPolicy(
+			[&aContainer, &aComp](auto& policy)
+			{
+				std::sort(policy, std::ranges::begin(aContainer), std::ranges::end(aContainer), aComp);
+			}, Policy::ParUnseq);
+	}
+
+	/// Stable sort of the container in ascending order of the key returned by aKey. When the key is an
+	/// integer or IEEE float, the keys are radix sorted together with the index of their element, after
+	/// which the elements are moved into place once. Other keys fall back to std::stable_sort.
+	///
+	template<typename C, typename KeyFunc> requires(std::invocable<KeyFunc&, const std::ranges::range_value_t<C>&>)
+	void ParallelSortByKey(ThreadPool& aPool, C& aContainer, KeyFunc&& aKey)
+	{
+		using T = std::ranges::range_value_t<C>;
+		using K = std::remove_cvref_t<std::invoke_result_t<KeyFunc&, const T&>>;
+
+		const std::size_t count = std::ranges::size(aContainer);
+
+		if constexpr (details::radix::Key<K> && std::ranges::random_access_range<C>)
+		{
+			if (count >= details::radix::THRESHOLD && count <= (std::numeric_limits<std::uint32_t>::max)())
+			{
+				struct Entry
+				{
+					details::radix::UnsignedKey<K>	key;
+					std::uint32_t					index;
+				};
+
+				auto first = std::ranges::begin(aContainer);
+
+				std::vector<Entry> entries(count);
+				std::vector<Entry> buffer(count);
+
+				ParallelFor(aPool, std::size_t(0), count, details::radix::MIN_GRAIN,
+					[&](std::size_t aIndex)
+					{
+						entries[aIndex] = Entry{ details::radix::ToUnsigned(static_cast<K>(aKey(std::as_const(first[aIndex])))), static_cast<std::uint32_t>(aIndex) };
+					});
+
+				details::radix::Sort(aPool, entries.data(), buffer.data(), count,
+					[](const Entry& aEntry) { return aEntry.key; });
+
+				std::vector<T> sorted;
+				sorted.reserve(count);
+
+				for (const Entry& entry : entries)
+				{
+					sorted.emplace_back(std::move(first[entry.index]));
+				}
+
+				std::ranges::move(sorted, first);
+
+				return;
+			}
+		}
+
+		std::stable_sort(std::ranges::begin(aContainer), std::ranges::end(aContainer),
+			[&aKey](const T& aLeft, const T& aRight)
+			{
+				return aKey(aLeft) < aKey(aRight);
+			});
+	}
 }
\ No newline at end of file
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+
+#include <CommonUtilities/Thread/ThreadPool.h>
+#include <CommonUtilities/Utility/NonCopyable.h>
+
+namespace CommonUtilities
+{
+    /// Tracks a set of tasks submitted to a ThreadPool so that they can be waited on together. Waiting
+    /// runs pending tasks on the calling thread instead of sleeping, backing off while there is nothing
+    /// to help out with until every task in the group has finished.
+    ///
+    class TaskGroup : private NonCopyable
+    {
+    public:
+        explicit TaskGroup(ThreadPool& aPool);
+        ~TaskGroup();
+
+        /// Submits a function to the pool as part of this group. May also be called from within
+        /// tasks of the group, e.g., to fan out further work.
+        ///
+        template<class F> requires(std::is_invocable_v<F>)
+        void Run(F&& aFunc);
+
+        /// Waits for all tasks in the group to finish, running pending tasks on the calling thread in
+        /// the meantime. Rethrows the first exception thrown by a task in the group, if any.
+        ///
+        void Wait();
+
+        /// \returns Whether all tasks in the group have finished.
+        ///
+        NODISC bool IsDone() const noexcept;
+
+        NODISC ThreadPool& GetPool() const noexcept;
+
+    private:
+        void Begin();
+        void Finish() noexcept;
+        void CaptureException(std::exception_ptr aException) noexcept;
+
+        ThreadPool*                 myPool {nullptr};
+        std::atomic<std::size_t>    myPending {0};
+        std::size_t                 myBusyCount {0}; // times the group went from idle to busy
+        std::size_t                 myIdleCount {0}; // times the group went from busy to idle
+        std::exception_ptr          myException;
+        std::condition_variable     myCV;
+        std::mutex                  myMutex;
+    };
+
+    template<class F> requires(std::is_invocable_v<F>)
+    inline void TaskGroup::Run(F&& aFunc)
+    {
+        Begin();
+
+        try
+        {
+            myPool->Submit([this, func = std::forward<F>(aFunc)]() mutable
+            {
+                try
+                {
+                    func();
+                }
+                catch (...)
+                {
+                    CaptureException(std::current_exception());
+                }
+
+                Finish();
+            });
+        }
+        catch (...)
+        {
+            Finish();
+            throw;
+        }
+    }
+}
@@ -3,11 +3,18 @@
 #include <thread>
 #include <functional>
 #include <mutex>
+#include <atomic>
+#include <memory>
+#include <new>
+#include <cstdint>
 #include <type_traits>
 #include <array>
 #include <queue>
+#include <optional>
 
 #include <CommonUtilities/Structures/FreeVector.hpp>
+#include <CommonUtilities/System/CpuTopology.h>
+#include <CommonUtilities/Thread/ThreadStats.h>
 #include <CommonUtilities/Utility/NonCopyable.h>
 
 namespace CommonUtilities
@@ -25,18 +32,64 @@ namespace CommonUtilities
             std::exception_ptr  exceptionPtr;
         };
 
+        enum class WakeMode
+        {
+            ConditionVariable,  // loops sleep on a shared condition variable
+            Atomic              // loops wait on their own atomic, optionally spinning first for lower wake latency
+        };
+
+        struct Stats
+        {
+            std::vector<WorkerStats>    loops;          // per loop thread, start latency is measured from the last dispatch
+            WorkerStats                 total;
+            std::chrono::nanoseconds    elapsed {0};    // since start or the last reset
+        };
+
+        static constexpr bool STATS_ENABLED = COMMON_UTILITIES_THREAD_STATS;
+
         ThreadLoops();
         ~ThreadLoops();
 
-        void Start(std::size_t aThreadCount);
+        /// Starts the loop threads, does nothing if already started.
+        ///
+        /// \param aThreadCount: Number of threads, i.e., max number of loop tasks.
+        /// \param aWakeMode: How loop threads are woken up when dispatched.
+        /// \param aSpinCount: Number of times to check for a dispatch before going to sleep in Atomic mode,
+        /// trades CPU time for wake latency when loops are dispatched every frame.
+        /// \param aPlacement: Which processors the loop threads are pinned to, if any.
+        ///
+        void Start(std::size_t aThreadCount, WakeMode aWakeMode = WakeMode::ConditionVariable, std::size_t aSpinCount = 0, const PlacementPolicy& aPlacement = {});
         void Shutdown();
 
         ThreadException GetLastException();
 
+        /// \returns Processor the loop thread is pinned to, or nothing if it is not pinned.
+        ///
+        NODISC std::optional<LogicalProcessor> GetLoopPlacement(LoopID aLoopID) const;
+
+        /// Aggregates the counters of every loop into a snapshot, empty unless built with
+        /// COMMON_UTILITIES_THREAD_STATS.
+        ///
+        NODISC Stats GetStats() const;
+        void ResetStats();
+
         LoopID SetLoopTask(const std::function<void()>& aTask, const ExceptionCallback& aOnException = {});
         void RemoveLoopTask(LoopID aLoopID);
         void DispatchLoop(LoopID aLoopID);
 
+        /// Dispatches every loop, loops without a task complete immediately.
+        ///
+        void DispatchAll();
+
+        /// Blocks until the loop has finished all runs dispatched before the call.
+        ///
+        void WaitLoop(LoopID aLoopID);
+
+        /// Blocks until every loop has finished all runs dispatched before the call, e.g., to join
+        /// the loops at the end of a frame after DispatchAll.
+        ///
+        void WaitAll();
+
     private:
         struct LoopTask
         {
@@ -44,15 +97,35 @@ namespace CommonUtilities
             ExceptionCallback       exceptionCallback;
         };
 
+        struct alignas(std::hardware_destructive_interference_size) LoopState // padded to not share cache lines with other loops
+        {
+            std::atomic<std::uint32_t> dispatched   {0}; // number of times dispatched
+            std::atomic<std::uint32_t> finished     {0}; // value of dispatched when the loop last finished a run
+            std::atomic<LoopTask*>     task         {nullptr}; // read instead of myLoopTasks, whose validity bits are shared with other loops' tasks
+#if COMMON_UTILITIES_THREAD_STATS
+            std::atomic<std::uint64_t> dispatchTime {0};
+            details::threadstats::WorkerCounters counters;
+#endif
+        };
+
         void ThreadLoop(LoopID aLoopID);
 
+        NODISC std::uint32_t WaitForDispatch(LoopState& aState, std::uint32_t aFinished);
+        void RunLoopTask(LoopID aLoopID);
+
         std::vector<std::jthread>       myThreads;
         FreeVector<LoopTask>            myLoopTasks;
-        std::vector<bool>               myDispatchedLoops;
+        std::unique_ptr<LoopState[]>    myLoopStates;
+        std::vector<LogicalProcessor>   myPlacements; // per loop thread, empty if not pinned
         std::queue<ThreadException>     myExceptions;
         std::condition_variable         myCV;
         std::mutex                      myMutex; // sync access to task queue
         std::mutex                      myExceptionMutex;
-        bool                            myShutdown {true};
+        WakeMode                        myWakeMode {WakeMode::ConditionVariable};
+        std::size_t                     mySpinCount {0};
+        std::atomic<bool>               myShutdown {true};
+#if COMMON_UTILITIES_THREAD_STATS
+        std::atomic<std::uint64_t>      myStatsStart {0};
+#endif
 	};
 }
\ No newline at end of file
@@ -2,41 +2,349 @@
 
 #include <future>
 #include <thread>
-#include <queue>
 #include <functional>
 #include <mutex>
+#include <atomic>
+#include <coroutine>
+#include <memory>
+#include <string>
+#include <optional>
+#include <stop_token>
 #include <type_traits>
+#include <utility>
 
+#include <CommonUtilities/Structures/WorkStealingDeque.hpp>
+#include <CommonUtilities/Structures/EnumArray.hpp>
+#include <CommonUtilities/System/CpuTopology.h>
+#include <CommonUtilities/Thread/ThreadStats.h>
+#include <CommonUtilities/Utility/SmallFunction.hpp>
 #include <CommonUtilities/Utility/NonCopyable.h>
 
 namespace CommonUtilities
 {
+    namespace details::threadpool
+    {
+        /// Fixed size-class block pool with thread-local caches used for task nodes and future states,
+        /// so submitting work does not have to touch the global heap once it has warmed up.
+        ///
+        COMMON_UTILITIES_API NODISC void* Allocate(std::size_t aNumBytes);
+        COMMON_UTILITIES_API void Deallocate(void* aMemory, std::size_t aNumBytes) noexcept;
+
+        template<typename T>
+        class TaskAlloc
+        {
+        public:
+            using value_type        = T;
+            using is_always_equal   = std::true_type;
+
+            constexpr TaskAlloc() noexcept = default;
+
+            template<class U>
+            constexpr TaskAlloc(const TaskAlloc<U>&) noexcept {}
+
+            NODISC T* allocate(std::size_t aNumObjects)
+            {
+                if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                {
+                    return static_cast<T*>(::operator new(aNumObjects * sizeof(T), std::align_val_t(alignof(T))));
+                }
+                else
+                {
+                    return static_cast<T*>(Allocate(aNumObjects * sizeof(T)));
+                }
+            }
+
+            void deallocate(T* aObject, std::size_t aNumObjects) noexcept
+            {
+                if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                {
+                    ::operator delete(aObject, std::align_val_t(alignof(T)));
+                }
+                else
+                {
+                    Deallocate(aObject, aNumObjects * sizeof(T));
+                }
+            }
+
+            template<class U>
+            NODISC constexpr bool operator==(const TaskAlloc<U>&) const noexcept { return true; }
+        };
+
+        /// Keeps a callable in a pooled block instead of on the heap, for tasks that do not fit in the
+        /// inline storage of a task, e.g., a promise together with a large capture.
+        ///
+        template<class F>
+        class PooledFunction
+        {
+        public:
+            explicit PooledFunction(F&& aFunc)
+            {
+                TaskAlloc<F> alloc;
+                myFunc = alloc.allocate(1);
+
+                try
+                {
+                    ::new (static_cast<void*>(myFunc)) F(std::move(aFunc));
+                }
+                catch (...)
+                {
+                    alloc.deallocate(myFunc, 1);
+                    throw;
+                }
+            }
+
+            PooledFunction(PooledFunction&& aOther) noexcept
+                : myFunc(std::exchange(aOther.myFunc, nullptr)) {}
+
+            ~PooledFunction()
+            {
+                if (myFunc)
+                {
+                    myFunc->~F();
+                    TaskAlloc<F>().deallocate(myFunc, 1);
+                }
+            }
+
+            PooledFunction(const PooledFunction&) = delete;
+            auto operator=(const PooledFunction&) -> PooledFunction& = delete;
+            auto operator=(PooledFunction&&) -> PooledFunction& = delete;
+
+            void operator()()
+            {
+                (*myFunc)();
+            }
+
+        private:
+            F* myFunc {nullptr};
+        };
+
+        /// Passes the stop token along if the function accepts one as its first parameter.
+        ///
+        template<class F, typename... Args>
+        decltype(auto) InvokeTask(const std::stop_token& aToken, F&& aFunc, Args&&... someArgs)
+        {
+            if constexpr (std::is_invocable_v<F, std::stop_token, Args...>)
+            {
+                return std::invoke(std::forward<F>(aFunc), aToken, std::forward<Args>(someArgs)...);
+            }
+            else
+            {
+                return std::invoke(std::forward<F>(aFunc), std::forward<Args>(someArgs)...);
+            }
+        }
+
+        template<class F, typename... Args>
+        using TaskResult = decltype(InvokeTask(std::declval<const std::stop_token&>(), std::declval<F>(), std::declval<Args>()...));
+    }
+
     class ThreadPool : private NonCopyable
     {
     public:
+        static constexpr std::size_t TASK_CAPACITY = 64; // captures up to this size are stored without heap allocation
+
+        using TaskFunction = SmallFunction<void(), TASK_CAPACITY>;
+
+        enum class Scheduling
+        {
+            GlobalQueue,    // all tasks are placed in one shared queue
+            WorkStealing    // each worker has its own deque and steals from others when it runs dry
+        };
+
+        enum class Priority
+        {
+            Critical,       // latency-critical work, e.g., jobs the current frame waits on
+            Normal,
+            Background,     // long-running work that may be delayed, e.g., streaming or rebuilds
+
+            Count
+        };
+
+        static constexpr std::size_t NULL_WORKER        = static_cast<std::size_t>(-1);
+        static constexpr std::size_t PRIORITY_COUNT     = static_cast<std::size_t>(Priority::Count);
+        static constexpr std::size_t STARVATION_LIMIT   = 8; // a lane passed over this many times is served next
+
+        struct TaskOptions
+        {
+            Priority        priority {Priority::Normal};
+            std::stop_token stopToken;  // the task is dropped without running if stop is requested before it starts
+            std::string     threadName; // empty if the worker should keep its current name
+        };
+
+        struct Stats
+        {
+            std::vector<WorkerStats>                            workers;        // per worker, followed by one entry for other threads helping out through RunPendingTask
+            WorkerStats                                         total;
+            EnumArray<Priority, std::size_t, PRIORITY_COUNT>    queueDepths {};
+            std::chrono::nanoseconds                            elapsed     {0}; // since start or the last reset
+
+            NODISC double GetTasksPerSecond() const noexcept;
+        };
+
+        static constexpr bool STATS_ENABLED = COMMON_UTILITIES_THREAD_STATS;
+
+        class ScheduleAwaiter
+        {
+        public:
+            constexpr ScheduleAwaiter(ThreadPool& aPool, Priority aPriority) noexcept
+                : myPool(&aPool), myPriority(aPriority) {}
+
+            NODISC constexpr bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> aHandle) const;
+            constexpr void await_resume() const noexcept {}
+
+        private:
+            ThreadPool* myPool;
+            Priority    myPriority;
+        };
+
         ThreadPool();
         ~ThreadPool();
 
-        void Start(std::size_t aThreadCount);
+        /// Starts the worker threads, does nothing if already started.
+        ///
+        /// \param aThreadCount: Number of workers to create.
+        /// \param aScheduling: How tasks are distributed among the workers.
+        /// \param aThreadName: Name given to each worker on start.
+        /// \param aPlacement: Which processors the workers are pinned to, if any.
+        ///
+        void Start(std::size_t aThreadCount, Scheduling aScheduling = Scheduling::GlobalQueue, const std::string& aThreadName = "CU THREAD", const PlacementPolicy& aPlacement = {});
         void Shutdown();
 
+        NODISC Scheduling GetScheduling() const noexcept;
+        NODISC std::size_t GetThreadCount() const noexcept;
+
+        /// \returns Processor the worker is pinned to, or nothing if it is not pinned.
+        ///
+        NODISC std::optional<LogicalProcessor> GetWorkerPlacement(std::size_t aWorkerIndex) const;
+
+        /// Aggregates the counters of every worker into a snapshot. Only the queue depths are filled in
+        /// unless built with COMMON_UTILITIES_THREAD_STATS, in which case nothing is recorded at all.
+        ///
+        NODISC Stats GetStats() const;
+        void ResetStats();
+
+        /// \returns Index of the calling worker within its pool, or NULL_WORKER if not called from a worker.
+        ///
+        NODISC static std::size_t GetCurrentWorkerIndex() noexcept;
+
+        /// \returns Approximate number of tasks in the lane that have not started yet.
+        ///
+        NODISC std::size_t GetQueueDepth(Priority aPriority) const noexcept;
+
+        /// Enqueues a function and returns a future to its result. The thread name is only applied
+        /// when it differs from the name the worker currently has. Captures that do not fit in
+        /// TASK_CAPACITY along with the promise are kept in pooled blocks, not on the heap.
+        ///
         template<class F, typename... Args> requires(std::is_invocable_v<F, Args...>)
         auto Enqueue(F&& aFunc, std::string&& aThreadName = "CU THREAD", Args&&... someArgs) -> std::future<std::invoke_result_t<F, Args...>>;
 
+        /// Enqueues a function in the given lane. If stop is requested on the token before the task
+        /// starts, it is dropped and the future reports std::future_errc::broken_promise. A function
+        /// that takes a std::stop_token as its first parameter is given the token to check while running.
+        ///
+        template<class F, typename... Args> requires(std::is_invocable_v<F, Args...> || std::is_invocable_v<F, std::stop_token, Args...>)
+        auto Enqueue(TaskOptions aOptions, F&& aFunc, Args&&... someArgs) -> std::future<details::threadpool::TaskResult<F, Args...>>;
+
+        /// Fire-and-forget submission, nothing is allocated on the heap for captures that fit in
+        /// TASK_CAPACITY. Exceptions thrown by the function are not caught, use Enqueue if the result
+        /// or exception is needed.
+        ///
+        template<class F, typename... Args> requires(std::is_invocable_v<F, Args...>)
+        void Submit(F&& aFunc, Args&&... someArgs);
+
+        /// Fire-and-forget submission in the given lane, see Enqueue for how the stop token is used.
+        ///
+        template<class F, typename... Args> requires(std::is_invocable_v<F, Args...> || std::is_invocable_v<F, std::stop_token, Args...>)
+        void Submit(TaskOptions aOptions, F&& aFunc, Args&&... someArgs);
+
+        /// Awaitable that suspends the calling coroutine and resumes it on one of the workers, e.g.,
+        /// co_await pool.Schedule() at the start of a coroutine to move its work off the caller.
+        ///
+        NODISC ScheduleAwaiter Schedule(Priority aPriority = Priority::Normal) noexcept;
+
+        /// Runs one pending task on the calling thread, used to help out instead of blocking while
+        /// waiting for other tasks to finish. Background tasks are only picked up once starving.
+        ///
+        /// \returns Whether a task was run.
+        ///
+        bool RunPendingTask();
+
     private:
         struct Task
         {
-            std::string             name;
-            std::function<void()>   func;
+            TaskFunction    func;
+            std::string     name; // empty if the worker should keep its current name
+            std::stop_token stopToken;
+            Priority        priority {Priority::Normal};
+#if COMMON_UTILITIES_THREAD_STATS
+            std::uint64_t   enqueueTime {0};
+#endif
+        };
+
+        struct TaskQueue
+        {
+            std::vector<Task*>  tasks; // ring buffer, does not allocate once it has grown large enough
+            std::size_t         head    {0};
+            std::size_t         count   {0};
+            std::size_t         skipped {0}; // times passed over in favour of another lane while non-empty
+
+            void Push(Task* aTask);
+            NODISC Task* Pop();
+        };
+
+        struct Worker
+        {
+            WorkStealingDeque<Task*>    tasks;
+            std::uint64_t               seed {0};
         };
 
-        void ThreadLoop();
+        /// \returns The function stored inline if it fits, otherwise moved into a pooled block.
+        ///
+        template<class F>
+        NODISC static TaskFunction MakeTaskFunction(F&& aFunc);
 
-        std::vector<std::jthread>   myThreads;
-        std::queue<Task>            myTasks;
-        std::condition_variable     myCV;
-        std::mutex                  myMutex; // sync access to task queue
-        bool                        myShutdown = true;
+        NODISC static Task* CreateTask(TaskFunction&& aFunc, std::string&& aThreadName = {});
+        NODISC static Task* CreateTask(TaskFunction&& aFunc, TaskOptions&& aOptions);
+        static void DestroyTask(Task* aTask) noexcept;
+
+        void Push(Task* aTask);
+
+        NODISC Task* FindTask(std::size_t aWorkerIndex);
+        NODISC Task* StealTask(std::size_t aSkipIndex, std::uint64_t& aSeed);
+        NODISC Task* PopGlobalTask(Priority aLowest);
+
+        void PushGlobal(Task* aTask);
+        NODISC Task* PopGlobal(Priority aLowest);
+
+        static void SetThreadName(const std::string& aThreadName);
+        void RunTask(Task* aTask, bool aRename);
+
+#if COMMON_UTILITIES_THREAD_STATS
+        NODISC details::threadstats::WorkerCounters& GetCounters() const noexcept;
+#endif
+
+        void BeginWorker(std::size_t aWorkerIndex, const std::string& aThreadName);
+
+        void ThreadLoop(std::size_t aWorkerIndex, std::string aThreadName);
+        void WorkStealingLoop(std::size_t aWorkerIndex, std::string aThreadName);
+
+        std::vector<std::jthread>               myThreads;
+        std::vector<std::unique_ptr<Worker>>    myWorkers;
+        std::vector<LogicalProcessor>           myPlacements; // per worker, empty if not pinned
+        EnumArray<Priority, TaskQueue, PRIORITY_COUNT>                  myQueues;
+        EnumArray<Priority, std::atomic<std::size_t>, PRIORITY_COUNT>   myQueueDepths;
+        std::size_t                             myTasksCount {0}; // tasks in all of the shared queues
+        std::condition_variable                 myCV;
+        std::mutex                              myMutex; // sync access to task queues
+        std::atomic<std::size_t>                myPendingTasks {0};
+        std::atomic<std::size_t>                mySleepingWorkers {0};
+        Scheduling                              myScheduling {Scheduling::GlobalQueue};
+        std::atomic<bool>                       myShutdown {true};
+
+#if COMMON_UTILITIES_THREAD_STATS
+        std::vector<std::unique_ptr<details::threadstats::WorkerCounters>> myCounters; // per worker and one for other threads
+        std::atomic<std::uint64_t>                                          myStatsStart {0};
+#endif
     };
 
     template<class F, typename... Args> requires(std::is_invocable_v<F, Args...>)
@@ -44,27 +352,121 @@ namespace CommonUtilities
     {
         using ReturnType = std::invoke_result_t<F, Args...>;
 
-        auto task = std::make_shared<std::packaged_task<ReturnType()>>
-        (
-            std::bind(std::forward<F>(aFunc), std::forward<Args>(someArgs)...)
-        );
+        std::promise<ReturnType> promise(std::allocator_arg, details::threadpool::TaskAlloc<std::byte>());
+        std::future<ReturnType> result = promise.get_future();
 
-        std::future<ReturnType> result = task->get_future();
-        {
-            std::lock_guard<std::mutex> lock(myMutex); // lock to synchronize access to tasks
+        Push(CreateTask(MakeTaskFunction(
+            [promise = std::move(promise), func = std::forward<F>(aFunc), ...args = std::forward<Args>(someArgs)]() mutable
+            {
+                try
+                {
+                    if constexpr (std::is_void_v<ReturnType>)
+                    {
+                        std::invoke(std::move(func), std::move(args)...);
+                        promise.set_value();
+                    }
+                    else
+                    {
+                        promise.set_value(std::invoke(std::move(func), std::move(args)...));
+                    }
+                }
+                catch (...)
+                {
+                    promise.set_exception(std::current_exception());
+                }
+            }), std::move(aThreadName)));
+
+        return result;
+    }
+
+    template<class F, typename... Args> requires(std::is_invocable_v<F, Args...> || std::is_invocable_v<F, std::stop_token, Args...>)
+    inline auto ThreadPool::Enqueue(TaskOptions aOptions, F&& aFunc, Args&&... someArgs) -> std::future<details::threadpool::TaskResult<F, Args...>>
+    {
+        using ReturnType = details::threadpool::TaskResult<F, Args...>;
 
-            if (myShutdown)
+        std::promise<ReturnType> promise(std::allocator_arg, details::threadpool::TaskAlloc<std::byte>());
+        std::future<ReturnType> result = promise.get_future();
+
+        Push(CreateTask(MakeTaskFunction(
+            [promise = std::move(promise), token = aOptions.stopToken, func = std::forward<F>(aFunc), ...args = std::forward<Args>(someArgs)]() mutable
             {
-                throw std::runtime_error("Thread pool has shut down, no more tasks can be added");
-            }
+                try
+                {
+                    if constexpr (std::is_void_v<ReturnType>)
+                    {
+                        details::threadpool::InvokeTask(token, std::move(func), std::move(args)...);
+                        promise.set_value();
+                    }
+                    else
+                    {
+                        promise.set_value(details::threadpool::InvokeTask(token, std::move(func), std::move(args)...));
+                    }
+                }
+                catch (...)
+                {
+                    promise.set_exception(std::current_exception());
+                }
+            }), std::move(aOptions)));
+
+        return result;
+    }
+
+    template<class F>
+    inline auto ThreadPool::MakeTaskFunction(F&& aFunc) -> TaskFunction
+    {
+        using Func = std::decay_t<F>;
 
-            // place task in queue, copying the shared pointer keeps it alive
-            myTasks.emplace(std::move(aThreadName), [task] { (*task)(); });
+        if constexpr (sizeof(Func) <= TASK_CAPACITY && alignof(Func) <= alignof(std::max_align_t) && std::is_nothrow_move_constructible_v<Func>)
+        {
+            return TaskFunction(std::forward<F>(aFunc));
         }
+        else
+        {
+            return TaskFunction(details::threadpool::PooledFunction<Func>(Func(std::forward<F>(aFunc))));
+        }
+    }
 
-        myCV.notify_one(); // notify a thread that a task is available
+    template<class F, typename... Args> requires(std::is_invocable_v<F, Args...>)
+    inline void ThreadPool::Submit(F&& aFunc, Args&&... someArgs)
+    {
+        if constexpr (sizeof...(Args) == 0)
+        {
+            Push(CreateTask(TaskFunction(std::forward<F>(aFunc))));
+        }
+        else
+        {
+            Push(CreateTask(
+                [func = std::forward<F>(aFunc), ...args = std::forward<Args>(someArgs)]() mutable
+                {
+                    std::invoke(std::move(func), std::move(args)...);
+                }));
+        }
+    }
 
-        return result;
+    template<class F, typename... Args> requires(std::is_invocable_v<F, Args...> || std::is_invocable_v<F, std::stop_token, Args...>)
+    inline void ThreadPool::Submit(TaskOptions aOptions, F&& aFunc, Args&&... someArgs)
+    {
+        if constexpr (sizeof...(Args) == 0 && !std::is_invocable_v<F, std::stop_token>)
+        {
+            Push(CreateTask(TaskFunction(std::forward<F>(aFunc)), std::move(aOptions)));
+        }
+        else
+        {
+            Push(CreateTask(
+                [token = aOptions.stopToken, func = std::forward<F>(aFunc), ...args = std::forward<Args>(someArgs)]() mutable
+                {
+                    details::threadpool::InvokeTask(token, std::move(func), std::move(args)...);
+                }, std::move(aOptions)));
+        }
+    }
+
+    inline void ThreadPool::ScheduleAwaiter::await_suspend(std::coroutine_handle<> aHandle) const
+    {
+        myPool->Submit(TaskOptions{ myPriority, {}, {} }, [aHandle]() { aHandle.resume(); });
     }
-}
 
+    inline auto ThreadPool::Schedule(Priority aPriority) noexcept -> ScheduleAwaiter
+    {
+        return ScheduleAwaiter(*this, aPriority);
+    }
+}
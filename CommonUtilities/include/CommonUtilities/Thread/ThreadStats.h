@@ -0,0 +1,142 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <new>
+
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+    /// Log-linear histogram in the style of HdrHistogram. Every power of two is split into
+    /// SUB_BUCKET_COUNT buckets, so any recorded value is within 12.5% of the bucket it lands in,
+    /// while the whole 64-bit range fits in a fixed array.
+    ///
+    class COMMON_UTILITIES_API LatencyHistogram
+    {
+    public:
+        static constexpr std::size_t SUB_BUCKET_BITS    = 3;
+        static constexpr std::size_t SUB_BUCKET_COUNT   = std::size_t(1) << SUB_BUCKET_BITS;
+        static constexpr std::size_t BUCKET_COUNT       = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+        void Record(std::uint64_t aValue, std::uint64_t aCount = 1) noexcept;
+        void Merge(const LatencyHistogram& aOther) noexcept;
+        void Reset() noexcept;
+
+        NODISC std::uint64_t GetCount() const noexcept;
+        NODISC std::uint64_t GetMin() const noexcept;
+        NODISC std::uint64_t GetMax() const noexcept;
+        NODISC double GetMean() const noexcept;
+
+        /// \param aPercentile: In range [0, 100], e.g., 99.9.
+        ///
+        /// \returns Highest value of the bucket the percentile falls in, capped to the max recorded value.
+        ///
+        NODISC std::uint64_t GetPercentile(double aPercentile) const noexcept;
+
+        NODISC std::uint64_t GetBucketCount(std::size_t aIndex) const noexcept;
+
+        NODISC static std::size_t GetBucketIndex(std::uint64_t aValue) noexcept;
+        NODISC static std::uint64_t GetBucketLowest(std::size_t aIndex) noexcept;
+        NODISC static std::uint64_t GetBucketHighest(std::size_t aIndex) noexcept;
+
+    private:
+        std::array<std::uint64_t, BUCKET_COUNT> myBuckets   {};
+        std::uint64_t                           myCount     {0};
+        std::uint64_t                           myTotal     {0};
+        std::uint64_t                           myMin       {UINT64_MAX};
+        std::uint64_t                           myMax       {0};
+    };
+
+    /// Snapshot of what a single worker or loop thread has done since the stats were last reset.
+    ///
+    struct WorkerStats
+    {
+        std::uint64_t               tasksExecuted   {0};
+        std::uint64_t               tasksStolen     {0}; // taken from another worker's deque
+        std::uint64_t               tasksCancelled  {0}; // dropped before running since their stop token was triggered
+        std::chrono::nanoseconds    busyTime        {0};
+        LatencyHistogram            startLatency;       // nanoseconds from submission or dispatch until the task started
+        LatencyHistogram            runTime;            // nanoseconds spent running each task
+
+        void Merge(const WorkerStats& aOther) noexcept;
+
+        /// \returns Fraction of the elapsed time spent running tasks, the rest was spent idle or looking for work.
+        ///
+        NODISC double GetUtilization(std::chrono::nanoseconds aElapsed) const noexcept;
+    };
+
+    namespace details::threadstats
+    {
+        using Clock = std::chrono::steady_clock;
+
+        NODISC inline std::uint64_t Now() noexcept
+        {
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count());
+        }
+
+        /// Counters written by the thread doing the work and read by whoever takes a snapshot. Relaxed
+        /// atomics are enough since a snapshot only has to be approximately consistent.
+        ///
+        class alignas(std::hardware_destructive_interference_size) WorkerCounters
+        {
+        public:
+            void AddExecuted(std::uint64_t aStartLatency, std::uint64_t aRunTime) noexcept
+            {
+                myExecuted.fetch_add(1, std::memory_order_relaxed);
+                myBusyTime.fetch_add(aRunTime, std::memory_order_relaxed);
+
+                myStartLatency[LatencyHistogram::GetBucketIndex(aStartLatency)].fetch_add(1, std::memory_order_relaxed);
+                myRunTime[LatencyHistogram::GetBucketIndex(aRunTime)].fetch_add(1, std::memory_order_relaxed);
+            }
+
+            void AddStolen() noexcept { myStolen.fetch_add(1, std::memory_order_relaxed); }
+            void AddCancelled() noexcept { myCancelled.fetch_add(1, std::memory_order_relaxed); }
+
+            void Snapshot(WorkerStats& aStats) const noexcept
+            {
+                aStats.tasksExecuted    = myExecuted.load(std::memory_order_relaxed);
+                aStats.tasksStolen      = myStolen.load(std::memory_order_relaxed);
+                aStats.tasksCancelled   = myCancelled.load(std::memory_order_relaxed);
+                aStats.busyTime         = std::chrono::nanoseconds(myBusyTime.load(std::memory_order_relaxed));
+
+                aStats.startLatency.Reset();
+                aStats.runTime.Reset();
+
+                for (std::size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i)
+                {
+                    if (const std::uint64_t count = myStartLatency[i].load(std::memory_order_relaxed))
+                        aStats.startLatency.Record(LatencyHistogram::GetBucketLowest(i), count);
+
+                    if (const std::uint64_t count = myRunTime[i].load(std::memory_order_relaxed))
+                        aStats.runTime.Record(LatencyHistogram::GetBucketLowest(i), count);
+                }
+            }
+
+            void Reset() noexcept
+            {
+                myExecuted.store(0, std::memory_order_relaxed);
+                myStolen.store(0, std::memory_order_relaxed);
+                myCancelled.store(0, std::memory_order_relaxed);
+                myBusyTime.store(0, std::memory_order_relaxed);
+
+                for (std::size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i)
+                {
+                    myStartLatency[i].store(0, std::memory_order_relaxed);
+                    myRunTime[i].store(0, std::memory_order_relaxed);
+                }
+            }
+
+        private:
+            std::atomic<std::uint64_t> myExecuted   {0};
+            std::atomic<std::uint64_t> myStolen     {0};
+            std::atomic<std::uint64_t> myCancelled  {0};
+            std::atomic<std::uint64_t> myBusyTime   {0};
+
+            std::array<std::atomic<std::uint64_t>, LatencyHistogram::BUCKET_COUNT> myStartLatency {};
+            std::array<std::atomic<std::uint64_t>, LatencyHistogram::BUCKET_COUNT> myRunTime {};
+        };
+    }
+}
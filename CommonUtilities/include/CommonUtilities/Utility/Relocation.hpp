@@ -0,0 +1,91 @@
+#pragma once
+
+#include <type_traits>
+#include <memory>
+#include <utility>
+#include <cstring>
+#include <cstddef>
+
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+	/// Whether an object can be moved to another address by copying its bytes, after which the source is
+	/// treated as destroyed. Holds for trivially copyable types and can be specialized for others, e.g., a
+	/// type that owns its memory through a pointer but never points into itself.
+	///
+	template<typename T>
+	struct TriviallyRelocatable : std::bool_constant<std::is_trivially_copyable_v<T>> {};
+
+	template<typename T>
+	concept IsTriviallyRelocatable = TriviallyRelocatable<std::remove_cv_t<T>>::value;
+
+	template<typename T, typename U>
+	struct TriviallyRelocatable<std::pair<T, U>> : std::bool_constant<IsTriviallyRelocatable<T> && IsTriviallyRelocatable<U>> {};
+
+	namespace details::relocate
+	{
+		/// Moves the objects in [First, Last) into uninitialized memory at Dest and destroys the originals.
+		/// The ranges may not overlap.
+		///
+		/// \returns End of the relocated range.
+		///
+		template<typename T>
+		T* Relocate(T* aFirst, T* aLast, T* aDest) noexcept(IsTriviallyRelocatable<T> || std::is_nothrow_move_constructible_v<T>)
+		{
+			if constexpr (IsTriviallyRelocatable<T>)
+			{
+				const auto count = static_cast<std::size_t>(aLast - aFirst);
+				if (count != 0)
+				{
+					std::memcpy(static_cast<void*>(aDest), static_cast<const void*>(aFirst), count * sizeof(T));
+				}
+
+				return aDest + count;
+			}
+			else
+			{
+				T* last = std::uninitialized_move(aFirst, aLast, aDest);
+				std::destroy(aFirst, aLast);
+
+				return last;
+			}
+		}
+
+		/// Shifts the objects in [First, Last) to Dest within the same buffer. Only valid for trivially
+		/// relocatable types, where the ranges may overlap.
+		///
+		template<IsTriviallyRelocatable T>
+		void Shift(T* aFirst, T* aLast, T* aDest) noexcept
+		{
+			const auto count = static_cast<std::size_t>(aLast - aFirst);
+			if (count != 0)
+			{
+				std::memmove(static_cast<void*>(aDest), static_cast<const void*>(aFirst), count * sizeof(T));
+			}
+		}
+
+		/// Exchanges the bytes of two non-overlapping regions in fixed-size chunks, which the compiler turns into
+		/// plain vector loads and stores rather than calls to memcpy.
+		///
+		inline void SwapBytes(std::byte* aLhs, std::byte* aRhs, std::size_t aSize) noexcept
+		{
+			constexpr std::size_t CHUNK_SIZE = 32;
+
+			std::size_t offset = 0;
+			for (; offset + CHUNK_SIZE <= aSize; offset += CHUNK_SIZE)
+			{
+				std::byte lhs[CHUNK_SIZE];
+				std::byte rhs[CHUNK_SIZE];
+
+				std::memcpy(lhs, aLhs + offset, CHUNK_SIZE);
+				std::memcpy(rhs, aRhs + offset, CHUNK_SIZE);
+				std::memcpy(aLhs + offset, rhs, CHUNK_SIZE);
+				std::memcpy(aRhs + offset, lhs, CHUNK_SIZE);
+			}
+
+			for (; offset < aSize; ++offset)
+				std::swap(aLhs[offset], aRhs[offset]);
+		}
+	}
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <functional>
+#include <type_traits>
+
+#include <CommonUtilities/Config.h>
+
+namespace CommonUtilities
+{
+	template<class Signature, std::size_t Capacity = 64>
+	class SmallFunction;
+
+	/// Move-only alternative to std::function that stores the callable inline when it fits within
+	/// Capacity bytes, and only falls back to the heap for larger (or throwing-move) callables.
+	///
+	/// \param Capacity: Number of bytes available for inline storage.
+	///
+	template<class R, class... Args, std::size_t Capacity>
+	class SmallFunction<R(Args...), Capacity>
+	{
+	public:
+		SmallFunction() noexcept = default;
+		SmallFunction(std::nullptr_t) noexcept {}
+
+		template<class F> requires (!std::is_same_v<std::remove_cvref_t<F>, SmallFunction> && std::is_invocable_r_v<R, std::decay_t<F>&, Args...>)
+		SmallFunction(F&& aFunc)
+		{
+			using Func = std::decay_t<F>;
+
+			if constexpr (std::is_pointer_v<Func> || std::is_member_pointer_v<Func>)
+			{
+				if (aFunc == nullptr)
+					return;
+			}
+
+			if constexpr (STORE_INLINE<Func>)
+			{
+				::new (static_cast<void*>(myStorage)) Func(std::forward<F>(aFunc));
+				myVTable = &INLINE_VTABLE<Func>;
+			}
+			else
+			{
+				::new (static_cast<void*>(myStorage)) Func*(new Func(std::forward<F>(aFunc)));
+				myVTable = &HEAP_VTABLE<Func>;
+			}
+		}
+
+		~SmallFunction();
+
+		SmallFunction(const SmallFunction&) = delete;
+		SmallFunction(SmallFunction&& aOther) noexcept;
+
+		auto operator=(const SmallFunction&) -> SmallFunction& = delete;
+		auto operator=(SmallFunction&& aOther) noexcept -> SmallFunction&;
+
+		auto operator=(std::nullptr_t) noexcept -> SmallFunction&;
+
+		NODISC explicit operator bool() const noexcept;
+
+		R operator()(Args... someArgs);
+
+		/// \returns Whether the callable is stored inline, i.e., no heap allocation was made for it.
+		///
+		NODISC bool IsInline() const noexcept;
+
+	private:
+		struct VTable
+		{
+			R		(*invoke)(void*, Args&&...);
+			void	(*move)(void* aDest, void* aSource) noexcept;
+			void	(*destroy)(void*) noexcept;
+			bool	isInline;
+		};
+
+		template<class F>
+		static constexpr bool STORE_INLINE =
+			sizeof(F) <= Capacity &&
+			alignof(F) <= alignof(std::max_align_t) &&
+			std::is_nothrow_move_constructible_v<F>;
+
+		template<class F>
+		static R Invoke(F& aFunc, Args&&... someArgs)
+		{
+			if constexpr (std::is_void_v<R>)
+			{
+				std::invoke(aFunc, std::forward<Args>(someArgs)...); // discards any result
+			}
+			else
+			{
+				return std::invoke(aFunc, std::forward<Args>(someArgs)...);
+			}
+		}
+
+		template<class F>
+		static constexpr VTable INLINE_VTABLE
+		{
+			[](void* aStorage, Args&&... someArgs) -> R
+			{
+				return Invoke(*std::launder(static_cast<F*>(aStorage)), std::forward<Args>(someArgs)...);
+			},
+			[](void* aDest, void* aSource) noexcept
+			{
+				F* source = std::launder(static_cast<F*>(aSource));
+				::new (aDest) F(std::move(*source));
+				source->~F();
+			},
+			[](void* aStorage) noexcept
+			{
+				std::launder(static_cast<F*>(aStorage))->~F();
+			},
+			true
+		};
+
+		template<class F>
+		static constexpr VTable HEAP_VTABLE
+		{
+			[](void* aStorage, Args&&... someArgs) -> R
+			{
+				return Invoke(**static_cast<F**>(aStorage), std::forward<Args>(someArgs)...);
+			},
+			[](void* aDest, void* aSource) noexcept
+			{
+				::new (aDest) F*(*static_cast<F**>(aSource));
+			},
+			[](void* aStorage) noexcept
+			{
+				delete *static_cast<F**>(aStorage);
+			},
+			false
+		};
+
+		void Reset() noexcept;
+
+		alignas(std::max_align_t) std::byte	myStorage[Capacity < sizeof(void*) ? sizeof(void*) : Capacity];
+		const VTable*						myVTable {nullptr};
+	};
+
+	template<class R, class... Args, std::size_t Capacity>
+	inline SmallFunction<R(Args...), Capacity>::~SmallFunction()
+	{
+		Reset();
+	}
+
+	template<class R, class... Args, std::size_t Capacity>
+	inline SmallFunction<R(Args...), Capacity>::SmallFunction(SmallFunction&& aOther) noexcept
+		: myVTable(aOther.myVTable)
+	{
+		if (myVTable)
+		{
+			myVTable->move(myStorage, aOther.myStorage);
+			aOther.myVTable = nullptr;
+		}
+	}
+
+	template<class R, class... Args, std::size_t Capacity>
+	inline auto SmallFunction<R(Args...), Capacity>::operator=(SmallFunction&& aOther) noexcept -> SmallFunction&
+	{
+		if (this != &aOther)
+		{
+			Reset();
+
+			if (aOther.myVTable)
+			{
+				myVTable = aOther.myVTable;
+				myVTable->move(myStorage, aOther.myStorage);
+				aOther.myVTable = nullptr;
+			}
+		}
+
+		return *this;
+	}
+
+	template<class R, class... Args, std::size_t Capacity>
+	inline auto SmallFunction<R(Args...), Capacity>::operator=(std::nullptr_t) noexcept -> SmallFunction&
+	{
+		Reset();
+		return *this;
+	}
+
+	template<class R, class... Args, std::size_t Capacity>
+	inline SmallFunction<R(Args...), Capacity>::operator bool() const noexcept
+	{
+		return myVTable != nullptr;
+	}
+
+	template<class R, class... Args, std::size_t Capacity>
+	inline R SmallFunction<R(Args...), Capacity>::operator()(Args... someArgs)
+	{
+		if (!myVTable)
+			throw std::bad_function_call();
+
+		return myVTable->invoke(myStorage, std::forward<Args>(someArgs)...);
+	}
+
+	template<class R, class... Args, std::size_t Capacity>
+	inline bool SmallFunction<R(Args...), Capacity>::IsInline() const noexcept
+	{
+		return myVTable && myVTable->isInline;
+	}
+
+	template<class R, class... Args, std::size_t Capacity>
+	inline void SmallFunction<R(Args...), Capacity>::Reset() noexcept
+	{
+		if (myVTable)
+		{
+			myVTable->destroy(myStorage);
+			myVTable = nullptr;
+		}
+	}
+}
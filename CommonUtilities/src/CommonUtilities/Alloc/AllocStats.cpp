@@ -0,0 +1,505 @@
+#include <CommonUtilities/Alloc/AllocStats.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <algorithm>
+#include <new>
+#include <utility>
+
+using namespace CommonUtilities;
+
+namespace
+{
+	inline constexpr std::size_t TYPE_COUNT		= static_cast<std::size_t>(AllocatorType::Count);
+	inline constexpr std::int64_t FLUSH_BYTES	= 64 * 1024; // change in live memory a thread accumulates before it updates the peak
+
+	// everything here is constant-initialized so that it stays usable while threads and statics are torn down
+
+	template<typename T>
+	void Add(std::atomic<T>& aCounter, T aValue) noexcept
+	{
+		// counters are only written by their own thread, or under a lock, so there is no need for a locked add
+		aCounter.store(aCounter.load(std::memory_order_relaxed) + aValue, std::memory_order_relaxed);
+	}
+
+	template<typename T>
+	void UpdateMax(std::atomic<T>& aMax, T aValue) noexcept
+	{
+		T current = aMax.load(std::memory_order_relaxed);
+		while (current < aValue && !aMax.compare_exchange_weak(current, aValue, std::memory_order_relaxed)) {}
+	}
+
+	struct SharedCounters
+	{
+		std::atomic<std::uint64_t>	reserved		{0};
+		std::atomic<std::uint64_t>	peakReserved	{0};
+		std::atomic<std::int64_t>	flushedLive		{0}; // sum of what the threads have flushed
+		std::atomic<std::int64_t>	peakLive		{0};
+	};
+
+	struct TypeCounters
+	{
+		std::atomic<std::int64_t>	live			{0};
+		std::atomic<std::uint64_t>	allocations		{0};
+		std::atomic<std::uint64_t>	deallocations	{0};
+		std::int64_t				unflushed		{0};
+
+		std::array<std::atomic<std::uint64_t>, AllocatorStats::SIZE_CLASS_COUNT> sizeClasses {};
+	};
+
+	struct TagCounters
+	{
+		std::atomic<std::uint64_t> allocations		{0};
+		std::atomic<std::uint64_t> deallocations	{0};
+		std::atomic<std::uint64_t> bytesAllocated	{0};
+		std::atomic<std::uint64_t> bytesFreed		{0};
+	};
+
+	std::array<SharedCounters, TYPE_COUNT> locShared;
+
+	std::mutex										locTagMutex;
+	std::array<std::string_view, AllocTag::MAX_TAGS>	locTagNames { "Untagged" };
+	std::atomic<std::size_t>							locTagCount { 1 };
+
+	thread_local std::size_t locTag = 0;
+
+	class Counters
+	{
+	public:
+		void Allocate(AllocatorType aType, std::size_t aNumBytes, std::int64_t aFlushBytes) noexcept
+		{
+			TypeCounters& counters = myTypes[static_cast<std::size_t>(aType)];
+
+			Add(counters.allocations, std::uint64_t(1));
+			Add(counters.sizeClasses[AllocatorStats::GetSizeClass(aNumBytes)], std::uint64_t(1));
+
+			TagCounters& tag = myTags[locTag];
+
+			Add(tag.allocations, std::uint64_t(1));
+			Add(tag.bytesAllocated, static_cast<std::uint64_t>(aNumBytes));
+
+			Track(aType, static_cast<std::int64_t>(aNumBytes), aFlushBytes);
+		}
+
+		void Deallocate(AllocatorType aType, std::size_t aNumBytes, std::int64_t aFlushBytes) noexcept
+		{
+			TypeCounters& counters = myTypes[static_cast<std::size_t>(aType)];
+
+			Add(counters.deallocations, std::uint64_t(1));
+
+			TagCounters& tag = myTags[locTag];
+
+			Add(tag.deallocations, std::uint64_t(1));
+			Add(tag.bytesFreed, static_cast<std::uint64_t>(aNumBytes));
+
+			Track(aType, -static_cast<std::int64_t>(aNumBytes), aFlushBytes);
+		}
+
+		void Rewind(AllocatorType aType, std::size_t aNumBytes, std::int64_t aFlushBytes) noexcept
+		{
+			Add(myTags[locTag].bytesFreed, static_cast<std::uint64_t>(aNumBytes));
+			Track(aType, -static_cast<std::int64_t>(aNumBytes), aFlushBytes);
+		}
+
+		void Flush() noexcept
+		{
+			for (std::size_t i = 0; i < TYPE_COUNT; ++i)
+				Flush(i);
+		}
+
+		void AddTo(Counters& aOther) const noexcept
+		{
+			for (std::size_t i = 0; i < TYPE_COUNT; ++i)
+			{
+				const TypeCounters& from = myTypes[i];
+				TypeCounters& to = aOther.myTypes[i];
+
+				Add(to.live,			from.live.load(std::memory_order_relaxed));
+				Add(to.allocations,		from.allocations.load(std::memory_order_relaxed));
+				Add(to.deallocations,	from.deallocations.load(std::memory_order_relaxed));
+
+				for (std::size_t j = 0; j < AllocatorStats::SIZE_CLASS_COUNT; ++j)
+					Add(to.sizeClasses[j], from.sizeClasses[j].load(std::memory_order_relaxed));
+			}
+
+			for (std::size_t i = 0; i < AllocTag::MAX_TAGS; ++i)
+			{
+				const TagCounters& from = myTags[i];
+				TagCounters& to = aOther.myTags[i];
+
+				Add(to.allocations,		from.allocations.load(std::memory_order_relaxed));
+				Add(to.deallocations,	from.deallocations.load(std::memory_order_relaxed));
+				Add(to.bytesAllocated,	from.bytesAllocated.load(std::memory_order_relaxed));
+				Add(to.bytesFreed,		from.bytesFreed.load(std::memory_order_relaxed));
+			}
+		}
+
+		void AddTo(AllocStats& aStats, std::size_t aTagCount) const noexcept
+		{
+			for (std::size_t i = 0; i < TYPE_COUNT; ++i)
+			{
+				const TypeCounters& from = myTypes[i];
+				AllocatorStats& to = aStats.allocators[i];
+
+				to.live				+= from.live.load(std::memory_order_relaxed);
+				to.allocations		+= from.allocations.load(std::memory_order_relaxed);
+				to.deallocations	+= from.deallocations.load(std::memory_order_relaxed);
+
+				for (std::size_t j = 0; j < AllocatorStats::SIZE_CLASS_COUNT; ++j)
+					to.sizeClasses[j] += from.sizeClasses[j].load(std::memory_order_relaxed);
+			}
+
+			for (std::size_t i = 0; i < aTagCount; ++i)
+			{
+				const TagCounters& from = myTags[i];
+				AllocTagStats& to = aStats.tags[i];
+
+				to.allocations		+= from.allocations.load(std::memory_order_relaxed);
+				to.deallocations	+= from.deallocations.load(std::memory_order_relaxed);
+				to.bytesAllocated	+= from.bytesAllocated.load(std::memory_order_relaxed);
+				to.bytesFreed		+= from.bytesFreed.load(std::memory_order_relaxed);
+			}
+		}
+
+	private:
+		void Track(AllocatorType aType, std::int64_t aDiff, std::int64_t aFlushBytes) noexcept
+		{
+			TypeCounters& counters = myTypes[static_cast<std::size_t>(aType)];
+
+			Add(counters.live, aDiff);
+
+			counters.unflushed += aDiff;
+			if (counters.unflushed >= aFlushBytes || counters.unflushed <= -aFlushBytes)
+				Flush(static_cast<std::size_t>(aType));
+		}
+
+		void Flush(std::size_t aIndex) noexcept
+		{
+			TypeCounters& counters = myTypes[aIndex];
+			SharedCounters& shared = locShared[aIndex];
+
+			const std::int64_t live = shared.flushedLive.fetch_add(counters.unflushed, std::memory_order_relaxed) + counters.unflushed;
+			UpdateMax(shared.peakLive, live);
+
+			counters.unflushed = 0;
+		}
+
+		std::array<TypeCounters, TYPE_COUNT>		myTypes;
+		std::array<TagCounters, AllocTag::MAX_TAGS>	myTags;
+	};
+
+	std::mutex	locThreadMutex;
+	Counters		locRetired; // counters of exited threads, and of threads still recording after their counters were destroyed
+
+	class ThreadCounters;
+	ThreadCounters* locThreads = nullptr;
+
+	thread_local bool locExited = false;
+
+	class alignas(std::hardware_destructive_interference_size) ThreadCounters
+	{
+	public:
+		ThreadCounters()
+		{
+			std::scoped_lock lock(locThreadMutex);
+
+			myNext = locThreads;
+			if (myNext)
+				myNext->myPrev = this;
+
+			locThreads = this;
+		}
+
+		~ThreadCounters()
+		{
+			myCounters.Flush();
+
+			std::scoped_lock lock(locThreadMutex);
+
+			myCounters.AddTo(locRetired);
+
+			if (myPrev)
+				myPrev->myNext = myNext;
+			else
+				locThreads = myNext;
+
+			if (myNext)
+				myNext->myPrev = myPrev;
+
+			locExited = true;
+		}
+
+		NODISC Counters& Get() noexcept { return myCounters; }
+		NODISC const Counters& Get() const noexcept { return myCounters; }
+
+		NODISC ThreadCounters* Next() const noexcept { return myNext; }
+
+	private:
+		Counters		myCounters;
+		ThreadCounters*	myPrev {nullptr};
+		ThreadCounters*	myNext {nullptr};
+	};
+
+	thread_local ThreadCounters locCounters;
+
+	template<typename Func>
+	void Update(Func&& aFunc) noexcept
+	{
+		if (!locExited) [[likely]]
+		{
+			aFunc(locCounters.Get(), FLUSH_BYTES);
+			return;
+		}
+
+		// e.g., thread-local allocators releasing their memory after the counters are gone
+
+		std::scoped_lock lock(locThreadMutex);
+		aFunc(locRetired, std::int64_t(0));
+	}
+}
+
+#if COMMON_UTILITIES_ALLOC_STATS
+
+void details::allocstats::RecordAllocate(AllocatorType aType, std::size_t aNumBytes) noexcept
+{
+	Update([&](Counters& aCounters, std::int64_t aFlushBytes) { aCounters.Allocate(aType, aNumBytes, aFlushBytes); });
+}
+
+void details::allocstats::RecordDeallocate(AllocatorType aType, std::size_t aNumBytes) noexcept
+{
+	Update([&](Counters& aCounters, std::int64_t aFlushBytes) { aCounters.Deallocate(aType, aNumBytes, aFlushBytes); });
+}
+
+void details::allocstats::RecordRewind(AllocatorType aType, std::size_t aNumBytes) noexcept
+{
+	if (aNumBytes == 0)
+		return;
+
+	Update([&](Counters& aCounters, std::int64_t aFlushBytes) { aCounters.Rewind(aType, aNumBytes, aFlushBytes); });
+}
+
+void details::allocstats::RecordReserve(AllocatorType aType, std::size_t aNumBytes) noexcept
+{
+	SharedCounters& shared = locShared[static_cast<std::size_t>(aType)];
+
+	const std::uint64_t reserved = shared.reserved.fetch_add(aNumBytes, std::memory_order_relaxed) + aNumBytes;
+	UpdateMax(shared.peakReserved, reserved);
+}
+
+void details::allocstats::RecordRelease(AllocatorType aType, std::size_t aNumBytes) noexcept
+{
+	locShared[static_cast<std::size_t>(aType)].reserved.fetch_sub(aNumBytes, std::memory_order_relaxed);
+}
+
+std::size_t details::allocstats::SetTag(std::size_t aID) noexcept
+{
+	return std::exchange(locTag, aID);
+}
+
+#endif
+
+void AllocatorStats::Merge(const AllocatorStats& aOther) noexcept
+{
+	reserved		+= aOther.reserved;
+	peakReserved	+= aOther.peakReserved;
+	live			+= aOther.live;
+	peakLive		+= aOther.peakLive;
+	allocations		+= aOther.allocations;
+	deallocations	+= aOther.deallocations;
+
+	for (std::size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+	{
+		sizeClasses[i] += aOther.sizeClasses[i];
+	}
+}
+
+double AllocatorStats::GetFragmentation() const noexcept
+{
+	if (reserved == 0)
+		return 0.0;
+
+	const double used = static_cast<double>((std::max)(live, std::int64_t(0))) / static_cast<double>(reserved);
+	return std::clamp(1.0 - used, 0.0, 1.0);
+}
+
+AllocStats AllocStats::Capture()
+{
+	AllocStats stats;
+
+	const std::size_t tagCount = locTagCount.load(std::memory_order_acquire);
+
+	stats.tags.resize(tagCount);
+	for (std::size_t i = 0; i < tagCount; ++i)
+	{
+		stats.tags[i].name = locTagNames[i];
+	}
+
+	{
+		std::scoped_lock lock(locThreadMutex);
+
+		locRetired.AddTo(stats, tagCount);
+		for (const ThreadCounters* counters = locThreads; counters; counters = counters->Next())
+		{
+			counters->Get().AddTo(stats, tagCount);
+		}
+	}
+
+	for (std::size_t i = 0; i < TYPE_COUNT; ++i)
+	{
+		const SharedCounters& shared = locShared[i];
+		AllocatorStats& allocator = stats.allocators[i];
+
+		allocator.reserved		= shared.reserved.load(std::memory_order_relaxed);
+		allocator.peakReserved	= (std::max)(shared.peakReserved.load(std::memory_order_relaxed), allocator.reserved);
+		allocator.peakLive		= (std::max)(shared.peakLive.load(std::memory_order_relaxed), allocator.live);
+
+		stats.total.Merge(allocator); // the total peak is the sum of the peaks, which need not have been at the same time
+	}
+
+	return stats;
+}
+
+void AllocStats::ResetPeaks()
+{
+	for (SharedCounters& shared : locShared)
+	{
+		shared.peakReserved.store(shared.reserved.load(std::memory_order_relaxed), std::memory_order_relaxed);
+		shared.peakLive.store(shared.flushedLive.load(std::memory_order_relaxed), std::memory_order_relaxed);
+	}
+}
+
+std::string AllocStats::ToCSV() const
+{
+	std::string result = "section,name,metric,value\n";
+
+	const auto row = [&result](std::string_view aSection, std::string_view aName, std::string_view aMetric, const std::string& aValue)
+	{
+		result.append(aSection).append(",").append(aName).append(",").append(aMetric).append(",").append(aValue).append("\n");
+	};
+
+	const auto allocator = [&row](std::string_view aName, const AllocatorStats& aStats)
+	{
+		row("allocator", aName, "reserved",			std::to_string(aStats.reserved));
+		row("allocator", aName, "peak_reserved",	std::to_string(aStats.peakReserved));
+		row("allocator", aName, "live",				std::to_string(aStats.live));
+		row("allocator", aName, "peak_live",		std::to_string(aStats.peakLive));
+		row("allocator", aName, "allocations",		std::to_string(aStats.allocations));
+		row("allocator", aName, "deallocations",	std::to_string(aStats.deallocations));
+		row("allocator", aName, "fragmentation",	std::to_string(aStats.GetFragmentation()));
+
+		for (std::size_t i = 0; i < AllocatorStats::SIZE_CLASS_COUNT; ++i)
+		{
+			const std::size_t limit = AllocatorStats::GetSizeClassLimit(i);
+			row("allocator", aName, "size_" + (limit != SIZE_MAX ? std::to_string(limit) : std::string("max")), std::to_string(aStats.sizeClasses[i]));
+		}
+	};
+
+	for (std::size_t i = 0; i < TYPE_COUNT; ++i)
+	{
+		allocator(GetName(static_cast<AllocatorType>(i)), allocators[i]);
+	}
+
+	allocator("Total", total);
+
+	for (const AllocTagStats& tag : tags)
+	{
+		row("tag", tag.name, "allocations",		std::to_string(tag.allocations));
+		row("tag", tag.name, "deallocations",	std::to_string(tag.deallocations));
+		row("tag", tag.name, "bytes_allocated",	std::to_string(tag.bytesAllocated));
+		row("tag", tag.name, "bytes_freed",		std::to_string(tag.bytesFreed));
+		row("tag", tag.name, "live",			std::to_string(tag.GetLive()));
+	}
+
+	return result;
+}
+
+std::string AllocStats::ToJSON() const
+{
+	std::string result = "{\"allocators\":{";
+
+	const auto allocator = [&result](std::string_view aName, const AllocatorStats& aStats)
+	{
+		result.append("\"").append(aName).append("\":{");
+
+		result.append("\"reserved\":").append(std::to_string(aStats.reserved));
+		result.append(",\"peak_reserved\":").append(std::to_string(aStats.peakReserved));
+		result.append(",\"live\":").append(std::to_string(aStats.live));
+		result.append(",\"peak_live\":").append(std::to_string(aStats.peakLive));
+		result.append(",\"allocations\":").append(std::to_string(aStats.allocations));
+		result.append(",\"deallocations\":").append(std::to_string(aStats.deallocations));
+		result.append(",\"fragmentation\":").append(std::to_string(aStats.GetFragmentation()));
+
+		result.append(",\"size_classes\":[");
+		for (std::size_t i = 0; i < AllocatorStats::SIZE_CLASS_COUNT; ++i)
+		{
+			const std::size_t limit = AllocatorStats::GetSizeClassLimit(i);
+
+			result.append(i != 0 ? ",{" : "{");
+			result.append("\"limit\":").append(limit != SIZE_MAX ? std::to_string(limit) : std::string("null"));
+			result.append(",\"count\":").append(std::to_string(aStats.sizeClasses[i]));
+			result.append("}");
+		}
+		result.append("]}");
+	};
+
+	for (std::size_t i = 0; i < TYPE_COUNT; ++i)
+	{
+		allocator(GetName(static_cast<AllocatorType>(i)), allocators[i]);
+		result.append(",");
+	}
+
+	allocator("Total", total);
+
+	result.append("},\"tags\":[");
+
+	for (std::size_t i = 0; i < tags.size(); ++i)
+	{
+		const AllocTagStats& tag = tags[i];
+
+		result.append(i != 0 ? ",{" : "{");
+		result.append("\"name\":\"").append(tag.name).append("\""); // tag names are expected to be plain identifiers
+		result.append(",\"allocations\":").append(std::to_string(tag.allocations));
+		result.append(",\"deallocations\":").append(std::to_string(tag.deallocations));
+		result.append(",\"bytes_allocated\":").append(std::to_string(tag.bytesAllocated));
+		result.append(",\"bytes_freed\":").append(std::to_string(tag.bytesFreed));
+		result.append(",\"live\":").append(std::to_string(tag.GetLive()));
+		result.append("}");
+	}
+
+	result.append("]}");
+
+	return result;
+}
+
+std::string_view AllocStats::GetName(AllocatorType aType) noexcept
+{
+	switch (aType)
+	{
+		case AllocatorType::Arena:		return "Arena";
+		case AllocatorType::Pool:		return "Pool";
+		case AllocatorType::Frame:		return "Frame";
+		case AllocatorType::Resource:	return "Resource";
+		default:						return "Unknown";
+	}
+}
+
+AllocTag::AllocTag(std::string_view aName)
+	: myName(aName)
+{
+	std::scoped_lock lock(locTagMutex);
+
+	const std::size_t count = locTagCount.load(std::memory_order_relaxed);
+
+	const auto it = std::find(locTagNames.begin(), locTagNames.begin() + count, aName);
+	if (it != locTagNames.begin() + count)
+	{
+		myID = static_cast<std::size_t>(it - locTagNames.begin());
+	}
+	else if (count < MAX_TAGS)
+	{
+		locTagNames[count] = aName;
+		locTagCount.store(count + 1, std::memory_order_release);
+
+		myID = count;
+	}
+}
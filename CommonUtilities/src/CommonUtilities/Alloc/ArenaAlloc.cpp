@@ -1,133 +1,567 @@
 #include <CommonUtilities/Alloc/ArenaAlloc.hpp>
+#include <CommonUtilities/Alloc/AllocStats.hpp>
+#include <CommonUtilities/Alloc/VirtualMemory.hpp>
 
 #include <vector>
-#include <memory>
+#include <atomic>
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cstdint>
+#include <mutex>
+#include <new>
 
 using namespace CommonUtilities;
 
-inline constexpr std::size_t DEFAULT_Buffer_CAPACITY = 4096;
+namespace vmem = CommonUtilities::details::vmem;
 
-class Buffer
-{
-public:
-	Buffer(std::size_t aMinCapacity)
-		: myCapacity((std::max)(DEFAULT_Buffer_CAPACITY, aMinCapacity))
-		, myData(std::make_unique<std::byte[]>(myCapacity))
-	{
-
-	}
-
-	NODISC const std::byte* data() const	{ return myData.get(); }
-	NODISC std::byte* data()				{ return const_cast<std::byte*>(std::as_const(*this).data()); }
-
-	NODISC const std::byte* top() const		{ return myData.get() + mySize; }
-	NODISC std::byte* top()					{ return const_cast<std::byte*>(std::as_const(*this).top()); }
-
-	NODISC const std::byte* begin() const	{ return myData.get(); }
-	NODISC std::byte* begin()				{ return const_cast<std::byte*>(std::as_const(*this).begin()); }
-
-	NODISC const std::byte* end() const		{ return myData.get() + myCapacity; }
-	NODISC std::byte* end()					{ return const_cast<std::byte*>(std::as_const(*this).end()); }
-
-	NODISC unsigned ref_count() const		{ return myRefCount; }
-	NODISC bool unused() const				{ return ref_count() == 0; }
+// buffers live at the start of regions aligned to REGION_SIZE, so the buffer owning any allocation is
+// found by masking its address. Allocations too large for a region are given a region of their own
 
-	void ref()		{ ++myRefCount; }
-	void unref()	{ --myRefCount; }
+inline constexpr std::size_t REGION_SIZE	= 64 * 1024;
+inline constexpr std::size_t RECYCLE_LIMIT	= 4; // unused regions kept by each thread for reuse
 
-	void resize(std::ptrdiff_t aDiff)	{ mySize += aDiff; }
-	void clear()						{ mySize = 0; }
+static_assert(std::has_single_bit(REGION_SIZE), "Region size must be a power of two");
 
-private:
-	std::size_t						myCapacity	= 0;
-	std::unique_ptr<std::byte[]>	myData		= nullptr;
-	std::size_t						mySize		= 0;
-	unsigned						myRefCount	= 0;
-};
+static std::mutex	locConfigMutex;
+static ArenaConfig	locConfig;
 
-static std::vector<std::unique_ptr<Buffer>> locMemoryBuffers;
-
-using BufferIterator = decltype(locMemoryBuffers)::iterator;
-
-static auto FindBuffer(const std::byte* aHint)
+void CommonUtilities::SetArenaConfig(const ArenaConfig& aConfig)
 {
-	const auto end = locMemoryBuffers.end();
-	for (auto it = locMemoryBuffers.begin(); it != end; ++it)
-	{
-		if (aHint >= (*it)->data() && aHint < (*it)->top())
-			return it;
-	}
-
-	return end;
+	std::scoped_lock lock(locConfigMutex);
+	locConfig = aConfig;
 }
 
-static __forceinline std::ptrdiff_t AlignmentOffset(const std::byte* aMemory, std::size_t aAlignment)
+ArenaConfig CommonUtilities::GetArenaConfig()
 {
-	const auto off = aAlignment - reinterpret_cast<std::uintptr_t>(aMemory) % aAlignment;
-	return off == aAlignment ? 0 : off;
+	std::scoped_lock lock(locConfigMutex);
+	return locConfig;
 }
 
-static __forceinline bool Fits(const Buffer& aBuffer, std::size_t aNumBytes, std::size_t aAlignment)
+namespace
 {
-	aNumBytes += AlignmentOffset(aBuffer.top(), aAlignment);
-	return aBuffer.top() + aNumBytes < aBuffer.end();
-}
+	/// Address space that regions are carved from in order. Regions given back are decommitted and reused
+	/// before carving further. Reservations are never unmapped, as orphaned buffers may still live in them,
+	/// and are instead handed to the next thread when their thread exits.
+	///
+	struct Reservation
+	{
+		vmem::Range				range;
+		std::byte*				next		{nullptr}; // regions below have been carved
+		std::byte*				committed	{nullptr}; // pages below are committed, may run ahead of next
+		std::byte*				end			{nullptr};
+		std::vector<std::byte*>	decommitted;
+		bool					hugePages	{false};
+		bool					populate	{false};
+	};
+
+	/// Reservations left behind by exited threads. Their address space is left to the system at exit,
+	/// as static objects destroyed later may still free into them.
+	///
+	struct ReservationDepot
+	{
+		~ReservationDepot()
+		{
+			for (Reservation* reservation : reservations)
+				delete reservation;
+		}
 
-static auto FindBuffer(std::size_t aNumBytes, std::size_t aAlignment, const std::byte* aHint)
-{
-	const auto end = locMemoryBuffers.end();
+		std::mutex					mutex;
+		std::vector<Reservation*>	reservations;
+	};
 
-	BufferIterator it;
+	ReservationDepot locDepot;
 
-	if (aHint)
+	void Commit(std::byte* aMemory, std::size_t aSize, bool aHugePages, bool aPopulate)
 	{
-		it = FindBuffer(aHint);
-		if (it != end && Fits(**it, aNumBytes, aAlignment))
-			return it;
+		if (!details::vmem::Commit(aMemory, aSize, aHugePages, aPopulate))
+			throw std::bad_alloc();
+
+		details::allocstats::RecordReserve(AllocatorType::Arena, aSize);
 	}
 
-	for (it = locMemoryBuffers.begin(); it != end; ++it)
+	void Decommit(std::byte* aMemory, std::size_t aSize)
 	{
-		if (Fits(**it, aNumBytes, aAlignment))
-			return it;
+		details::allocstats::RecordRelease(AllocatorType::Arena, aSize);
+		details::vmem::Decommit(aMemory, aSize);
 	}
 
-	return end;
-}
+	enum class Backing : std::uint8_t
+	{
+		Heap,		// fallback where virtual memory is unavailable
+		Reserved,	// region carved from a reservation
+		Mapped		// large allocation with a mapping of its own
+	};
 
-std::byte* details::arena::Allocate(std::size_t aNumBytes, std::size_t aAlignment, const std::byte* aHint)
-{
-	auto it = FindBuffer(aNumBytes, aAlignment, aHint);
-	if (it == locMemoryBuffers.end())
+	class ThreadArena;
+
+	class Buffer
+	{
+	public:
+		NODISC static Buffer* Create(ThreadArena* aOwner, std::size_t aRegionSize)
+		{
+			void* memory = ::operator new(aRegionSize, std::align_val_t(REGION_SIZE));
+			details::allocstats::RecordReserve(AllocatorType::Arena, aRegionSize);
+
+			return new (memory) Buffer(aOwner, aRegionSize, Backing::Heap);
+		}
+
+		/// \param Memory: Committed region aligned to REGION_SIZE.
+		///
+		NODISC static Buffer* Create(std::byte* aMemory, ThreadArena* aOwner, Reservation* aReservation)
+		{
+			Buffer* buffer = new (aMemory) Buffer(aOwner, REGION_SIZE, Backing::Reserved);
+			buffer->myReservation = aReservation;
+
+			return buffer;
+		}
+
+		NODISC static Buffer* CreateMapped(std::size_t aRegionSize, bool aHugePages, bool aPopulate)
+		{
+			vmem::Range range;
+
+			std::byte* memory = vmem::Reserve(aRegionSize, REGION_SIZE, range);
+			if (!memory)
+			{
+				Buffer* buffer = Create(nullptr, aRegionSize);
+				buffer->myLarge = true;
+
+				return buffer;
+			}
+
+			if (!vmem::Commit(memory, aRegionSize, aHugePages && aRegionSize >= vmem::HUGE_PAGE_SIZE, aPopulate))
+			{
+				vmem::Release(range);
+				throw std::bad_alloc();
+			}
+
+			details::allocstats::RecordReserve(AllocatorType::Arena, aRegionSize);
+
+			Buffer* buffer = new (memory) Buffer(nullptr, aRegionSize, Backing::Mapped);
+			buffer->myRange = range;
+			buffer->myLarge = true;
+
+			return buffer;
+		}
+
+		/// Reserved regions are only decommitted, their address space is left unused since the reservation
+		/// may be in use by another thread. The owner recycles them through ThreadArena::Destroy instead.
+		///
+		static void Destroy(Buffer* aBuffer)
+		{
+			const Backing backing			= aBuffer->myBacking;
+			const vmem::Range range			= aBuffer->myRange;
+			const std::size_t regionSize	= aBuffer->myRegionSize;
+
+			aBuffer->~Buffer();
+
+			switch (backing)
+			{
+				case Backing::Heap:
+				{
+					details::allocstats::RecordRelease(AllocatorType::Arena, regionSize);
+					::operator delete(aBuffer, std::align_val_t(REGION_SIZE));
+
+					break;
+				}
+				case Backing::Reserved:
+				{
+					Decommit(reinterpret_cast<std::byte*>(aBuffer), regionSize);
+					break;
+				}
+				case Backing::Mapped:
+				{
+					details::allocstats::RecordRelease(AllocatorType::Arena, regionSize);
+					vmem::Release(range);
+
+					break;
+				}
+			}
+		}
+
+		/// \param aMemory: Pointer returned from an allocation, may not point further into the allocation.
+		///
+		NODISC static Buffer* From(const std::byte* aMemory)
+		{
+			return reinterpret_cast<Buffer*>(reinterpret_cast<std::uintptr_t>(aMemory) & ~(REGION_SIZE - 1));
+		}
+
+		NODISC const std::byte* data() const	{ return reinterpret_cast<const std::byte*>(this) + sizeof(Buffer); }
+		NODISC std::byte* data()				{ return const_cast<std::byte*>(std::as_const(*this).data()); }
+
+		NODISC const std::byte* top() const		{ return data() + mySize; }
+		NODISC std::byte* top()					{ return const_cast<std::byte*>(std::as_const(*this).top()); }
+
+		NODISC const std::byte* begin() const	{ return data(); }
+		NODISC std::byte* begin()				{ return const_cast<std::byte*>(std::as_const(*this).begin()); }
+
+		NODISC const std::byte* end() const		{ return reinterpret_cast<const std::byte*>(this) + myRegionSize; }
+		NODISC std::byte* end()					{ return const_cast<std::byte*>(std::as_const(*this).end()); }
+
+		// may be called by any thread
+
+		NODISC bool large() const				{ return myLarge; }
+		NODISC Backing backing() const			{ return myBacking; }
+		NODISC Reservation* reservation() const	{ return myReservation; }
+		NODISC ThreadArena* owner() const		{ return myOwner.load(std::memory_order_acquire); }
+
+		/// \returns Whether the buffer was orphaned and this was its last outstanding allocation.
+		///
+		bool remote_unref()
+		{
+			return myRemoteFrees.fetch_add(1, std::memory_order_acq_rel) + 1 == 0;
+		}
+
+		// only called by the owning thread
+
+		NODISC unsigned ref_count() const		{ return myRefCount; }
+		NODISC std::size_t index() const		{ return myIndex; }
+
+		void ref()		{ ++myRefCount; }
+		void unref()	{ --myRefCount; }
+
+		void resize(std::ptrdiff_t aDiff)		{ mySize += aDiff; }
+		void clear()							{ mySize = 0; }
+
+		void set_index(std::size_t aIndex)		{ myIndex = aIndex; }
+
+		/// Folds in the deallocations made by other threads, and clears the buffer if nothing is in use.
+		///
+		/// \returns Whether the buffer is unused.
+		///
+		bool reclaim()
+		{
+			const std::int64_t remoteFrees = myRemoteFrees.load(std::memory_order_acquire);
+			if (static_cast<std::int64_t>(myRefCount) != remoteFrees)
+				return false;
+
+			// nothing is outstanding so no other thread can be freeing into the buffer at this point
+
+			myRemoteFrees.fetch_sub(remoteFrees, std::memory_order_relaxed);
+			myRefCount = 0;
+			clear();
+
+			return true;
+		}
+
+		/// Gives up ownership when the owning thread exits, after which the last remote deallocation
+		/// is responsible for destroying the buffer.
+		///
+		/// \returns Whether nothing is outstanding and the buffer can be destroyed right away.
+		///
+		bool orphan()
+		{
+			myOwner.store(nullptr, std::memory_order_release); // another thread's arena may later reside at the same address
+
+			const auto outstanding = static_cast<std::int64_t>(myRefCount);
+			return myRemoteFrees.fetch_sub(outstanding, std::memory_order_acq_rel) - outstanding == 0;
+		}
+
+	private:
+		Buffer(ThreadArena* aOwner, std::size_t aRegionSize, Backing aBacking)
+			: myOwner(aOwner), myRegionSize(aRegionSize), myBacking(aBacking)
+		{
+
+		}
+
+		std::atomic<ThreadArena*>	myOwner			= nullptr;
+		std::size_t					myRegionSize	= 0;
+		Backing						myBacking		= Backing::Heap;
+		Reservation*				myReservation	= nullptr;
+		vmem::Range					myRange;
+		std::size_t					mySize			= 0;
+		std::size_t					myIndex			= 0; // position in the owner's buffers
+		unsigned					myRefCount		= 0;
+		bool						myLarge			= false; // holds a single allocation, may be no larger than a region
+
+		// deallocations made by other threads. Once orphaned, the outstanding count is subtracted so
+		// that the buffer can be destroyed by whoever brings it back to zero
+		alignas(std::hardware_destructive_interference_size) std::atomic<std::int64_t> myRemoteFrees {0};
+	};
+
+	__forceinline std::ptrdiff_t AlignmentOffset(const std::byte* aMemory, std::size_t aAlignment)
 	{
-		locMemoryBuffers.emplace_back(std::make_unique<Buffer>(aNumBytes));
-		it = std::prev(locMemoryBuffers.end());
+		const auto off = aAlignment - reinterpret_cast<std::uintptr_t>(aMemory) % aAlignment;
+		return off == aAlignment ? 0 : off;
 	}
 
-	(*it)->resize(AlignmentOffset((*it)->top(), aAlignment));
-
-	std::byte* r = (*it)->top();
-	(*it)->resize(aNumBytes);
+	__forceinline bool Fits(const Buffer& aBuffer, std::size_t aNumBytes, std::size_t aAlignment)
+	{
+		aNumBytes += AlignmentOffset(aBuffer.top(), aAlignment);
+		return aBuffer.top() + aNumBytes < aBuffer.end();
+	}
 
-	(*it)->ref();
+	class ThreadArena
+	{
+	public:
+		~ThreadArena()
+		{
+			for (Buffer* buffer : myBuffers)
+			{
+				if (buffer->orphan())
+					Destroy(buffer);
+			}
+
+			for (Buffer* buffer : myUnused)
+			{
+				Destroy(buffer);
+			}
+
+			myBuffers.clear();
+			myUnused.clear();
+			myCurrent = nullptr;
+
+			if (!myReservations.empty())
+			{
+				std::scoped_lock lock(locDepot.mutex);
+				locDepot.reservations.insert(locDepot.reservations.end(), myReservations.begin(), myReservations.end());
+			}
+
+			myReservations.clear();
+		}
+
+		std::byte* Allocate(std::size_t aNumBytes, std::size_t aAlignment)
+		{
+			assert(aAlignment < REGION_SIZE && "Alignment must be smaller than a region");
+
+			if (sizeof(Buffer) + aNumBytes + aAlignment >= REGION_SIZE)
+				return AllocateLarge(aNumBytes, aAlignment);
+
+			if (!myCurrent || !Fits(*myCurrent, aNumBytes, aAlignment))
+			{
+				if (!myCurrent || !myCurrent->reclaim()) // other threads may have freed everything in it
+					NextBuffer();
+			}
+
+			myCurrent->resize(AlignmentOffset(myCurrent->top(), aAlignment));
+
+			std::byte* r = myCurrent->top();
+			myCurrent->resize(aNumBytes);
+
+			myCurrent->ref();
+
+			return r;
+		}
+
+		void Deallocate(Buffer* aBuffer, std::byte* aMemory, std::size_t aNumBytes)
+		{
+			aBuffer->unref();
+
+			if (aBuffer->reclaim())
+			{
+				if (aBuffer != myCurrent)
+					Release(aBuffer);
+			}
+			else if (aMemory + aNumBytes == aBuffer->top())
+			{
+				aBuffer->resize(-(std::ptrdiff_t)aNumBytes);
+			}
+		}
+
+	private:
+		std::byte* AllocateLarge(std::size_t aNumBytes, std::size_t aAlignment)
+		{
+			// the allocation is placed right after the header so masking its address still finds the buffer,
+			// nothing else is allocated from it so it is destroyed by whichever thread deallocates it
+
+			const std::size_t regionSize = (sizeof(Buffer) + aNumBytes + aAlignment + REGION_SIZE - 1) & ~(REGION_SIZE - 1);
+
+			const ArenaConfig config = GetArenaConfig();
+
+			Buffer* buffer = Buffer::CreateMapped(regionSize, config.hugePages, config.populate);
+			buffer->resize(AlignmentOffset(buffer->top(), aAlignment));
+
+			return buffer->top();
+		}
+
+		void NextBuffer()
+		{
+			// buffers emptied by other threads are only noticed here, which happens once per filled region
+
+			for (std::size_t i = myBuffers.size(); i-- > 0;)
+			{
+				Buffer* buffer = myBuffers[i];
+				if (buffer != myCurrent && buffer->reclaim())
+					Release(buffer);
+			}
+
+			if (!myUnused.empty())
+			{
+				myCurrent = myUnused.back();
+				myUnused.pop_back();
+			}
+			else if (Reservation* reservation = nullptr; std::byte* region = AcquireRegion(reservation))
+			{
+				myCurrent = Buffer::Create(region, this, reservation);
+			}
+			else
+			{
+				myCurrent = Buffer::Create(this, REGION_SIZE);
+			}
+
+			myCurrent->set_index(myBuffers.size());
+			myBuffers.emplace_back(myCurrent);
+		}
+
+		/// \returns Committed region from the reservations, or nullptr if no address space could be reserved.
+		///
+		std::byte* AcquireRegion(Reservation*& outReservation)
+		{
+			for (Reservation* reservation : myReservations)
+			{
+				if (!reservation->decommitted.empty())
+				{
+					std::byte* region = reservation->decommitted.back();
+					reservation->decommitted.pop_back();
+
+					Commit(region, REGION_SIZE, reservation->hugePages, reservation->populate);
+
+					outReservation = reservation;
+					return region;
+				}
+			}
+
+			Reservation* reservation = !myReservations.empty() ? myReservations.back() : nullptr;
+
+			if (!reservation || reservation->next == reservation->end)
+			{
+				if (!(reservation = Reserve()))
+					return nullptr;
+			}
+
+			std::byte* region = reservation->next;
+			reservation->next += REGION_SIZE;
+
+			if (reservation->next > reservation->committed)
+			{
+				// commit a huge page at a time so that it can be backed by one
+
+				const std::size_t step = reservation->hugePages ? vmem::HUGE_PAGE_SIZE : REGION_SIZE;
+				std::byte* committed = (std::min)(reservation->committed + step, reservation->end);
+
+				Commit(reservation->committed, committed - reservation->committed, reservation->hugePages, reservation->populate);
+				reservation->committed = committed;
+			}
+
+			outReservation = reservation;
+			return region;
+		}
+
+		Reservation* Reserve()
+		{
+			{
+				std::scoped_lock lock(locDepot.mutex);
+
+				const auto it = std::find_if(locDepot.reservations.begin(), locDepot.reservations.end(), 
+					[](const Reservation* aReservation) 
+					{ 
+						return aReservation->next != aReservation->end || !aReservation->decommitted.empty(); 
+					});
+
+				if (it != locDepot.reservations.end())
+				{
+					Reservation* reservation = *it;
+					locDepot.reservations.erase(it);
+
+					myReservations.emplace_back(reservation);
+					return reservation;
+				}
+			}
+
+			const ArenaConfig config = GetArenaConfig();
+
+			const std::size_t alignment	= config.hugePages ? vmem::HUGE_PAGE_SIZE : REGION_SIZE;
+			const std::size_t capacity	= (std::max)((config.capacity + alignment - 1) & ~(alignment - 1), alignment);
+
+			vmem::Range range;
+
+			std::byte* memory = vmem::Reserve(capacity, alignment, range);
+			if (!memory)
+				return nullptr;
+
+			auto* reservation = new Reservation{range, memory, memory, memory + capacity, {}, config.hugePages, config.populate};
+
+			if (myReservations.empty() && config.prefault > 0) // only the first reservation of each thread
+			{
+				const std::size_t prefault = (std::min)((config.prefault + alignment - 1) & ~(alignment - 1), capacity);
+
+				Commit(memory, prefault, config.hugePages, config.populate);
+				reservation->committed += prefault;
+			}
+
+			myReservations.emplace_back(reservation);
+			return reservation;
+		}
+
+		/// Gives a buffer's region back, reserved regions are kept for reuse by this or later threads.
+		///
+		void Destroy(Buffer* aBuffer)
+		{
+			if (aBuffer->backing() != Backing::Reserved)
+			{
+				Buffer::Destroy(aBuffer);
+				return;
+			}
+
+			Reservation* reservation = aBuffer->reservation();
+			auto* region = reinterpret_cast<std::byte*>(aBuffer);
+
+			Buffer::Destroy(aBuffer);
+			reservation->decommitted.emplace_back(region);
+		}
+
+		void Release(Buffer* aBuffer)
+		{
+			Buffer* last = myBuffers.back();
+
+			myBuffers[aBuffer->index()] = last;
+			last->set_index(aBuffer->index());
+			myBuffers.pop_back();
+
+			if (myUnused.size() < RECYCLE_LIMIT)
+			{
+				myUnused.emplace_back(aBuffer);
+			}
+			else
+			{
+				Destroy(aBuffer);
+			}
+		}
+
+		std::vector<Buffer*>		myBuffers;		// buffers that may have allocations outstanding
+		std::vector<Buffer*>		myUnused;		// cleared buffers kept for reuse
+		std::vector<Reservation*>	myReservations;	// carved from the last one
+		Buffer*						myCurrent		= nullptr;
+	};
+
+	thread_local ThreadArena locArena;
+}
 
-	return r;
+std::byte* details::arena::Allocate(std::size_t aNumBytes, std::size_t aAlignment, const std::byte*)
+{
+	details::allocstats::RecordAllocate(AllocatorType::Arena, aNumBytes);
+	return locArena.Allocate(aNumBytes, aAlignment);
 }
 
 void details::arena::Deallocate(std::byte* aMemory, std::size_t aNumBytes)
 {
-	auto it = FindBuffer(aMemory);
-	if (it == locMemoryBuffers.end())
+	if (!aMemory)
 		return;
 
-	(*it)->unref();
+	details::allocstats::RecordDeallocate(AllocatorType::Arena, aNumBytes);
 
-	if ((*it)->unused())
+	Buffer* buffer = Buffer::From(aMemory);
+
+	if (buffer->large())
+	{
+		Buffer::Destroy(buffer);
+	}
+	else if (buffer->owner() == &locArena)
 	{
-		(*it)->clear();
+		locArena.Deallocate(buffer, aMemory, aNumBytes);
 	}
-	else if (aMemory + aNumBytes == (*it)->top())
+	else if (buffer->remote_unref()) // let the owner reclaim it later
 	{
-		(*it)->resize(-(std::ptrdiff_t)aNumBytes);
+		Buffer::Destroy(buffer);
 	}
-}
\ No newline at end of file
+}
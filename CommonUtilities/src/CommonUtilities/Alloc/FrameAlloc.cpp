@@ -0,0 +1,210 @@
+#include <CommonUtilities/Alloc/FrameAlloc.hpp>
+#include <CommonUtilities/Alloc/AllocStats.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cassert>
+
+using namespace CommonUtilities;
+
+static std::size_t AlignmentOffset(const std::byte* aMemory, std::size_t aAlignment)
+{
+	const auto off = aAlignment - reinterpret_cast<std::uintptr_t>(aMemory) % aAlignment;
+	return off == aAlignment ? 0 : off;
+}
+
+FrameAllocator::FrameAllocator(std::size_t aCapacity, std::pmr::memory_resource* aUpstream)
+	: myUpstream(aUpstream), myCapacity(aCapacity)
+{
+
+}
+
+FrameAllocator::~FrameAllocator()
+{
+	Release();
+}
+
+std::byte* FrameAllocator::Allocate(std::size_t aNumBytes, std::size_t aAlignment)
+{
+	Frame& frame = GetFrame();
+
+	while (frame.current < frame.chunks.size())
+	{
+		Chunk& chunk = frame.chunks[frame.current];
+
+		std::byte* top = chunk.data + chunk.size;
+		const std::size_t offset = AlignmentOffset(top, aAlignment);
+
+		if (chunk.size + offset + aNumBytes <= chunk.capacity)
+		{
+			chunk.size += offset + aNumBytes;
+			details::allocstats::RecordAllocate(AllocatorType::Frame, offset + aNumBytes); // padding is live until popped
+
+			return top + offset;
+		}
+
+		if (frame.current + 1 == frame.chunks.size())
+			break;
+
+		frame.chunks[++frame.current].size = 0; // chunks past the current one are left over from earlier scopes
+	}
+
+	// out of space, chain another chunk that is merged with the others on the next reset of this frame
+
+	const std::size_t last = frame.chunks.empty() ? myCapacity : frame.chunks.back().capacity * 2;
+	const std::size_t capacity = (std::max)(last, aNumBytes + aAlignment);
+
+	Chunk& chunk = AddChunk(frame, capacity);
+	frame.current = frame.chunks.size() - 1;
+
+	std::byte* top = chunk.data;
+	const std::size_t offset = AlignmentOffset(top, aAlignment);
+
+	chunk.size = offset + aNumBytes;
+	details::allocstats::RecordAllocate(AllocatorType::Frame, offset + aNumBytes);
+
+	return top + offset;
+}
+
+void FrameAllocator::Deallocate(std::byte* aMemory, std::size_t aNumBytes)
+{
+	Frame& frame = GetFrame();
+
+	if (frame.current >= frame.chunks.size())
+		return;
+
+	Chunk& chunk = frame.chunks[frame.current];
+	if (aMemory + aNumBytes == chunk.data + chunk.size)
+	{
+		chunk.size -= aNumBytes;
+		details::allocstats::RecordDeallocate(AllocatorType::Frame, aNumBytes);
+	}
+	else
+	{
+		details::allocstats::RecordDeallocate(AllocatorType::Frame, 0); // left until the scope or frame ends
+	}
+}
+
+auto FrameAllocator::PushMarker() const -> Marker
+{
+	const Frame& frame = GetFrame();
+
+	if (frame.current >= frame.chunks.size())
+		return Marker{};
+
+	return Marker{ frame.current, frame.chunks[frame.current].size };
+}
+
+void FrameAllocator::PopToMarker(const Marker& aMarker)
+{
+	Frame& frame = GetFrame();
+
+	if (frame.chunks.empty())
+		return;
+
+	assert(aMarker.chunk <= frame.current && "Markers must be popped in the reverse order they were pushed");
+
+	const std::size_t used = AllocStats::ENABLED ? GetUsed(frame) : 0;
+
+	frame.current = aMarker.chunk;
+	frame.chunks[frame.current].size = aMarker.offset;
+
+	if constexpr (AllocStats::ENABLED)
+		details::allocstats::RecordRewind(AllocatorType::Frame, used - GetUsed(frame));
+}
+
+void FrameAllocator::Reset()
+{
+	myIndex = (myIndex + 1) % myFrames.size();
+
+	Frame& frame = GetFrame();
+
+	if constexpr (AllocStats::ENABLED)
+		details::allocstats::RecordRewind(AllocatorType::Frame, GetUsed(frame));
+
+	if (frame.chunks.size() > 1) // merge into one chunk large enough for what this frame needed last time
+	{
+		std::size_t capacity = 0;
+		for (const Chunk& chunk : frame.chunks)
+			capacity += chunk.capacity;
+
+		ReleaseChunks(frame);
+		AddChunk(frame, capacity);
+	}
+
+	for (Chunk& chunk : frame.chunks)
+		chunk.size = 0;
+
+	frame.current = 0;
+}
+
+void FrameAllocator::Release()
+{
+	for (Frame& frame : myFrames)
+	{
+		if constexpr (AllocStats::ENABLED)
+			details::allocstats::RecordRewind(AllocatorType::Frame, GetUsed(frame));
+
+		ReleaseChunks(frame);
+	}
+}
+
+std::size_t FrameAllocator::GetUsed() const
+{
+	return GetUsed(GetFrame());
+}
+
+std::size_t FrameAllocator::GetCapacity() const
+{
+	const Frame& frame = GetFrame();
+
+	std::size_t capacity = 0;
+	for (const Chunk& chunk : frame.chunks)
+		capacity += chunk.capacity;
+
+	return capacity;
+}
+
+std::size_t FrameAllocator::GetUsed(const Frame& aFrame)
+{
+	std::size_t used = 0;
+	for (std::size_t i = 0; i <= aFrame.current && i < aFrame.chunks.size(); ++i)
+		used += aFrame.chunks[i].size;
+
+	return used;
+}
+
+auto FrameAllocator::GetFrame() -> Frame&
+{
+	return myFrames[myIndex];
+}
+auto FrameAllocator::GetFrame() const -> const Frame&
+{
+	return myFrames[myIndex];
+}
+
+auto FrameAllocator::AddChunk(Frame& aFrame, std::size_t aCapacity) -> Chunk&
+{
+	auto* data = static_cast<std::byte*>(myUpstream->allocate(aCapacity, alignof(std::max_align_t)));
+	details::allocstats::RecordReserve(AllocatorType::Frame, aCapacity);
+
+	return aFrame.chunks.emplace_back(data, aCapacity, 0);
+}
+
+void FrameAllocator::ReleaseChunks(Frame& aFrame)
+{
+	for (const Chunk& chunk : aFrame.chunks)
+	{
+		myUpstream->deallocate(chunk.data, chunk.capacity, alignof(std::max_align_t));
+		details::allocstats::RecordRelease(AllocatorType::Frame, chunk.capacity);
+	}
+
+	aFrame.chunks.clear();
+	aFrame.current = 0;
+}
+
+FrameAllocator& details::frame::GetScratch()
+{
+	static thread_local FrameAllocator scratch;
+	return scratch;
+}
@@ -0,0 +1,307 @@
+#include <CommonUtilities/Alloc/MemoryResource.hpp>
+#include <CommonUtilities/Alloc/AllocStats.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <new>
+
+using namespace CommonUtilities;
+using namespace CommonUtilities::details::resource;
+
+static std::size_t AlignmentOffset(const std::byte* aMemory, std::size_t aAlignment)
+{
+	const auto off = aAlignment - reinterpret_cast<std::uintptr_t>(aMemory) % aAlignment;
+	return off == aAlignment ? 0 : off;
+}
+
+static constexpr std::size_t RoundUp(std::size_t aValue, std::size_t aMultiple)
+{
+	return (aValue + aMultiple - 1) / aMultiple * aMultiple;
+}
+
+// LargeList
+
+void* LargeList::Allocate(std::pmr::memory_resource* aUpstream, std::size_t aNumBytes, std::size_t aAlignment)
+{
+	// the node sits right before the returned memory so that it can be found again from it
+
+	const std::size_t header	= HeaderSize(aAlignment);
+	const std::size_t size		= header + aNumBytes;
+	const std::size_t alignment	= (std::max)(aAlignment, alignof(Node));
+
+	auto* memory = static_cast<std::byte*>(aUpstream->allocate(size, alignment));
+	details::allocstats::RecordReserve(AllocatorType::Resource, size);
+
+	auto* node = new (memory + header - sizeof(Node)) Node{nullptr, myHead, size, alignment};
+
+	if (myHead)
+		myHead->prev = node;
+
+	myHead = node;
+
+	return memory + header;
+}
+
+void LargeList::Deallocate(std::pmr::memory_resource* aUpstream, void* aMemory, std::size_t, std::size_t aAlignment)
+{
+	auto* memory = static_cast<std::byte*>(aMemory);
+	auto* node = reinterpret_cast<Node*>(memory - sizeof(Node));
+
+	if (node->prev)
+		node->prev->next = node->next;
+	else
+		myHead = node->next;
+
+	if (node->next)
+		node->next->prev = node->prev;
+
+	details::allocstats::RecordRelease(AllocatorType::Resource, node->size);
+	aUpstream->deallocate(memory - HeaderSize(aAlignment), node->size, node->alignment);
+}
+
+void LargeList::Release(std::pmr::memory_resource* aUpstream)
+{
+	while (myHead)
+	{
+		Node* node = myHead;
+		myHead = node->next;
+
+		auto* memory = reinterpret_cast<std::byte*>(node) + sizeof(Node) - HeaderSize(node->alignment);
+
+		details::allocstats::RecordRelease(AllocatorType::Resource, node->size);
+		aUpstream->deallocate(memory, node->size, node->alignment);
+	}
+}
+
+std::size_t LargeList::HeaderSize(std::size_t aAlignment)
+{
+	return RoundUp(sizeof(Node), (std::max)(aAlignment, alignof(Node)));
+}
+
+// ArenaResource
+
+inline constexpr std::size_t CHUNK_ALIGNMENT = alignof(std::max_align_t);
+
+ArenaResource::ArenaResource(std::size_t aChunkSize, std::pmr::memory_resource* aUpstream)
+	: myUpstream(aUpstream), myChunkSize((std::max)(aChunkSize, std::size_t(1024)))
+{
+
+}
+
+ArenaResource::~ArenaResource()
+{
+	Release();
+}
+
+void ArenaResource::Reset()
+{
+	while (myChunks)
+	{
+		Chunk* chunk = myChunks;
+		myChunks = chunk->next;
+
+		chunk->size = 0;
+		chunk->next = myUnused;
+		myUnused = chunk;
+	}
+
+	myLarge.Release(myUpstream);
+
+	details::allocstats::RecordRewind(AllocatorType::Resource, myLive);
+	myLive = 0;
+}
+
+void ArenaResource::Release()
+{
+	ReleaseChunks(myChunks);
+	ReleaseChunks(myUnused);
+
+	myChunks = nullptr;
+	myUnused = nullptr;
+
+	myLarge.Release(myUpstream);
+
+	details::allocstats::RecordRewind(AllocatorType::Resource, myLive);
+	myLive = 0;
+}
+
+void* ArenaResource::do_allocate(std::size_t aNumBytes, std::size_t aAlignment)
+{
+	myLive += aNumBytes;
+	details::allocstats::RecordAllocate(AllocatorType::Resource, aNumBytes);
+
+	if (IsLarge(aNumBytes, aAlignment))
+		return myLarge.Allocate(myUpstream, aNumBytes, aAlignment);
+
+	Chunk* chunk = myChunks;
+
+	std::byte* top = chunk ? reinterpret_cast<std::byte*>(chunk) + chunk->size : nullptr;
+	std::size_t offset = chunk ? AlignmentOffset(top, aAlignment) : 0;
+
+	if (!chunk || chunk->size + offset + aNumBytes > chunk->capacity)
+	{
+		chunk	= NextChunk();
+		top		= reinterpret_cast<std::byte*>(chunk) + chunk->size;
+		offset	= AlignmentOffset(top, aAlignment);
+	}
+
+	chunk->size += offset + aNumBytes;
+
+	return top + offset;
+}
+
+void ArenaResource::do_deallocate(void* aMemory, std::size_t aNumBytes, std::size_t aAlignment)
+{
+	myLive -= aNumBytes;
+	details::allocstats::RecordDeallocate(AllocatorType::Resource, aNumBytes);
+
+	if (IsLarge(aNumBytes, aAlignment))
+	{
+		myLarge.Deallocate(myUpstream, aMemory, aNumBytes, aAlignment);
+		return;
+	}
+
+	Chunk* chunk = myChunks; // only the latest allocation is reclaimed, e.g., when a vector grows
+	if (chunk && static_cast<std::byte*>(aMemory) + aNumBytes == reinterpret_cast<std::byte*>(chunk) + chunk->size)
+	{
+		chunk->size -= aNumBytes;
+	}
+}
+
+bool ArenaResource::do_is_equal(const std::pmr::memory_resource& aOther) const noexcept
+{
+	return this == &aOther;
+}
+
+bool ArenaResource::IsLarge(std::size_t aNumBytes, std::size_t aAlignment) const
+{
+	return aNumBytes + aAlignment > myChunkSize / 4;
+}
+
+auto ArenaResource::NextChunk() -> Chunk*
+{
+	// sizes are measured from the start of the chunk, so the header is counted as used
+
+	constexpr std::size_t header = RoundUp(sizeof(Chunk), CHUNK_ALIGNMENT);
+
+	Chunk* chunk = myUnused;
+	if (chunk)
+	{
+		myUnused = chunk->next;
+	}
+	else
+	{
+		void* memory = myUpstream->allocate(myChunkSize, CHUNK_ALIGNMENT);
+		details::allocstats::RecordReserve(AllocatorType::Resource, myChunkSize);
+
+		chunk = new (memory) Chunk{nullptr, myChunkSize, 0};
+	}
+
+	chunk->size = header;
+	chunk->next = myChunks;
+	myChunks = chunk;
+
+	return chunk;
+}
+
+void ArenaResource::ReleaseChunks(Chunk* aChunk)
+{
+	while (aChunk)
+	{
+		Chunk* next = aChunk->next;
+
+		details::allocstats::RecordRelease(AllocatorType::Resource, aChunk->capacity);
+		myUpstream->deallocate(aChunk, aChunk->capacity, CHUNK_ALIGNMENT);
+		aChunk = next;
+	}
+}
+
+// PoolResource
+
+using namespace CommonUtilities::details::pool;
+
+PoolResource::PoolResource(std::size_t aSlabSize, std::pmr::memory_resource* aUpstream)
+	: myUpstream(aUpstream), mySlabSize((std::max)(aSlabSize, BLOCK_ALIGNMENT + MAX_BLOCK_SIZE))
+{
+
+}
+
+PoolResource::~PoolResource()
+{
+	Release();
+}
+
+void PoolResource::Release()
+{
+	while (mySlabs)
+	{
+		Slab* next = mySlabs->next;
+
+		details::allocstats::RecordRelease(AllocatorType::Resource, mySlabSize);
+		myUpstream->deallocate(mySlabs, mySlabSize, BLOCK_ALIGNMENT);
+		mySlabs = next;
+	}
+
+	myLists.fill(nullptr);
+	myLarge.Release(myUpstream);
+
+	details::allocstats::RecordRewind(AllocatorType::Resource, myLive);
+	myLive = 0;
+}
+
+void* PoolResource::do_allocate(std::size_t aNumBytes, std::size_t aAlignment)
+{
+	myLive += aNumBytes;
+	details::allocstats::RecordAllocate(AllocatorType::Resource, aNumBytes);
+
+	if (aNumBytes > MAX_BLOCK_SIZE || aAlignment > BLOCK_ALIGNMENT)
+		return myLarge.Allocate(myUpstream, aNumBytes, aAlignment);
+
+	const std::size_t index = ClassIndex(aNumBytes);
+	if (!myLists[index])
+		Carve(index);
+
+	FreeBlock* block = myLists[index];
+	myLists[index] = block->next;
+
+	return block;
+}
+
+void PoolResource::do_deallocate(void* aMemory, std::size_t aNumBytes, std::size_t aAlignment)
+{
+	myLive -= aNumBytes;
+	details::allocstats::RecordDeallocate(AllocatorType::Resource, aNumBytes);
+
+	if (aNumBytes > MAX_BLOCK_SIZE || aAlignment > BLOCK_ALIGNMENT)
+	{
+		myLarge.Deallocate(myUpstream, aMemory, aNumBytes, aAlignment);
+		return;
+	}
+
+	const std::size_t index = ClassIndex(aNumBytes);
+	myLists[index] = new (aMemory) FreeBlock{myLists[index]};
+}
+
+bool PoolResource::do_is_equal(const std::pmr::memory_resource& aOther) const noexcept
+{
+	return this == &aOther;
+}
+
+void PoolResource::Carve(std::size_t aIndex)
+{
+	// the slab header takes up the first block-aligned slot, the rest is split into blocks of the class
+
+	auto* slab = static_cast<std::byte*>(myUpstream->allocate(mySlabSize, BLOCK_ALIGNMENT));
+	details::allocstats::RecordReserve(AllocatorType::Resource, mySlabSize);
+
+	mySlabs = new (slab) Slab{mySlabs};
+
+	const std::size_t size	= ClassSize(aIndex);
+	const std::size_t count	= (mySlabSize - BLOCK_ALIGNMENT) / size;
+
+	std::byte* blocks = slab + BLOCK_ALIGNMENT;
+	for (std::size_t i = count; i-- > 0;)
+	{
+		myLists[aIndex] = new (blocks + i * size) FreeBlock{myLists[aIndex]};
+	}
+}
@@ -0,0 +1,214 @@
+#include <CommonUtilities/Alloc/PoolAlloc.hpp>
+#include <CommonUtilities/Alloc/AllocStats.hpp>
+
+#include <array>
+#include <vector>
+#include <mutex>
+#include <algorithm>
+#include <new>
+
+using namespace CommonUtilities;
+using namespace CommonUtilities::details::pool;
+
+namespace
+{
+	inline constexpr std::size_t SLAB_SIZE		= 64 * 1024;
+	inline constexpr std::size_t BATCH_BYTES	= 8 * 1024; // roughly how much memory is moved between a cache and the depot at once
+
+	constexpr std::size_t BatchCount(std::size_t aIndex)
+	{
+		return std::clamp(BATCH_BYTES / ClassSize(aIndex), std::size_t(4), std::size_t(64));
+	}
+
+	struct FreeBlock
+	{
+		FreeBlock* next = nullptr;
+	};
+
+	struct Batch
+	{
+		FreeBlock*	head	= nullptr;
+		std::size_t	count	= 0;
+	};
+
+	// blocks shared between threads, only touched when a thread cache runs empty or overflows
+
+	class Depot
+	{
+	public:
+		~Depot()
+		{
+			for (std::byte* slab : mySlabs)
+			{
+				::operator delete(slab, std::align_val_t(BLOCK_ALIGNMENT));
+			}
+		}
+
+		Batch Pop(std::size_t aIndex)
+		{
+			Class& c = myClasses[aIndex];
+			{
+				std::scoped_lock lock(c.mutex);
+				if (!c.batches.empty())
+				{
+					const Batch batch = c.batches.back();
+					c.batches.pop_back();
+
+					return batch;
+				}
+			}
+
+			return Carve(aIndex);
+		}
+
+		void Push(std::size_t aIndex, const Batch& aBatch)
+		{
+			Class& c = myClasses[aIndex];
+
+			std::scoped_lock lock(c.mutex);
+			c.batches.emplace_back(aBatch);
+		}
+
+	private:
+		Batch Carve(std::size_t aIndex)
+		{
+			// slabs are kept until exit, their blocks only move between caches and the depot
+
+			const std::size_t size	= ClassSize(aIndex);
+			const std::size_t count	= SLAB_SIZE / size;
+			const std::size_t batch	= BatchCount(aIndex);
+
+			auto* slab = static_cast<std::byte*>(::operator new(SLAB_SIZE, std::align_val_t(BLOCK_ALIGNMENT)));
+			details::allocstats::RecordReserve(AllocatorType::Pool, SLAB_SIZE);
+			{
+				std::scoped_lock lock(mySlabMutex);
+				mySlabs.emplace_back(slab);
+			}
+
+			Batch first;
+			Batch current;
+
+			for (std::size_t i = count; i-- > 0;)
+			{
+				auto* block = new (slab + i * size) FreeBlock{current.head};
+
+				current.head = block;
+				if (++current.count == batch || i == 0)
+				{
+					if (!first.head)
+						first = current;
+					else
+						Push(aIndex, current);
+
+					current = {};
+				}
+			}
+
+			return first;
+		}
+
+		struct Class
+		{
+			std::mutex			mutex;
+			std::vector<Batch>	batches;
+		};
+
+		std::array<Class, CLASS_COUNT>	myClasses;
+		std::mutex						mySlabMutex;
+		std::vector<std::byte*>			mySlabs;
+	};
+
+	Depot locDepot;
+
+	class ThreadCache
+	{
+	public:
+		~ThreadCache()
+		{
+			for (std::size_t i = 0; i < CLASS_COUNT; ++i)
+			{
+				if (myLists[i].head)
+					locDepot.Push(i, myLists[i]);
+			}
+		}
+
+		std::byte* Allocate(std::size_t aIndex)
+		{
+			Batch& list = myLists[aIndex];
+			if (!list.head)
+				list = locDepot.Pop(aIndex);
+
+			FreeBlock* block = list.head;
+
+			list.head = block->next;
+			--list.count;
+
+			return reinterpret_cast<std::byte*>(block);
+		}
+
+		void Deallocate(std::byte* aMemory, std::size_t aIndex)
+		{
+			Batch& list = myLists[aIndex];
+
+			list.head = new (aMemory) FreeBlock{list.head};
+			++list.count;
+
+			const std::size_t batch = BatchCount(aIndex);
+			if (list.count >= 2 * batch) // spill a batch so that blocks freed by one thread can be reused by another
+			{
+				Batch spill{list.head, batch};
+
+				FreeBlock* last = list.head;
+				for (std::size_t i = 1; i < batch; ++i)
+					last = last->next;
+
+				list.head = last->next;
+				list.count -= batch;
+
+				last->next = nullptr;
+
+				locDepot.Push(aIndex, spill);
+			}
+		}
+
+	private:
+		std::array<Batch, CLASS_COUNT> myLists;
+	};
+
+	thread_local ThreadCache locCache;
+
+	bool IsPooled(std::size_t aNumBytes, std::size_t aAlignment)
+	{
+		return aNumBytes <= MAX_BLOCK_SIZE && aAlignment <= BLOCK_ALIGNMENT;
+	}
+}
+
+std::byte* details::pool::Allocate(std::size_t aNumBytes, std::size_t aAlignment)
+{
+	details::allocstats::RecordAllocate(AllocatorType::Pool, aNumBytes);
+
+	if (!IsPooled(aNumBytes, aAlignment))
+	{
+		details::allocstats::RecordReserve(AllocatorType::Pool, aNumBytes);
+		return static_cast<std::byte*>(::operator new(aNumBytes, std::align_val_t(aAlignment)));
+	}
+
+	return locCache.Allocate(ClassIndex(aNumBytes));
+}
+
+void details::pool::Deallocate(std::byte* aMemory, std::size_t aNumBytes, std::size_t aAlignment)
+{
+	if (!aMemory)
+		return;
+
+	details::allocstats::RecordDeallocate(AllocatorType::Pool, aNumBytes);
+
+	if (!IsPooled(aNumBytes, aAlignment))
+	{
+		details::allocstats::RecordRelease(AllocatorType::Pool, aNumBytes);
+		::operator delete(aMemory, aNumBytes, std::align_val_t(aAlignment));
+		return;
+	}
+
+	locCache.Deallocate(aMemory, ClassIndex(aNumBytes));
+}
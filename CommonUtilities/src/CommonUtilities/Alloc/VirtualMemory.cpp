@@ -0,0 +1,154 @@
+#include <CommonUtilities/Alloc/VirtualMemory.hpp>
+
+#include <cstdint>
+
+#if defined(COMMON_UTILITIES_SYSTEM_WIN)
+#	include <CommonUtilities/System/WindowsHeader.h>
+#elif defined(COMMON_UTILITIES_SYSTEM_LINUX)
+#	include <sys/mman.h>
+#	include <unistd.h>
+#endif
+
+using namespace CommonUtilities;
+
+static std::byte* AlignUp(std::byte* aMemory, std::size_t aAlignment)
+{
+	const auto address = reinterpret_cast<std::uintptr_t>(aMemory);
+	return aMemory + ((aAlignment - address % aAlignment) % aAlignment);
+}
+
+static void Touch(std::byte* aMemory, std::size_t aSize)
+{
+	const std::size_t pageSize = details::vmem::GetPageSize();
+	for (std::size_t offset = 0; offset < aSize; offset += pageSize)
+	{
+		*reinterpret_cast<volatile std::byte*>(aMemory + offset) = std::byte{0};
+	}
+}
+
+std::byte* details::vmem::Reserve(std::size_t aSize, std::size_t aAlignment, Range& outRange)
+{
+	// reserve enough to fit the alignment, the part in front of it is left unused
+
+	const std::size_t pageSize = GetPageSize();
+
+	aSize		= (aSize + pageSize - 1) / pageSize * pageSize;
+	aAlignment	= aAlignment < pageSize ? pageSize : aAlignment;
+
+	const std::size_t size = aSize + aAlignment - pageSize;
+
+#if defined(COMMON_UTILITIES_SYSTEM_WIN)
+	void* base = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+	if (!base)
+		return nullptr;
+
+	outRange = Range{base, size};
+
+	return AlignUp(static_cast<std::byte*>(base), aAlignment);
+#elif defined(COMMON_UTILITIES_SYSTEM_LINUX)
+	void* base = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+	if (base == MAP_FAILED)
+		return nullptr;
+
+	// unlike on Windows, the excess can be given back right away
+
+	auto* begin		= static_cast<std::byte*>(base);
+	auto* aligned	= AlignUp(begin, aAlignment);
+	auto* end		= begin + size;
+
+	if (aligned != begin)
+		munmap(begin, aligned - begin);
+
+	if (aligned + aSize != end)
+		munmap(aligned + aSize, end - (aligned + aSize));
+
+	outRange = Range{aligned, aSize};
+
+	return aligned;
+#else
+	(void)size;
+	return nullptr;
+#endif
+}
+
+bool details::vmem::Commit(std::byte* aMemory, std::size_t aSize, bool aHugePages, bool aPopulate)
+{
+#if defined(COMMON_UTILITIES_SYSTEM_WIN)
+	(void)aHugePages;
+
+	if (!VirtualAlloc(aMemory, aSize, MEM_COMMIT, PAGE_READWRITE))
+		return false;
+
+	if (aPopulate)
+		Touch(aMemory, aSize);
+
+	return true;
+#elif defined(COMMON_UTILITIES_SYSTEM_LINUX)
+	if (mprotect(aMemory, aSize, PROT_READ | PROT_WRITE) != 0)
+		return false;
+
+#	ifdef MADV_HUGEPAGE
+	if (aHugePages)
+		madvise(aMemory, aSize, MADV_HUGEPAGE);
+#	endif
+
+	if (aPopulate)
+	{
+#	ifdef MADV_POPULATE_WRITE
+		if (madvise(aMemory, aSize, MADV_POPULATE_WRITE) != 0) // needs Linux 5.14
+			Touch(aMemory, aSize);
+#	else
+		Touch(aMemory, aSize);
+#	endif
+	}
+
+	return true;
+#else
+	(void)aMemory; (void)aSize; (void)aHugePages; (void)aPopulate;
+	return false;
+#endif
+}
+
+void details::vmem::Decommit(std::byte* aMemory, std::size_t aSize)
+{
+#if defined(COMMON_UTILITIES_SYSTEM_WIN)
+	VirtualFree(aMemory, aSize, MEM_DECOMMIT);
+#elif defined(COMMON_UTILITIES_SYSTEM_LINUX)
+	madvise(aMemory, aSize, MADV_DONTNEED);
+	mprotect(aMemory, aSize, PROT_NONE);
+#else
+	(void)aMemory; (void)aSize;
+#endif
+}
+
+void details::vmem::Release(const Range& aRange)
+{
+	if (!aRange.base)
+		return;
+
+#if defined(COMMON_UTILITIES_SYSTEM_WIN)
+	VirtualFree(aRange.base, 0, MEM_RELEASE);
+#elif defined(COMMON_UTILITIES_SYSTEM_LINUX)
+	munmap(aRange.base, aRange.size);
+#endif
+}
+
+std::size_t details::vmem::GetPageSize()
+{
+#if defined(COMMON_UTILITIES_SYSTEM_WIN)
+	static const std::size_t pageSize = []
+	{
+		SYSTEM_INFO info{};
+		GetSystemInfo(&info);
+
+		return static_cast<std::size_t>(info.dwPageSize);
+	}();
+
+	return pageSize;
+#elif defined(COMMON_UTILITIES_SYSTEM_LINUX)
+	static const std::size_t pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+	return pageSize;
+#else
+	return 4096;
+#endif
+}
@@ -0,0 +1,504 @@
+#include <CommonUtilities/System/CpuTopology.h>
+
+#include <algorithm>
+#include <map>
+#include <set>
+#include <thread>
+#include <tuple>
+
+#if defined(COMMON_UTILITIES_SYSTEM_WIN)
+#	include <CommonUtilities/System/WindowsHeader.h>
+#elif defined(COMMON_UTILITIES_SYSTEM_LINUX)
+#	include <cctype>
+#	include <fstream>
+#	include <string>
+#	include <filesystem>
+#	include <pthread.h>
+#	include <sched.h>
+#endif
+
+using namespace CommonUtilities;
+
+namespace
+{
+#if defined(COMMON_UTILITIES_SYSTEM_WIN)
+
+	template<typename Func>
+	void ForEachProcessor(const GROUP_AFFINITY& aAffinity, Func&& aFunc)
+	{
+		for (std::uint32_t bit = 0; bit < sizeof(KAFFINITY) * 8; ++bit)
+		{
+			if (aAffinity.Mask & (KAFFINITY(1) << bit))
+				aFunc(static_cast<std::uint32_t>(aAffinity.Group) * 64 + bit);
+		}
+	}
+
+	bool DetectProcessors(std::vector<LogicalProcessor>& someProcessors)
+	{
+		DWORD length = 0;
+		GetLogicalProcessorInformationEx(RelationAll, nullptr, &length);
+
+		if (length == 0)
+			return false;
+
+		std::vector<std::byte> buffer(length);
+		if (!GetLogicalProcessorInformationEx(RelationAll, reinterpret_cast<PSYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX>(buffer.data()), &length))
+			return false;
+
+		std::map<std::uint32_t, LogicalProcessor> processors;
+
+		std::uint32_t coreIndex		= 0;
+		std::uint32_t packageIndex	= 0;
+		std::uint32_t cacheIndex	= 0;
+
+		bool hasCache = false;
+
+		for (DWORD offset = 0; offset < length;)
+		{
+			const auto* info = reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+
+			switch (info->Relationship)
+			{
+				case RelationProcessorCore:
+				{
+					for (WORD i = 0; i < info->Processor.GroupCount; ++i)
+					{
+						ForEachProcessor(info->Processor.GroupMask[i], [&](std::uint32_t aID)
+						{
+							processors[aID].id = aID;
+							processors[aID].core = coreIndex;
+						});
+					}
+					++coreIndex;
+					break;
+				}
+				case RelationProcessorPackage:
+				{
+					for (WORD i = 0; i < info->Processor.GroupCount; ++i)
+					{
+						ForEachProcessor(info->Processor.GroupMask[i], [&](std::uint32_t aID)
+						{
+							processors[aID].package = packageIndex;
+						});
+					}
+					++packageIndex;
+					break;
+				}
+				case RelationNumaNode:
+				{
+					ForEachProcessor(info->NumaNode.GroupMask, [&](std::uint32_t aID)
+					{
+						processors[aID].node = info->NumaNode.NodeNumber;
+					});
+					break;
+				}
+				case RelationCache:
+				{
+					if (info->Cache.Level == 3)
+					{
+						ForEachProcessor(info->Cache.GroupMask, [&](std::uint32_t aID)
+						{
+							processors[aID].cache = cacheIndex;
+						});
+						++cacheIndex;
+						hasCache = true;
+					}
+					break;
+				}
+				default:
+					break;
+			}
+
+			offset += info->Size;
+		}
+
+		for (auto& [id, processor] : processors)
+		{
+			if (!hasCache)
+				processor.cache = processor.package;
+
+			someProcessors.emplace_back(processor);
+		}
+
+		return !someProcessors.empty();
+	}
+
+#elif defined(COMMON_UTILITIES_SYSTEM_LINUX)
+
+	/// Parses lists such as "0-3,8,10-11" used throughout sysfs.
+	///
+	std::vector<std::uint32_t> ParseList(const std::string& aList)
+	{
+		std::vector<std::uint32_t> result;
+
+		std::size_t pos = 0;
+		while (pos < aList.size())
+		{
+			std::size_t end = aList.find(',', pos);
+			if (end == std::string::npos)
+				end = aList.size();
+
+			const std::string range = aList.substr(pos, end - pos);
+			const std::size_t dash = range.find('-');
+
+			try
+			{
+				const auto first = static_cast<std::uint32_t>(std::stoul(range.substr(0, dash)));
+				const auto last = (dash == std::string::npos) ? first : static_cast<std::uint32_t>(std::stoul(range.substr(dash + 1)));
+
+				for (std::uint32_t i = first; i <= last; ++i)
+				{
+					result.emplace_back(i);
+				}
+			}
+			catch (const std::exception&) {} // skip anything malformed, e.g., trailing newline
+
+			pos = end + 1;
+		}
+
+		return result;
+	}
+
+	bool ReadLine(const std::filesystem::path& aPath, std::string& aLine)
+	{
+		std::ifstream file(aPath);
+		return file && std::getline(file, aLine);
+	}
+
+	std::uint32_t ReadNumber(const std::filesystem::path& aPath, std::uint32_t aDefault)
+	{
+		std::string line;
+		if (!ReadLine(aPath, line))
+			return aDefault;
+
+		try
+		{
+			return static_cast<std::uint32_t>(std::stoul(line));
+		}
+		catch (const std::exception&)
+		{
+			return aDefault;
+		}
+	}
+
+	bool DetectProcessors(std::vector<LogicalProcessor>& someProcessors)
+	{
+		namespace fs = std::filesystem;
+
+		const fs::path cpuRoot = "/sys/devices/system/cpu";
+
+		std::string online;
+		if (!ReadLine(cpuRoot / "online", online))
+			return false;
+
+		std::map<std::uint32_t, std::uint32_t> nodes; // processor to node
+
+		std::error_code error;
+		for (const auto& entry : fs::directory_iterator("/sys/devices/system/node", error))
+		{
+			const std::string name = entry.path().filename().string();
+			if (name.rfind("node", 0) != 0 || name.size() == 4 || !std::isdigit(static_cast<unsigned char>(name[4])))
+				continue;
+
+			std::string list;
+			if (!ReadLine(entry.path() / "cpulist", list))
+				continue;
+
+			const auto node = static_cast<std::uint32_t>(std::stoul(name.substr(4)));
+			for (std::uint32_t id : ParseList(list))
+			{
+				nodes[id] = node;
+			}
+		}
+
+		for (std::uint32_t id : ParseList(online))
+		{
+			const fs::path cpuPath = cpuRoot / ("cpu" + std::to_string(id));
+
+			LogicalProcessor& processor = someProcessors.emplace_back();
+
+			processor.id		= id;
+			processor.package	= ReadNumber(cpuPath / "topology/physical_package_id", 0);
+			processor.core		= ReadNumber(cpuPath / "topology/core_id", id); // only unique within the package, made unique in Finalize
+			processor.cache		= processor.package;
+			processor.node		= nodes.contains(id) ? nodes[id] : 0;
+
+			for (const auto& entry : fs::directory_iterator(cpuPath / "cache", error))
+			{
+				if (ReadNumber(entry.path() / "level", 0) != 3)
+					continue;
+
+				std::string shared;
+				if (ReadLine(entry.path() / "shared_cpu_list", shared))
+				{
+					const std::vector<std::uint32_t> sharing = ParseList(shared);
+					if (!sharing.empty())
+						processor.cache = *std::min_element(sharing.begin(), sharing.end()); // identify the domain by its first processor
+				}
+
+				break;
+			}
+		}
+
+		return !someProcessors.empty();
+	}
+
+#else
+
+	bool DetectProcessors(std::vector<LogicalProcessor>&)
+	{
+		return false;
+	}
+
+#endif
+
+	/// Remaps the values in the range to 0..N-1 in order of their keys.
+	///
+	template<typename Key, typename GetKey, typename SetValue>
+	std::size_t Densify(std::vector<LogicalProcessor>& someProcessors, GetKey&& aGetKey, SetValue&& aSetValue)
+	{
+		std::map<Key, std::uint32_t> indices;
+		for (const LogicalProcessor& processor : someProcessors)
+		{
+			indices.try_emplace(aGetKey(processor), 0);
+		}
+
+		std::uint32_t next = 0;
+		for (auto& [key, index] : indices)
+		{
+			index = next++;
+		}
+
+		for (LogicalProcessor& processor : someProcessors)
+		{
+			aSetValue(processor, indices[aGetKey(processor)]);
+		}
+
+		return indices.size();
+	}
+}
+
+const CpuTopology& CpuTopology::Get()
+{
+	static const CpuTopology topology = Detect();
+	return topology;
+}
+
+CpuTopology CpuTopology::Detect()
+{
+	CpuTopology topology;
+
+	if (!DetectProcessors(topology.myProcessors))
+	{
+		topology.myProcessors.clear();
+
+		const std::uint32_t count = (std::max)(std::thread::hardware_concurrency(), 1u);
+		for (std::uint32_t i = 0; i < count; ++i)
+		{
+			LogicalProcessor& processor = topology.myProcessors.emplace_back();
+			processor.id	= i;
+			processor.core	= i;
+		}
+	}
+
+	topology.Finalize();
+
+	return topology;
+}
+
+const std::vector<LogicalProcessor>& CpuTopology::GetProcessors() const noexcept
+{
+	return myProcessors;
+}
+
+std::size_t CpuTopology::GetCoreCount() const noexcept
+{
+	return myCoreCount;
+}
+std::size_t CpuTopology::GetPackageCount() const noexcept
+{
+	return myPackageCount;
+}
+std::size_t CpuTopology::GetNodeCount() const noexcept
+{
+	return myNodeCount;
+}
+
+const LogicalProcessor* CpuTopology::Find(std::uint32_t aID) const noexcept
+{
+	const auto it = std::lower_bound(myProcessors.begin(), myProcessors.end(), aID,
+		[](const LogicalProcessor& aProcessor, std::uint32_t aValue) { return aProcessor.id < aValue; });
+
+	return (it != myProcessors.end() && it->id == aID) ? &*it : nullptr;
+}
+
+std::vector<LogicalProcessor> CpuTopology::Assign(const PlacementPolicy& aPolicy, std::size_t aThreadCount) const
+{
+	if (aPolicy.placement == Placement::None || myProcessors.empty())
+		return {};
+
+	const std::vector<LogicalProcessor> reserved = GetReserved(aPolicy);
+
+	std::vector<LogicalProcessor> available;
+	for (const LogicalProcessor& processor : Order(aPolicy.placement))
+	{
+		const bool isReserved = std::any_of(reserved.begin(), reserved.end(),
+			[&processor](const LogicalProcessor& aReserved) { return aReserved.id == processor.id; });
+
+		if (!isReserved)
+			available.emplace_back(processor);
+	}
+
+	if (available.empty()) // reserved everything, better to share than to not run at all
+		available = Order(aPolicy.placement);
+
+	std::vector<LogicalProcessor> result;
+	result.reserve(aThreadCount);
+
+	for (std::size_t i = 0; i < aThreadCount; ++i)
+	{
+		result.emplace_back(available[i % available.size()]);
+	}
+
+	return result;
+}
+
+std::vector<LogicalProcessor> CpuTopology::GetReserved(const PlacementPolicy& aPolicy) const
+{
+	std::vector<LogicalProcessor> result;
+	if (aPolicy.reservedCores == 0)
+		return result;
+
+	std::set<std::uint32_t> cores;
+	for (const LogicalProcessor& processor : Order(Placement::Compact))
+	{
+		if (cores.size() == aPolicy.reservedCores && !cores.contains(processor.core))
+			continue;
+
+		cores.insert(processor.core);
+		result.emplace_back(processor); // includes SMT siblings of the reserved cores
+	}
+
+	return result;
+}
+
+bool CpuTopology::SetThreadAffinity(std::uint32_t aID)
+{
+#if defined(COMMON_UTILITIES_SYSTEM_WIN)
+	GROUP_AFFINITY affinity{};
+	affinity.Group	= static_cast<WORD>(aID / 64);
+	affinity.Mask	= KAFFINITY(1) << (aID % 64);
+
+	return SetThreadGroupAffinity(GetCurrentThread(), &affinity, nullptr) != 0;
+#elif defined(COMMON_UTILITIES_SYSTEM_LINUX)
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	CPU_SET(aID, &set);
+
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+	return false;
+#endif
+}
+
+std::uint32_t CpuTopology::GetCurrentProcessor()
+{
+#if defined(COMMON_UTILITIES_SYSTEM_WIN)
+	PROCESSOR_NUMBER number{};
+	GetCurrentProcessorNumberEx(&number);
+
+	return static_cast<std::uint32_t>(number.Group) * 64 + number.Number;
+#elif defined(COMMON_UTILITIES_SYSTEM_LINUX)
+	const int cpu = sched_getcpu();
+	return cpu < 0 ? 0 : static_cast<std::uint32_t>(cpu);
+#else
+	return 0;
+#endif
+}
+
+std::uint32_t CpuTopology::GetCurrentNode() const
+{
+	const LogicalProcessor* processor = Find(GetCurrentProcessor());
+	return processor ? processor->node : 0;
+}
+
+void CpuTopology::Finalize()
+{
+	std::sort(myProcessors.begin(), myProcessors.end(),
+		[](const LogicalProcessor& aLeft, const LogicalProcessor& aRight) { return aLeft.id < aRight.id; });
+
+	myCoreCount = Densify<std::pair<std::uint32_t, std::uint32_t>>(myProcessors,
+		[](const LogicalProcessor& aProcessor) { return std::make_pair(aProcessor.package, aProcessor.core); },
+		[](LogicalProcessor& aProcessor, std::uint32_t aIndex) { aProcessor.core = aIndex; });
+
+	Densify<std::pair<std::uint32_t, std::uint32_t>>(myProcessors,
+		[](const LogicalProcessor& aProcessor) { return std::make_pair(aProcessor.package, aProcessor.cache); },
+		[](LogicalProcessor& aProcessor, std::uint32_t aIndex) { aProcessor.cache = aIndex; });
+
+	myPackageCount = Densify<std::uint32_t>(myProcessors,
+		[](const LogicalProcessor& aProcessor) { return aProcessor.package; },
+		[](LogicalProcessor& aProcessor, std::uint32_t aIndex) { aProcessor.package = aIndex; });
+
+	std::set<std::uint32_t> nodes; // keep the node numbers used by the OS, since they are what NUMA APIs expect
+	for (const LogicalProcessor& processor : myProcessors)
+	{
+		nodes.insert(processor.node);
+	}
+	myNodeCount = nodes.size();
+
+	std::map<std::uint32_t, std::uint32_t> siblings; // processors seen per core so far, in id order
+	for (LogicalProcessor& processor : myProcessors)
+	{
+		processor.smt = siblings[processor.core]++;
+	}
+}
+
+std::vector<LogicalProcessor> CpuTopology::Order(Placement aPlacement) const
+{
+	std::vector<LogicalProcessor> result = myProcessors;
+
+	const auto CompactKey = [](const LogicalProcessor& aProcessor)
+	{
+		return std::make_tuple(aProcessor.package, aProcessor.node, aProcessor.cache, aProcessor.smt, aProcessor.core, aProcessor.id);
+	};
+
+	std::sort(result.begin(), result.end(), [&CompactKey](const LogicalProcessor& aLeft, const LogicalProcessor& aRight)
+	{
+		return CompactKey(aLeft) < CompactKey(aRight);
+	});
+
+	if (aPlacement != Placement::Spread)
+		return result;
+
+	// rank each processor within its socket, then interleave the sockets rank by rank
+
+	std::map<std::pair<std::uint32_t, std::uint32_t>, std::uint32_t> ranks;
+	std::vector<std::uint32_t> rankOf(result.size());
+
+	for (std::size_t i = 0; i < result.size(); ++i)
+	{
+		rankOf[i] = ranks[{ result[i].package, result[i].smt }]++;
+	}
+
+	std::vector<std::size_t> order(result.size());
+	for (std::size_t i = 0; i < order.size(); ++i)
+	{
+		order[i] = i;
+	}
+
+	std::sort(order.begin(), order.end(), [&result, &rankOf](std::size_t aLeft, std::size_t aRight)
+	{
+		return std::make_tuple(result[aLeft].smt, rankOf[aLeft], result[aLeft].package) <
+			   std::make_tuple(result[aRight].smt, rankOf[aRight], result[aRight].package);
+	});
+
+	std::vector<LogicalProcessor> spread;
+	spread.reserve(result.size());
+
+	for (std::size_t index : order)
+	{
+		spread.emplace_back(result[index]);
+	}
+
+	return spread;
+}
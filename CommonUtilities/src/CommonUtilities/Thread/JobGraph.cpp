@@ -0,0 +1,120 @@
+#include <CommonUtilities/Thread/JobGraph.h>
+
+#include <cassert>
+
+using namespace CommonUtilities;
+
+JobGraph::JobGraph(ThreadPool& aPool)
+    : myGroup(aPool)
+{
+
+}
+
+JobGraph::~JobGraph() = default; // group waits for any running jobs
+
+auto JobGraph::Add(JobFunction&& aFunc) -> JobID
+{
+    assert(IsDone() && "Jobs may not be added while the graph is running");
+
+    myJobs.emplace_back().func = std::move(aFunc);
+    return myJobs.size() - 1;
+}
+
+void JobGraph::Precede(JobID aJob, JobID aSuccessor)
+{
+    assert(IsDone() && "Dependencies may not be added while the graph is running");
+    assert(aJob < myJobs.size() && aSuccessor < myJobs.size() && aJob != aSuccessor);
+
+    myJobs[aJob].successors.emplace_back(aSuccessor);
+    ++myJobs[aSuccessor].dependencies;
+}
+
+void JobGraph::Precede(JobID aJob, std::initializer_list<JobID> someSuccessors)
+{
+    for (const JobID successor : someSuccessors)
+    {
+        Precede(aJob, successor);
+    }
+}
+
+void JobGraph::Succeed(JobID aJob, std::initializer_list<JobID> someDependencies)
+{
+    for (const JobID dependency : someDependencies)
+    {
+        Precede(dependency, aJob);
+    }
+}
+
+void JobGraph::Run()
+{
+    assert(IsDone() && "Graph is already running");
+
+    for (Job& job : myJobs)
+    {
+        job.remaining.store(job.dependencies, std::memory_order_relaxed);
+    }
+
+    for (JobID i = 0; i < myJobs.size(); ++i)
+    {
+        if (myJobs[i].dependencies == 0)
+        {
+            myGroup.Run([this, i] { Execute(i); });
+        }
+    }
+}
+
+void JobGraph::Wait()
+{
+    myGroup.Wait();
+}
+
+void JobGraph::RunAndWait()
+{
+    Run();
+    Wait();
+}
+
+bool JobGraph::IsDone() const noexcept
+{
+    return myGroup.IsDone();
+}
+
+std::size_t JobGraph::Count() const noexcept
+{
+    return myJobs.size();
+}
+
+void JobGraph::Clear()
+{
+    assert(IsDone() && "Jobs may not be removed while the graph is running");
+    myJobs.clear();
+}
+
+void JobGraph::Execute(JobID aJob)
+{
+    // continue directly with one of the successors that became ready, saves a round trip through the pool
+
+    JobID current = aJob;
+    while (current != NULL_JOB)
+    {
+        Job& job = myJobs[current];
+        job.func();
+
+        current = NULL_JOB;
+
+        for (const JobID successor : job.successors)
+        {
+            if (myJobs[successor].remaining.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                continue;
+
+            if (current == NULL_JOB)
+            {
+                current = successor;
+            }
+            else
+            {
+                myGroup.Run([this, successor] { Execute(successor); });
+            }
+        }
+    }
+}
@@ -0,0 +1,119 @@
+#include <CommonUtilities/Thread/TaskGroup.h>
+
+#include <algorithm>
+#include <chrono>
+
+using namespace CommonUtilities;
+
+static constexpr std::size_t SPIN_COUNT = 64; // failed attempts at finding work before backing off
+
+static constexpr std::chrono::microseconds MIN_BACKOFF(50);
+static constexpr std::chrono::microseconds MAX_BACKOFF(1000);
+
+TaskGroup::TaskGroup(ThreadPool& aPool)
+    : myPool(&aPool)
+{
+
+}
+
+TaskGroup::~TaskGroup()
+{
+    try
+    {
+        Wait();
+    }
+    catch (...)
+    {
+        // nowhere to report it from a destructor, call Wait before if exceptions are of interest
+    }
+}
+
+void TaskGroup::Wait()
+{
+    // keeps helping until no task is left, finding no work may be spurious as the shared queue is only
+    // try-locked, and giving up could leave a nested group's tasks with no free worker to run them
+
+    std::size_t attempts = 0;
+    std::chrono::microseconds backoff = MIN_BACKOFF;
+
+    while (myPending.load(std::memory_order_acquire) != 0)
+    {
+        if (myPool->RunPendingTask())
+        {
+            attempts = 0;
+            backoff = MIN_BACKOFF;
+        }
+        else if (++attempts < SPIN_COUNT)
+        {
+            std::this_thread::yield();
+        }
+        else
+        {
+            // the last task to finish wakes us up early, otherwise look for work again after a while
+
+            std::unique_lock<std::mutex> lock(myMutex);
+            myCV.wait_for(lock, backoff, [this]
+            {
+                return myPending.load(std::memory_order_acquire) == 0;
+            });
+
+            backoff = (std::min)(backoff * 2, MAX_BACKOFF);
+        }
+    }
+
+    std::exception_ptr exception;
+    {
+        // also waits for the last task to leave Finish so that the group may safely be destroyed after
+        std::unique_lock<std::mutex> lock(myMutex);
+        myCV.wait(lock, [this]
+        {
+            return myPending.load(std::memory_order_acquire) == 0 && myBusyCount == myIdleCount;
+        });
+
+        exception = std::exchange(myException, nullptr);
+    }
+
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+}
+
+bool TaskGroup::IsDone() const noexcept
+{
+    return myPending.load(std::memory_order_acquire) == 0;
+}
+
+ThreadPool& TaskGroup::GetPool() const noexcept
+{
+    return *myPool;
+}
+
+void TaskGroup::Begin()
+{
+    if (myPending.fetch_add(1, std::memory_order_acq_rel) == 0)
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        ++myBusyCount;
+        myCV.notify_all(); // the task may already have finished and counted itself as idle
+    }
+}
+
+void TaskGroup::Finish() noexcept
+{
+    if (myPending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        ++myIdleCount;
+        myCV.notify_all(); // notify under the lock, the group may be destroyed as soon as it is released
+    }
+}
+
+void TaskGroup::CaptureException(std::exception_ptr aException) noexcept
+{
+    std::lock_guard<std::mutex> lock(myMutex);
+    if (!myException)
+    {
+        myException = std::move(aException);
+    }
+}
@@ -14,15 +14,29 @@ ThreadLoops::~ThreadLoops()
     Shutdown();
 }
 
-void ThreadLoops::Start(std::size_t aThreadCount)
+void ThreadLoops::Start(std::size_t aThreadCount, WakeMode aWakeMode, std::size_t aSpinCount, const PlacementPolicy& aPlacement)
 {
     if (!myShutdown || !myThreads.empty())
         return;
 
     myShutdown = false;
+    myWakeMode = aWakeMode;
+    mySpinCount = aSpinCount;
 
     myThreads.reserve(aThreadCount);
-    myDispatchedLoops.resize(aThreadCount);
+    myLoopTasks.reserve(aThreadCount); // loop threads read their task without locking, so it should never move
+    myLoopStates = std::make_unique<LoopState[]>(aThreadCount);
+    myPlacements = CpuTopology::Get().Assign(aPlacement, aThreadCount);
+
+    myLoopTasks.for_each_valid([this, aThreadCount](std::size_t aLoopID, LoopTask& aTask)
+    {
+        if (aLoopID < aThreadCount) // tasks set before a previous shutdown
+            myLoopStates[aLoopID].task.store(&aTask, std::memory_order_relaxed);
+    });
+
+#if COMMON_UTILITIES_THREAD_STATS
+    myStatsStart = details::threadstats::Now();
+#endif
 
     for (std::size_t i = 0; i < aThreadCount; ++i)
     {
@@ -41,7 +55,18 @@ void ThreadLoops::Shutdown()
 
     myCV.notify_all();
 
+    if (myWakeMode == WakeMode::Atomic)
+    {
+        for (std::size_t i = 0; i < myThreads.size(); ++i)
+        {
+            myLoopStates[i].dispatched.fetch_add(1, std::memory_order_release); // wake the loop so that it sees the shutdown
+            myLoopStates[i].dispatched.notify_one();
+        }
+    }
+
     myThreads.clear();
+    myLoopStates.reset();
+    myPlacements.clear();
 }
 
 ThreadLoops::ThreadException ThreadLoops::GetLastException()
@@ -58,6 +83,43 @@ ThreadLoops::ThreadException ThreadLoops::GetLastException()
     return e;
 }
 
+std::optional<LogicalProcessor> ThreadLoops::GetLoopPlacement(LoopID aLoopID) const
+{
+    if (aLoopID >= myPlacements.size())
+        return std::nullopt;
+
+    return myPlacements[aLoopID];
+}
+
+auto ThreadLoops::GetStats() const -> Stats
+{
+    Stats stats;
+
+#if COMMON_UTILITIES_THREAD_STATS
+    stats.elapsed = std::chrono::nanoseconds(details::threadstats::Now() - myStatsStart.load(std::memory_order_relaxed));
+
+    stats.loops.resize(myThreads.size());
+    for (std::size_t i = 0; i < myThreads.size(); ++i)
+    {
+        myLoopStates[i].counters.Snapshot(stats.loops[i]);
+        stats.total.Merge(stats.loops[i]);
+    }
+#endif
+
+    return stats;
+}
+
+void ThreadLoops::ResetStats()
+{
+#if COMMON_UTILITIES_THREAD_STATS
+    for (std::size_t i = 0; i < myThreads.size(); ++i)
+    {
+        myLoopStates[i].counters.Reset();
+    }
+    myStatsStart = details::threadstats::Now();
+#endif
+}
+
 LoopID ThreadLoops::SetLoopTask(const std::function<void()>& aTask, const ExceptionCallback& aOnException)
 {
     std::lock_guard lock(myMutex);
@@ -67,62 +129,203 @@ LoopID ThreadLoops::SetLoopTask(const std::function<void()>& aTask, const Except
         throw std::runtime_error("More tasks than threads!");
     }
 
-	return myLoopTasks.emplace(aTask, aOnException);
+    const LoopID loopID = myLoopTasks.emplace(aTask, aOnException);
+    if (loopID < myThreads.size()) // otherwise left over from before a restart with fewer threads, and never run
+        myLoopStates[loopID].task.store(&myLoopTasks[loopID], std::memory_order_release);
+
+    return loopID;
 }
 
 void ThreadLoops::RemoveLoopTask(LoopID aLoopID)
 {
     std::lock_guard lock(myMutex);
+
+    if (aLoopID < myThreads.size())
+        myLoopStates[aLoopID].task.store(nullptr, std::memory_order_release);
+
     myLoopTasks.erase(aLoopID);
 }
 
 void ThreadLoops::DispatchLoop(LoopID aLoopID)
 {
+    LoopState& state = myLoopStates[aLoopID];
+
+#if COMMON_UTILITIES_THREAD_STATS
+    state.dispatchTime.store(details::threadstats::Now(), std::memory_order_relaxed);
+#endif
+
+    if (myWakeMode == WakeMode::Atomic)
     {
-        std::lock_guard lock(myMutex);
-        myDispatchedLoops[aLoopID] = true;
+        state.dispatched.fetch_add(1, std::memory_order_release);
+        state.dispatched.notify_one();
+    }
+    else
+    {
+        {
+            std::lock_guard lock(myMutex);
+            state.dispatched.fetch_add(1, std::memory_order_release);
+        }
+        myCV.notify_all();
     }
-    myCV.notify_all();
 }
 
-void ThreadLoops::ThreadLoop(LoopID aLoopID)
+void ThreadLoops::DispatchAll()
 {
-    while (true)
+#if COMMON_UTILITIES_THREAD_STATS
+    const std::uint64_t now = details::threadstats::Now();
+    for (std::size_t i = 0; i < myThreads.size(); ++i)
     {
-        {
-            std::unique_lock<std::mutex> lock(myMutex);
+        myLoopStates[i].dispatchTime.store(now, std::memory_order_relaxed);
+    }
+#endif
 
-            myCV.wait(lock, [this, &aLoopID]
+    if (myWakeMode == WakeMode::Atomic)
+    {
+        for (std::size_t i = 0; i < myThreads.size(); ++i)
+        {
+            myLoopStates[i].dispatched.fetch_add(1, std::memory_order_release);
+            myLoopStates[i].dispatched.notify_one();
+        }
+    }
+    else
+    {
+        {
+            std::lock_guard lock(myMutex);
+            for (std::size_t i = 0; i < myThreads.size(); ++i)
             {
-                return myDispatchedLoops[aLoopID] || myShutdown;
-            });
+                myLoopStates[i].dispatched.fetch_add(1, std::memory_order_release);
+            }
+        }
+        myCV.notify_all();
+    }
+}
 
-            if (myShutdown)
-                break;
+void ThreadLoops::WaitLoop(LoopID aLoopID)
+{
+    LoopState& state = myLoopStates[aLoopID];
 
-            myDispatchedLoops[aLoopID] = false;
-        }
+    const std::uint32_t target = state.dispatched.load(std::memory_order_acquire);
+    std::uint32_t finished = state.finished.load(std::memory_order_acquire);
 
-        auto& loopTask = myLoopTasks[aLoopID];
+    const auto IsDone = [&target](std::uint32_t aFinished)
+    {
+        return static_cast<std::int32_t>(aFinished - target) >= 0; // counters may wrap around
+    };
 
-        if (!loopTask.callback)
-            continue;
+    for (std::size_t i = 0; i < mySpinCount && !IsDone(finished); ++i)
+    {
+        YieldProcessor();
+        finished = state.finished.load(std::memory_order_acquire);
+    }
 
-        try
+    while (!IsDone(finished))
+    {
+        state.finished.wait(finished, std::memory_order_acquire);
+        finished = state.finished.load(std::memory_order_acquire);
+    }
+}
+
+void ThreadLoops::WaitAll()
+{
+    for (std::size_t i = 0; i < myThreads.size(); ++i)
+    {
+        WaitLoop(i);
+    }
+}
+
+std::uint32_t ThreadLoops::WaitForDispatch(LoopState& aState, std::uint32_t aFinished)
+{
+    if (myWakeMode == WakeMode::Atomic)
+    {
+        for (std::size_t i = 0; i < mySpinCount; ++i)
         {
-            loopTask.callback();
+            const std::uint32_t dispatched = aState.dispatched.load(std::memory_order_acquire);
+            if (dispatched != aFinished)
+                return dispatched;
+
+            YieldProcessor();
         }
-        catch (std::exception& e)
+
+        std::uint32_t dispatched = aState.dispatched.load(std::memory_order_acquire);
+        while (dispatched == aFinished)
         {
-            {
-                std::scoped_lock lock(myExceptionMutex);
-                myExceptions.emplace(GetCurrentThread(), std::current_exception());
-            }
+            aState.dispatched.wait(aFinished, std::memory_order_acquire);
+            dispatched = aState.dispatched.load(std::memory_order_acquire);
+        }
 
-            if (loopTask.exceptionCallback)
-            {
-                loopTask.exceptionCallback(e);
-            }
+        return dispatched;
+    }
+
+    std::unique_lock<std::mutex> lock(myMutex);
+
+    myCV.wait(lock, [this, &aState, aFinished]
+    {
+        return aState.dispatched.load(std::memory_order_relaxed) != aFinished || myShutdown;
+    });
+
+    return aState.dispatched.load(std::memory_order_relaxed);
+}
+
+void ThreadLoops::ThreadLoop(LoopID aLoopID)
+{
+    if (aLoopID < myPlacements.size())
+    {
+        CpuTopology::SetThreadAffinity(myPlacements[aLoopID].id);
+    }
+
+    LoopState& state = myLoopStates[aLoopID];
+    std::uint32_t finished = 0;
+
+    while (true)
+    {
+        const std::uint32_t dispatched = WaitForDispatch(state, finished);
+
+        if (myShutdown)
+            break;
+
+#if COMMON_UTILITIES_THREAD_STATS
+        const std::uint64_t startTime = details::threadstats::Now();
+        RunLoopTask(aLoopID);
+        const std::uint64_t endTime = details::threadstats::Now();
+
+        const std::uint64_t dispatchTime = state.dispatchTime.load(std::memory_order_relaxed);
+        state.counters.AddExecuted(startTime > dispatchTime ? startTime - dispatchTime : 0, endTime - startTime);
+#else
+        RunLoopTask(aLoopID);
+#endif
+
+        finished = dispatched; // dispatches made while running will run the loop again
+
+        state.finished.store(finished, std::memory_order_release);
+        state.finished.notify_all();
+    }
+}
+
+void ThreadLoops::RunLoopTask(LoopID aLoopID)
+{
+    LoopTask* task = myLoopStates[aLoopID].task.load(std::memory_order_acquire);
+    if (!task)
+        return;
+
+    auto& loopTask = *task;
+
+    if (!loopTask.callback)
+        return;
+
+    try
+    {
+        loopTask.callback();
+    }
+    catch (std::exception& e)
+    {
+        {
+            std::scoped_lock lock(myExceptionMutex);
+            myExceptions.emplace(GetCurrentThread(), std::current_exception());
+        }
+
+        if (loopTask.exceptionCallback)
+        {
+            loopTask.exceptionCallback(e);
         }
     }
-}
\ No newline at end of file
+}
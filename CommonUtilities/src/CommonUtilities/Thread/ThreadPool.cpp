@@ -1,9 +1,151 @@
 #include <CommonUtilities/Thread/ThreadPool.h>
 
+#include <array>
+#include <bit>
+
 #include <CommonUtilities/System/WindowsHeader.h>
 
 using namespace CommonUtilities;
 
+static thread_local ThreadPool* locCurrentPool  = nullptr; // pool that owns the calling thread, if any
+static thread_local std::size_t locWorkerIndex  = ThreadPool::NULL_WORKER;
+static thread_local std::string locThreadName;              // name last given to the calling thread
+static thread_local std::uint64_t locStealSeed  = 0x2545F4914F6CDD1DULL;
+
+namespace
+{
+    inline constexpr std::size_t MIN_BLOCK_SIZE     = 64;
+    inline constexpr std::size_t SIZE_CLASS_COUNT   = 4;    // 64, 128, 256, and 512 bytes
+    inline constexpr std::size_t MAX_CACHED_BLOCKS  = 64;   // per size class and thread
+    inline constexpr std::size_t TRANSFER_BATCH     = 32;   // blocks moved between a thread cache and the shared list at once
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct FreeList
+    {
+        FreeBlock*  head    {nullptr};
+        std::size_t count   {0};
+
+        void Push(FreeBlock* aBlock) noexcept
+        {
+            aBlock->next = head;
+            head = aBlock;
+            ++count;
+        }
+
+        FreeBlock* Pop() noexcept
+        {
+            FreeBlock* block = head;
+            if (block)
+            {
+                head = block->next;
+                --count;
+            }
+            return block;
+        }
+    };
+
+    struct SharedFreeList
+    {
+        std::mutex  mutex;
+        FreeList    list;
+    };
+
+    std::array<SharedFreeList, SIZE_CLASS_COUNT> locSharedBlocks;
+
+    struct BlockCache
+    {
+        std::array<FreeList, SIZE_CLASS_COUNT> lists;
+
+        ~BlockCache()
+        {
+            for (std::size_t i = 0; i < SIZE_CLASS_COUNT; ++i)
+            {
+                std::lock_guard<std::mutex> lock(locSharedBlocks[i].mutex);
+                while (FreeBlock* block = lists[i].Pop())
+                {
+                    locSharedBlocks[i].list.Push(block);
+                }
+            }
+        }
+    };
+
+    thread_local BlockCache locBlockCache;
+
+    std::size_t SizeClass(std::size_t aNumBytes) noexcept
+    {
+        return static_cast<std::size_t>(std::bit_width((std::max<std::size_t>(aNumBytes, 1) - 1) / MIN_BLOCK_SIZE));
+    }
+}
+
+static std::uint64_t NextRandom(std::uint64_t& aState)
+{
+    // xorshift64, cheap enough to pick a victim on every steal attempt
+    aState ^= aState << 13;
+    aState ^= aState >> 7;
+    aState ^= aState << 17;
+    return aState;
+}
+
+void* details::threadpool::Allocate(std::size_t aNumBytes)
+{
+    const std::size_t sizeClass = SizeClass(aNumBytes);
+    if (sizeClass >= SIZE_CLASS_COUNT)
+        return ::operator new(aNumBytes);
+
+    FreeList& local = locBlockCache.lists[sizeClass];
+
+    if (local.head == nullptr) // refill from blocks released by other threads
+    {
+        SharedFreeList& shared = locSharedBlocks[sizeClass];
+
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        for (std::size_t i = 0; i < TRANSFER_BATCH; ++i)
+        {
+            FreeBlock* block = shared.list.Pop();
+            if (!block)
+                break;
+
+            local.Push(block);
+        }
+    }
+
+    if (FreeBlock* block = local.Pop())
+        return block;
+
+    return ::operator new(MIN_BLOCK_SIZE << sizeClass);
+}
+
+void details::threadpool::Deallocate(void* aMemory, std::size_t aNumBytes) noexcept
+{
+    if (!aMemory)
+        return;
+
+    const std::size_t sizeClass = SizeClass(aNumBytes);
+    if (sizeClass >= SIZE_CLASS_COUNT)
+    {
+        ::operator delete(aMemory);
+        return;
+    }
+
+    FreeList& local = locBlockCache.lists[sizeClass];
+    local.Push(static_cast<FreeBlock*>(aMemory));
+
+    if (local.count > MAX_CACHED_BLOCKS) // blocks are often freed on another thread than they were allocated on, give them back
+    {
+        SharedFreeList& shared = locSharedBlocks[sizeClass];
+
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        for (std::size_t i = 0; i < TRANSFER_BATCH; ++i)
+        {
+            shared.list.Push(local.Pop());
+        }
+    }
+}
+
 ThreadPool::ThreadPool() = default;
 
 ThreadPool::~ThreadPool()
@@ -11,17 +153,45 @@ ThreadPool::~ThreadPool()
     Shutdown();
 }
 
-void ThreadPool::Start(std::size_t aThreadCount)
+void ThreadPool::Start(std::size_t aThreadCount, Scheduling aScheduling, const std::string& aThreadName, const PlacementPolicy& aPlacement)
 {
     if (!myShutdown || !myThreads.empty())
         return;
 
     myShutdown = false;
+    myScheduling = aScheduling;
+    myPlacements = CpuTopology::Get().Assign(aPlacement, aThreadCount);
+
+#if COMMON_UTILITIES_THREAD_STATS
+    myCounters.clear();
+    for (std::size_t i = 0; i < aThreadCount + 1; ++i)
+    {
+        myCounters.emplace_back(std::make_unique<details::threadstats::WorkerCounters>());
+    }
+    myStatsStart = details::threadstats::Now();
+#endif
+
+    if (myScheduling == Scheduling::WorkStealing)
+    {
+        myWorkers.reserve(aThreadCount);
+        for (std::size_t i = 0; i < aThreadCount; ++i)
+        {
+            auto& worker = myWorkers.emplace_back(std::make_unique<Worker>());
+            worker->seed = 0x9E3779B97F4A7C15ULL * (i + 1);
+        }
+    }
 
     myThreads.reserve(aThreadCount);
     for (std::size_t i = 0; i < aThreadCount; ++i)
     {
-        myThreads.emplace_back(&ThreadPool::ThreadLoop, this);
+        if (myScheduling == Scheduling::WorkStealing)
+        {
+            myThreads.emplace_back(&ThreadPool::WorkStealingLoop, this, i, aThreadName);
+        }
+        else
+        {
+            myThreads.emplace_back(&ThreadPool::ThreadLoop, this, i, aThreadName);
+        }
     }
 }
 
@@ -36,33 +206,436 @@ void ThreadPool::Shutdown()
     }
 
     myCV.notify_all();
-    
+
     myThreads.clear();
+    myWorkers.clear();
+    myPlacements.clear();
+}
+
+auto ThreadPool::GetScheduling() const noexcept -> Scheduling
+{
+    return myScheduling;
+}
+
+std::size_t ThreadPool::GetThreadCount() const noexcept
+{
+    return myThreads.size();
+}
+
+std::optional<LogicalProcessor> ThreadPool::GetWorkerPlacement(std::size_t aWorkerIndex) const
+{
+    if (aWorkerIndex >= myPlacements.size())
+        return std::nullopt;
+
+    return myPlacements[aWorkerIndex];
+}
+
+double ThreadPool::Stats::GetTasksPerSecond() const noexcept
+{
+    if (elapsed.count() <= 0)
+        return 0.0;
+
+    return static_cast<double>(total.tasksExecuted) / std::chrono::duration<double>(elapsed).count();
+}
+
+auto ThreadPool::GetStats() const -> Stats
+{
+    Stats stats;
+
+    for (std::size_t i = 0; i < PRIORITY_COUNT; ++i)
+    {
+        const auto lane = static_cast<Priority>(i);
+        stats.queueDepths[lane] = GetQueueDepth(lane);
+    }
+
+#if COMMON_UTILITIES_THREAD_STATS
+    stats.elapsed = std::chrono::nanoseconds(details::threadstats::Now() - myStatsStart.load(std::memory_order_relaxed));
+
+    stats.workers.resize(myCounters.size());
+    for (std::size_t i = 0; i < myCounters.size(); ++i)
+    {
+        myCounters[i]->Snapshot(stats.workers[i]);
+        stats.total.Merge(stats.workers[i]);
+    }
+#endif
+
+    return stats;
+}
+
+void ThreadPool::ResetStats()
+{
+#if COMMON_UTILITIES_THREAD_STATS
+    for (auto& counters : myCounters)
+    {
+        counters->Reset();
+    }
+    myStatsStart = details::threadstats::Now();
+#endif
+}
+
+std::size_t ThreadPool::GetCurrentWorkerIndex() noexcept
+{
+    return locWorkerIndex;
+}
+
+std::size_t ThreadPool::GetQueueDepth(Priority aPriority) const noexcept
+{
+    return myQueueDepths[aPriority].load(std::memory_order_relaxed);
+}
+
+auto ThreadPool::CreateTask(TaskFunction&& aFunc, std::string&& aThreadName) -> Task*
+{
+    void* memory = details::threadpool::Allocate(sizeof(Task));
+    return ::new (memory) Task{ .func = std::move(aFunc), .name = std::move(aThreadName), .stopToken = {} };
+}
+
+auto ThreadPool::CreateTask(TaskFunction&& aFunc, TaskOptions&& aOptions) -> Task*
+{
+    void* memory = details::threadpool::Allocate(sizeof(Task));
+    return ::new (memory) Task{ .func = std::move(aFunc), .name = std::move(aOptions.threadName), .stopToken = std::move(aOptions.stopToken), .priority = aOptions.priority };
+}
+
+void ThreadPool::DestroyTask(Task* aTask) noexcept
+{
+    aTask->~Task();
+    details::threadpool::Deallocate(aTask, sizeof(Task));
+}
+
+void ThreadPool::Push(Task* aTask)
+{
+#if COMMON_UTILITIES_THREAD_STATS
+    aTask->enqueueTime = details::threadstats::Now();
+#endif
+
+    if (myScheduling == Scheduling::WorkStealing && locCurrentPool == this && aTask->priority == Priority::Normal)
+    {
+        if (myShutdown)
+        {
+            DestroyTask(aTask);
+            throw std::runtime_error("Thread pool has shut down, no more tasks can be added");
+        }
+
+        // submitted from one of our own workers, place it in its local deque without locking. Other
+        // lanes go through the shared queues so that they are ordered against everything else
+
+        myQueueDepths[aTask->priority].fetch_add(1, std::memory_order_relaxed);
+        myPendingTasks.fetch_add(1);
+        myWorkers[locWorkerIndex]->tasks.push(aTask);
+
+        if (mySleepingWorkers.load() != 0)
+        {
+            std::lock_guard<std::mutex> lock(myMutex); // a worker may be between checking for work and going to sleep
+        }
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(myMutex); // lock to synchronize access to tasks
+
+        if (myShutdown)
+        {
+            DestroyTask(aTask);
+            throw std::runtime_error("Thread pool has shut down, no more tasks can be added");
+        }
+
+        myQueueDepths[aTask->priority].fetch_add(1, std::memory_order_relaxed);
+        PushGlobal(aTask);
+        myPendingTasks.fetch_add(1);
+    }
+
+    myCV.notify_one(); // notify a thread that a task is available
+}
+
+auto ThreadPool::FindTask(std::size_t aWorkerIndex) -> Task*
+{
+    // critical tasks only ever live in the shared queue, check it before our own deque when there are any
+
+    if (myQueueDepths[Priority::Critical].load(std::memory_order_relaxed) != 0)
+    {
+        if (Task* task = PopGlobalTask(Priority::Normal))
+            return task;
+    }
+
+    if (auto task = myWorkers[aWorkerIndex]->tasks.pop())
+    {
+        myPendingTasks.fetch_sub(1);
+        return *task;
+    }
+
+    if (Task* task = PopGlobalTask(Priority::Normal))
+        return task;
+
+    if (Task* task = StealTask(aWorkerIndex, myWorkers[aWorkerIndex]->seed))
+        return task;
+
+    return PopGlobalTask(Priority::Background); // nothing else to do
+}
+
+auto ThreadPool::StealTask(std::size_t aSkipIndex, std::uint64_t& aSeed) -> Task*
+{
+    const std::size_t workerCount = myWorkers.size();
+    if (workerCount == 0)
+        return nullptr;
+
+    const std::size_t start = NextRandom(aSeed) % workerCount;
+
+    for (std::size_t i = 0; i < workerCount; ++i)
+    {
+        const std::size_t victim = (start + i) % workerCount;
+        if (victim == aSkipIndex)
+            continue;
+
+        if (auto task = myWorkers[victim]->tasks.steal())
+        {
+            myPendingTasks.fetch_sub(1);
+#if COMMON_UTILITIES_THREAD_STATS
+            myCounters[aSkipIndex]->AddStolen(); // the skip index is the thief, or one past the workers for other threads
+#endif
+            return *task;
+        }
+    }
+
+    return nullptr;
+}
+
+auto ThreadPool::PopGlobalTask(Priority aLowest) -> Task*
+{
+    std::unique_lock<std::mutex> lock(myMutex, std::try_to_lock); // don't convoy on the lock, we will come back if it is busy
+
+    if (!lock.owns_lock() || myTasksCount == 0)
+        return nullptr;
+
+    Task* task = PopGlobal(aLowest);
+    if (task)
+    {
+        myPendingTasks.fetch_sub(1);
+    }
+
+    return task;
+}
+
+void ThreadPool::TaskQueue::Push(Task* aTask)
+{
+    if (count == tasks.size()) // full, grow and unwrap so that the head is at the front
+    {
+        std::vector<Task*> newTasks((std::max)(tasks.size() * 2, std::size_t(64)), nullptr);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            newTasks[i] = tasks[(head + i) % tasks.size()];
+        }
+
+        tasks = std::move(newTasks);
+        head = 0;
+    }
+
+    tasks[(head + count) % tasks.size()] = aTask;
+    ++count;
+}
+
+auto ThreadPool::TaskQueue::Pop() -> Task*
+{
+    Task* task = tasks[head];
+
+    head = (head + 1) % tasks.size();
+    --count;
+
+    return task;
+}
+
+void ThreadPool::PushGlobal(Task* aTask)
+{
+    myQueues[aTask->priority].Push(aTask);
+    ++myTasksCount;
+}
+
+auto ThreadPool::PopGlobal(Priority aLowest) -> Task*
+{
+    // the highest priority lane is served first, unless a lane has been passed over too many times
+    // in which case it gets a turn. Lanes below aLowest are only picked once they are starving
+
+    Priority selected = Priority::Count;
+    for (std::size_t i = 0; i < PRIORITY_COUNT; ++i)
+    {
+        const auto lane = static_cast<Priority>(i);
+
+        const TaskQueue& queue = myQueues[lane];
+        if (queue.count == 0)
+            continue;
+
+        if (queue.skipped >= STARVATION_LIMIT)
+        {
+            selected = lane;
+            break;
+        }
+
+        if (selected == Priority::Count && lane <= aLowest)
+            selected = lane;
+    }
+
+    if (selected == Priority::Count)
+        return nullptr;
+
+    for (std::size_t i = 0; i < PRIORITY_COUNT; ++i)
+    {
+        TaskQueue& queue = myQueues[static_cast<Priority>(i)];
+        if (queue.count != 0)
+            ++queue.skipped;
+    }
+
+    myQueues[selected].skipped = 0;
+    --myTasksCount;
+
+    return myQueues[selected].Pop();
+}
+
+bool ThreadPool::RunPendingTask()
+{
+    Task* task = nullptr;
+
+    if (myScheduling == Scheduling::WorkStealing)
+    {
+        if (locCurrentPool == this)
+        {
+            task = FindTask(locWorkerIndex);
+        }
+        else if (!myWorkers.empty())
+        {
+            task = PopGlobalTask(Priority::Normal);
+            if (!task)
+                task = StealTask(myWorkers.size(), locStealSeed);
+        }
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(myMutex);
+        if (myTasksCount != 0)
+        {
+            task = PopGlobal(Priority::Normal);
+            if (task)
+                myPendingTasks.fetch_sub(1);
+        }
+    }
+
+    if (!task)
+        return false;
+
+    RunTask(task, false); // the helping thread keeps its own name
+
+    return true;
+}
+
+void ThreadPool::SetThreadName(const std::string& aThreadName)
+{
+    std::wstring wName = std::wstring(aThreadName.begin(), aThreadName.end());
+    SetThreadDescription(GetCurrentThread(), PCWSTR(wName.c_str()));
+
+    locThreadName = aThreadName;
+}
+
+void ThreadPool::RunTask(Task* aTask, bool aRename)
+{
+    myQueueDepths[aTask->priority].fetch_sub(1, std::memory_order_relaxed);
+
+    if (aTask->stopToken.stop_requested()) // gone stale while waiting, drop it without running
+    {
+#if COMMON_UTILITIES_THREAD_STATS
+        GetCounters().AddCancelled();
+#endif
+        DestroyTask(aTask);
+        return;
+    }
+
+    if (aRename && !aTask->name.empty() && aTask->name != locThreadName)
+    {
+        SetThreadName(aTask->name);
+    }
+
+#if COMMON_UTILITIES_THREAD_STATS
+    const std::uint64_t startTime = details::threadstats::Now();
+    aTask->func();
+    const std::uint64_t endTime = details::threadstats::Now();
+
+    GetCounters().AddExecuted(startTime - aTask->enqueueTime, endTime - startTime);
+#else
+    aTask->func();
+#endif
+
+    DestroyTask(aTask);
 }
 
-void ThreadPool::ThreadLoop()
+#if COMMON_UTILITIES_THREAD_STATS
+details::threadstats::WorkerCounters& ThreadPool::GetCounters() const noexcept
 {
+    return *myCounters[locCurrentPool == this ? locWorkerIndex : myCounters.size() - 1];
+}
+#endif
+
+void ThreadPool::BeginWorker(std::size_t aWorkerIndex, const std::string& aThreadName)
+{
+    SetThreadName(aThreadName);
+
+    if (aWorkerIndex < myPlacements.size())
+    {
+        CpuTopology::SetThreadAffinity(myPlacements[aWorkerIndex].id);
+    }
+
+    locCurrentPool = this;
+    locWorkerIndex = aWorkerIndex;
+}
+
+void ThreadPool::ThreadLoop(std::size_t aWorkerIndex, std::string aThreadName)
+{
+    BeginWorker(aWorkerIndex, aThreadName);
+
     while (true)
     {
-        Task task;
+        Task* task = nullptr;
         {
             std::unique_lock<std::mutex> lock(myMutex);
 
             myCV.wait(lock, [this]
             {
-                return !myTasks.empty() || myShutdown;
+                return myTasksCount != 0 || myShutdown;
             });
 
-            if (myTasks.empty() && myShutdown)
+            if (myTasksCount == 0 && myShutdown)
                 break;
 
-            task = std::move(myTasks.front());
-            myTasks.pop();
+            task = PopGlobal(Priority::Background);
+            myPendingTasks.fetch_sub(1);
+        }
+
+        RunTask(task, true);
+    }
+
+    locCurrentPool = nullptr;
+    locWorkerIndex = NULL_WORKER;
+}
+
+void ThreadPool::WorkStealingLoop(std::size_t aWorkerIndex, std::string aThreadName)
+{
+    BeginWorker(aWorkerIndex, aThreadName);
 
-            std::wstring wName = std::wstring(task.name.begin(), task.name.end());
-            SetThreadDescription(GetCurrentThread(), PCWSTR(wName.c_str()));
+    while (true)
+    {
+        if (Task* task = FindTask(aWorkerIndex))
+        {
+            RunTask(task, true);
+            continue;
         }
 
-        task.func();
+        std::unique_lock<std::mutex> lock(myMutex);
+
+        mySleepingWorkers.fetch_add(1);
+        myCV.wait(lock, [this]
+        {
+            return myPendingTasks.load() != 0 || myShutdown;
+        });
+        mySleepingWorkers.fetch_sub(1);
+
+        if (myPendingTasks.load() == 0 && myShutdown)
+            break;
     }
+
+    locCurrentPool = nullptr;
+    locWorkerIndex = NULL_WORKER;
 }
@@ -0,0 +1,131 @@
+#include <CommonUtilities/Thread/ThreadStats.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using namespace CommonUtilities;
+
+void LatencyHistogram::Record(std::uint64_t aValue, std::uint64_t aCount) noexcept
+{
+    if (aCount == 0)
+        return;
+
+    myBuckets[GetBucketIndex(aValue)] += aCount;
+
+    myCount += aCount;
+    myTotal += aValue * aCount;
+    myMin = (std::min)(myMin, aValue);
+    myMax = (std::max)(myMax, aValue);
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& aOther) noexcept
+{
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        myBuckets[i] += aOther.myBuckets[i];
+    }
+
+    myCount += aOther.myCount;
+    myTotal += aOther.myTotal;
+    myMin = (std::min)(myMin, aOther.myMin);
+    myMax = (std::max)(myMax, aOther.myMax);
+}
+
+void LatencyHistogram::Reset() noexcept
+{
+    *this = LatencyHistogram();
+}
+
+std::uint64_t LatencyHistogram::GetCount() const noexcept
+{
+    return myCount;
+}
+std::uint64_t LatencyHistogram::GetMin() const noexcept
+{
+    return myCount != 0 ? myMin : 0;
+}
+std::uint64_t LatencyHistogram::GetMax() const noexcept
+{
+    return myMax;
+}
+double LatencyHistogram::GetMean() const noexcept
+{
+    return myCount != 0 ? static_cast<double>(myTotal) / static_cast<double>(myCount) : 0.0;
+}
+
+std::uint64_t LatencyHistogram::GetPercentile(double aPercentile) const noexcept
+{
+    if (myCount == 0)
+        return 0;
+
+    const double fraction = std::clamp(aPercentile, 0.0, 100.0) / 100.0;
+    const auto target = (std::max)(static_cast<std::uint64_t>(std::ceil(fraction * static_cast<double>(myCount))), std::uint64_t(1));
+
+    std::uint64_t count = 0;
+    for (std::size_t i = 0; i < BUCKET_COUNT; ++i)
+    {
+        count += myBuckets[i];
+        if (count >= target)
+            return (std::min)(GetBucketHighest(i), myMax);
+    }
+
+    return myMax;
+}
+
+std::uint64_t LatencyHistogram::GetBucketCount(std::size_t aIndex) const noexcept
+{
+    return myBuckets[aIndex];
+}
+
+std::size_t LatencyHistogram::GetBucketIndex(std::uint64_t aValue) noexcept
+{
+    if (aValue < SUB_BUCKET_COUNT) // small values are exact
+        return static_cast<std::size_t>(aValue);
+
+    const auto exponent = static_cast<std::size_t>(std::bit_width(aValue)) - 1;
+    const auto shift    = exponent - SUB_BUCKET_BITS;
+    const auto sub      = static_cast<std::size_t>(aValue >> shift) - SUB_BUCKET_COUNT; // strip the leading bit
+
+    return (shift + 1) * SUB_BUCKET_COUNT + sub;
+}
+
+std::uint64_t LatencyHistogram::GetBucketLowest(std::size_t aIndex) noexcept
+{
+    if (aIndex < SUB_BUCKET_COUNT)
+        return aIndex;
+
+    const std::size_t shift = aIndex / SUB_BUCKET_COUNT - 1;
+    const std::size_t sub   = aIndex % SUB_BUCKET_COUNT;
+
+    return static_cast<std::uint64_t>(SUB_BUCKET_COUNT + sub) << shift;
+}
+
+std::uint64_t LatencyHistogram::GetBucketHighest(std::size_t aIndex) noexcept
+{
+    if (aIndex < SUB_BUCKET_COUNT)
+        return aIndex;
+
+    const std::size_t shift = aIndex / SUB_BUCKET_COUNT - 1;
+
+    return GetBucketLowest(aIndex) + ((std::uint64_t(1) << shift) - 1);
+}
+
+void WorkerStats::Merge(const WorkerStats& aOther) noexcept
+{
+    tasksExecuted   += aOther.tasksExecuted;
+    tasksStolen     += aOther.tasksStolen;
+    tasksCancelled  += aOther.tasksCancelled;
+    busyTime        += aOther.busyTime;
+
+    startLatency.Merge(aOther.startLatency);
+    runTime.Merge(aOther.runTime);
+}
+
+double WorkerStats::GetUtilization(std::chrono::nanoseconds aElapsed) const noexcept
+{
+    if (aElapsed.count() <= 0)
+        return 0.0;
+
+    return (std::min)(static_cast<double>(busyTime.count()) / static_cast<double>(aElapsed.count()), 1.0);
+}
@@ -0,0 +1,382 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestUtils.h"
+
+#include <CommonUtilities/Alloc/ArenaAlloc.hpp>
+#include <CommonUtilities/Alloc/PoolAlloc.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	struct Node // typical size of a small node in a linked structure
+	{
+		std::array<std::size_t, 6> values;
+	};
+
+	static_assert(sizeof(Node) == 48);
+
+	/// Each thread keeps a table of nodes and replaces random entries, so nodes are freed in a
+	/// different order than they were allocated in.
+	///
+	/// \returns Number of nodes whose contents were overwritten while alive.
+	///
+	template<class Alloc>
+	std::size_t Churn(std::size_t aThreadCount, std::size_t aReplacements)
+	{
+		static constexpr std::size_t TABLE_SIZE = 4096;
+
+		std::atomic<std::size_t>	corrupted {0};
+		std::vector<std::thread>	threads;
+
+		for (std::size_t t = 0; t < aThreadCount; ++t)
+		{
+			threads.emplace_back([&corrupted, aReplacements, t]()
+			{
+				using Traits = typename std::allocator_traits<Alloc>::template rebind_traits<Node>;
+				typename Traits::allocator_type alloc;
+
+				std::vector<Node*> table(TABLE_SIZE);
+				for (std::size_t i = 0; i < TABLE_SIZE; ++i)
+				{
+					table[i] = Traits::allocate(alloc, 1);
+					table[i]->values.fill(i);
+				}
+
+				std::size_t errors	= 0;
+				std::size_t state	= 0x9E3779B97F4A7C15ull * (t + 1);
+
+				for (std::size_t i = 0; i < aReplacements; ++i)
+				{
+					state ^= state << 13; // xorshift
+					state ^= state >> 7;
+					state ^= state << 17;
+
+					const std::size_t index = state % TABLE_SIZE;
+
+					errors += (table[index]->values.back() % TABLE_SIZE != index);
+					Traits::deallocate(alloc, table[index], 1);
+
+					table[index] = Traits::allocate(alloc, 1);
+					table[index]->values.fill(index + i * TABLE_SIZE);
+				}
+
+				for (Node* node : table)
+					Traits::deallocate(alloc, node, 1);
+
+				corrupted += errors;
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		return corrupted.load();
+	}
+
+	/// ArenaAlloc as it was before every thread got buffers of its own: one list of buffers shared by
+	/// all threads behind a single mutex, kept to compare against.
+	///
+	class GlobalArena
+	{
+	public:
+		static std::byte* Allocate(std::size_t aNumBytes, std::size_t aAlignment)
+		{
+			std::scoped_lock lock(ourMutex);
+
+			Buffer* buffer = nullptr;
+			for (const auto& candidate : ourBuffers)
+			{
+				if (candidate->Fits(aNumBytes, aAlignment))
+				{
+					buffer = candidate.get();
+					break;
+				}
+			}
+
+			if (!buffer)
+				buffer = ourBuffers.emplace_back(std::make_unique<Buffer>(aNumBytes + aAlignment)).get();
+
+			buffer->size += AlignmentOffset(buffer->Top(), aAlignment);
+
+			std::byte* memory = buffer->Top();
+			buffer->size += aNumBytes;
+			++buffer->refCount;
+
+			return memory;
+		}
+
+		static void Deallocate(std::byte* aMemory, std::size_t aNumBytes)
+		{
+			std::scoped_lock lock(ourMutex);
+
+			for (const auto& buffer : ourBuffers)
+			{
+				if (aMemory >= buffer->data.get() && aMemory < buffer->Top())
+				{
+					if (--buffer->refCount == 0)
+						buffer->size = 0;
+					else if (aMemory + aNumBytes == buffer->Top())
+						buffer->size -= aNumBytes;
+
+					return;
+				}
+			}
+		}
+
+	private:
+		struct Buffer
+		{
+			explicit Buffer(std::size_t aMinCapacity)
+				: capacity((std::max)(std::size_t(4096), aMinCapacity)), data(std::make_unique<std::byte[]>(capacity)) {}
+
+			std::byte* Top() const { return data.get() + size; }
+
+			bool Fits(std::size_t aNumBytes, std::size_t aAlignment) const
+			{
+				return size + AlignmentOffset(Top(), aAlignment) + aNumBytes <= capacity;
+			}
+
+			std::size_t						capacity	{0};
+			std::unique_ptr<std::byte[]>	data;
+			std::size_t						size		{0};
+			std::size_t						refCount	{0};
+		};
+
+		static std::size_t AlignmentOffset(const std::byte* aMemory, std::size_t aAlignment)
+		{
+			return (aAlignment - reinterpret_cast<std::uintptr_t>(aMemory) % aAlignment) % aAlignment;
+		}
+
+		static inline std::mutex							ourMutex;
+		static inline std::vector<std::unique_ptr<Buffer>>	ourBuffers;
+	};
+
+	template<typename T>
+	struct GlobalArenaAlloc
+	{
+		using value_type = T;
+
+		GlobalArenaAlloc() = default;
+
+		template<class U>
+		GlobalArenaAlloc(const GlobalArenaAlloc<U>&) {}
+
+		T* allocate(std::size_t aNumObjects)
+		{
+			return reinterpret_cast<T*>(GlobalArena::Allocate(aNumObjects * sizeof(T), alignof(T)));
+		}
+
+		void deallocate(T* anObject, std::size_t aNumObjects)
+		{
+			GlobalArena::Deallocate(reinterpret_cast<std::byte*>(anObject), aNumObjects * sizeof(T));
+		}
+
+		template<class U>
+		bool operator==(const GlobalArenaAlloc<U>&) const { return true; }
+	};
+
+	struct alignas(16) Chunk
+	{
+		std::byte bytes[16];
+	};
+
+	struct Block
+	{
+		Chunk*		memory	{nullptr};
+		std::size_t	count	{0};	// chunks, so 16 to 160 bytes
+		std::size_t	tag		{0};	// written to the first and last chunk to detect overlapping blocks
+	};
+
+	/// Every thread allocates blocks of mixed sizes and frees them in batches. With remote frees, each
+	/// batch is handed to the next thread and freed there, as when a producer passes work to a consumer.
+	///
+	/// \returns Number of blocks whose contents were overwritten while alive.
+	///
+	template<class Alloc>
+	std::size_t AllocateFree(std::size_t aThreadCount, std::size_t anAllocations, bool aRemoteFree)
+	{
+		static constexpr std::size_t BATCH_SIZE		= 64;
+		static constexpr std::size_t MAILBOX_LIMIT	= 4 * BATCH_SIZE;
+
+		using Traits = typename std::allocator_traits<Alloc>::template rebind_traits<Chunk>;
+
+		struct Mailbox
+		{
+			std::mutex				mutex;
+			std::vector<Block>		blocks;
+		};
+
+		std::vector<Mailbox>		mailboxes(aThreadCount);
+		std::atomic<std::size_t>	corrupted	{0};
+		std::atomic<std::size_t>	finished	{0}; // threads done allocating, the others still free what they are handed
+		std::vector<std::thread>	threads;
+
+		for (Mailbox& mailbox : mailboxes)
+			mailbox.blocks.reserve(MAILBOX_LIMIT + BATCH_SIZE);
+
+		const auto release = [](std::vector<Block>& someBlocks) -> std::size_t
+		{
+			typename Traits::allocator_type alloc;
+
+			std::size_t errors = 0;
+			for (const Block& block : someBlocks)
+			{
+				errors += (std::to_integer<std::size_t>(block.memory[0].bytes[0]) != (block.tag & 0xFF));
+				errors += (std::to_integer<std::size_t>(block.memory[block.count - 1].bytes[15]) != (block.tag & 0xFF));
+
+				Traits::deallocate(alloc, block.memory, block.count);
+			}
+
+			someBlocks.clear();
+			return errors;
+		};
+
+		for (std::size_t t = 0; t < aThreadCount; ++t)
+		{
+			threads.emplace_back([&, t]()
+			{
+				typename Traits::allocator_type alloc;
+
+				std::vector<Block> batch, received;
+				batch.reserve(BATCH_SIZE);
+				received.reserve(MAILBOX_LIMIT + BATCH_SIZE);
+
+				std::size_t errors	= 0;
+				std::size_t state	= 0x9E3779B97F4A7C15ull * (t + 1);
+
+				const auto receive = [&]()
+				{
+					{
+						std::scoped_lock lock(mailboxes[t].mutex);
+						received.swap(mailboxes[t].blocks);
+					}
+
+					errors += release(received);
+				};
+
+				for (std::size_t i = 0; i < anAllocations; ++i)
+				{
+					state ^= state << 13; // xorshift
+					state ^= state >> 7;
+					state ^= state << 17;
+
+					Block block{ nullptr, 1 + state % 10, t * anAllocations + i };
+					block.memory = Traits::allocate(alloc, block.count);
+					block.memory[0].bytes[0]				= static_cast<std::byte>(block.tag);
+					block.memory[block.count - 1].bytes[15]	= static_cast<std::byte>(block.tag);
+
+					batch.push_back(block);
+
+					if (batch.size() < BATCH_SIZE)
+						continue;
+
+					if (!aRemoteFree)
+					{
+						errors += release(batch);
+						continue;
+					}
+
+					// waits for room so that a slow receiver does not pile up blocks, which would make
+					// this measure how the allocators cope with a growing heap instead
+
+					for (Mailbox& next = mailboxes[(t + 1) % aThreadCount];;)
+					{
+						{
+							std::scoped_lock lock(next.mutex);
+							if (next.blocks.size() < MAILBOX_LIMIT)
+							{
+								next.blocks.insert(next.blocks.end(), batch.begin(), batch.end());
+								break;
+							}
+						}
+
+						receive(); // others may be waiting on us in turn
+						std::this_thread::yield();
+					}
+
+					batch.clear();
+					receive();
+				}
+
+				errors += release(batch);
+
+				++finished;
+				while (finished.load() < aThreadCount)
+				{
+					receive();
+					std::this_thread::yield();
+				}
+				receive();
+
+				corrupted += errors;
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		return corrupted.load();
+	}
+}
+
+namespace Tests
+{
+	TEST_CLASS(AllocatorTests)
+	{
+	public:
+		TEST_METHOD(ChurnBenchmark)
+		{
+			const std::size_t maxThreads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+
+			for (std::size_t threads = 1; threads <= maxThreads; threads *= 2)
+			{
+				const std::string suffix = ": " + std::to_string(threads) + " threads";
+
+				std::size_t corrupted = 0;
+
+				Benchmark("PoolAlloc" + suffix,			[&]() { corrupted += Churn<cu::PoolAlloc<Node>>(threads, REPLACEMENTS); });
+				Benchmark("ArenaAlloc" + suffix,		[&]() { corrupted += Churn<cu::ArenaAlloc<Node>>(threads, REPLACEMENTS); });
+				Benchmark("std::allocator" + suffix,	[&]() { corrupted += Churn<std::allocator<Node>>(threads, REPLACEMENTS); });
+
+				Assert::AreEqual(std::size_t(0), corrupted);
+			}
+		}
+
+		TEST_METHOD(ThreadScalingBenchmark)
+		{
+			const std::size_t maxThreads = std::max<std::size_t>(std::thread::hardware_concurrency(), 8);
+
+			for (const bool remoteFree : { false, true })
+			{
+				for (std::size_t threads = 1; threads <= maxThreads; threads *= 2)
+				{
+					const std::string suffix = std::string(remoteFree ? " remote free" : " local free") + ": " + std::to_string(threads) + " threads";
+
+					std::size_t corrupted = 0;
+
+					Benchmark("ArenaAlloc" + suffix,			[&]() { corrupted += AllocateFree<cu::ArenaAlloc<Chunk>>(threads, ALLOCATIONS, remoteFree); });
+					Benchmark("global mutex arena" + suffix,	[&]() { corrupted += AllocateFree<GlobalArenaAlloc<Chunk>>(threads, ALLOCATIONS, remoteFree); });
+					Benchmark("std::allocator" + suffix,		[&]() { corrupted += AllocateFree<std::allocator<Chunk>>(threads, ALLOCATIONS, remoteFree); });
+
+					Assert::AreEqual(std::size_t(0), corrupted);
+				}
+			}
+		}
+
+	private:
+		static constexpr std::size_t REPLACEMENTS	= 1000000; // per thread
+		static constexpr std::size_t ALLOCATIONS	= 1000000; // per thread
+	};
+}
@@ -0,0 +1,368 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestUtils.h"
+
+#include <CommonUtilities/Structures/Blackboard.hpp>
+#include <CommonUtilities/Structures/ComponentRegistry.hpp>
+#include <CommonUtilities/Structures/SparseSet.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	struct Position	{ float x {0.0f}, y {0.0f}, z {0.0f}; };
+	struct Velocity	{ float x {0.0f}, y {0.0f}, z {0.0f}; };
+	struct Name		{ std::string value; };
+	struct Unused	{ int value {0}; };
+
+	using Registry = cu::ComponentRegistry<std::uint32_t>;
+
+	/// \returns Whether the set holds exactly the IDs of the reference, and the packed positions map back to them.
+	///
+	template<class Set>
+	bool Same(const Set& aSet, const std::set<std::uint32_t>& aReference)
+	{
+		if (aSet.size() != aReference.size() || aSet.empty() != aReference.empty())
+			return false;
+
+		for (std::size_t i = 0; i < aSet.size(); ++i)
+		{
+			const std::uint32_t id = aSet.data()[i];
+			if (!aReference.contains(id) || aSet.index(id) != i)
+				return false;
+		}
+
+		return std::all_of(aReference.begin(), aReference.end(), [&aSet](std::uint32_t aID) { return aSet.contains(aID); });
+	}
+
+	/// \returns Entities that have every one of the components according to the reference maps.
+	///
+	std::vector<std::uint32_t> Expected(const std::map<std::uint32_t, int>& aPositions, const std::map<std::uint32_t, int>& aVelocities)
+	{
+		std::vector<std::uint32_t> entities;
+		for (const auto& [entity, value] : aPositions)
+		{
+			if (aVelocities.contains(entity))
+				entities.push_back(entity);
+		}
+
+		return entities;
+	}
+}
+
+namespace Tests
+{
+	TEST_CLASS(ComponentRegistryTests)
+	{
+	public:
+		TEST_METHOD(SparseSetRandomizedAgainstSet)
+		{
+			std::mt19937 rng(1);
+
+			cu::SparseSet<std::uint32_t, 64>	set; // small pages, so that many of them are touched
+			std::set<std::uint32_t>				reference;
+
+			const auto randomID = [&rng]() -> std::uint32_t
+			{
+				return rng() % 4 == 0 ? rng() % 1000000 : rng() % 2000; // mostly dense, some far apart
+			};
+
+			for (int i = 0; i < 100000; ++i)
+			{
+				const std::uint32_t id = randomID();
+
+				switch (rng() % 4)
+				{
+					case 0:
+					case 1:
+					{
+						if (!reference.contains(id))
+						{
+							const std::size_t size = set.size();
+
+							Assert::AreEqual(size, set.insert(id));
+							reference.insert(id);
+						}
+					}
+					break;
+					case 2:
+					{
+						if (!reference.empty())
+						{
+							const std::uint32_t erased = set.data()[rng() % set.size()];
+
+							set.erase(erased);
+							reference.erase(erased);
+
+							Assert::IsFalse(set.contains(erased));
+						}
+					}
+					break;
+					default:
+					{
+						Assert::AreEqual(reference.contains(id), set.contains(id));
+					}
+					break;
+				}
+
+				if (i % 10000 == 0)
+					Assert::IsTrue(Same(set, reference));
+			}
+
+			Assert::IsTrue(Same(set, reference));
+
+			cu::SparseSet<std::uint32_t, 64> copy = set;
+			Assert::IsTrue(Same(copy, reference));
+
+			set.clear();
+			Assert::IsTrue(Same(set, {}));
+			Assert::IsTrue(Same(copy, reference)); // pages are not shared
+
+			for (const std::uint32_t id : reference) // pages kept by clear are reused
+				(void)set.insert(id);
+
+			Assert::IsTrue(Same(set, reference));
+			Assert::IsTrue(std::equal(set.begin(), set.end(), reference.begin(), reference.end()));
+		}
+
+		TEST_METHOD(RegistryRandomizedAgainstMaps)
+		{
+			std::mt19937 rng(2);
+
+			Registry registry;
+
+			std::map<std::uint32_t, int> positions; // entity to the value stored in x
+			std::map<std::uint32_t, int> velocities;
+			std::map<std::uint32_t, int> names;
+
+			for (int i = 0; i < 50000; ++i)
+			{
+				const std::uint32_t entity = rng() % 3000;
+				const int value = static_cast<int>(rng() % 1000);
+
+				switch (rng() % 10)
+				{
+					case 0:
+					case 1:
+					{
+						registry.Emplace<Position>(entity, static_cast<float>(value), 0.0f, 0.0f);
+						positions[entity] = value;
+					}
+					break;
+					case 2:
+					{
+						registry.Emplace<Velocity>(entity, static_cast<float>(value), 0.0f, 0.0f);
+						velocities[entity] = value;
+					}
+					break;
+					case 3:
+					{
+						registry.Emplace<Name>(entity, std::to_string(value) + "_long_enough_to_be_on_the_heap");
+						names[entity] = value;
+					}
+					break;
+					case 4:
+					{
+						Assert::AreEqual(positions.erase(entity) != 0, registry.Erase<Position>(entity));
+					}
+					break;
+					case 5:
+					{
+						Assert::AreEqual(names.erase(entity) != 0, registry.Erase<Name>(entity));
+					}
+					break;
+					case 6:
+					{
+						registry.EraseEntity(entity);
+
+						positions.erase(entity);
+						velocities.erase(entity);
+						names.erase(entity);
+					}
+					break;
+					default:
+					{
+						const Position* position = registry.TryGet<Position>(entity);
+						const Name* name = std::as_const(registry).TryGet<Name>(entity);
+
+						Assert::AreEqual(positions.contains(entity), position != nullptr);
+						Assert::AreEqual(names.contains(entity), name != nullptr);
+						Assert::AreEqual(velocities.contains(entity), registry.Has<Velocity>(entity));
+
+						if (position != nullptr)
+							Assert::AreEqual(static_cast<float>(positions[entity]), position->x);
+
+						if (name != nullptr)
+							Assert::AreEqual(std::to_string(names[entity]) + "_long_enough_to_be_on_the_heap", name->value);
+					}
+					break;
+				}
+
+				Assert::AreEqual(positions.size(), registry.Size<Position>());
+				Assert::AreEqual(velocities.size(), registry.Size<Velocity>());
+				Assert::AreEqual(names.size(), registry.Size<Name>());
+			}
+
+			const auto& positionEntities = registry.Entities<Position>();
+			const auto positionComponents = registry.Components<Position>();
+
+			Assert::AreEqual(positionEntities.size(), positionComponents.size());
+			for (std::size_t i = 0; i < positionEntities.size(); ++i) // packed arrays are in the same order
+				Assert::AreEqual(static_cast<float>(positions[positionEntities.data()[i]]), positionComponents[i].x);
+
+			std::vector<std::uint32_t> visited;
+			registry.GetView<Position, const Velocity>().Each([&](std::uint32_t anEntity, Position& aPosition, const Velocity& aVelocity)
+			{
+				aPosition.x += aVelocity.x;
+				visited.push_back(anEntity);
+			});
+
+			std::ranges::sort(visited);
+			Assert::IsTrue(visited == Expected(positions, velocities));
+
+			for (const std::uint32_t entity : visited)
+				Assert::AreEqual(static_cast<float>(positions[entity] + velocities[entity]), registry.Get<Position>(entity).x);
+
+			Assert::AreEqual(std::size_t(0), registry.Size<Unused>()); // types never added behave as empty
+			Assert::IsTrue(registry.Components<Unused>().empty());
+			Assert::IsFalse(registry.Erase<Unused>(0));
+			Assert::AreEqual(std::size_t(0), registry.GetView<Position, Unused>().SizeHint());
+
+			registry.Clear<Position>();
+			Assert::AreEqual(std::size_t(0), registry.Size<Position>());
+			Assert::AreEqual(velocities.size(), registry.Size<Velocity>());
+
+			registry.Clear();
+			Assert::AreEqual(std::size_t(0), registry.Size<Velocity>() + registry.Size<Name>());
+		}
+
+		TEST_METHOD(ViewEachErasesCurrentEntity)
+		{
+			Registry registry;
+
+			for (std::uint32_t entity = 0; entity < 1000; ++entity)
+			{
+				registry.Emplace<Position>(entity, static_cast<float>(entity), 0.0f, 0.0f);
+
+				if (entity % 2 == 0)
+					registry.Emplace<Velocity>(entity, 1.0f, 0.0f, 0.0f);
+
+				if (entity % 3 == 0)
+					registry.Emplace<Name>(entity, std::to_string(entity));
+			}
+
+			std::set<std::uint32_t> visited;
+
+			registry.GetView<Position, Velocity>().Each([&](std::uint32_t anEntity, Position& aPosition, Velocity&)
+			{
+				Assert::IsTrue(visited.insert(anEntity).second); // visited once, also after erasing moves the last entity
+
+				if (anEntity % 4 == 0)
+					registry.EraseEntity(anEntity);
+				else if (anEntity % 3 == 1)
+					(void)registry.Erase<Velocity>(anEntity);
+				else
+					aPosition.x = -1.0f;
+			});
+
+			Assert::AreEqual(std::size_t(500), visited.size());
+
+			for (std::uint32_t entity = 0; entity < 1000; ++entity)
+			{
+				const bool erased		= (entity % 4 == 0);
+				const bool lostVelocity	= (entity % 2 == 0 && !erased && entity % 3 == 1);
+
+				Assert::AreEqual(!erased, registry.Has<Position>(entity));
+				Assert::AreEqual(entity % 2 == 0 && !erased && !lostVelocity, registry.Has<Velocity>(entity));
+				Assert::AreEqual(entity % 3 == 0 && !erased, registry.Has<Name>(entity));
+
+				if (entity % 2 == 0 && !erased && !lostVelocity)
+					Assert::AreEqual(-1.0f, registry.Get<Position>(entity).x);
+			}
+
+			const Registry& constRegistry = registry;
+
+			std::size_t count = 0;
+			constRegistry.GetView<Position, Name>().Each([&](std::uint32_t anEntity, const Position&, const Name& aName)
+			{
+				Assert::AreEqual(std::to_string(anEntity), aName.value);
+				Assert::IsTrue(constRegistry.GetView<Position, Name>().Contains(anEntity));
+				++count;
+			});
+
+			Assert::AreEqual(std::size_t(250), count); // every third entity, less those divisible by four
+		}
+
+		TEST_METHOD(ViewBenchmark)
+		{
+			for (const std::uint32_t count : { 1000u, 100000u })
+			{
+				Registry registry;
+				cu::Blackboard<std::uint32_t> blackboard;
+
+				for (std::uint32_t entity = 0; entity < count; ++entity)
+				{
+					registry.Emplace<Position>(entity);
+					blackboard.Emplace<Position>(entity);
+
+					if (entity % 4 == 0)
+					{
+						registry.Emplace<Velocity>(entity, 1.0f, 2.0f, 3.0f);
+						blackboard.Emplace<Velocity>(entity, Velocity{ 1.0f, 2.0f, 3.0f });
+					}
+				}
+
+				const std::string suffix = " (" + std::to_string(count) + ")";
+
+				Benchmark("Blackboard Position += Velocity" + suffix, [&]()
+				{
+					for (std::size_t pass = 0; pass < PASSES; ++pass)
+					{
+						for (std::uint32_t entity = 0; entity < count; ++entity)
+						{
+							if (const Velocity* velocity = blackboard.TryGet<Velocity>(entity))
+							{
+								Position& position = blackboard.Get<Position>(entity);
+
+								position.x += velocity->x;
+								position.y += velocity->y;
+								position.z += velocity->z;
+							}
+						}
+					}
+				});
+
+				Benchmark("ComponentRegistry View::Each Position += Velocity" + suffix, [&]()
+				{
+					for (std::size_t pass = 0; pass < PASSES; ++pass)
+					{
+						registry.GetView<Position, const Velocity>().Each([](std::uint32_t, Position& aPosition, const Velocity& aVelocity)
+						{
+							aPosition.x += aVelocity.x;
+							aPosition.y += aVelocity.y;
+							aPosition.z += aVelocity.z;
+						});
+					}
+				});
+
+				for (std::uint32_t entity = 0; entity < count; ++entity)
+				{
+					Assert::AreEqual(blackboard.Get<Position>(entity).x, registry.Get<Position>(entity).x);
+					Assert::AreEqual(blackboard.Get<Position>(entity).z, registry.Get<Position>(entity).z);
+				}
+			}
+		}
+
+	private:
+		static constexpr std::size_t PASSES = 100;
+	};
+}
@@ -0,0 +1,395 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestUtils.h"
+
+#include <CommonUtilities/Structures/MPMCQueue.hpp>
+#include <CommonUtilities/Structures/SPSCQueue.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	// values are made from their index and read back, so every element can be checked exactly once
+
+	struct IndexTraits
+	{
+		static std::size_t Make(std::size_t aIndex) { return aIndex; }
+		static std::size_t Get(std::size_t aValue) { return aValue; }
+	};
+
+	struct StringTraits // long enough to live on the heap, so lost or doubled moves are caught by the sanitizers
+	{
+		static std::string Make(std::size_t aIndex) { return std::to_string(aIndex) + "_padding_past_small_string_storage"; }
+		static std::size_t Get(const std::string& aValue) { return std::stoull(aValue); }
+	};
+
+	struct UniqueTraits
+	{
+		static std::unique_ptr<std::size_t> Make(std::size_t aIndex) { return std::make_unique<std::size_t>(aIndex); }
+		static std::size_t Get(const std::unique_ptr<std::size_t>& aValue) { return *aValue; }
+	};
+
+	/// Producers alternate between single and batch pushes and consumers between single and batch
+	/// pops, so both paths race against each other.
+	///
+	/// \returns Number of elements that were not popped exactly once.
+	///
+	template<class Traits>
+	std::size_t StressMPMC(std::size_t aProducers, std::size_t aConsumers, std::size_t aCount, std::size_t aCapacity)
+	{
+		using T = decltype(Traits::Make(0));
+
+		cu::MPMCQueue<T> queue(aCapacity);
+
+		std::vector<std::atomic<int>>	seen(aProducers * aCount);
+		std::atomic<std::size_t>		popped {0};
+		std::vector<std::thread>		threads;
+
+		for (std::size_t p = 0; p < aProducers; ++p)
+		{
+			threads.emplace_back([&, p]()
+			{
+				std::vector<T> batch;
+
+				for (std::size_t i = 0; i < aCount;)
+				{
+					if (i % 3 == 0 && i + 8 <= aCount)
+					{
+						batch.clear();
+						for (std::size_t j = 0; j < 8; ++j)
+							batch.push_back(Traits::Make(p * aCount + i + j));
+
+						const std::size_t pushed = queue.try_push(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+
+						if (pushed == 0)
+							std::this_thread::yield();
+
+						i += pushed;
+					}
+					else if (queue.try_push(Traits::Make(p * aCount + i)))
+					{
+						++i;
+					}
+					else
+					{
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+
+		for (std::size_t c = 0; c < aConsumers; ++c)
+		{
+			threads.emplace_back([&, c]()
+			{
+				std::vector<T> batch;
+
+				while (popped.load() < aProducers * aCount)
+				{
+					if (c % 2 != 0)
+					{
+						batch.clear();
+
+						const std::size_t count = queue.try_pop(std::back_inserter(batch), 5);
+						for (const T& value : batch)
+							seen[Traits::Get(value)].fetch_add(1);
+
+						if (count == 0)
+							std::this_thread::yield();
+
+						popped += count;
+					}
+					else if (std::optional<T> value = queue.try_pop())
+					{
+						seen[Traits::Get(*value)].fetch_add(1);
+						++popped;
+					}
+					else
+					{
+						std::this_thread::yield();
+					}
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+
+		return static_cast<std::size_t>(std::count_if(seen.begin(), seen.end(),
+			[](const std::atomic<int>& aSeen) { return aSeen.load() != 1; })) + !queue.empty();
+	}
+
+	/// \returns Number of elements that were popped out of order.
+	///
+	template<class Traits>
+	std::size_t StressSPSC(std::size_t aCount, std::size_t aCapacity)
+	{
+		using T = decltype(Traits::Make(0));
+
+		cu::SPSCQueue<T> queue(aCapacity);
+
+		std::thread producer([&]()
+		{
+			std::vector<T> batch;
+
+			for (std::size_t i = 0; i < aCount;)
+			{
+				if (i % 5 == 0 && i + 7 <= aCount)
+				{
+					batch.clear();
+					for (std::size_t j = 0; j < 7; ++j)
+						batch.push_back(Traits::Make(i + j));
+
+					const std::size_t pushed = queue.try_push(std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+
+					if (pushed == 0)
+						std::this_thread::yield();
+
+					i += pushed;
+				}
+				else if (queue.try_push(Traits::Make(i)))
+				{
+					++i;
+				}
+				else
+				{
+					std::this_thread::yield();
+				}
+			}
+		});
+
+		std::size_t errors	= 0;
+		std::size_t next	= 0;
+
+		std::vector<T> batch;
+
+		while (next < aCount)
+		{
+			if (next % 2 != 0)
+			{
+				batch.clear();
+
+				if (queue.try_pop(std::back_inserter(batch), 6) == 0)
+					std::this_thread::yield();
+
+				for (const T& value : batch)
+					errors += (Traits::Get(value) != next++);
+			}
+			else if (std::optional<T> value = queue.try_pop())
+			{
+				errors += (Traits::Get(*value) != next++);
+			}
+			else
+			{
+				std::this_thread::yield();
+			}
+		}
+
+		producer.join();
+
+		return errors + !queue.empty();
+	}
+
+	/// Baseline for the throughput benchmarks.
+	///
+	class LockedQueue
+	{
+	public:
+		explicit LockedQueue(std::size_t aCapacity) : myCapacity(aCapacity) {}
+
+		bool try_push(std::size_t aValue)
+		{
+			std::scoped_lock lock(myMutex);
+
+			if (myQueue.size() >= myCapacity)
+				return false;
+
+			myQueue.push(aValue);
+			return true;
+		}
+
+		std::optional<std::size_t> try_pop()
+		{
+			std::scoped_lock lock(myMutex);
+
+			if (myQueue.empty())
+				return std::nullopt;
+
+			const std::size_t value = myQueue.front();
+			myQueue.pop();
+
+			return value;
+		}
+
+	private:
+		std::queue<std::size_t>	myQueue;
+		std::mutex				myMutex;
+		std::size_t				myCapacity;
+	};
+
+	template<class Queue, bool Batch = false>
+	void RunThroughput(std::size_t aProducers, std::size_t aConsumers, std::size_t aCount)
+	{
+		static constexpr std::size_t BATCH_SIZE = 32;
+
+		Queue queue(1024);
+
+		std::atomic<std::size_t>	popped {0};
+		std::vector<std::thread>	threads;
+
+		for (std::size_t p = 0; p < aProducers; ++p)
+		{
+			threads.emplace_back([&]()
+			{
+				std::size_t batch[BATCH_SIZE];
+
+				for (std::size_t i = 0; i < aCount;)
+				{
+					if constexpr (Batch)
+					{
+						const std::size_t count = std::min(BATCH_SIZE, aCount - i);
+						for (std::size_t j = 0; j < count; ++j)
+							batch[j] = i + j;
+
+						const std::size_t pushed = queue.try_push(batch, batch + count);
+
+						if (pushed == 0)
+							std::this_thread::yield();
+
+						i += pushed;
+					}
+					else
+					{
+						if (queue.try_push(i))
+							++i;
+						else
+							std::this_thread::yield();
+					}
+				}
+			});
+		}
+
+		for (std::size_t c = 0; c < aConsumers; ++c)
+		{
+			threads.emplace_back([&]()
+			{
+				std::size_t batch[BATCH_SIZE];
+
+				while (popped.load(std::memory_order_relaxed) < aProducers * aCount)
+				{
+					if constexpr (Batch)
+					{
+						const std::size_t count = queue.try_pop(batch, BATCH_SIZE);
+
+						if (count == 0)
+							std::this_thread::yield();
+
+						popped.fetch_add(count, std::memory_order_relaxed);
+					}
+					else
+					{
+						if (queue.try_pop())
+							popped.fetch_add(1, std::memory_order_relaxed);
+						else
+							std::this_thread::yield();
+					}
+				}
+			});
+		}
+
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+}
+
+namespace Tests
+{
+	TEST_CLASS(ConcurrentQueueTests)
+	{
+	public:
+		TEST_METHOD(MPMCQueueStress)
+		{
+			Assert::AreEqual(std::size_t(0), StressMPMC<IndexTraits>(4, 4, 100000, 64));
+			Assert::AreEqual(std::size_t(0), StressMPMC<StringTraits>(2, 3, 5000, 16));
+			Assert::AreEqual(std::size_t(0), StressMPMC<UniqueTraits>(3, 2, 5000, 8));
+			Assert::AreEqual(std::size_t(0), StressMPMC<IndexTraits>(1, 1, 10000, 2));
+		}
+
+		TEST_METHOD(SPSCQueueStress)
+		{
+			Assert::AreEqual(std::size_t(0), StressSPSC<IndexTraits>(400000, 64));
+			Assert::AreEqual(std::size_t(0), StressSPSC<StringTraits>(20000, 8));
+			Assert::AreEqual(std::size_t(0), StressSPSC<UniqueTraits>(20000, 2));
+		}
+
+		TEST_METHOD(MPMCQueueBounds)
+		{
+			cu::MPMCQueue<int> queue(3);
+			Assert::AreEqual(std::size_t(4), queue.capacity()); // rounded up to a power of two
+
+			const int items[] = { 1, 2, 3, 4, 5 };
+			Assert::AreEqual(std::size_t(4), queue.try_push(std::begin(items), std::end(items)));
+			Assert::IsFalse(queue.try_push(6));
+			Assert::AreEqual(std::size_t(4), queue.size());
+
+			int popped[8] {};
+			Assert::AreEqual(std::size_t(4), queue.try_pop(popped, 8));
+			Assert::AreEqual(4, popped[3]);
+			Assert::IsFalse(queue.try_pop().has_value());
+			Assert::IsTrue(queue.empty());
+		}
+
+		TEST_METHOD(SPSCQueueBounds)
+		{
+			cu::SPSCQueue<std::string> queue(4);
+
+			const std::vector<std::string> items { "a", "b", "c", "d", "e" };
+			Assert::AreEqual(std::size_t(4), queue.try_push(items.begin(), items.end()));
+			Assert::IsFalse(queue.try_emplace(1, 'f'));
+			Assert::AreEqual(std::size_t(4), queue.size());
+
+			Assert::AreEqual(std::string("a"), *queue.try_pop());
+			Assert::IsTrue(queue.try_emplace(3, 'f'));
+
+			std::vector<std::string> popped;
+			Assert::AreEqual(std::size_t(4), queue.try_pop(std::back_inserter(popped), 8));
+			Assert::AreEqual(std::string("fff"), popped.back());
+			Assert::IsTrue(queue.empty());
+		}
+
+		TEST_METHOD(MPMCQueueThroughput)
+		{
+			const std::size_t threads	= std::clamp<std::size_t>(std::thread::hardware_concurrency() / 2, 1, 4);
+			const std::size_t count		= THROUGHPUT_COUNT / threads;
+
+			Benchmark("MPMC " + std::to_string(threads) + "P" + std::to_string(threads) + "C mutex + std::queue",
+				[&]() { RunThroughput<LockedQueue>(threads, threads, count); });
+			Benchmark("MPMC " + std::to_string(threads) + "P" + std::to_string(threads) + "C MPMCQueue",
+				[&]() { RunThroughput<cu::MPMCQueue<std::size_t>>(threads, threads, count); });
+			Benchmark("MPMC " + std::to_string(threads) + "P" + std::to_string(threads) + "C MPMCQueue batch",
+				[&]() { RunThroughput<cu::MPMCQueue<std::size_t>, true>(threads, threads, count); });
+		}
+
+		TEST_METHOD(SPSCQueueThroughput)
+		{
+			Benchmark("SPSC mutex + std::queue",	[]() { RunThroughput<LockedQueue>(1, 1, THROUGHPUT_COUNT); });
+			Benchmark("SPSC MPMCQueue",				[]() { RunThroughput<cu::MPMCQueue<std::size_t>>(1, 1, THROUGHPUT_COUNT); });
+			Benchmark("SPSC SPSCQueue",				[]() { RunThroughput<cu::SPSCQueue<std::size_t>>(1, 1, THROUGHPUT_COUNT); });
+			Benchmark("SPSC SPSCQueue batch",		[]() { RunThroughput<cu::SPSCQueue<std::size_t>, true>(1, 1, THROUGHPUT_COUNT); });
+		}
+
+	private:
+		static constexpr std::size_t THROUGHPUT_COUNT = 1000000;
+	};
+}
@@ -0,0 +1,267 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestUtils.h"
+
+#include <CommonUtilities/Structures/FlatHashMap.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	struct StringHash
+	{
+		using is_transparent = void;
+		std::size_t operator()(std::string_view aKey) const { return std::hash<std::string_view>{}(aKey); }
+	};
+
+	struct StringEqual
+	{
+		using is_transparent = void;
+		bool operator()(std::string_view aLhs, std::string_view aRhs) const { return aLhs == aRhs; }
+	};
+
+	/// \returns Whether both maps hold the same pairs, also checks that iteration visits each once.
+	///
+	template<class Map, class Reference>
+	bool Same(const Map& aMap, const Reference& aReference)
+	{
+		if (aMap.size() != aReference.size())
+			return false;
+
+		std::size_t visited = 0;
+		for (const auto& [key, value] : aMap)
+		{
+			const auto it = aReference.find(key);
+			if (it == aReference.end() || it->second != value)
+				return false;
+
+			++visited;
+		}
+
+		return visited == aReference.size();
+	}
+
+	template<class Map, class Key>
+	void RunBenchmarks(const std::string& aName, const std::vector<Key>& someKeys, const std::vector<Key>& someMissing)
+	{
+		static constexpr std::size_t LOOKUP_PASSES = 4;
+
+		const std::string suffix = aName + " (" + std::to_string(someKeys.size()) + ")";
+
+		Map map;
+		std::size_t found = 0;
+
+		Tests::Benchmark("insert " + suffix, [&]()
+		{
+			for (const Key& key : someKeys)
+				map[key] = 1;
+		});
+
+		Tests::Benchmark("lookup hit " + suffix, [&]()
+		{
+			for (std::size_t pass = 0; pass < LOOKUP_PASSES; ++pass)
+			{
+				for (const Key& key : someKeys)
+					found += map.find(key)->second;
+			}
+		});
+
+		Tests::Benchmark("lookup miss " + suffix, [&]()
+		{
+			for (const Key& key : someMissing)
+				found += map.count(key);
+		});
+
+		Assert::AreEqual(someKeys.size() * LOOKUP_PASSES, found); // random 64-bit keys, so the missing ones are not found in practice
+	}
+}
+
+namespace Tests
+{
+	TEST_CLASS(FlatHashMapTests)
+	{
+	public:
+		TEST_METHOD(RandomizedAgainstUnorderedMap)
+		{
+			std::mt19937 rng(1);
+
+			for (int round = 0; round < 8; ++round)
+			{
+				cu::FlatHashMap<int, int>		map;
+				std::unordered_map<int, int>	reference;
+
+				const int range = (round % 2 != 0) ? 64 : 5000; // few keys churn tombstones, many keys grow the table
+
+				for (int i = 0; i < 50000; ++i)
+				{
+					const int key = static_cast<int>(rng() % range);
+
+					switch (rng() % 6)
+					{
+						case 0:
+						case 1:
+						{
+							map[key] = i;
+							reference[key] = i;
+						}
+						break;
+						case 2:
+						{
+							Assert::AreEqual(reference.erase(key), map.erase(key));
+						}
+						break;
+						case 3:
+						{
+							const auto [it, inserted] = map.try_emplace(key, i);
+							const auto [expectedIt, expectedInserted] = reference.try_emplace(key, i);
+
+							Assert::AreEqual(expectedInserted, inserted);
+							Assert::AreEqual(expectedIt->second, it->second);
+						}
+						break;
+						case 4:
+						{
+							Assert::AreEqual(reference.contains(key), map.contains(key));
+						}
+						break;
+						default: // erase through an iterator
+						{
+							if (const auto it = map.find(key); it != map.end())
+							{
+								map.erase(it);
+								reference.erase(key);
+							}
+						}
+						break;
+					}
+
+					if (i % 5000 == 0)
+						Assert::IsTrue(Same(map, reference));
+				}
+
+				Assert::IsTrue(Same(map, reference));
+
+				auto copy = map;
+				Assert::IsTrue(Same(copy, reference));
+
+				auto moved = std::move(copy);
+				Assert::IsTrue(Same(moved, reference));
+
+				map.rehash(0);
+				Assert::IsTrue(Same(map, reference));
+
+				map.clear();
+				Assert::IsTrue(map.empty());
+				Assert::IsTrue(map.begin() == map.end());
+			}
+		}
+
+		TEST_METHOD(RandomizedStringKeysAgainstUnorderedMap)
+		{
+			std::mt19937 rng(2);
+
+			cu::FlatHashMap<std::string, std::string, StringHash, StringEqual>	map;
+			std::unordered_map<std::string, std::string>						reference;
+
+			for (int i = 0; i < 50000; ++i)
+			{
+				const std::string key = std::to_string(rng() % 3000) + "_long_enough_to_be_on_the_heap";
+
+				switch (rng() % 4)
+				{
+					case 0:
+					case 1:
+					{
+						map.insert_or_assign(key, key + "_value");
+						reference[key] = key + "_value";
+					}
+					break;
+					case 2:
+					{
+						Assert::AreEqual(reference.erase(key), map.erase(std::string_view(key)));
+					}
+					break;
+					default:
+					{
+						Assert::AreEqual(reference.contains(key), map.contains(std::string_view(key)));
+					}
+					break;
+				}
+			}
+
+			Assert::IsTrue(Same(map, reference));
+
+			for (const auto& [key, value] : reference)
+				Assert::AreEqual(value, map.at(std::string_view(key)));
+
+			Assert::ExpectException<std::out_of_range>([&]() { (void)map.at(std::string_view("missing")); });
+
+			decltype(map) other;
+			other.swap(map);
+
+			Assert::IsTrue(Same(other, reference));
+			Assert::IsTrue(map.empty());
+		}
+
+		TEST_METHOD(ReserveKeepsCapacity)
+		{
+			cu::FlatHashMap<int, std::unique_ptr<int>> map;
+			map.reserve(1000);
+
+			const std::size_t capacity = map.capacity();
+
+			for (int i = 0; i < 1000; ++i)
+				map.try_emplace(i, std::make_unique<int>(i));
+
+			Assert::AreEqual(capacity, map.capacity());
+
+			for (int i = 0; i < 1000; ++i)
+				Assert::AreEqual(i, *map.at(i));
+		}
+
+		TEST_METHOD(IntegerKeyBenchmark)
+		{
+			for (const std::size_t count : { std::size_t(1000), std::size_t(100000) })
+			{
+				std::mt19937_64 rng(3);
+
+				std::vector<std::uint64_t> keys, missing;
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					keys.push_back(rng());
+					missing.push_back(rng());
+				}
+
+				RunBenchmarks<std::unordered_map<std::uint64_t, std::uint64_t>>("std::unordered_map<u64>", keys, missing);
+				RunBenchmarks<cu::FlatHashMap<std::uint64_t, std::uint64_t>>("FlatHashMap<u64>", keys, missing);
+			}
+		}
+
+		TEST_METHOD(StringKeyBenchmark)
+		{
+			for (const std::size_t count : { std::size_t(1000), std::size_t(100000) })
+			{
+				std::mt19937_64 rng(4);
+
+				std::vector<std::string> keys, missing;
+				for (std::size_t i = 0; i < count; ++i)
+				{
+					keys.push_back("key_" + std::to_string(rng()));
+					missing.push_back("key_" + std::to_string(rng()));
+				}
+
+				RunBenchmarks<std::unordered_map<std::string, std::size_t>>("std::unordered_map<string>", keys, missing);
+				RunBenchmarks<cu::FlatHashMap<std::string, std::size_t>>("FlatHashMap<string>", keys, missing);
+			}
+		}
+	};
+}
@@ -0,0 +1,337 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestUtils.h"
+
+#include <CommonUtilities/Alloc/FrameAlloc.hpp>
+#include <CommonUtilities/Structures/Octree.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory_resource>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	/// Counts the frame buffers the allocator takes from upstream.
+	///
+	class CountingResource : public std::pmr::memory_resource
+	{
+	public:
+		std::size_t allocations = 0;
+
+	private:
+		void* do_allocate(std::size_t aBytes, std::size_t anAlignment) override
+		{
+			++allocations;
+			return std::pmr::new_delete_resource()->allocate(aBytes, anAlignment);
+		}
+
+		void do_deallocate(void* aMemory, std::size_t aBytes, std::size_t anAlignment) override
+		{
+			std::pmr::new_delete_resource()->deallocate(aMemory, aBytes, anAlignment);
+		}
+
+		bool do_is_equal(const std::pmr::memory_resource& aOther) const noexcept override
+		{
+			return this == &aOther;
+		}
+	};
+
+	bool IsAligned(const std::byte* aMemory, std::size_t anAlignment)
+	{
+		return reinterpret_cast<std::uintptr_t>(aMemory) % anAlignment == 0;
+	}
+
+	constexpr float WORLD_SIZE = 500.0f; // half extent
+
+	cu::AABBf RandomBox(std::mt19937& aRng, float aMaxSize)
+	{
+		std::uniform_real_distribution<float> position(-WORLD_SIZE, WORLD_SIZE);
+		std::uniform_real_distribution<float> size(0.5f, aMaxSize);
+
+		const cu::Vector3f center(position(aRng), position(aRng), position(aRng));
+		const cu::Vector3f extents(size(aRng), size(aRng), size(aRng));
+
+		return cu::AABBf(center - extents, center + extents);
+	}
+
+	template<class Vector>
+	std::vector<int> Sorted(const Vector& someIndices)
+	{
+		std::vector<int> sorted(someIndices.begin(), someIndices.end());
+		std::ranges::sort(sorted);
+
+		return sorted;
+	}
+}
+
+namespace Tests
+{
+	TEST_CLASS(FrameAllocTests)
+	{
+	public:
+		TEST_METHOD(MarkersRewindInOrder)
+		{
+			cu::FrameAllocator allocator(1024);
+
+			(void)allocator.Allocate(100);
+			const std::size_t afterFirst = allocator.GetUsed();
+
+			std::byte* second = nullptr;
+			{
+				cu::FrameAllocator::Scope outer(allocator);
+
+				second = allocator.Allocate(200);
+				{
+					cu::FrameAllocator::Scope inner(allocator);
+
+					(void)allocator.Allocate(300);
+					Assert::IsTrue(allocator.GetUsed() > afterFirst + 500);
+				}
+
+				const std::size_t afterInner = allocator.GetUsed();
+				Assert::IsTrue(afterInner >= afterFirst + 200 && afterInner < afterFirst + 500);
+
+				std::byte* again = allocator.Allocate(300); // reuses what the inner scope released
+				Assert::IsTrue(again > second && again < second + 200 + alignof(std::max_align_t));
+			}
+
+			Assert::AreEqual(afterFirst, allocator.GetUsed());
+			Assert::IsTrue(allocator.Allocate(200) == second);
+
+			const cu::FrameAllocator::Marker marker = allocator.PushMarker();
+			(void)allocator.Allocate(50);
+			allocator.PopToMarker(marker);
+
+			Assert::IsTrue(allocator.Allocate(1, 1) == second + 200);
+		}
+
+		TEST_METHOD(MarkersRewindAcrossChunks)
+		{
+			cu::FrameAllocator allocator(256);
+
+			(void)allocator.Allocate(200);
+			const std::size_t before = allocator.GetUsed();
+
+			std::byte* first = nullptr;
+			{
+				cu::FrameAllocator::Scope scope(allocator);
+
+				first = allocator.Allocate(500); // does not fit, chains a chunk
+				for (int i = 0; i < 20; ++i)
+					(void)allocator.Allocate(300);
+
+				Assert::IsTrue(allocator.GetCapacity() > 256);
+			}
+
+			Assert::AreEqual(before, allocator.GetUsed());
+
+			{
+				cu::FrameAllocator::Scope scope(allocator);
+				Assert::IsTrue(allocator.Allocate(500) == first); // chained chunks are kept for reuse within the frame
+			}
+		}
+
+		TEST_METHOD(AlignmentIsHonoured)
+		{
+			cu::FrameAllocator allocator(512);
+
+			for (int i = 0; i < 200; ++i)
+			{
+				const std::size_t alignment = std::size_t(1) << (i % 9); // 1 to 256, larger than a chunk at times
+				std::byte* memory = allocator.Allocate(1 + i % 37, alignment);
+
+				Assert::IsTrue(IsAligned(memory, alignment));
+			}
+		}
+
+		TEST_METHOD(DeallocateReclaimsLatest)
+		{
+			cu::FrameAllocator allocator(4096);
+
+			std::byte* first	= allocator.Allocate(64);
+			std::byte* second	= allocator.Allocate(64);
+
+			const std::size_t used = allocator.GetUsed();
+
+			allocator.Deallocate(first, 64); // not the latest, left until the scope or frame ends
+			Assert::AreEqual(used, allocator.GetUsed());
+
+			allocator.Deallocate(second, 64);
+			Assert::AreEqual(used - 64, allocator.GetUsed());
+
+			{
+				cu::FrameAllocator::Scope scope(allocator);
+
+				std::vector<int, cu::FrameAlloc<int>> vector(allocator);
+				for (int i = 0; i < 1000; ++i) // every reallocation frees the latest block before taking a larger one
+					vector.push_back(i);
+
+				Assert::IsTrue(allocator.GetUsed() < used + 2 * vector.capacity() * sizeof(int));
+			}
+		}
+
+		TEST_METHOD(FramesAreDoubleBuffered)
+		{
+			CountingResource upstream;
+			cu::FrameAllocator allocator(1024, &upstream);
+
+			for (int frame = 0; frame < 8; ++frame)
+			{
+				std::vector<std::byte*> previous;
+				for (int i = 0; i < 40; ++i) // outgrows the initial capacity in the first frames
+				{
+					std::byte* memory = allocator.Allocate(100);
+					std::fill_n(memory, 100, static_cast<std::byte>(frame));
+					previous.push_back(memory);
+				}
+
+				allocator.Reset();
+
+				for (int i = 0; i < 40; ++i)
+					std::fill_n(allocator.Allocate(100), 100, std::byte(0xFF));
+
+				for (std::byte* memory : previous) // last frame's memory is untouched by this frame
+					Assert::IsTrue(std::all_of(memory, memory + 100, [frame](std::byte aByte) { return aByte == static_cast<std::byte>(frame); }));
+
+				allocator.Reset();
+			}
+
+			const std::size_t warmed = upstream.allocations;
+
+			for (int frame = 0; frame < 8; ++frame)
+			{
+				for (int i = 0; i < 40; ++i)
+					(void)allocator.Allocate(100);
+
+				allocator.Reset();
+			}
+
+			Assert::AreEqual(warmed, upstream.allocations); // merged chunks fit a whole frame once warmed up
+		}
+
+		TEST_METHOD(OctreeResultsMatchStdAllocator)
+		{
+			std::mt19937 rng(1);
+
+			const cu::AABBf root(cu::Vector3f(-WORLD_SIZE * 1.1f), cu::Vector3f(WORLD_SIZE * 1.1f));
+
+			cu::FrameAllocator storage(DEFAULT_CAPACITY); // never reset, holds the tree of the second octree
+			cu::FrameAllocator results(DEFAULT_CAPACITY);
+
+			cu::Octree<int>							octree(root, 8, 8);
+			cu::Octree<int, cu::FrameAlloc<int>>	frameOctree(root, 8, 8, cu::FrameAlloc<int>(storage));
+
+			std::vector<std::pair<cu::AABBf, int>> inserted;
+			for (int i = 0; i < 3000; ++i)
+			{
+				const cu::AABBf box = RandomBox(rng, 20.0f);
+
+				const int index = octree.Insert(box, i);
+				Assert::AreEqual(index, frameOctree.Insert(box, i));
+
+				inserted.emplace_back(box, index);
+			}
+
+			std::shuffle(inserted.begin(), inserted.end(), rng);
+			for (int i = 0; i < 1000; ++i)
+			{
+				Assert::IsTrue(octree.Erase(inserted.back().second));
+				Assert::IsTrue(frameOctree.Erase(inserted.back().second));
+				inserted.pop_back();
+			}
+
+			octree.Cleanup();
+			frameOctree.Cleanup();
+
+			for (int frame = 0; frame < 50; ++frame)
+			{
+				cu::FrameAllocator::Scope scope(results);
+
+				const cu::AABBf query = RandomBox(rng, 150.0f);
+				const cu::Spheref sphere(query.GetCenter(), 80.0f);
+
+				std::vector<int> expected;
+				for (const auto& [box, index] : inserted)
+				{
+					if (box.Overlaps(query))
+						expected.push_back(index);
+				}
+
+				std::vector<int>							stdResult;
+				std::vector<int, cu::FrameAlloc<int>>	frameResult(results);
+				std::vector<int, cu::FrameAlloc<int>>	frameTreeResult(results);
+
+				octree.Query(query, stdResult);
+				octree.Query(query, frameResult);
+				frameOctree.Query(query, frameTreeResult);
+
+				Assert::IsTrue(Sorted(expected) == Sorted(stdResult));
+				Assert::IsTrue(Sorted(stdResult) == Sorted(frameResult));
+				Assert::IsTrue(Sorted(stdResult) == Sorted(frameTreeResult));
+
+				stdResult.clear();
+				frameResult.clear();
+
+				octree.Query(sphere, stdResult);
+				frameOctree.Query(sphere, frameResult);
+
+				Assert::IsTrue(Sorted(stdResult) == Sorted(frameResult));
+			}
+		}
+
+		TEST_METHOD(OctreeQueryBenchmark)
+		{
+			std::mt19937 rng(2);
+
+			const cu::AABBf root(cu::Vector3f(-WORLD_SIZE * 1.1f), cu::Vector3f(WORLD_SIZE * 1.1f));
+
+			cu::Octree<int> octree(root, 16, 8);
+			for (int i = 0; i < 20000; ++i)
+				(void)octree.Insert(RandomBox(rng, 5.0f), i);
+
+			std::vector<cu::AABBf> queries;
+			for (int i = 0; i < QUERY_COUNT; ++i)
+				queries.push_back(RandomBox(rng, 40.0f));
+
+			cu::FrameAllocator frame(DEFAULT_CAPACITY);
+
+			std::size_t stdHits		= 0;
+			std::size_t frameHits	= 0;
+
+			// a fresh result vector per query, as a system collecting results for the frame would
+
+			Benchmark("Octree query, std::allocator results (" + std::to_string(QUERY_COUNT) + ")", [&]()
+			{
+				for (const cu::AABBf& query : queries)
+				{
+					std::vector<int> result;
+					octree.Query(query, result);
+					stdHits += result.size();
+				}
+			});
+
+			Benchmark("Octree query, FrameAlloc results (" + std::to_string(QUERY_COUNT) + ")", [&]()
+			{
+				for (const cu::AABBf& query : queries)
+				{
+					std::vector<int, cu::FrameAlloc<int>> result(frame);
+					octree.Query(query, result);
+					frameHits += result.size();
+				}
+
+				frame.Reset();
+			});
+
+			Assert::AreEqual(stdHits, frameHits);
+		}
+
+	private:
+		static constexpr std::size_t	DEFAULT_CAPACITY	= cu::FrameAllocator::DEFAULT_CAPACITY;
+		static constexpr int			QUERY_COUNT			= 20000;
+	};
+}
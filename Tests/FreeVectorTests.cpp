@@ -0,0 +1,268 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestUtils.h"
+
+#include <CommonUtilities/Structures/FreeVector.hpp>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <variant>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	struct Payload // 12 bytes with 4-byte alignment, as a small component or particle would be
+	{
+		Payload() = default;
+		explicit Payload(int aValue) : values{ aValue, aValue + 1, aValue + 2 } {}
+
+		std::array<int, 3> values {};
+	};
+
+	static_assert(sizeof(Payload) == 12);
+
+	/// How FreeVector stored its slots before they held the free-list link in their own storage.
+	///
+	using OldSlot = std::variant<Payload, std::int64_t>;
+
+	/// Keeps track of the bytes currently allocated through it and its rebound copies.
+	///
+	template<class T>
+	struct CountingAlloc
+	{
+		using value_type = T;
+
+		explicit CountingAlloc(std::size_t& aBytes) : bytes(&aBytes) {}
+
+		template<class U>
+		CountingAlloc(const CountingAlloc<U>& aOther) : bytes(aOther.bytes) {}
+
+		T* allocate(std::size_t aCount)
+		{
+			*bytes += aCount * sizeof(T);
+			return std::allocator<T>().allocate(aCount);
+		}
+
+		void deallocate(T* aPointer, std::size_t aCount)
+		{
+			*bytes -= aCount * sizeof(T);
+			std::allocator<T>().deallocate(aPointer, aCount);
+		}
+
+		template<class U>
+		bool operator==(const CountingAlloc<U>& aOther) const { return bytes == aOther.bytes; }
+
+		std::size_t* bytes;
+	};
+
+	/// \returns Whether the vector holds the same elements at the same indices as the reference, also
+	/// checks that for_each_valid visits exactly those indices in ascending order.
+	///
+	bool Same(const cu::FreeVector<std::string>& aVector, const std::vector<std::optional<std::string>>& aReference)
+	{
+		if (aVector.size() != aReference.size())
+			return false;
+
+		std::size_t count = 0;
+		for (std::size_t i = 0; i < aReference.size(); ++i)
+		{
+			if (aVector.valid(i) != aReference[i].has_value())
+				return false;
+
+			if (aReference[i].has_value())
+			{
+				if (aVector[i] != *aReference[i])
+					return false;
+
+				++count;
+			}
+		}
+
+		if (aVector.count() != count)
+			return false;
+
+		std::size_t expected	= 0;
+		bool inOrder			= true;
+
+		aVector.for_each_valid([&](std::size_t anIndex, const std::string& aElement)
+		{
+			while (expected < aReference.size() && !aReference[expected].has_value())
+				++expected;
+
+			inOrder = inOrder && anIndex == expected && aElement == *aReference[expected];
+			++expected;
+		});
+
+		return inOrder;
+	}
+}
+
+namespace Tests
+{
+	TEST_CLASS(FreeVectorTests)
+	{
+	public:
+		TEST_METHOD(RandomizedAgainstOptionals)
+		{
+			std::mt19937 rng(1);
+
+			cu::FreeVector<std::string>					vector;
+			std::vector<std::optional<std::string>>		reference;
+			std::vector<std::size_t>					freed; // most recently erased last, which is reused first
+
+			for (int i = 0; i < 50000; ++i)
+			{
+				if (rng() % 3 != 0 || reference.empty())
+				{
+					const std::string value = std::to_string(i) + "_long_enough_to_be_on_the_heap";
+					const std::size_t index = vector.emplace(value);
+
+					if (freed.empty())
+					{
+						Assert::AreEqual(reference.size(), index);
+						reference.emplace_back(value);
+					}
+					else
+					{
+						Assert::AreEqual(freed.back(), index);
+						freed.pop_back();
+						reference[index] = value;
+					}
+				}
+				else
+				{
+					const std::size_t index = rng() % reference.size();
+
+					if (reference[index].has_value())
+					{
+						vector.erase(index);
+						reference[index].reset();
+						freed.push_back(index);
+					}
+				}
+
+				if (i % 5000 == 0)
+					Assert::IsTrue(Same(vector, reference));
+			}
+
+			Assert::IsTrue(Same(vector, reference));
+
+			auto copy = vector;
+			Assert::IsTrue(Same(copy, reference));
+
+			auto moved = std::move(copy);
+			Assert::IsTrue(Same(moved, reference));
+
+			moved.reserve(moved.capacity() * 2);
+			Assert::IsTrue(Same(moved, reference));
+			Assert::IsTrue(moved == vector);
+		}
+
+		TEST_METHOD(FootprintBenchmark)
+		{
+			std::size_t oldBytes = 0;
+			std::size_t newBytes = 0;
+
+			std::vector<OldSlot, CountingAlloc<OldSlot>>			oldVector{ CountingAlloc<OldSlot>(oldBytes) };
+			cu::FreeVector<Payload, CountingAlloc<Payload>>		newVector{ CountingAlloc<Payload>(newBytes) };
+
+			oldVector.reserve(SLOT_COUNT);
+			newVector.reserve(SLOT_COUNT);
+
+			Benchmark("std::vector<std::variant<Payload, int64>> fill (" + std::to_string(SLOT_COUNT) + ")", [&]()
+			{
+				for (std::size_t i = 0; i < SLOT_COUNT; ++i)
+					oldVector.emplace_back(std::in_place_index<0>, static_cast<int>(i));
+			});
+
+			Benchmark("FreeVector<Payload> fill (" + std::to_string(SLOT_COUNT) + ")", [&]()
+			{
+				for (std::size_t i = 0; i < SLOT_COUNT; ++i)
+					(void)newVector.emplace(static_cast<int>(i));
+			});
+
+			Logger::WriteMessage(("old slot: " + std::to_string(sizeof(OldSlot)) + " B, " + std::to_string(oldBytes) + " B in total\n").c_str());
+			Logger::WriteMessage(("new slot: " + std::to_string(sizeof(Payload)) + " B and a bit, " + std::to_string(newBytes) + " B in total\n").c_str());
+
+			Assert::AreEqual(SLOT_COUNT * sizeof(OldSlot), oldBytes);
+			Assert::AreEqual(SLOT_COUNT * sizeof(Payload) + SLOT_COUNT / 8, newBytes); // one validity bit per slot
+			Assert::IsTrue(newBytes * 3 < oldBytes * 2);
+		}
+
+		TEST_METHOD(ForEachValidBenchmark)
+		{
+			std::vector<OldSlot>		oldVector;
+			cu::FreeVector<Payload>		newVector;
+
+			for (std::size_t i = 0; i < SLOT_COUNT; ++i)
+			{
+				oldVector.emplace_back(std::in_place_index<0>, static_cast<int>(i));
+				(void)newVector.emplace(static_cast<int>(i));
+			}
+
+			std::mt19937 rng(2);
+			for (std::size_t i = 0; i < SLOT_COUNT / 4; ++i) // a quarter of the slots become holes, scattered
+			{
+				const std::size_t index = rng() % SLOT_COUNT;
+
+				if (newVector.valid(index))
+				{
+					oldVector[index] = std::int64_t(-1);
+					newVector.erase(index);
+				}
+			}
+
+			std::int64_t oldSum		= 0;
+			std::int64_t indexSum	= 0;
+			std::int64_t validSum	= 0;
+
+			Benchmark("std::variant slots index loop", [&]()
+			{
+				for (std::size_t pass = 0; pass < PASSES; ++pass)
+				{
+					for (const OldSlot& slot : oldVector)
+					{
+						if (const Payload* payload = std::get_if<Payload>(&slot))
+							oldSum += payload->values[1];
+					}
+				}
+			});
+
+			Benchmark("FreeVector index loop", [&]()
+			{
+				for (std::size_t pass = 0; pass < PASSES; ++pass)
+				{
+					for (std::size_t i = 0; i < newVector.size(); ++i)
+					{
+						if (newVector.valid(i))
+							indexSum += newVector[i].values[1];
+					}
+				}
+			});
+
+			Benchmark("FreeVector for_each_valid", [&]()
+			{
+				for (std::size_t pass = 0; pass < PASSES; ++pass)
+				{
+					newVector.for_each_valid([&validSum](std::size_t, const Payload& aPayload)
+					{
+						validSum += aPayload.values[1];
+					});
+				}
+			});
+
+			Assert::AreEqual(oldSum, indexSum);
+			Assert::AreEqual(oldSum, validSum);
+		}
+
+	private:
+		static constexpr std::size_t SLOT_COUNT	= std::size_t(1) << 22;
+		static constexpr std::size_t PASSES		= 20;
+	};
+}
@@ -0,0 +1,224 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestUtils.h"
+
+#include <CommonUtilities/Structures/LooseOctree.hpp>
+#include <CommonUtilities/Structures/Octree.hpp>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	constexpr float WORLD_SIZE = 1000.0f; // half extent
+
+	enum class Sizes
+	{
+		Uniform,	// small boxes only
+		Mixed		// mostly small boxes, with some medium and a few large ones spanning many cells
+	};
+
+	cu::AABBf RandomBox(std::mt19937& aRng, Sizes aSizes)
+	{
+		std::uniform_real_distribution<float> position(-WORLD_SIZE, WORLD_SIZE);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+		const float roll = unit(aRng);
+
+		float size = 0.5f + unit(aRng) * 4.0f;
+		if (aSizes == Sizes::Mixed && roll >= 0.8f)
+			size = (roll < 0.97f) ? 10.0f + unit(aRng) * 60.0f : 100.0f + unit(aRng) * 400.0f;
+
+		const cu::Vector3f center(position(aRng), position(aRng), position(aRng));
+		const cu::Vector3f extents(size, size * (0.5f + unit(aRng)), size);
+
+		return cu::AABBf(center - extents, center + extents);
+	}
+
+	/// Hit counts of every query, so that the trees can be checked against each other.
+	///
+	struct Hits
+	{
+		std::size_t smallBoxes	= 0;
+		std::size_t largeBoxes	= 0;
+		std::size_t spheres		= 0;
+	};
+
+	/// Inserts the boxes, queries them, moves a tenth of them for a few frames, and erases them all.
+	///
+	template<class Tree>
+	Hits RunBenchmarks(const std::string& aName, Tree& aTree, const std::vector<cu::AABBf>& someBoxes, Sizes aSizes)
+	{
+		static constexpr int SMALL_QUERIES	= 5000;
+		static constexpr int LARGE_QUERIES	= 100;
+		static constexpr int CHURN_FRAMES	= 5;
+
+		std::vector<cu::AABBf>	boxes = someBoxes;
+		std::vector<int>		indices(boxes.size());
+		std::vector<int>		result;
+
+		Hits hits;
+
+		std::mt19937 rng(9);
+		std::uniform_real_distribution<float> position(-WORLD_SIZE, WORLD_SIZE);
+
+		const auto randomPoint = [&]() { return cu::Vector3f(position(rng), position(rng), position(rng)); };
+
+		Tests::Benchmark(aName + " insert", [&]()
+		{
+			for (std::size_t i = 0; i < boxes.size(); ++i)
+				indices[i] = aTree.Insert(boxes[i], static_cast<int>(i));
+		});
+
+		Tests::Benchmark(aName + " " + std::to_string(SMALL_QUERIES) + " small box queries", [&]()
+		{
+			for (int i = 0; i < SMALL_QUERIES; ++i)
+			{
+				const cu::Vector3f center = randomPoint();
+				aTree.Query(cu::AABBf(center - cu::Vector3f(40.0f), center + cu::Vector3f(40.0f)), result);
+				hits.smallBoxes += result.size();
+			}
+		});
+
+		Tests::Benchmark(aName + " " + std::to_string(LARGE_QUERIES) + " large box queries", [&]()
+		{
+			for (int i = 0; i < LARGE_QUERIES; ++i)
+			{
+				const cu::Vector3f center = randomPoint();
+				aTree.Query(cu::AABBf(center - cu::Vector3f(300.0f), center + cu::Vector3f(300.0f)), result);
+				hits.largeBoxes += result.size();
+			}
+		});
+
+		Tests::Benchmark(aName + " " + std::to_string(SMALL_QUERIES) + " sphere queries", [&]()
+		{
+			for (int i = 0; i < SMALL_QUERIES; ++i)
+			{
+				aTree.Query(cu::Spheref(randomPoint(), 40.0f), result);
+				hits.spheres += result.size();
+			}
+		});
+
+		Tests::Benchmark(aName + " churn", [&]()
+		{
+			std::mt19937 churnRng(5);
+
+			for (int frame = 0; frame < CHURN_FRAMES; ++frame)
+			{
+				for (std::size_t i = 0; i < boxes.size() / 10; ++i)
+				{
+					const std::size_t index = churnRng() % boxes.size();
+
+					aTree.Erase(indices[index]);
+					boxes[index] = RandomBox(churnRng, aSizes);
+					indices[index] = aTree.Insert(boxes[index], static_cast<int>(index));
+				}
+			}
+		});
+
+		Tests::Benchmark(aName + " erase all", [&]()
+		{
+			for (const int index : indices)
+				aTree.Erase(index);
+		});
+
+		Assert::AreEqual(0, aTree.ElementCount());
+
+		return hits;
+	}
+
+	void CompareTrees(Sizes aSizes, const std::string& aName)
+	{
+		static constexpr std::size_t BOX_COUNT = 20000;
+
+		std::mt19937 rng(3);
+
+		std::vector<cu::AABBf> boxes;
+		for (std::size_t i = 0; i < BOX_COUNT; ++i)
+			boxes.push_back(RandomBox(rng, aSizes));
+
+		const cu::AABBf root(cu::Vector3f(-WORLD_SIZE * 1.05f), cu::Vector3f(WORLD_SIZE * 1.05f));
+
+		cu::Octree<int>			octree(root, 16, 8);
+		cu::LooseOctree<int>	loose(root, 16, 8, 2.0f);
+		cu::LooseOctree<int>	tighter(root, 16, 8, 1.5f);
+
+		const Hits expected		= RunBenchmarks(aName + " Octree", octree, boxes, aSizes);
+		const Hits looseHits	= RunBenchmarks(aName + " LooseOctree 2.0", loose, boxes, aSizes);
+		const Hits tighterHits	= RunBenchmarks(aName + " LooseOctree 1.5", tighter, boxes, aSizes);
+
+		for (const Hits& hits : { looseHits, tighterHits })
+		{
+			Assert::AreEqual(expected.smallBoxes, hits.smallBoxes);
+			Assert::AreEqual(expected.largeBoxes, hits.largeBoxes);
+			Assert::AreEqual(expected.spheres, hits.spheres);
+		}
+	}
+}
+
+namespace Tests
+{
+	TEST_CLASS(LooseOctreeTests)
+	{
+	public:
+		TEST_METHOD(QueriesMatchBruteForce)
+		{
+			std::mt19937 rng(7);
+
+			for (const float looseness : { 1.0f, 1.5f, 2.0f, 3.0f })
+			{
+				cu::LooseOctree<int> tree(cu::AABBf(cu::Vector3f(-WORLD_SIZE), cu::Vector3f(WORLD_SIZE)), 4, 8, looseness);
+
+				std::vector<std::pair<cu::AABBf, int>> inserted;
+				for (int i = 0; i < 2000; ++i)
+				{
+					const cu::AABBf box = RandomBox(rng, Sizes::Mixed);
+					inserted.emplace_back(box, tree.Insert(box, i));
+				}
+
+				std::shuffle(inserted.begin(), inserted.end(), rng);
+				for (int i = 0; i < 500; ++i) // erase some, so that queries run over emptied nodes as well
+				{
+					Assert::IsTrue(tree.Erase(inserted.back().second));
+					inserted.pop_back();
+				}
+
+				std::vector<int> result;
+				std::vector<int> expected;
+
+				for (int i = 0; i < 100; ++i)
+				{
+					const cu::AABBf query = RandomBox(rng, Sizes::Mixed);
+
+					expected.clear();
+					for (const auto& [box, index] : inserted)
+					{
+						if (box.Overlaps(query))
+							expected.push_back(index);
+					}
+
+					tree.Query(query, result);
+
+					std::ranges::sort(result);
+					std::ranges::sort(expected);
+
+					Assert::IsTrue(result == expected);
+				}
+			}
+		}
+
+		TEST_METHOD(MixedSizeBenchmark)
+		{
+			CompareTrees(Sizes::Mixed, "mixed");
+		}
+
+		TEST_METHOD(UniformSizeBenchmark)
+		{
+			CompareTrees(Sizes::Uniform, "uniform");
+		}
+	};
+}
@@ -0,0 +1,226 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestUtils.h"
+
+#include <CommonUtilities/Thread/Parallel.hpp>
+#include <CommonUtilities/Thread/ThreadPool.h>
+#include <CommonUtilities/Utility/ExecPolicy.h>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	/// Some arithmetic per element, so that the loops are not bound by memory bandwidth alone.
+	///
+	std::uint64_t Work(std::uint64_t aValue)
+	{
+		aValue ^= aValue >> 33;
+		aValue *= 0xFF51AFD7ED558CCDull;
+		aValue ^= aValue >> 33;
+		aValue *= 0xC4CEB9FE1A85EC53ull;
+		aValue ^= aValue >> 33;
+
+		return aValue & 0xFFFF;
+	}
+
+	/// 2x2 matrix product, associative but not commutative, so partials combined out of order show up.
+	///
+	using Matrix = std::array<std::uint64_t, 4>;
+
+	Matrix Multiply(const Matrix& aLeft, const Matrix& aRight)
+	{
+		return
+		{
+			aLeft[0] * aRight[0] + aLeft[1] * aRight[2], aLeft[0] * aRight[1] + aLeft[1] * aRight[3],
+			aLeft[2] * aRight[0] + aLeft[3] * aRight[2], aLeft[2] * aRight[1] + aLeft[3] * aRight[3]
+		};
+	}
+
+	std::vector<std::uint64_t> MakeValues(std::size_t aCount)
+	{
+		std::mt19937_64 rng(1);
+
+		std::vector<std::uint64_t> values(aCount);
+		for (std::uint64_t& value : values)
+			value = rng();
+
+		return values;
+	}
+}
+
+namespace Tests
+{
+	TEST_CLASS(ParallelTests)
+	{
+	public:
+		TEST_METHOD(MatchesSequentialForAnyGrainSize)
+		{
+			cu::ThreadPool pool;
+			pool.Start(3);
+
+			for (const std::size_t count : { std::size_t(0), std::size_t(1), std::size_t(1000), std::size_t(100003) })
+			{
+				const std::vector<std::uint64_t> values = MakeValues(count);
+
+				std::vector<std::uint64_t> expectedScan(count);
+				std::inclusive_scan(values.begin(), values.end(), expectedScan.begin());
+
+				const std::uint64_t expectedSum		= std::accumulate(values.begin(), values.end(), std::uint64_t(0));
+				const std::uint64_t expectedWork	= std::transform_reduce(values.begin(), values.end(), std::uint64_t(0), std::plus<>(), Work);
+
+				for (const std::size_t grainSize : { std::size_t(0), std::size_t(1), std::size_t(7), std::size_t(4096), count + 1 })
+				{
+					std::vector<std::uint64_t> output(count);
+					cu::ParallelFor(pool, std::size_t(0), count, grainSize, [&](std::size_t anIndex) { output[anIndex] = values[anIndex] + 1; });
+
+					for (std::size_t i = 0; i < count; ++i)
+						Assert::AreEqual(values[i] + 1, output[i]);
+
+					Assert::AreEqual(expectedSum, cu::ParallelReduce(pool, values.begin(), values.end(), grainSize, std::uint64_t(0)));
+					Assert::AreEqual(expectedWork, cu::ParallelTransformReduce(pool, values.begin(), values.end(), grainSize, std::uint64_t(0), std::plus<>(), Work));
+
+					cu::ParallelInclusiveScan(pool, values.begin(), values.end(), output.begin(), grainSize);
+					Assert::IsTrue(output == expectedScan);
+				}
+			}
+		}
+
+		TEST_METHOD(ReduceKeepsChunkOrder)
+		{
+			cu::ThreadPool pool;
+			pool.Start(3);
+
+			std::mt19937_64 rng(2);
+
+			std::vector<Matrix> matrices(10000);
+			for (Matrix& matrix : matrices)
+				matrix = { rng() % 4, rng() % 4, rng() % 4, rng() % 4 };
+
+			const Matrix identity { 1, 0, 0, 1 };
+			const Matrix expected = std::accumulate(matrices.begin(), matrices.end(), identity, Multiply);
+
+			for (const std::size_t grainSize : { std::size_t(0), std::size_t(1), std::size_t(33) })
+			{
+				Assert::IsTrue(expected == cu::ParallelReduce(pool, matrices.begin(), matrices.end(), grainSize, identity, Multiply));
+
+				std::vector<Matrix> scanned(matrices.size());
+				cu::ParallelInclusiveScan(pool, matrices.begin(), matrices.end(), scanned.begin(), grainSize, Multiply);
+
+				Assert::IsTrue(expected == scanned.back());
+			}
+		}
+
+		TEST_METHOD(ExecPolicyBenchmark)
+		{
+			const std::size_t threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 2) - 1; // the caller takes part as well
+
+			cu::ThreadPool pool;
+			pool.Start(threads, cu::ThreadPool::Scheduling::WorkStealing);
+
+			const std::vector<std::uint64_t> values = MakeValues(COUNT);
+			const std::string suffix = " (" + std::to_string(COUNT) + ")";
+
+			std::vector<std::uint64_t> poolOutput(COUNT);
+			std::vector<std::uint64_t> policyOutput(COUNT);
+
+			Benchmark("ParallelFor on pool" + suffix, [&]()
+			{
+				for (std::size_t pass = 0; pass < PASSES; ++pass)
+					cu::ParallelFor(pool, std::size_t(0), COUNT, 0, [&](std::size_t anIndex) { poolOutput[anIndex] = Work(values[anIndex]); });
+			});
+
+			Benchmark("std::for_each par_unseq" + suffix, [&]()
+			{
+				for (std::size_t pass = 0; pass < PASSES; ++pass)
+				{
+					cu::ExecPolicy([&](auto& aPolicy)
+					{
+						std::for_each(aPolicy, values.begin(), values.end(), [&](const std::uint64_t& aValue)
+						{
+							policyOutput[&aValue - values.data()] = Work(aValue);
+						});
+					}, cu::Policy::ParUnseq);
+				}
+			});
+
+			Assert::IsTrue(poolOutput == policyOutput);
+
+			std::uint64_t poolSum	= 0;
+			std::uint64_t policySum	= 0;
+
+			Benchmark("ParallelReduce on pool" + suffix, [&]()
+			{
+				for (std::size_t pass = 0; pass < PASSES; ++pass)
+					poolSum += cu::ParallelReduce(pool, values.begin(), values.end(), 0, std::uint64_t(0));
+			});
+
+			Benchmark("std::reduce par_unseq" + suffix, [&]()
+			{
+				for (std::size_t pass = 0; pass < PASSES; ++pass)
+				{
+					policySum += cu::ExecPolicy([&](auto& aPolicy)
+					{
+						return std::reduce(aPolicy, values.begin(), values.end(), std::uint64_t(0));
+					}, cu::Policy::ParUnseq);
+				}
+			});
+
+			Assert::AreEqual(policySum, poolSum);
+
+			poolSum		= 0;
+			policySum	= 0;
+
+			Benchmark("ParallelTransformReduce on pool" + suffix, [&]()
+			{
+				for (std::size_t pass = 0; pass < PASSES; ++pass)
+					poolSum += cu::ParallelTransformReduce(pool, values.begin(), values.end(), 0, std::uint64_t(0), std::plus<>(), Work);
+			});
+
+			Benchmark("std::transform_reduce par_unseq" + suffix, [&]()
+			{
+				for (std::size_t pass = 0; pass < PASSES; ++pass)
+				{
+					policySum += cu::ExecPolicy([&](auto& aPolicy)
+					{
+						return std::transform_reduce(aPolicy, values.begin(), values.end(), std::uint64_t(0), std::plus<>(), Work);
+					}, cu::Policy::ParUnseq);
+				}
+			});
+
+			Assert::AreEqual(policySum, poolSum);
+
+			Benchmark("ParallelInclusiveScan on pool" + suffix, [&]()
+			{
+				for (std::size_t pass = 0; pass < PASSES; ++pass)
+					cu::ParallelInclusiveScan(pool, values.begin(), values.end(), poolOutput.begin(), 0);
+			});
+
+			Benchmark("std::inclusive_scan par_unseq" + suffix, [&]()
+			{
+				for (std::size_t pass = 0; pass < PASSES; ++pass)
+				{
+					cu::ExecPolicy([&](auto& aPolicy)
+					{
+						std::inclusive_scan(aPolicy, values.begin(), values.end(), policyOutput.begin());
+					}, cu::Policy::ParUnseq);
+				}
+			});
+
+			Assert::IsTrue(poolOutput == policyOutput);
+		}
+
+	private:
+		static constexpr std::size_t COUNT	= std::size_t(1) << 22;
+		static constexpr std::size_t PASSES	= 10;
+	};
+}
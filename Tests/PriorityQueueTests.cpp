@@ -0,0 +1,355 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestUtils.h"
+
+#include <CommonUtilities/Structures/IndexedPriorityQueue.hpp>
+#include <CommonUtilities/Structures/PriorityQueue.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <limits>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	struct Item
+	{
+		std::int64_t	key {0};
+		int				id	{0}; // breaks ties, so that the expected top is unique
+
+		bool operator<(const Item& aOther) const { return key != aOther.key ? key < aOther.key : id < aOther.id; }
+		bool operator==(const Item& aOther) const = default;
+	};
+
+	/// Runs random pushes, pops, updates, decrease-keys, erases and heapifies on the queue and a set
+	/// holding the same items, checking the top and size after every operation.
+	///
+	template<cu::pq::HeapType C, std::size_t D>
+	void RandomizedAgainstSet(unsigned aSeed)
+	{
+		static constexpr bool IS_MIN = (C == cu::pq::HeapType::Min);
+
+		std::mt19937 rng(aSeed);
+
+		cu::IndexedPriorityQueue<Item, C, D>	queue;
+		std::set<Item>							reference;
+		std::vector<cu::SlotHandle>				handles;	// by item id, stays behind once the item is gone
+		std::vector<Item>						items;		// by item id, current value
+
+		const auto randomKey = [&rng]() { return static_cast<std::int64_t>(rng() % 100000); };
+
+		const auto add = [&](cu::SlotHandle aHandle, const Item& anItem)
+		{
+			handles.push_back(aHandle);
+			items.push_back(anItem);
+			reference.insert(anItem);
+		};
+
+		const auto randomLive = [&]() -> int // id of an item still queued, or -1
+		{
+			if (reference.empty())
+				return -1;
+
+			for (int attempt = 0; attempt < 16; ++attempt)
+			{
+				const int id = static_cast<int>(rng() % items.size());
+				if (queue.contains(handles[id]))
+					return id;
+			}
+
+			return reference.begin()->id;
+		};
+
+		for (int i = 0; i < 40000; ++i)
+		{
+			switch (rng() % 8)
+			{
+				case 0:
+				case 1:
+				{
+					const Item item{ randomKey(), static_cast<int>(items.size()) };
+					add(queue.push(item), item);
+				}
+				break;
+				case 2:
+				{
+					if (!queue.empty())
+					{
+						const Item top = queue.top();
+						Assert::IsTrue(queue.top_handle() == handles[top.id]);
+
+						queue.pop();
+						reference.erase(top);
+
+						Assert::IsFalse(queue.contains(handles[top.id]));
+					}
+				}
+				break;
+				case 3:
+				{
+					if (const int id = randomLive(); id != -1)
+					{
+						const Item item{ randomKey(), id };
+
+						queue.update(handles[id], item);
+						reference.erase(items[id]);
+						reference.insert(item);
+						items[id] = item;
+					}
+				}
+				break;
+				case 4:
+				{
+					if (const int id = randomLive(); id != -1)
+					{
+						const std::int64_t change = static_cast<std::int64_t>(rng() % 1000);
+						const Item item{ IS_MIN ? items[id].key - change : items[id].key + change, id }; // higher priority
+
+						queue.decrease_key(handles[id], item);
+						reference.erase(items[id]);
+						reference.insert(item);
+						items[id] = item;
+					}
+				}
+				break;
+				case 5:
+				{
+					if (const int id = randomLive(); id != -1)
+					{
+						Assert::IsTrue(queue.erase(handles[id]));
+						Assert::IsFalse(queue.erase(handles[id])); // stale now
+						reference.erase(items[id]);
+					}
+				}
+				break;
+				case 6:
+				{
+					std::vector<Item> batch(rng() % 64);
+					for (std::size_t j = 0; j < batch.size(); ++j)
+						batch[j] = Item{ randomKey(), static_cast<int>(items.size() + j) };
+
+					std::vector<cu::SlotHandle> batchHandles;
+					queue.heapify(batch, std::back_inserter(batchHandles));
+
+					Assert::AreEqual(batch.size(), batchHandles.size());
+
+					for (std::size_t j = 0; j < batch.size(); ++j)
+					{
+						add(batchHandles[j], batch[j]);
+						Assert::IsTrue(queue[batchHandles[j]] == batch[j]);
+					}
+				}
+				break;
+				default:
+				{
+					if (const int id = randomLive(); id != -1)
+						Assert::IsTrue(queue[handles[id]] == items[id]);
+				}
+				break;
+			}
+
+			Assert::AreEqual(reference.size(), queue.size());
+
+			if (!reference.empty())
+				Assert::IsTrue(queue.top() == (IS_MIN ? *reference.begin() : *reference.rbegin()));
+		}
+
+		while (!queue.empty()) // drains in order
+		{
+			const Item expected = IS_MIN ? *reference.begin() : *std::prev(reference.end());
+
+			Assert::IsTrue(queue.top() == expected);
+
+			queue.pop();
+			reference.erase(expected);
+		}
+
+		Assert::IsTrue(reference.empty());
+	}
+
+	struct Node
+	{
+		std::int64_t	cost {0}; // distance so far, plus the heuristic for A*
+		int				cell {0};
+
+		bool operator<(const Node& aOther) const { return cost < aOther.cost; }
+	};
+
+	/// Grid with random costs of entering each cell, moving to any of the four neighbours.
+	///
+	struct Grid
+	{
+		int width {0};
+		std::vector<std::uint8_t> costs;
+
+		std::int64_t Heuristic(int aCell, int aGoal) const // manhattan distance, admissible as every cell costs at least 1
+		{
+			return std::abs(aCell % width - aGoal % width) + std::abs(aCell / width - aGoal / width);
+		}
+
+		template<class Func>
+		void ForEachNeighbour(int aCell, Func&& aFunc) const
+		{
+			const int x = aCell % width;
+			const int y = aCell / width;
+
+			if (x > 0)			aFunc(aCell - 1);
+			if (x < width - 1)	aFunc(aCell + 1);
+			if (y > 0)			aFunc(aCell - width);
+			if (y < width - 1)	aFunc(aCell + width);
+		}
+	};
+
+	/// Shortest path from the first to the given cell, pushing a new entry whenever a cell gets closer
+	/// and skipping those that are stale once popped. Searches every cell if the goal is negative.
+	///
+	/// \returns Distance to the goal, or to the last cell when searching every cell.
+	///
+	std::int64_t LazySearch(const Grid& aGrid, int aGoal, std::size_t& aPeak)
+	{
+		const bool useHeuristic = (aGoal >= 0);
+		const int goal = useHeuristic ? aGoal : static_cast<int>(aGrid.costs.size()) - 1;
+
+		std::vector<std::int64_t> distances(aGrid.costs.size(), (std::numeric_limits<std::int64_t>::max)());
+
+		cu::PriorityQueue<Node> queue;
+
+		distances[0] = 0;
+		queue.push(Node{ useHeuristic ? aGrid.Heuristic(0, goal) : 0, 0 });
+
+		aPeak = 0;
+
+		while (!queue.empty())
+		{
+			const Node node = queue.top();
+			queue.pop();
+
+			const std::int64_t distance = node.cost - (useHeuristic ? aGrid.Heuristic(node.cell, goal) : 0);
+
+			if (distance > distances[node.cell])
+				continue;
+
+			if (useHeuristic && node.cell == goal)
+				break;
+
+			aGrid.ForEachNeighbour(node.cell, [&](int aNeighbour)
+			{
+				const std::int64_t next = distance + aGrid.costs[aNeighbour];
+				if (next < distances[aNeighbour])
+				{
+					distances[aNeighbour] = next;
+					queue.push(Node{ next + (useHeuristic ? aGrid.Heuristic(aNeighbour, goal) : 0), aNeighbour });
+				}
+			});
+
+			aPeak = (std::max)(aPeak, queue.size());
+		}
+
+		return distances[goal];
+	}
+
+	/// Same search, but every cell is queued at most once and moved up when it gets closer.
+	///
+	template<std::size_t D>
+	std::int64_t IndexedSearch(const Grid& aGrid, int aGoal, std::size_t& aPeak)
+	{
+		const bool useHeuristic = (aGoal >= 0);
+		const int goal = useHeuristic ? aGoal : static_cast<int>(aGrid.costs.size()) - 1;
+
+		std::vector<std::int64_t>	distances(aGrid.costs.size(), (std::numeric_limits<std::int64_t>::max)());
+		std::vector<cu::SlotHandle>	handles(aGrid.costs.size());
+
+		cu::IndexedPriorityQueue<Node, cu::pq::HeapType::Min, D> queue;
+
+		distances[0] = 0;
+		handles[0] = queue.push(Node{ useHeuristic ? aGrid.Heuristic(0, goal) : 0, 0 });
+
+		aPeak = 0;
+
+		while (!queue.empty())
+		{
+			const Node node = queue.top();
+			queue.pop();
+
+			if (useHeuristic && node.cell == goal)
+				break;
+
+			const std::int64_t distance = distances[node.cell];
+
+			aGrid.ForEachNeighbour(node.cell, [&](int aNeighbour)
+			{
+				const std::int64_t next = distance + aGrid.costs[aNeighbour];
+				if (next < distances[aNeighbour])
+				{
+					const Node updated{ next + (useHeuristic ? aGrid.Heuristic(aNeighbour, goal) : 0), aNeighbour };
+
+					if (queue.contains(handles[aNeighbour]))
+						queue.decrease_key(handles[aNeighbour], updated);
+					else
+						handles[aNeighbour] = queue.push(updated);
+
+					distances[aNeighbour] = next;
+				}
+			});
+
+			aPeak = (std::max)(aPeak, queue.size());
+		}
+
+		return distances[goal];
+	}
+}
+
+namespace Tests
+{
+	TEST_CLASS(PriorityQueueTests)
+	{
+	public:
+		TEST_METHOD(RandomizedBinaryMinHeap)		{ RandomizedAgainstSet<cu::pq::HeapType::Min, 2>(1); }
+		TEST_METHOD(RandomizedQuaternaryMinHeap)	{ RandomizedAgainstSet<cu::pq::HeapType::Min, 4>(2); }
+		TEST_METHOD(RandomizedQuaternaryMaxHeap)	{ RandomizedAgainstSet<cu::pq::HeapType::Max, 4>(3); }
+		TEST_METHOD(RandomizedOctonaryMinHeap)		{ RandomizedAgainstSet<cu::pq::HeapType::Min, 8>(4); }
+
+		TEST_METHOD(GridSearchBenchmark)
+		{
+			std::mt19937 rng(5);
+
+			Grid grid;
+			grid.width = GRID_WIDTH;
+			grid.costs.resize(static_cast<std::size_t>(GRID_WIDTH) * GRID_WIDTH);
+
+			for (std::uint8_t& cost : grid.costs)
+				cost = static_cast<std::uint8_t>(1 + rng() % 9);
+
+			const int corner = GRID_WIDTH * GRID_WIDTH - 1;
+			const int center = GRID_WIDTH * (GRID_WIDTH / 2) + GRID_WIDTH / 2;
+
+			for (const auto& [goal, name] : { std::pair(-1, "Dijkstra"), std::pair(corner, "A* to corner"), std::pair(center, "A* to center") })
+			{
+				const std::string suffix = " " + std::string(name) + " " + std::to_string(GRID_WIDTH) + "x" + std::to_string(GRID_WIDTH);
+
+				std::size_t lazyPeak = 0, binaryPeak = 0, quaternaryPeak = 0;
+				std::int64_t lazy = 0, binary = 0, quaternary = 0;
+
+				Benchmark("PriorityQueue (lazy)" + suffix,	[&]() { lazy = LazySearch(grid, goal, lazyPeak); });
+				Benchmark("IndexedPriorityQueue D=2" + suffix,	[&]() { binary = IndexedSearch<2>(grid, goal, binaryPeak); });
+				Benchmark("IndexedPriorityQueue D=4" + suffix,	[&]() { quaternary = IndexedSearch<4>(grid, goal, quaternaryPeak); });
+
+				Logger::WriteMessage(("peak queue size, lazy: " + std::to_string(lazyPeak) + ", indexed: " + std::to_string(quaternaryPeak) + "\n").c_str());
+
+				Assert::AreEqual(lazy, binary);
+				Assert::AreEqual(lazy, quaternary);
+				Assert::IsTrue(quaternaryPeak <= lazyPeak);
+			}
+		}
+
+	private:
+		static constexpr int GRID_WIDTH = 1000;
+	};
+}
@@ -0,0 +1,85 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestUtils.h"
+
+#include <CommonUtilities/Thread/TaskGroup.h>
+#include <CommonUtilities/Thread/ThreadPool.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <string>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	/// Every task opens a group of its own and waits on it from within the pool, so with few workers
+	/// all of them end up waiting and the innermost tasks only run if the waiting threads help.
+	///
+	void Fan(cu::ThreadPool& aPool, std::atomic<std::size_t>& aLeaves, std::size_t aDepth, std::size_t aWidth)
+	{
+		if (aDepth == 0)
+		{
+			++aLeaves;
+			return;
+		}
+
+		cu::TaskGroup group(aPool);
+
+		for (std::size_t i = 0; i < aWidth; ++i)
+			group.Run([&aPool, &aLeaves, aDepth, aWidth]() { Fan(aPool, aLeaves, aDepth - 1, aWidth); });
+
+		group.Wait();
+	}
+}
+
+namespace Tests
+{
+	TEST_CLASS(TaskGroupTests)
+	{
+	public:
+		TEST_METHOD(NestedGroupsOnFewWorkers)
+		{
+			for (const auto scheduling : { cu::ThreadPool::Scheduling::GlobalQueue, cu::ThreadPool::Scheduling::WorkStealing })
+			{
+				for (const std::size_t workers : { std::size_t(1), std::size_t(2) })
+				{
+					cu::ThreadPool pool;
+					pool.Start(workers, scheduling);
+
+					for (std::size_t round = 0; round < ROUNDS; ++round)
+					{
+						std::atomic<std::size_t> leaves {0};
+
+						Fan(pool, leaves, DEPTH, WIDTH);
+
+						Assert::AreEqual(std::size_t(WIDTH * WIDTH * WIDTH), leaves.load());
+					}
+				}
+			}
+		}
+
+		TEST_METHOD(NestedGroupRethrows)
+		{
+			cu::ThreadPool pool;
+			pool.Start(1, cu::ThreadPool::Scheduling::WorkStealing);
+
+			cu::TaskGroup outer(pool);
+
+			outer.Run([&pool]()
+			{
+				cu::TaskGroup inner(pool);
+				inner.Run([]() { throw std::runtime_error("inner"); });
+				inner.Wait(); // rethrown here, then captured by the outer group
+			});
+
+			Assert::ExpectException<std::runtime_error>([&outer]() { outer.Wait(); });
+			Assert::IsTrue(outer.IsDone());
+		}
+
+	private:
+		static constexpr std::size_t DEPTH	= 3;
+		static constexpr std::size_t WIDTH	= 8;
+		static constexpr std::size_t ROUNDS	= 50;
+	};
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CppUnitTest.h"
+
+#include <CommonUtilities/Utility/Benchmark.h>
+
+#include <chrono>
+#include <string>
+
+namespace Tests
+{
+	/// Profiles the function with the Benchmark.h harness and also writes its run time to the test
+	/// output, as the harness itself only prints to the console.
+	///
+	/// \returns Run time in seconds.
+	///
+	template<class Func>
+	double Benchmark(const std::string& aName, Func&& aFunc)
+	{
+		cu::bm::Begin(aName);
+
+		const auto begin = std::chrono::steady_clock::now();
+		aFunc();
+		const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - begin;
+
+		cu::bm::End();
+
+		Microsoft::VisualStudio::CppUnitTestFramework::Logger::WriteMessage((aName + ": " + std::to_string(elapsed.count() * 1000.0) + " ms\n").c_str());
+
+		return elapsed.count();
+	}
+}
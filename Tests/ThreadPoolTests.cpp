@@ -0,0 +1,231 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestUtils.h"
+
+#include <CommonUtilities/Thread/ThreadPool.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <future>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+// every allocation made through the global operator new by any thread is counted while enabled,
+// including those made by the workers
+
+static std::atomic<bool>			locCounting		{false};
+static std::atomic<std::int64_t>	locAllocations	{0};
+
+void* operator new(std::size_t aSize)
+{
+	if (locCounting.load(std::memory_order_relaxed))
+		locAllocations.fetch_add(1, std::memory_order_relaxed);
+
+	if (void* memory = std::malloc(aSize != 0 ? aSize : 1))
+		return memory;
+
+	throw std::bad_alloc();
+}
+
+void operator delete(void* aMemory) noexcept
+{
+	std::free(aMemory);
+}
+
+void operator delete(void* aMemory, std::size_t) noexcept
+{
+	std::free(aMemory);
+}
+
+namespace Tests
+{
+	TEST_CLASS(ThreadPoolTests)
+	{
+	public:
+		TEST_METHOD(SubmitDoesNotAllocate)
+		{
+			for (const auto scheduling : { cu::ThreadPool::Scheduling::GlobalQueue, cu::ThreadPool::Scheduling::WorkStealing })
+			{
+				cu::ThreadPool pool;
+				pool.Start(4, scheduling);
+
+				std::atomic<std::size_t> completed {0};
+
+				const auto submit = [&pool, &completed](std::size_t aCount)
+				{
+					completed = 0;
+
+					for (std::size_t i = 0; i < aCount; ++i)
+					{
+						std::array<char, 40> capture{}; // well within TASK_CAPACITY
+						capture[0] = 1;
+
+						pool.Submit([&completed, capture]() { completed += capture[0]; });
+					}
+
+					while (completed.load() < aCount)
+						std::this_thread::yield();
+				};
+
+				submit(WARMUP_COUNT); // grows the queues and fills the block caches
+
+				const std::int64_t allocations = CountAllocations([&]() { submit(TASK_COUNT); });
+
+				Assert::AreEqual(std::int64_t(0), allocations, L"Submit allocated in steady state");
+			}
+		}
+
+		TEST_METHOD(EnqueueDoesNotAllocate)
+		{
+			for (const auto scheduling : { cu::ThreadPool::Scheduling::GlobalQueue, cu::ThreadPool::Scheduling::WorkStealing })
+			{
+				cu::ThreadPool pool;
+				pool.Start(4, scheduling);
+
+				std::vector<std::future<std::size_t>> futures;
+				futures.reserve(WARMUP_COUNT);
+
+				std::size_t mismatches = 0; // asserting builds messages on the heap, so results are checked after counting
+
+				const auto enqueue = [&pool, &futures, &mismatches](std::size_t aCount)
+				{
+					futures.clear();
+
+					for (std::size_t i = 0; i < aCount; ++i)
+					{
+						if (i % 2 == 0)
+						{
+							futures.push_back(pool.Enqueue([i]() { return i; }));
+						}
+						else
+						{
+							std::array<std::size_t, 6> capture{}; // 48 bytes, does not fit in TASK_CAPACITY along with the promise
+							capture.fill(i);
+
+							futures.push_back(pool.Enqueue([capture]() { return capture.back(); }));
+						}
+					}
+
+					for (std::size_t i = 0; i < aCount; ++i)
+						mismatches += (futures[i].get() != i);
+				};
+
+				enqueue(WARMUP_COUNT);
+
+				const std::int64_t allocations = CountAllocations([&]() { enqueue(TASK_COUNT); });
+
+				Assert::AreEqual(std::size_t(0), mismatches);
+				Assert::AreEqual(std::int64_t(0), allocations, L"Enqueue allocated in steady state");
+			}
+		}
+
+		TEST_METHOD(NestedSubmitDoesNotAllocate)
+		{
+			cu::ThreadPool pool;
+			pool.Start(4, cu::ThreadPool::Scheduling::WorkStealing);
+
+			std::atomic<std::size_t> completed {0};
+
+			const auto submit = [&pool, &completed](std::size_t aRounds)
+			{
+				for (std::size_t round = 0; round < aRounds; ++round)
+				{
+					completed = 0;
+
+					pool.Submit([&pool, &completed]()
+					{
+						for (std::size_t i = 0; i < NESTED_COUNT; ++i) // pushed to the worker's own deque
+							pool.Submit([&completed]() { ++completed; });
+					});
+
+					while (completed.load() < NESTED_COUNT)
+						std::this_thread::yield();
+				}
+			};
+
+			submit(WARMUP_COUNT / NESTED_COUNT);
+
+			const std::int64_t allocations = CountAllocations([&]() { submit(TASK_COUNT / NESTED_COUNT); });
+
+			Assert::AreEqual(std::int64_t(0), allocations, L"Submit from a worker allocated in steady state");
+		}
+
+		TEST_METHOD(SchedulingContentionBenchmark)
+		{
+			const std::size_t threads = std::max<std::size_t>(std::thread::hardware_concurrency(), 2);
+
+			for (const auto scheduling : { cu::ThreadPool::Scheduling::GlobalQueue, cu::ThreadPool::Scheduling::WorkStealing })
+			{
+				const std::string name = (scheduling == cu::ThreadPool::Scheduling::GlobalQueue) ? "GlobalQueue" : "WorkStealing";
+
+				cu::ThreadPool pool;
+				pool.Start(threads, scheduling);
+
+				std::atomic<std::size_t> completed {0};
+
+				// every task is submitted from outside, so all of them pass through the shared queue
+
+				Benchmark(name + ": " + std::to_string(BENCHMARK_COUNT) + " external tasks", [&]()
+				{
+					completed = 0;
+
+					for (std::size_t i = 0; i < BENCHMARK_COUNT; ++i)
+						pool.Submit([&completed]() { completed.fetch_add(1, std::memory_order_relaxed); });
+
+					while (completed.load() < BENCHMARK_COUNT)
+						std::this_thread::yield();
+				});
+
+				// tasks split their range in two until small enough, so nearly every task is submitted by a worker
+
+				Benchmark(name + ": " + std::to_string(BENCHMARK_COUNT) + " items split recursively", [&]()
+				{
+					completed = 0;
+
+					Split(pool, completed, 0, BENCHMARK_COUNT);
+
+					while (completed.load() < BENCHMARK_COUNT)
+						std::this_thread::yield();
+				});
+			}
+		}
+
+	private:
+		static constexpr std::size_t WARMUP_COUNT		= 4096;
+		static constexpr std::size_t TASK_COUNT			= 1024;
+		static constexpr std::size_t NESTED_COUNT		= 128; // below the initial capacity of a worker's deque, which only grows once per worker
+		static constexpr std::size_t BENCHMARK_COUNT	= 1 << 18;
+
+		static void Split(cu::ThreadPool& aPool, std::atomic<std::size_t>& aCompleted, std::size_t aBegin, std::size_t aEnd)
+		{
+			if (aEnd - aBegin <= 16)
+			{
+				aCompleted.fetch_add(aEnd - aBegin, std::memory_order_relaxed);
+				return;
+			}
+
+			const std::size_t middle = aBegin + (aEnd - aBegin) / 2;
+
+			aPool.Submit([&aPool, &aCompleted, aBegin, middle]() { Split(aPool, aCompleted, aBegin, middle); });
+			aPool.Submit([&aPool, &aCompleted, middle, aEnd]() { Split(aPool, aCompleted, middle, aEnd); });
+		}
+
+		template<class Func>
+		static std::int64_t CountAllocations(Func&& aFunc)
+		{
+			locAllocations = 0;
+			locCounting = true;
+
+			aFunc();
+
+			locCounting = false;
+			return locAllocations.load();
+		}
+	};
+}
@@ -0,0 +1,186 @@
+#include "pch.h"
+#include "CppUnitTest.h"
+#include "TestUtils.h"
+
+#include <CommonUtilities/Structures/SmallVector.hpp>
+#include <CommonUtilities/Structures/StaticVector.hpp>
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Microsoft::VisualStudio::CppUnitTestFramework;
+
+namespace
+{
+	struct Pod // trivially copyable, relocated with memcpy/memmove
+	{
+		Pod() = default;
+		explicit Pod(int aValue) : values{ aValue } {}
+
+		std::array<int, 6> values {};
+	};
+
+	struct Handle // owns memory, only relocated in bulk because it opts in below
+	{
+		Handle() = default;
+		explicit Handle(int aValue) : value(std::make_unique<int>(aValue)) {}
+
+		std::unique_ptr<int> value;
+	};
+
+	int GetValue(int aValue)				{ return aValue; }
+	int GetValue(const Pod& aPod)			{ return aPod.values[0]; }
+	int GetValue(const Handle& aHandle)		{ return *aHandle.value; }
+
+	enum class Operation
+	{
+		PushBack,
+		MidInsert,	// insert every element in the middle
+		FrontErase	// fill, then erase from the front until empty
+	};
+
+	/// \returns Checksum of the elements in the order they were visited, to compare containers by.
+	///
+	template<class Vector>
+	std::size_t Perform(Operation aOperation, int aCount)
+	{
+		using T = typename Vector::value_type;
+
+		Vector vector;
+		std::size_t checksum = 0;
+
+		switch (aOperation)
+		{
+			case Operation::PushBack:
+			{
+				for (int i = 0; i < aCount; ++i)
+					vector.push_back(T(i));
+			}
+			break;
+			case Operation::MidInsert:
+			{
+				for (int i = 0; i < aCount; ++i)
+					vector.insert(vector.begin() + static_cast<std::ptrdiff_t>(vector.size() / 2), T(i));
+			}
+			break;
+			case Operation::FrontErase:
+			{
+				for (int i = 0; i < aCount; ++i)
+					vector.push_back(T(i));
+
+				while (!vector.empty())
+				{
+					checksum = checksum * 31 + static_cast<std::size_t>(GetValue(vector.front()));
+					vector.erase(vector.begin());
+				}
+			}
+			break;
+		}
+
+		for (const T& element : vector)
+			checksum = checksum * 31 + static_cast<std::size_t>(GetValue(element));
+
+		return checksum;
+	}
+}
+
+template<>
+struct cu::TriviallyRelocatable<Handle> : std::true_type {};
+
+namespace Tests
+{
+	TEST_CLASS(VectorTests)
+	{
+	public:
+		TEST_METHOD(IntBenchmark)		{ RunBenchmarks<int>("int"); }
+		TEST_METHOD(PodBenchmark)		{ RunBenchmarks<Pod>("Pod24"); }
+		TEST_METHOD(HandleBenchmark)	{ RunBenchmarks<Handle>("Handle"); }
+
+		TEST_METHOD(SwapBenchmark)
+		{
+			cu::SmallVector<Handle, INLINE_COUNT> smallLhs, smallRhs;
+			cu::StaticVector<Handle, MAX_COUNT> staticLhs, staticRhs;
+
+			for (int i = 0; i < 24; ++i) // fits inline, so the elements themselves are swapped
+			{
+				smallLhs.push_back(Handle(i));
+				smallRhs.push_back(Handle(-i));
+			}
+
+			for (int i = 0; i < 200; ++i)
+			{
+				staticLhs.push_back(Handle(i));
+				staticRhs.push_back(Handle(-i));
+			}
+
+			Benchmark("SmallVector<Handle> swap (24 inline)", [&]()
+			{
+				for (std::size_t i = 0; i < REPETITIONS * 100; ++i)
+					smallLhs.swap(smallRhs);
+			});
+
+			Benchmark("StaticVector<Handle> swap (200)", [&]()
+			{
+				for (std::size_t i = 0; i < REPETITIONS * 100; ++i)
+					staticLhs.swap(staticRhs);
+			});
+
+			Assert::AreEqual(23, GetValue(smallLhs.back()));
+			Assert::AreEqual(199, GetValue(staticLhs.back()));
+		}
+
+	private:
+		static constexpr std::size_t INLINE_COUNT	= 32;
+		static constexpr std::size_t MAX_COUNT		= 256;
+		static constexpr std::size_t REPETITIONS	= 1000;
+
+		/// Times each operation on std::vector, SmallVector and StaticVector, both with a count that
+		/// fits in the inline storage of SmallVector and one that does not.
+		///
+		template<class T>
+		static void RunBenchmarks(const std::string& aTypeName)
+		{
+			static constexpr std::pair<Operation, const char*> operations[] =
+			{
+				{ Operation::PushBack,		"push_back"		},
+				{ Operation::MidInsert,		"mid-insert"	},
+				{ Operation::FrontErase,	"front-erase"	}
+			};
+
+			for (const int count : { 16, static_cast<int>(MAX_COUNT) })
+			{
+				for (const auto& [operation, name] : operations)
+				{
+					const std::string suffix = "<" + aTypeName + "> " + name + " (" + std::to_string(count) + ")";
+
+					std::size_t vectorSum	= 0;
+					std::size_t smallSum	= 0;
+					std::size_t staticSum	= 0;
+
+					Benchmark("std::vector" + suffix, [&]()
+					{
+						for (std::size_t i = 0; i < REPETITIONS; ++i)
+							vectorSum += Perform<std::vector<T>>(operation, count);
+					});
+
+					Benchmark("SmallVector" + suffix, [&]()
+					{
+						for (std::size_t i = 0; i < REPETITIONS; ++i)
+							smallSum += Perform<cu::SmallVector<T, INLINE_COUNT>>(operation, count);
+					});
+
+					Benchmark("StaticVector" + suffix, [&]()
+					{
+						for (std::size_t i = 0; i < REPETITIONS; ++i)
+							staticSum += Perform<cu::StaticVector<T, MAX_COUNT>>(operation, count);
+					});
+
+					Assert::AreEqual(vectorSum, smallSum);
+					Assert::AreEqual(vectorSum, staticSum);
+				}
+			}
+		}
+	};
+}